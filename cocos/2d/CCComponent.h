@@ -72,6 +72,8 @@ public:
     virtual void onExit();
     virtual void onAdd();
     virtual void onRemove();
+    /** Called when the content size or the anchor point of the owner changes. */
+    virtual void onOwnerGeometryChanged() {}
 
 CC_CONSTRUCTOR_ACCESS:
     /**
@@ -147,4 +147,12 @@ void ComponentContainer::onExit()
     }
 }
 
+void ComponentContainer::onOwnerGeometryChanged()
+{
+    for (auto& iter : _componentMap)
+    {
+        iter.second->onOwnerGeometryChanged();
+    }
+}
+
 NS_CC_END
@@ -64,6 +64,7 @@ public:
     
     void onEnter();
     void onExit();
+    void onOwnerGeometryChanged();
     
     bool isEmpty() const { return _componentMap.empty(); } 
 private:
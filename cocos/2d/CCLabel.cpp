@@ -35,6 +35,7 @@
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCDrawNode.h"
 #include "2d/CCCamera.h"
+#include "2d/CCComponentContainer.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCRenderer.h"
@@ -660,6 +661,7 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
     {
         _lineHeight = _fontAtlas->getLineHeight();
         _contentDirty = true;
+        notifyContentSizeChange();
         _systemFontDirty = false;
     }
     _useDistanceField = distanceFieldEnabled;
@@ -785,6 +787,7 @@ void Label::setString(const std::string& text)
     {
         _utf8Text = text;
         _contentDirty = true;
+        notifyContentSizeChange();
 
         std::u32string utf32String;
         if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
@@ -818,6 +821,7 @@ void Label::setMaxLineWidth(float maxLineWidth)
     {
         _maxLineWidth = maxLineWidth;
         _contentDirty = true;
+        notifyContentSizeChange();
     }
 }
 
@@ -835,6 +839,7 @@ void Label::setDimensions(float width, float height)
 
         _maxLineWidth = width;
         _contentDirty = true;
+        notifyContentSizeChange();
 
         if(_overflow == Overflow::SHRINK){
             if (_originalFontSize > 0) {
@@ -863,6 +868,7 @@ void Label::setLineBreakWithoutSpace(bool breakWithoutSpace)
     {
         _lineBreakWithoutSpaces = breakWithoutSpace;
         _contentDirty = true;     
+        notifyContentSizeChange();
     }
 }
 
@@ -1156,6 +1162,7 @@ void Label::setBMFontSizeInternal(float fontSize)
             this->setBMFontFilePath(_bmFontPath, _bmRect, _bmRotated, fontSize);
         }
         _contentDirty = true;
+        notifyContentSizeChange();
     }
 }
 
@@ -1860,6 +1867,7 @@ void Label::setSystemFontName(const std::string& systemFont)
         _systemFont = systemFont;
         _currentLabelType = LabelType::STRING_TEXTURE;
         _systemFontDirty = true;
+        notifyContentSizeChange();
     }
 }
 
@@ -1871,6 +1879,7 @@ void Label::setSystemFontSize(float fontSize)
         _originalFontSize = fontSize;
         _currentLabelType = LabelType::STRING_TEXTURE;
         _systemFontDirty = true;
+        notifyContentSizeChange();
     }
 }
 
@@ -1948,6 +1957,7 @@ void Label::setLineHeight(float height)
     {
         _lineHeight = height;
         _contentDirty = true;
+        notifyContentSizeChange();
     }
 }
 
@@ -1963,6 +1973,7 @@ void Label::setLineSpacing(float height)
     {
         _lineSpacing = height;
         _contentDirty = true;
+        notifyContentSizeChange();
     }
 }
 
@@ -1980,6 +1991,7 @@ void Label::setAdditionalKerning(float space)
         {
             _additionalKerning = space;
             _contentDirty = true;
+            notifyContentSizeChange();
         }
     }
     else
@@ -2161,6 +2173,15 @@ std::string Label::getDescription() const
     return ret;
 }
 
+void Label::notifyContentSizeChange()
+{
+    // the size is only measured by updateContent, but a LayoutComponent has to know before that
+    if (_componentContainer && !_componentContainer->isEmpty())
+    {
+        _componentContainer->onOwnerGeometryChanged();
+    }
+}
+
 const Size& Label::getContentSize() const
 {
     if (_systemFontDirty || _contentDirty)
@@ -2296,6 +2317,7 @@ void Label::enableWrap(bool enable)
     this->rescaleWithOriginalFontSize();
     
     _contentDirty = true;
+    notifyContentSizeChange();
 }
 
 bool Label::isWrapEnabled()const
@@ -2324,6 +2346,7 @@ void Label::setOverflow(Overflow overflow)
     this->rescaleWithOriginalFontSize();
     
     _contentDirty = true;
+    notifyContentSizeChange();
 }
 
 void Label::rescaleWithOriginalFontSize()
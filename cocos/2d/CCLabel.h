@@ -705,6 +705,8 @@ protected:
     bool getFontLetterDef(char32_t character, FontLetterDefinition& letterDef) const;
 
     void computeStringNumLines();
+    /** Tells the components that the content size, measured lazily by updateContent, may change. */
+    void notifyContentSizeChange();
 
     void onDraw(const Mat4& transform, bool transformUpdated);
     void onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor);
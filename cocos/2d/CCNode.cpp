@@ -630,6 +630,11 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+
+        if (_componentContainer && !_componentContainer->isEmpty())
+        {
+            _componentContainer->onOwnerGeometryChanged();
+        }
     }
 }
 
@@ -647,6 +652,11 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+
+        if (_componentContainer && !_componentContainer->isEmpty())
+        {
+            _componentContainer->onOwnerGeometryChanged();
+        }
     }
 }
 
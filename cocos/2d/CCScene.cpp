@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "renderer/CCRenderer.h"
 #include "renderer/CCFrameBuffer.h"
 #include "platform/CCDataManager.h"
+#include "3d/CCSceneBVH.h"
 
 #if CC_USE_PHYSICS
 #include "physics/CCPhysicsWorld.h"
@@ -91,6 +92,7 @@ Scene::~Scene()
 #endif
     Director::getInstance()->getEventDispatcher()->removeEventListener(_event);
     CC_SAFE_RELEASE(_event);
+    CC_SAFE_DELETE(_bvh);
     
 #if CC_USE_PHYSICS
     delete _physicsWorld;
@@ -187,6 +189,24 @@ const std::vector<Camera*>& Scene::getCameras()
     return _cameras;
 }
 
+void Scene::setBVHEnabled(bool enabled)
+{
+    if (enabled == (_bvh != nullptr))
+        return;
+
+    if (enabled)
+    {
+        _bvh = new (std::nothrow) SceneBVH();
+        if (_running)
+            _bvh->addSprites(this);
+    }
+    else
+    {
+        // detaches the registered sprites
+        CC_SAFE_DELETE(_bvh);
+    }
+}
+
 void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eyeProjection)
 {
     render(renderer, &eyeTransform, eyeProjection, 1);
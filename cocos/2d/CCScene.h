@@ -39,6 +39,7 @@ class BaseLight;
 class Renderer;
 class EventListenerCustom;
 class EventCustom;
+class SceneBVH;
 #if CC_USE_PHYSICS
 class PhysicsWorld;
 #endif
@@ -106,6 +107,25 @@ public:
      */
     const std::vector<BaseLight*>& getLights() const { return _lights; }
 
+    /** Enable or disable the bounding volume hierarchy of the scene.
+     * When enabled, the Sprite3D nodes of the scene are culled per camera through the hierarchy
+     * instead of testing each of them against the frustum, and can be picked with SceneBVH::rayCast.
+     * @param enabled Whether to build the hierarchy, it is disabled by default.
+     * @js NA
+     */
+    void setBVHEnabled(bool enabled);
+
+    /** Whether the bounding volume hierarchy is enabled.
+     * @js NA
+     */
+    bool isBVHEnabled() const { return _bvh != nullptr; }
+
+    /** Get the bounding volume hierarchy of the scene.
+     * @return The hierarchy, nullptr if it is not enabled.
+     * @js NA
+     */
+    SceneBVH* getBVH() const { return _bvh; }
+
     /** Render the scene.
      * @param renderer The renderer use to render the scene.
      * @param eyeTransform The AdditionalTransform of camera.
@@ -160,6 +180,8 @@ protected:
     EventListenerCustom*       _event = nullptr;
 
     std::vector<BaseLight *> _lights;
+
+    SceneBVH*            _bvh = nullptr;
     
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Scene);
@@ -8,6 +8,7 @@ LOCAL_MODULE_FILENAME := libc3d
 
 LOCAL_SRC_FILES := \
 CCRay.cpp \
+CCSceneBVH.cpp \
 CCAABB.cpp \
 CCOBB.cpp \
 CCAnimate3D.cpp \
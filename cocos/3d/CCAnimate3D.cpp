@@ -115,6 +115,7 @@ Animate3D* Animate3D::clone() const
     copy->_start = _start;
     copy->_last = _last;
     copy->_playReverse = _playReverse;
+    copy->_crowdMode = _crowdMode;
     copy->setDuration(animate->getDuration());
     copy->setOriginInterval(animate->getOriginInterval());
     return copy;
@@ -153,6 +154,7 @@ void Animate3D::startWithTarget(Node *target)
     if (needReMap)
     {
         _boneCurves.clear();
+        _boneTracks.clear();
         _nodeCurves.clear();
         
         bool hasCurve = false;
@@ -223,6 +225,19 @@ void Animate3D::startWithTarget(Node *target)
             }
         }
         
+        if (sprite && sprite->getSkeleton() && !_boneCurves.empty())
+        {
+            auto skeleton = sprite->getSkeleton();
+            _boneTracks.reserve(_boneCurves.size());
+            for (ssize_t i = 0, count = skeleton->getBoneCount(); i < count; ++i)
+            {
+                auto bone = skeleton->getBoneByIndex(static_cast<unsigned int>(i));
+                auto it = _boneCurves.find(bone);
+                if (it != _boneCurves.end())
+                    _boneTracks.push_back({bone, it->second, -1, -1, -1});
+            }
+        }
+        
         if (!hasCurve)
         {
             CCLOG("warning: no animation found for the skeleton");
@@ -335,7 +350,6 @@ void Animate3D::update(float t)
             if (_weight > 0.0f)
             {
                 float transDst[3], rotDst[4], scaleDst[3];
-                float* trans = nullptr, *rot = nullptr, *scale = nullptr;
                 if (_playReverse){
                     t = 1 - t;
                     lastTime = 1.0f - lastTime;
@@ -344,25 +358,16 @@ void Animate3D::update(float t)
                 t = _start + t * _last;
                 lastTime = _start + lastTime * _last;
                 
-                for (const auto& it : _boneCurves) {
-                    auto bone = it.first;
-                    auto curve = it.second;
-                    if (curve->translateCurve)
-                    {
-                        curve->translateCurve->evaluate(t, transDst, _translateEvaluate);
-                        trans = &transDst[0];
-                    }
-                    if (curve->rotCurve)
-                    {
-                        curve->rotCurve->evaluate(t, rotDst, _roteEvaluate);
-                        rot = &rotDst[0];
-                    }
-                    if (curve->scaleCurve)
-                    {
-                        curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate);
-                        scale = &scaleDst[0];
-                    }
-                    bone->setAnimationValue(trans, rot, scale, this, _weight);
+                // a shared pose is only valid when nothing else is blended into the skeleton
+                if (_crowdMode && _state == Animate3D::Animate3DState::Running && _weight >= 1.0f
+                    && !_boneTracks.empty() && s_fadeOutAnimates.find(_target) == s_fadeOutAnimates.end())
+                    updateSharedPose(t);
+                else
+                {
+                    // a pose applied from the cache on an earlier frame must not survive this evaluation
+                    if (!_boneTracks.empty())
+                        static_cast<Sprite3D*>(_target)->getSkeleton()->discardAppliedPose();
+                    evaluateBoneCurves(t);
                 }
                 
                 for (const auto& it : _nodeCurves)
@@ -418,6 +423,52 @@ void Animate3D::update(float t)
     }
 }
 
+void Animate3D::evaluateBoneCurves(float t)
+{
+    float transDst[3], rotDst[4], scaleDst[3];
+    float* trans = nullptr, *rot = nullptr, *scale = nullptr;
+    for (auto& track : _boneTracks) {
+        auto curve = track.curve;
+        if (curve->translateCurve)
+        {
+            curve->translateCurve->evaluate(t, transDst, _translateEvaluate, track.translateCursor);
+            trans = &transDst[0];
+        }
+        if (curve->rotCurve)
+        {
+            curve->rotCurve->evaluate(t, rotDst, _roteEvaluate, track.rotCursor);
+            rot = &rotDst[0];
+        }
+        if (curve->scaleCurve)
+        {
+            curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate, track.scaleCursor);
+            scale = &scaleDst[0];
+        }
+        track.bone->setAnimationValue(trans, rot, scale, this, _weight);
+    }
+}
+
+void Animate3D::updateSharedPose(float t)
+{
+    auto skeleton = static_cast<Sprite3D*>(_target)->getSkeleton();
+    auto cache = Animation3DPoseCache::getInstance();
+    float duration = _animation->getDuration();
+    float timeStep = cache->getTimeStep();
+    int bucket = static_cast<int>(t * duration / timeStep + 0.5f);
+    
+    if (cache->applyPose(_animation, bucket, _quality, skeleton))
+        return;
+    
+    // a culled sprite never draws, so a pose applied on an earlier frame may still be pending;
+    // drop it so updateBoneMatrix recomputes the bones before they are captured
+    skeleton->discardAppliedPose();
+    // evaluate at the bucket time rather than t, so that every character in the bucket gets the same pose
+    float bucketTime = duration > 0.0f ? std::min(bucket * timeStep / duration, 1.0f) : 0.0f;
+    evaluateBoneCurves(bucketTime);
+    skeleton->updateBoneMatrix();
+    cache->addPose(_animation, bucket, _quality, skeleton);
+}
+
 float Animate3D::getSpeed() const
 {
     return _playReverse ? -_absSpeed : _absSpeed;
@@ -497,6 +548,7 @@ Animate3D::Animate3D()
 , _lastTime(0.0f)
 , _originInterval(0.0f)
 , _frameRate(30.0f)
+, _crowdMode(false)
 {
     setQuality(Animate3DQuality::QUALITY_HIGH);
 }
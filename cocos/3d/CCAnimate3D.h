@@ -119,6 +119,14 @@ public:
     
     /**get animate quality*/
     Animate3DQuality getQuality() const;
+    
+    /**
+     * set crowd mode. While the animate is the only one running on its Sprite3D, the skeleton pose is
+     * evaluated at Animation3DPoseCache time steps and shared with every other crowd mode character
+     * playing the same animation on the same skeleton data.
+     */
+    void setCrowdMode(bool crowdMode) { _crowdMode = crowdMode; }
+    bool isCrowdMode() const { return _crowdMode; }
 
 
     struct Animate3DDisplayedEventInfo
@@ -147,6 +155,11 @@ CC_CONSTRUCTOR_ACCESS:
     
 protected:
     
+    /**evaluate bone curves at t (0 - 1 of the whole animation) and pass the values to the bones*/
+    void evaluateBoneCurves(float t);
+    /**apply the shared pose nearest to t, evaluating and caching it first if needed*/
+    void updateSharedPose(float t);
+    
     enum class Animate3DState
     {
         FadeIn,
@@ -172,8 +185,23 @@ protected:
     EvaluateType _roteEvaluate;
     EvaluateType _scaleEvaluate;
     Animate3DQuality _quality;
+    bool _crowdMode;
     
     std::unordered_map<Bone3D*, Animation3D::Curve*> _boneCurves; //weak ref
+    
+    /**
+     * flattened copy of _boneCurves in skeleton order, with the key frame found by the
+     * previous update cached per curve so that evaluating the next frame is usually O(1)
+     */
+    struct BoneTrack
+    {
+        Bone3D* bone; //weak ref
+        Animation3D::Curve* curve; //weak ref
+        int translateCursor;
+        int rotCursor;
+        int scaleCursor;
+    };
+    std::vector<BoneTrack> _boneTracks;
     std::unordered_map<Node*, Animation3D::Curve*> _nodeCurves;
     
     std::unordered_map<int, ValueMap> _keyFrameUserInfos;
@@ -25,6 +25,7 @@
 
 #include "3d/CCAnimation3D.h"
 #include "3d/CCBundle3D.h"
+#include "3d/CCSkeleton3D.h"
 #include "platform/CCFileUtils.h"
 
 NS_CC_BEGIN
@@ -87,6 +88,9 @@ Animation3D::Animation3D()
 
 Animation3D::~Animation3D()
 {
+    if (Animation3DPoseCache::_cacheInstance)
+        Animation3DPoseCache::_cacheInstance->removePoses(this);
+    
     for (const auto& itor : _boneCurves) {
         Curve* curve = itor.second;
         CC_SAFE_DELETE(curve);
@@ -250,4 +254,147 @@ Animation3DCache::~Animation3DCache()
     removeAllAnimations();
 }
 
+////////////////////////////////////////////////////////////////
+Animation3DPoseCache* Animation3DPoseCache::_cacheInstance = nullptr;
+
+Animation3DPoseCache* Animation3DPoseCache::getInstance()
+{
+    if (_cacheInstance == nullptr)
+        _cacheInstance = new (std::nothrow) Animation3DPoseCache();
+    
+    return _cacheInstance;
+}
+
+void Animation3DPoseCache::destroyInstance()
+{
+    CC_SAFE_DELETE(_cacheInstance);
+}
+
+size_t Animation3DPoseCache::PoseKeyHash::operator()(const PoseKey& key) const
+{
+    size_t hash = std::hash<void*>()(key.animation);
+    hash ^= std::hash<int>()(key.bucket) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(static_cast<int>(key.quality)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<unsigned int>()(key.skeletonHash) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+bool Animation3DPoseCache::applyPose(Animation3D* animation, int bucket, Animate3DQuality quality, Skeleton3D* skeleton)
+{
+    PoseKey key = {animation, bucket, quality, skeleton->getStructureHash()};
+    auto it = _poses.find(key);
+    if (it == _poses.end())
+    {
+        ++_misses;
+        return false;
+    }
+    
+    ++_hits;
+    it->second.lastUsed = ++_useCounter;
+    skeleton->applyPose(it->second.locals, it->second.worlds);
+    return true;
+}
+
+void Animation3DPoseCache::addPose(Animation3D* animation, int bucket, Animate3DQuality quality, Skeleton3D* skeleton)
+{
+    PoseKey key = {animation, bucket, quality, skeleton->getStructureHash()};
+    auto& pose = _poses[key];
+    _memoryBytes -= (pose.locals.size() + pose.worlds.size()) * sizeof(Mat4);
+    skeleton->capturePose(pose.locals, pose.worlds);
+    pose.lastUsed = ++_useCounter;
+    _memoryBytes += (pose.locals.size() + pose.worlds.size()) * sizeof(Mat4);
+    
+    if (_memoryBytes > _memoryLimit)
+        trim();
+}
+
+void Animation3DPoseCache::removePoses(Animation3D* animation)
+{
+    for (auto it = _poses.begin(); it != _poses.end(); ) {
+        if (it->first.animation == animation)
+        {
+            _memoryBytes -= (it->second.locals.size() + it->second.worlds.size()) * sizeof(Mat4);
+            it = _poses.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void Animation3DPoseCache::removeAllPoses()
+{
+    _poses.clear();
+    _memoryBytes = 0;
+}
+
+void Animation3DPoseCache::setTimeStep(float timeStep)
+{
+    CCASSERT(timeStep > 0.0f, "invalid time step");
+    if (timeStep != _timeStep)
+    {
+        _timeStep = timeStep;
+        removeAllPoses();
+    }
+}
+
+void Animation3DPoseCache::setMemoryLimit(size_t bytes)
+{
+    _memoryLimit = bytes;
+    if (_memoryBytes > _memoryLimit)
+        trim();
+}
+
+Animation3DPoseCache::Stats Animation3DPoseCache::getStats() const
+{
+    Stats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.poseCount = _poses.size();
+    stats.memoryBytes = _memoryBytes;
+    return stats;
+}
+
+void Animation3DPoseCache::resetStats()
+{
+    _hits = 0;
+    _misses = 0;
+}
+
+void Animation3DPoseCache::trim()
+{
+    // drop down to 3/4 of the limit so that a full cache does not trim on every insertion
+    std::vector<std::pair<unsigned int, PoseKey>> lru;
+    lru.reserve(_poses.size());
+    for (const auto& it : _poses) {
+        lru.push_back(std::make_pair(it.second.lastUsed, it.first));
+    }
+    std::sort(lru.begin(), lru.end(), [](const std::pair<unsigned int, PoseKey>& a, const std::pair<unsigned int, PoseKey>& b) {
+        return a.first < b.first;
+    });
+    
+    size_t target = _memoryLimit / 4 * 3;
+    for (const auto& it : lru) {
+        if (_memoryBytes <= target)
+            break;
+        auto pose = _poses.find(it.second);
+        _memoryBytes -= (pose->second.locals.size() + pose->second.worlds.size()) * sizeof(Mat4);
+        _poses.erase(pose);
+    }
+}
+
+Animation3DPoseCache::Animation3DPoseCache()
+: _timeStep(1.0f / 30.0f)
+, _memoryLimit(8 * 1024 * 1024)
+, _memoryBytes(0)
+, _useCounter(0)
+, _hits(0)
+, _misses(0)
+{
+}
+
+Animation3DPoseCache::~Animation3DPoseCache()
+{
+    removeAllPoses();
+}
+
 NS_CC_END
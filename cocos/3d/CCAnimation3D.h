@@ -132,6 +132,103 @@ protected:
     std::unordered_map<std::string, Animation3D*> _animations; //cached animations
 };
 
+class Skeleton3D;
+enum class Animate3DQuality;
+
+/**
+ * @brief Animation3D pose cache, used by Animate3D crowd mode.
+ *
+ * Characters playing the same Animation3D on skeletons with the same structure hash
+ * share one evaluated pose per time bucket, so N characters at M distinct phases
+ * only evaluate M poses.
+ */
+class CC_DLL Animation3DPoseCache
+{
+    friend class Animation3D;
+public:
+    /**
+     * the Stats struct
+     * @brief hit rate and memory usage of the cache
+     */
+    struct Stats
+    {
+        unsigned int hits;
+        unsigned int misses;
+        size_t poseCount;
+        size_t memoryBytes;
+    };
+    
+    /**get and destroy instance*/
+    static Animation3DPoseCache* getInstance();
+    static void destroyInstance();
+    
+    /**
+     * apply the cached pose of animation at bucket, evaluated with quality, to skeleton
+     * @return false if no pose is cached yet, the caller should evaluate the animation and call addPose
+     */
+    bool applyPose(Animation3D* animation, int bucket, Animate3DQuality quality, Skeleton3D* skeleton);
+    /**capture the current pose of skeleton as the pose of animation at bucket evaluated with quality*/
+    void addPose(Animation3D* animation, int bucket, Animate3DQuality quality, Skeleton3D* skeleton);
+    
+    /**remove all poses evaluated from animation*/
+    void removePoses(Animation3D* animation);
+    /**remove all poses*/
+    void removeAllPoses();
+    
+    /**get & set the width of a time bucket in seconds, default is 1/30. Changing it drops all poses*/
+    float getTimeStep() const { return _timeStep; }
+    void setTimeStep(float timeStep);
+    
+    /**get & set the memory limit in bytes, the least recently used poses are dropped when it is exceeded*/
+    size_t getMemoryLimit() const { return _memoryLimit; }
+    void setMemoryLimit(size_t bytes);
+    
+    /**get hit, miss and memory statistics*/
+    Stats getStats() const;
+    /**reset hit and miss counters*/
+    void resetStats();
+    
+protected:
+    struct PoseKey
+    {
+        Animation3D* animation;
+        int bucket;
+        Animate3DQuality quality;
+        unsigned int skeletonHash;
+        
+        bool operator==(const PoseKey& other) const
+        {
+            return animation == other.animation && bucket == other.bucket && quality == other.quality
+                && skeletonHash == other.skeletonHash;
+        }
+    };
+    struct PoseKeyHash
+    {
+        size_t operator()(const PoseKey& key) const;
+    };
+    struct Pose
+    {
+        std::vector<Mat4> locals;
+        std::vector<Mat4> worlds;
+        unsigned int lastUsed;
+    };
+    
+    Animation3DPoseCache();
+    ~Animation3DPoseCache();
+    
+    /**drop least recently used poses until memory is back under the limit*/
+    void trim();
+    
+    static Animation3DPoseCache* _cacheInstance; //cache instance
+    std::unordered_map<PoseKey, Pose, PoseKeyHash> _poses;
+    float _timeStep;
+    size_t _memoryLimit;
+    size_t _memoryBytes;
+    unsigned int _useCounter;
+    unsigned int _hits;
+    unsigned int _misses;
+};
+
 // end of 3d group
 /// @}
 NS_CC_END
@@ -25,6 +25,7 @@
 #ifndef __CCANIMATIONCURVE_H__
 #define __CCANIMATIONCURVE_H__
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
 
@@ -75,6 +76,15 @@ public:
      */
     void evaluate(float time, float* dst, EvaluateType type) const;
     
+    /**
+     * evaluate value of time, starting the key frame search from a cursor
+     * @param time Time to be estimated
+     * @param dst Estimated value of that time
+     * @param type EvaluateType
+     * @param cursor Key frame index found by the previous call, updated on return. Use -1 when unknown.
+     */
+    void evaluate(float time, float* dst, EvaluateType type, int& cursor) const;
+    
     /**set evaluate function, allow the user use own function*/
     void setEvaluateFun(std::function<void(float time, float* dst)> fun);
     
@@ -94,6 +104,11 @@ CC_CONSTRUCTOR_ACCESS:
      */
     int determineIndex(float time) const;
     
+    /**
+     * Determine index by time, checking the key frames around hint before falling back to a binary search.
+     */
+    int determineIndex(float time, int hint) const;
+    
 protected:
     
     float* _value;   //
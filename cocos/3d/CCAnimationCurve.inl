@@ -3,6 +3,13 @@ NS_CC_BEGIN
 
 template <int componentSize>
 void AnimationCurve<componentSize>::evaluate(float time, float* dst, EvaluateType type) const
+{
+    int cursor = -1;
+    evaluate(time, dst, type, cursor);
+}
+
+template <int componentSize>
+void AnimationCurve<componentSize>::evaluate(float time, float* dst, EvaluateType type, int& cursor) const
 {
     if (_count == 1 || time <= _keytime[0])
     {
@@ -15,7 +22,8 @@ void AnimationCurve<componentSize>::evaluate(float time, float* dst, EvaluateTyp
         return;
     }
     
-    unsigned int index = determineIndex(time);
+    unsigned int index = determineIndex(time, cursor);
+    cursor = index;
     
     float scale = (_keytime[index + 1] - _keytime[index]);
     float t = (time - _keytime[index]) / scale;
@@ -144,4 +152,28 @@ int AnimationCurve<componentSize>::determineIndex(float time) const
     return -1;
 }
 
+template <int componentSize>
+int AnimationCurve<componentSize>::determineIndex(float time, int hint) const
+{
+    // playback usually advances by less than a key frame per update, so the
+    // previous index or one of its neighbours is almost always the answer
+    if (hint >= 0 && hint < _count - 1)
+    {
+        if (time >= _keytime[hint])
+        {
+            for (int i = hint, end = std::min(hint + 4, _count - 1); i < end; ++i)
+            {
+                if (time <= _keytime[i + 1])
+                    return i;
+            }
+        }
+        else if (hint > 0 && time >= _keytime[hint - 1])
+        {
+            return hint - 1;
+        }
+    }
+    
+    return determineIndex(time);
+}
+
 NS_CC_END
\ No newline at end of file
@@ -32,6 +32,16 @@ THE SOFTWARE.
 #include "3d/CCBundleReader.h"
 #include "base/CCData.h"
 
+#include <cstring>
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CC_BUNDLE3D_USE_MMAP 1
+#endif
+
 #define BUNDLE_TYPE_SCENE               1
 #define BUNDLE_TYPE_NODE                2
 #define BUNDLE_TYPE_ANIMATIONS          3
@@ -147,6 +157,17 @@ void getChildMap(std::map<int, std::vector<int> >& map, SkinData* skinData, cons
     }
 }
 
+const char* Bundle3D::readBinaryArray(ssize_t size, ssize_t count)
+{
+    ssize_t position = _binaryReader.tell();
+    ssize_t bytes = size * count;
+    if (count <= 0 || position < 0 || bytes > _binaryReader.length() - position)
+        return nullptr;
+    
+    _binaryReader.seek((long int)bytes, SEEK_CUR);
+    return _binaryBuffer.get() + position;
+}
+
 Bundle3D* Bundle3D::createBundle()
 {
     auto bundle = new (std::nothrow) Bundle3D();
@@ -162,7 +183,7 @@ void Bundle3D::clear()
 {
     if (_isBinary)
     {
-        _binaryBuffer.clear();
+        _binaryBuffer.reset();
         CC_SAFE_DELETE_ARRAY(_references);
     }
     else
@@ -398,6 +419,8 @@ bool  Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
         return false;
     }
     MeshData*   meshData = nullptr;
+    // old versions have no aabb in the file, it is calculated from copied arrays instead
+    bool zeroCopy = _version != "0.3" && _version != "0.4" && _version != "0.5";
     for(unsigned int i = 0; i < meshSize ; ++i)
     {
          unsigned int attribSize=0;
@@ -434,12 +457,27 @@ bool  Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
             goto FAILED;
         }
 
-        meshData->vertex.resize(vertexSizeInFloat);
-        if (_binaryReader.read(&meshData->vertex[0], 4, vertexSizeInFloat) != vertexSizeInFloat)
+        if (zeroCopy)
         {
-            CCLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
-            goto FAILED;
+            meshData->mappedBuffer = _binaryBuffer;
+            meshData->mappedVertex = readBinaryArray(4, vertexSizeInFloat);
+            meshData->mappedVertexSizeInFloat = vertexSizeInFloat;
+            if (meshData->mappedVertex == nullptr)
+            {
+                CCLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
+                goto FAILED;
+            }
+        }
+        else
+        {
+            meshData->vertex.resize(vertexSizeInFloat);
+            if (_binaryReader.read(&meshData->vertex[0], 4, vertexSizeInFloat) != vertexSizeInFloat)
+            {
+                CCLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
+                goto FAILED;
+            }
         }
+        meshData->vertexSizeInFloat = vertexSizeInFloat;
 
         // Read index data
         unsigned int meshPartCount = 1;
@@ -456,14 +494,28 @@ bool  Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
                 CCLOG("warning: Failed to read meshdata: nIndexCount '%s'.", _path.c_str());
                 goto FAILED;
             }
-            indexArray.resize(nIndexCount);
-            if (_binaryReader.read(&indexArray[0], 2, nIndexCount) != nIndexCount)
+            if (zeroCopy)
             {
-                CCLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
-                goto FAILED;
+                const char* indices = readBinaryArray(2, nIndexCount);
+                if (indices == nullptr)
+                {
+                    CCLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
+                    goto FAILED;
+                }
+                meshData->mappedSubMeshIndices.push_back(std::make_pair(indices, (ssize_t)nIndexCount));
+                meshData->numIndex = (int)meshData->mappedSubMeshIndices.size();
+            }
+            else
+            {
+                indexArray.resize(nIndexCount);
+                if (_binaryReader.read(&indexArray[0], 2, nIndexCount) != nIndexCount)
+                {
+                    CCLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
+                    goto FAILED;
+                }
+                meshData->subMeshIndices.push_back(indexArray);
+                meshData->numIndex = (int)meshData->subMeshIndices.size();
             }
-            meshData->subMeshIndices.push_back(indexArray);
-            meshData->numIndex = (int)meshData->subMeshIndices.size();
             //meshData->subMeshAABB.push_back(calculateAABB(meshData->vertex, meshData->getPerVertexSize(), indexArray));
             if (_version != "0.3" && _version != "0.4" && _version != "0.5")
             {
@@ -1075,22 +1127,64 @@ bool Bundle3D::loadJson(const std::string& path)
 }
 
 
+std::shared_ptr<char> Bundle3D::mapBinaryFile(const std::string& path, ssize_t* size)
+{
+#ifdef CC_BUNDLE3D_USE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 4)
+    {
+        close(fd);
+        return nullptr;
+    }
+    
+    size_t length = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return nullptr;
+    
+    // FileUtils subclasses may decrypt or unpack files, only use the raw file if it is a plain c3b
+    if (memcmp(addr, "C3B", 4) != 0)
+    {
+        munmap(addr, length);
+        return nullptr;
+    }
+    
+    *size = static_cast<ssize_t>(length);
+    return std::shared_ptr<char>(static_cast<char*>(addr), [length](char* p) {
+        munmap(p, length);
+    });
+#else
+    return nullptr;
+#endif
+}
+
 bool Bundle3D::loadBinary(const std::string& path)
 {
     clear();
     
     // get file data
-    _binaryBuffer.clear();
-    _binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
-    if (_binaryBuffer.isNull())
+    ssize_t size = 0;
+    _binaryBuffer = mapBinaryFile(path, &size);
+    if (!_binaryBuffer)
     {
-        clear();
-        CCLOG("warning: Failed to read file: %s", path.c_str());
-        return false;
+        // not a plain file (e.g. inside the apk) or not readable as is, go through FileUtils
+        Data data = FileUtils::getInstance()->getDataFromFile(path);
+        if (data.isNull())
+        {
+            clear();
+            CCLOG("warning: Failed to read file: %s", path.c_str());
+            return false;
+        }
+        _binaryBuffer.reset((char*)data.takeBuffer(&size), free);
     }
     
     // Initialise bundle reader
-    _binaryReader.init( (char*)_binaryBuffer.getBytes(),  _binaryBuffer.getSize() );
+    _binaryReader.init(_binaryBuffer.get(), size);
     
     // Read identifier info
     char identifier[] = { 'C', '3', 'B', '\0'};
@@ -2210,9 +2304,16 @@ std::vector<Vec3> Bundle3D::getTrianglesList(const std::string& path)
     Bundle3D::destroyBundle(bundle);
     for (auto iter : meshs.meshDatas){
         int preVertexSize = iter->getPerVertexSize() / sizeof(float);
-        for (const auto& indexArray : iter->subMeshIndices){
-            for (auto i : indexArray){
-                trianglesList.emplace_back(iter->vertex[i * preVertexSize], iter->vertex[i * preVertexSize + 1], iter->vertex[i * preVertexSize + 2]);
+        // mapped data may be unaligned, copy values out instead of dereferencing
+        auto vertex = static_cast<const char*>(iter->getVertexData());
+        for (size_t k = 0, count = iter->getSubMeshCount(); k < count; ++k){
+            auto indices = static_cast<const char*>(iter->getSubMeshIndexData(k));
+            for (ssize_t j = 0, indexCount = iter->getSubMeshIndexCount(k); j < indexCount; ++j){
+                unsigned short i;
+                memcpy(&i, indices + j * sizeof(i), sizeof(i));
+                Vec3 position;
+                memcpy(&position, vertex + i * preVertexSize * sizeof(float), sizeof(position));
+                trianglesList.push_back(position);
             }
         }
     }
@@ -2237,12 +2338,23 @@ Bundle3D::~Bundle3D()
 }
 
 cocos2d::AABB Bundle3D::calculateAABB( const std::vector<float>& vertex, int stride, const std::vector<unsigned short>& index )
+{
+    return calculateAABB(vertex.data(), stride, index.data(), (ssize_t)index.size());
+}
+
+cocos2d::AABB Bundle3D::calculateAABB(const void* vertex, int stride, const void* index, ssize_t indexCount)
 {
     AABB aabb;
-    stride /= 4;
-    for (const auto& it : index)
-    {
-        Vec3 point(vertex[it * stride], vertex[it * stride + 1], vertex[it * stride + 2]);
+    // mapped buffers give no alignment guarantee, so copy the values out instead of dereferencing
+    auto vertexBytes = static_cast<const char*>(vertex);
+    auto indexBytes = static_cast<const char*>(index);
+    for (ssize_t i = 0; i < indexCount; ++i)
+    {
+        unsigned short it;
+        memcpy(&it, indexBytes + i * sizeof(unsigned short), sizeof(it));
+        float position[3];
+        memcpy(position, vertexBytes + it * stride, sizeof(position));
+        Vec3 point(position[0], position[1], position[2]);
         aabb.updateMinMax(&point, 1);
     }
     return aabb;
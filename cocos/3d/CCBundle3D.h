@@ -97,6 +97,8 @@ public:
     
     //calculate aabb
     static AABB calculateAABB(const std::vector<float>& vertex, int stride, const std::vector<unsigned short>& index);
+    /** same as above, for vertex and index data that may live in a mapped file buffer */
+    static AABB calculateAABB(const void* vertex, int stride, const void* index, ssize_t indexCount);
   
 protected:
 
@@ -167,6 +169,18 @@ protected:
      * @param The data id
      */
     Reference* seekToFirstType(unsigned int type, const std::string& id = "");
+    
+    /*
+     * skip count elements of size bytes in the binary buffer
+     * @return pointer to the first element in the buffer, nullptr if the buffer is too short
+     */
+    const char* readBinaryArray(ssize_t size, ssize_t count);
+    
+    /*
+     * memory map a c3b file
+     * @return the mapping, nullptr if the file can not be mapped or is not a plain c3b file
+     */
+    static std::shared_ptr<char> mapBinaryFile(const std::string& path, ssize_t* size);
 
 CC_CONSTRUCTOR_ACCESS:
     Bundle3D();
@@ -181,8 +195,8 @@ protected:
     std::string _jsonBuffer;
     rapidjson::Document _jsonReader;
 
-    // for binary reading
-    Data _binaryBuffer;
+    // for binary reading, memory mapped when possible, shared with the MeshData it produces
+    std::shared_ptr<char> _binaryBuffer;
     BundleReader _binaryReader;
     unsigned int _referenceCount;
     Reference* _references;
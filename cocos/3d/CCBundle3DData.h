@@ -33,6 +33,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
  
 NS_CC_BEGIN
 
@@ -151,6 +152,14 @@ struct MeshData
     int numIndex;
     std::vector<MeshVertexAttrib> attribs;
     int attribCount;
+    
+    // Binary bundles leave vertex and subMeshIndices empty and point into the file buffer
+    // instead; mappedBuffer keeps that buffer alive until the last MeshData using it is gone.
+    // The pointers may be unaligned, read them with memcpy.
+    std::shared_ptr<char> mappedBuffer;
+    const char* mappedVertex;
+    ssize_t mappedVertexSizeInFloat;
+    std::vector<std::pair<const char*, ssize_t>> mappedSubMeshIndices;
 
 public:
     /**
@@ -166,6 +175,36 @@ public:
         }
         return vertexsize;
     }
+    
+    /** Get vertex data, either from vertex or from the mapped buffer */
+    const void* getVertexData() const
+    {
+        return mappedVertex ? (const void*)mappedVertex : (const void*)vertex.data();
+    }
+    
+    /** Get vertex data size in float */
+    ssize_t getVertexDataSizeInFloat() const
+    {
+        return mappedVertex ? mappedVertexSizeInFloat : (ssize_t)vertex.size();
+    }
+    
+    /** Get sub mesh count */
+    size_t getSubMeshCount() const
+    {
+        return mappedBuffer ? mappedSubMeshIndices.size() : subMeshIndices.size();
+    }
+    
+    /** Get index data of sub mesh */
+    const void* getSubMeshIndexData(size_t index) const
+    {
+        return mappedBuffer ? (const void*)mappedSubMeshIndices[index].first : (const void*)subMeshIndices[index].data();
+    }
+    
+    /** Get index count of sub mesh */
+    ssize_t getSubMeshIndexCount(size_t index) const
+    {
+        return mappedBuffer ? mappedSubMeshIndices[index].second : (ssize_t)subMeshIndices[index].size();
+    }
 
     /**
      * Reset the data
@@ -179,11 +218,17 @@ public:
         vertexSizeInFloat = 0;
         numIndex = 0;
         attribCount = 0;
+        mappedBuffer.reset();
+        mappedVertex = nullptr;
+        mappedVertexSizeInFloat = 0;
+        mappedSubMeshIndices.clear();
     }
     MeshData()
     : vertexSizeInFloat(0)
     , numIndex(0)
     , attribCount(0)
+    , mappedVertex(nullptr)
+    , mappedVertexSizeInFloat(0)
     {
     }
 };
@@ -33,6 +33,7 @@
 #include "base/CCDirector.h"
 #include "base/CCConfiguration.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
 #include "renderer/CCTechnique.h"
@@ -133,6 +134,9 @@ Mesh::Mesh()
 , _blendDirty(true)
 , _material(nullptr)
 , _texFile("")
+, _instancingEnabled(false)
+, _instancingMaterialDirty(true)
+, _instancingMaterial(nullptr)
 {
     
 }
@@ -144,6 +148,7 @@ Mesh::~Mesh()
     CC_SAFE_RELEASE(_skin);
     CC_SAFE_RELEASE(_meshIndexData);
     CC_SAFE_RELEASE(_material);
+    CC_SAFE_RELEASE(_instancingMaterial);
     CC_SAFE_RELEASE(_glProgramState);
 }
 
@@ -306,6 +311,7 @@ void Mesh::setTexture(Texture2D* tex, NTextureData::Usage usage, bool cacheFileN
         }
         
         bindMeshCommand();
+        _instancingMaterialDirty = true;
         if (cacheFileName)
             _texFile = tex->getPath();
     }
@@ -365,6 +371,7 @@ void Mesh::setMaterial(Material* material)
         setBlendFunc(_blend);
     
     bindMeshCommand();
+    _instancingMaterialDirty = true;
 }
 
 Material* Mesh::getMaterial() const
@@ -404,9 +411,35 @@ void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, u
     _meshCommand.set3D(!_force2DQueue);
     _material->getStateBlock()->setBlend(_force2DQueue || isTransparent);
 
+    const auto scene = Director::getInstance()->getRunningScene();
+
+    if (_instancingEnabled && !isTransparent && !_force2DQueue)
+    {
+        if (_instancingMaterialDirty)
+            updateInstancingMaterial();
+
+        if (_instancingMaterial)
+        {
+            // color and transform are per-instance attributes, only lights are shared by the instances
+            auto pass = _instancingMaterial->_currentTechnique->_passes.at(0);
+            _meshCommand.setInstancing(_instancingMaterial, 0, color);
+            _meshCommand.genInstancingID(pass->getGLProgramState()->getGLProgram()->getProgram(),
+                                         pass->getTexture() ? pass->getTexture()->getName() : 0,
+                                         getVertexBuffer(),
+                                         getIndexBuffer(),
+                                         lightMask);
+
+            if (scene && !scene->getLights().empty())
+                setLightUniforms(pass, scene, color, lightMask);
+
+            renderer->addCommand(&_meshCommand);
+            return;
+        }
+    }
+    _meshCommand.setInstancing(nullptr, 0, color);
+
     // set default uniforms for Mesh
     // 'u_color' and others
-    const auto scene = Director::getInstance()->getRunningScene();
     auto technique = _material->_currentTechnique;
     for(const auto pass : technique->_passes)
     {
@@ -431,6 +464,7 @@ void Mesh::setSkin(MeshSkin* skin)
         CC_SAFE_RELEASE(_skin);
         _skin = skin;
         calculateAABB();
+        _instancingMaterialDirty = true;
     }
 }
 
@@ -443,6 +477,7 @@ void Mesh::setMeshIndexData(MeshIndexData* subMesh)
         _meshIndexData = subMesh;
         calculateAABB();
         bindMeshCommand();
+        _instancingMaterialDirty = true;
     }
 }
 
@@ -517,6 +552,54 @@ void Mesh::bindMeshCommand()
     }
 }
 
+void Mesh::setInstancingEnabled(bool enabled)
+{
+    if (_instancingEnabled != enabled)
+    {
+        _instancingEnabled = enabled;
+        _instancingMaterialDirty = true;
+    }
+}
+
+void Mesh::updateInstancingMaterial()
+{
+    _instancingMaterialDirty = false;
+    CC_SAFE_RELEASE_NULL(_instancingMaterial);
+
+    if (!_instancingEnabled || !_material || !_meshIndexData || _skin || !Configuration::getInstance()->supportsInstancing())
+        return;
+
+    auto diffuse = _textures.find(NTextureData::Usage::Diffuse);
+    if (diffuse == _textures.end() || diffuse->second == nullptr)
+        return;
+
+    auto technique = _material->_currentTechnique;
+    if (technique->getPassCount() != 1)
+        return;
+
+    // only the built-in shaders have an instanced version
+    auto cache = GLProgramCache::getInstance();
+    auto glProgram = technique->getPassByIndex(0)->getGLProgramState()->getGLProgram();
+    GLProgram* instancedProgram = nullptr;
+    if (glProgram == cache->getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE))
+        instancedProgram = cache->getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED);
+    else if (glProgram == cache->getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE))
+        instancedProgram = cache->getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED);
+
+    if (!instancedProgram)
+        return;
+
+    auto glProgramState = GLProgramState::create(instancedProgram);
+    _instancingMaterial = Material::createWithGLStateProgram(glProgramState);
+    _instancingMaterial->retain();
+    // share the render state, so blend, cull face and depth settings follow the regular material
+    _instancingMaterial->setStateBlock(_material->getStateBlock());
+
+    auto pass = _instancingMaterial->_currentTechnique->_passes.at(0);
+    pass->setVertexAttribBinding(VertexAttribBinding::create(_meshIndexData, glProgramState));
+    pass->setTexture(diffuse->second);
+}
+
 void Mesh::setLightUniforms(Pass* pass, Scene* scene, const Vec4& color, unsigned int lightmask)
 {
     CCASSERT(pass, "Invalid Pass");
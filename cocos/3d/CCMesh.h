@@ -228,6 +228,16 @@ public:
 
     std::string getTextureFileName(){ return _texFile; }
 
+    /**
+     * Enables hardware instancing for this mesh, default is false.
+     * Opaque meshes sharing the same vertex and index buffers, diffuse texture, built-in shader and light mask
+     * are then drawn by the renderer with a single instanced draw call, using the render state of the first one.
+     * Only the built-in unskinned shaders without normal mapping can be instanced, other meshes
+     * and devices without instancing support keep using the regular path.
+     */
+    void setInstancingEnabled(bool enabled);
+    bool isInstancingEnabled() const { return _instancingEnabled; }
+
 CC_CONSTRUCTOR_ACCESS:
 
     Mesh();
@@ -237,6 +247,7 @@ protected:
     void resetLightUniformValues();
     void setLightUniforms(Pass* pass, Scene* scene, const Vec4& color, unsigned int lightmask);
     void bindMeshCommand();
+    void updateInstancingMaterial();
 
     std::map<NTextureData::Usage, Texture2D*> _textures; //textures that submesh is using
     MeshSkin*           _skin;     //skin
@@ -270,6 +281,10 @@ protected:
     std::vector<float> _spotLightUniformRangeInverseValues;
 
     std::string _texFile;
+
+    bool                _instancingEnabled;
+    bool                _instancingMaterialDirty;
+    Material*           _instancingMaterial; // material with the instanced version of the built-in shader
 };
 
 // end of 3d group
@@ -104,15 +104,23 @@ Vec4* MeshSkin::getMatrixPalette()
     if (_matrixPalette == nullptr)
     {
         _matrixPalette = new (std::nothrow) Vec4[_skinBones.size() * PALETTE_ROWS];
+        _paletteVersions.assign(_skinBones.size(), 0);
     }
-    int i = 0, paletteIndex = 0;
-    static Mat4 t;
-    for (auto it : _skinBones )
+    Mat4 t;
+    for (ssize_t i = 0, size = _skinBones.size(); i < size; ++i)
     {
-        Mat4::multiply(it->getWorldMat(), _invBindPoses[i++], &t);
-        _matrixPalette[paletteIndex++].set(t.m[0], t.m[4], t.m[8], t.m[12]);
-        _matrixPalette[paletteIndex++].set(t.m[1], t.m[5], t.m[9], t.m[13]);
-        _matrixPalette[paletteIndex++].set(t.m[2], t.m[6], t.m[10], t.m[14]);
+        auto bone = _skinBones.at(i);
+        const Mat4& world = bone->getWorldMat();
+        // the palette entry only depends on the world matrix, skip bones whose pose did not change
+        if (_paletteVersions[i] == bone->_worldVersion)
+            continue;
+        _paletteVersions[i] = bone->_worldVersion;
+        
+        Mat4::multiply(world, _invBindPoses[i], &t);
+        Vec4* palette = _matrixPalette + i * PALETTE_ROWS;
+        palette[0].set(t.m[0], t.m[4], t.m[8], t.m[12]);
+        palette[1].set(t.m[1], t.m[5], t.m[9], t.m[13]);
+        palette[2].set(t.m[2], t.m[6], t.m[10], t.m[14]);
     }
     
     return _matrixPalette;
@@ -126,6 +134,7 @@ ssize_t MeshSkin::getMatrixPaletteSize() const
 void MeshSkin::removeAllBones()
 {
     _skinBones.clear();
+    _paletteVersions.clear();
     CC_SAFE_DELETE_ARRAY(_matrixPalette);
     CC_SAFE_RELEASE(_rootBone);
 }
@@ -133,6 +142,9 @@ void MeshSkin::removeAllBones()
 void MeshSkin::addSkinBone(Bone3D* bone)
 {
     _skinBones.pushBack(bone);
+    // force the palette to be reallocated and fully rebuilt
+    _paletteVersions.clear();
+    CC_SAFE_DELETE_ARRAY(_matrixPalette);
 }
 
 Bone3D* MeshSkin::getRootBone() const
@@ -105,6 +105,9 @@ protected:
     // Each 4x3 row-wise matrix is represented as 3 Vec4's.
     // The number of Vec4's is (_skinBones.size() * 3).
     Vec4* _matrixPalette;
+    
+    // Bone3D::_worldVersion of each skin bone when its palette entry was last written
+    std::vector<unsigned int> _paletteVersions;
 };
 
 // end of 3d group
@@ -0,0 +1,479 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "3d/CCSceneBVH.h"
+
+#include <float.h>
+#include <string.h>
+#include "2d/CCCamera.h"
+#include "3d/CCSprite3D.h"
+#include "base/CCDirector.h"
+
+NS_CC_BEGIN
+
+static float surfaceArea(const AABB& aabb)
+{
+    float x = std::max(aabb._max.x - aabb._min.x, 0.0f);
+    float y = std::max(aabb._max.y - aabb._min.y, 0.0f);
+    float z = std::max(aabb._max.z - aabb._min.z, 0.0f);
+    return 2.0f * (x * y + y * z + z * x);
+}
+
+static AABB combine(const AABB& a, const AABB& b)
+{
+    AABB result(a);
+    result.merge(b);
+    return result;
+}
+
+static bool contains(const AABB& outer, const AABB& inner)
+{
+    return outer._min.x <= inner._min.x && outer._min.y <= inner._min.y && outer._min.z <= inner._min.z
+        && inner._max.x <= outer._max.x && inner._max.y <= outer._max.y && inner._max.z <= outer._max.z;
+}
+
+SceneBVH::SceneBVH()
+: _root(NULL_PROXY)
+, _freeList(NULL_PROXY)
+, _proxyCount(0)
+, _margin(0.1f)
+, _queryCamera(nullptr)
+, _queryFrame(0)
+, _queryStamp(0)
+{
+    resetStats();
+}
+
+SceneBVH::~SceneBVH()
+{
+    removeAllProxies();
+}
+
+void SceneBVH::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+int SceneBVH::allocateNode()
+{
+    if (_freeList == NULL_PROXY)
+    {
+        _nodes.emplace_back();
+        _nodes.back().parent = NULL_PROXY;
+        _nodes.back().height = -1;
+        _freeList = (int)_nodes.size() - 1;
+    }
+
+    int nodeId = _freeList;
+    TreeNode& node = _nodes[nodeId];
+    _freeList = node.parent;
+    node.sprite = nullptr;
+    node.parent = NULL_PROXY;
+    node.child1 = NULL_PROXY;
+    node.child2 = NULL_PROXY;
+    node.height = 0;
+    node.visibleStamp = 0;
+    node.movedStamp = 0;
+    return nodeId;
+}
+
+void SceneBVH::freeNode(int nodeId)
+{
+    TreeNode& node = _nodes[nodeId];
+    node.sprite = nullptr;
+    node.parent = _freeList;
+    node.height = -1;
+    _freeList = nodeId;
+}
+
+void SceneBVH::fattenAABB(const AABB& aabb, AABB& fatAABB) const
+{
+    if (aabb.isEmpty())
+    {
+        fatAABB = aabb;
+        return;
+    }
+    Vec3 extent = (aabb._max - aabb._min) * _margin;
+    fatAABB.set(aabb._min - extent, aabb._max + extent);
+}
+
+int SceneBVH::addProxy(Sprite3D* sprite, const AABB& aabb)
+{
+    int proxyId = allocateNode();
+    TreeNode& node = _nodes[proxyId];
+    node.sprite = sprite;
+    node.aabb = aabb;
+    node.movedStamp = _queryStamp;
+    fattenAABB(aabb, node.fatAABB);
+    insertLeaf(proxyId);
+    ++_proxyCount;
+    return proxyId;
+}
+
+void SceneBVH::removeProxy(int proxyId)
+{
+    CCASSERT(proxyId >= 0 && proxyId < (int)_nodes.size() && _nodes[proxyId].isLeaf(), "invalid proxy");
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --_proxyCount;
+}
+
+void SceneBVH::moveProxy(int proxyId, const AABB& aabb)
+{
+    CCASSERT(proxyId >= 0 && proxyId < (int)_nodes.size() && _nodes[proxyId].isLeaf(), "invalid proxy");
+    TreeNode& node = _nodes[proxyId];
+    node.aabb = aabb;
+    // the result of the current query may be stale for this proxy
+    node.movedStamp = _queryStamp;
+    if (contains(node.fatAABB, aabb))
+        return;
+
+    removeLeaf(proxyId);
+    fattenAABB(aabb, _nodes[proxyId].fatAABB);
+    insertLeaf(proxyId);
+    ++_stats.reinserts;
+}
+
+void SceneBVH::removeAllProxies()
+{
+    for (auto& node : _nodes)
+    {
+        if (node.height == 0 && node.sprite)
+        {
+            node.sprite->_bvh = nullptr;
+            node.sprite->_bvhProxy = NULL_PROXY;
+        }
+    }
+    _nodes.clear();
+    _root = NULL_PROXY;
+    _freeList = NULL_PROXY;
+    _proxyCount = 0;
+    _queryCamera = nullptr;
+}
+
+void SceneBVH::addSprites(Node* node)
+{
+    auto sprite = dynamic_cast<Sprite3D*>(node);
+    if (sprite && sprite->isRunning() && !sprite->_bvh)
+    {
+        sprite->_bvh = this;
+        sprite->_bvhProxy = addProxy(sprite, sprite->getAABB());
+    }
+
+    for (auto child : node->getChildren())
+    {
+        addSprites(child);
+    }
+}
+
+void SceneBVH::insertLeaf(int leaf)
+{
+    if (_root == NULL_PROXY)
+    {
+        _root = leaf;
+        _nodes[leaf].parent = NULL_PROXY;
+        return;
+    }
+
+    // find the best sibling by the surface area heuristic
+    AABB leafAABB = _nodes[leaf].fatAABB;
+    int index = _root;
+    while (!_nodes[index].isLeaf())
+    {
+        const TreeNode& node = _nodes[index];
+        float area = surfaceArea(node.fatAABB);
+        float combinedArea = surfaceArea(combine(node.fatAABB, leafAABB));
+
+        // cost of creating a new parent for this node and the new leaf
+        float cost = 2.0f * combinedArea;
+        // minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCost[2];
+        int children[2] = { node.child1, node.child2 };
+        for (int i = 0; i < 2; ++i)
+        {
+            const TreeNode& child = _nodes[children[i]];
+            float newArea = surfaceArea(combine(child.fatAABB, leafAABB));
+            childCost[i] = child.isLeaf() ? newArea + inheritanceCost : newArea - surfaceArea(child.fatAABB) + inheritanceCost;
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+
+        index = childCost[0] < childCost[1] ? children[0] : children[1];
+    }
+
+    int sibling = index;
+    int oldParent = _nodes[sibling].parent;
+    int newParent = allocateNode();
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].fatAABB = combine(leafAABB, _nodes[sibling].fatAABB);
+    _nodes[newParent].height = _nodes[sibling].height + 1;
+    _nodes[newParent].child1 = sibling;
+    _nodes[newParent].child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent != NULL_PROXY)
+    {
+        if (_nodes[oldParent].child1 == sibling)
+            _nodes[oldParent].child1 = newParent;
+        else
+            _nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        _root = newParent;
+    }
+
+    // walk back up, refitting and balancing
+    index = _nodes[leaf].parent;
+    while (index != NULL_PROXY)
+    {
+        index = balance(index);
+        TreeNode& node = _nodes[index];
+        node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+        node.fatAABB = combine(_nodes[node.child1].fatAABB, _nodes[node.child2].fatAABB);
+        index = node.parent;
+    }
+}
+
+void SceneBVH::removeLeaf(int leaf)
+{
+    if (leaf == _root)
+    {
+        _root = NULL_PROXY;
+        return;
+    }
+
+    int parent = _nodes[leaf].parent;
+    int grandParent = _nodes[parent].parent;
+    int sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    if (grandParent != NULL_PROXY)
+    {
+        // replace the parent by the sibling
+        if (_nodes[grandParent].child1 == parent)
+            _nodes[grandParent].child1 = sibling;
+        else
+            _nodes[grandParent].child2 = sibling;
+        _nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        int index = grandParent;
+        while (index != NULL_PROXY)
+        {
+            index = balance(index);
+            TreeNode& node = _nodes[index];
+            node.fatAABB = combine(_nodes[node.child1].fatAABB, _nodes[node.child2].fatAABB);
+            node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+            index = node.parent;
+        }
+    }
+    else
+    {
+        _root = sibling;
+        _nodes[sibling].parent = NULL_PROXY;
+        freeNode(parent);
+    }
+    _nodes[leaf].parent = NULL_PROXY;
+}
+
+// rotate the taller grand child up if the subtrees of nodeId are unbalanced, returns the new root of the subtree
+int SceneBVH::balance(int iA)
+{
+    TreeNode* A = &_nodes[iA];
+    if (A->isLeaf() || A->height < 2)
+        return iA;
+
+    int iB = A->child1;
+    int iC = A->child2;
+    TreeNode* B = &_nodes[iB];
+    TreeNode* C = &_nodes[iC];
+    int diff = C->height - B->height;
+
+    // rotate C up, or B up by swapping the roles of B and C
+    if (diff > 1 || diff < -1)
+    {
+        bool rotateC = diff > 1;
+        int iUp = rotateC ? iC : iB;
+        int iOther = rotateC ? iB : iC;
+        TreeNode* up = &_nodes[iUp];
+        TreeNode* other = &_nodes[iOther];
+
+        int iF = up->child1;
+        int iG = up->child2;
+        TreeNode* F = &_nodes[iF];
+        TreeNode* G = &_nodes[iG];
+
+        // A becomes a child of up
+        up->child1 = iA;
+        up->parent = A->parent;
+        A->parent = iUp;
+
+        if (up->parent != NULL_PROXY)
+        {
+            if (_nodes[up->parent].child1 == iA)
+                _nodes[up->parent].child1 = iUp;
+            else
+                _nodes[up->parent].child2 = iUp;
+        }
+        else
+        {
+            _root = iUp;
+        }
+
+        // the taller grand child stays under up, the other one replaces up under A
+        int iKeep = F->height > G->height ? iF : iG;
+        int iMove = F->height > G->height ? iG : iF;
+        up->child2 = iKeep;
+        if (rotateC)
+            A->child2 = iMove;
+        else
+            A->child1 = iMove;
+        _nodes[iMove].parent = iA;
+
+        A->fatAABB = combine(other->fatAABB, _nodes[iMove].fatAABB);
+        up->fatAABB = combine(A->fatAABB, _nodes[iKeep].fatAABB);
+        A->height = 1 + std::max(other->height, _nodes[iMove].height);
+        up->height = 1 + std::max(A->height, _nodes[iKeep].height);
+        return iUp;
+    }
+    return iA;
+}
+
+int SceneBVH::getHeight() const
+{
+    return _root == NULL_PROXY ? 0 : _nodes[_root].height;
+}
+
+void SceneBVH::runFrustumQuery(const Camera* camera)
+{
+    ++_queryStamp;
+    if (_root == NULL_PROXY)
+        return;
+
+    unsigned int visible = 0;
+    _stack.clear();
+    _stack.push_back(_root);
+    while (!_stack.empty())
+    {
+        int index = _stack.back();
+        _stack.pop_back();
+        TreeNode& node = _nodes[index];
+
+        ++_stats.nodesTested;
+        if (!camera->isVisibleInFrustum(&node.fatAABB))
+            continue;
+
+        if (node.isLeaf())
+        {
+            node.visibleStamp = _queryStamp;
+            ++visible;
+        }
+        else
+        {
+            _stack.push_back(node.child1);
+            _stack.push_back(node.child2);
+        }
+    }
+    _stats.proxiesVisible += visible;
+    _stats.proxiesCulled += _proxyCount - visible;
+}
+
+bool SceneBVH::isVisible(int proxyId, const Camera* camera)
+{
+    unsigned int frame = Director::getInstance()->getTotalFrames();
+    const Mat4& viewProjection = camera->getViewProjectionMatrix();
+    if (camera != _queryCamera || frame != _queryFrame
+        || memcmp(viewProjection.m, _queryViewProjection.m, sizeof(viewProjection.m)) != 0)
+    {
+        runFrustumQuery(camera);
+        _queryCamera = camera;
+        _queryFrame = frame;
+        _queryViewProjection = viewProjection;
+    }
+
+    const TreeNode& node = _nodes[proxyId];
+    if (node.movedStamp == _queryStamp)
+    {
+        ++_stats.fallbackTests;
+        return camera->isVisibleInFrustum(&node.aabb);
+    }
+    return node.visibleStamp == _queryStamp;
+}
+
+void SceneBVH::queryFrustum(const Camera* camera, std::vector<Sprite3D*>& sprites)
+{
+    runFrustumQuery(camera);
+    _queryCamera = camera;
+    _queryFrame = Director::getInstance()->getTotalFrames();
+    _queryViewProjection = camera->getViewProjectionMatrix();
+
+    for (const auto& node : _nodes)
+    {
+        if (node.height == 0 && node.visibleStamp == _queryStamp)
+            sprites.push_back(node.sprite);
+    }
+}
+
+Sprite3D* SceneBVH::rayCast(const Ray& ray, float* distance) const
+{
+    if (_root == NULL_PROXY)
+        return nullptr;
+
+    Sprite3D* closest = nullptr;
+    float closestDistance = FLT_MAX;
+    std::vector<int> stack;
+    stack.push_back(_root);
+    while (!stack.empty())
+    {
+        int index = stack.back();
+        stack.pop_back();
+        const TreeNode& node = _nodes[index];
+
+        // Ray::intersects leaves the distance untouched when the origin is inside the box
+        float dist = 0.0f;
+        if (!ray.intersects(node.isLeaf() ? node.aabb : node.fatAABB, &dist) || dist >= closestDistance)
+            continue;
+
+        if (node.isLeaf())
+        {
+            closest = node.sprite;
+            closestDistance = dist;
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+
+    if (closest && distance)
+        *distance = closestDistance;
+    return closest;
+}
+
+NS_CC_END
@@ -0,0 +1,161 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_SCENE_BVH_H__
+#define __CC_SCENE_BVH_H__
+
+#include <vector>
+#include "3d/CCAABB.h"
+#include "3d/CCRay.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _3d
+ * @{
+ */
+
+class Camera;
+class Node;
+class Sprite3D;
+
+/**
+ * @brief SceneBVH is a dynamic bounding volume hierarchy over the Sprite3D nodes of a scene.
+ *
+ * Every sprite is a leaf holding its world space AABB enlarged by a margin, so a sprite moving
+ * inside that fat AABB does not change the tree. Camera culling walks the tree once per camera
+ * and frame and rejects a whole branch with one frustum test, ray picking skips branches the ray misses.
+ * Use Scene::setBVHEnabled() to build one for a scene, sprites then register themselves on enter.
+ */
+class CC_DLL SceneBVH
+{
+public:
+    enum { NULL_PROXY = -1 };
+
+    /** counters accumulated until resetStats() */
+    struct Stats
+    {
+        unsigned int nodesTested;   // tree nodes tested against a camera frustum
+        unsigned int proxiesVisible;// sprites found visible by the culling queries
+        unsigned int proxiesCulled; // sprites rejected by the culling queries
+        unsigned int fallbackTests; // sprites moved after the query of their camera, tested one by one
+        unsigned int reinserts;     // sprites which left their fat AABB and were re-inserted
+    };
+
+    SceneBVH();
+    ~SceneBVH();
+
+    /**
+     * Add a sprite with its world space AABB.
+     * @return the proxy id, which stays valid until removeProxy is called.
+     */
+    int addProxy(Sprite3D* sprite, const AABB& aabb);
+
+    /** remove a proxy added by addProxy */
+    void removeProxy(int proxyId);
+
+    /** set the new world space AABB of a proxy, the tree is only changed if it is not inside the fat AABB anymore */
+    void moveProxy(int proxyId, const AABB& aabb);
+
+    /** remove all proxies, the sprites are detached from the tree */
+    void removeAllProxies();
+
+    /** add the running Sprite3D nodes of a node tree which are not in a tree yet */
+    void addSprites(Node* node);
+
+    /**
+     * Whether a proxy is in the frustum of the camera.
+     * The tree is queried on the first call for each camera and frame, later calls only read the result.
+     */
+    bool isVisible(int proxyId, const Camera* camera);
+
+    /** get all the sprites in the frustum of the camera */
+    void queryFrustum(const Camera* camera, std::vector<Sprite3D*>& sprites);
+
+    /**
+     * Get the closest sprite whose AABB is hit by the ray.
+     * @param ray the ray in world space
+     * @param distance receives the distance from the ray origin to the AABB of the sprite, can be nullptr.
+     * @return the sprite, nullptr if nothing is hit.
+     */
+    Sprite3D* rayCast(const Ray& ray, float* distance = nullptr) const;
+
+    /** get the number of proxies */
+    int getProxyCount() const { return _proxyCount; }
+
+    /** get the height of the tree, 0 for a single leaf */
+    int getHeight() const;
+
+    /** set how much the AABBs are enlarged, relative to their size, default 0.1 */
+    void setMargin(float margin) { _margin = margin; }
+    float getMargin() const { return _margin; }
+
+    const Stats& getStats() const { return _stats; }
+    void resetStats();
+
+protected:
+    struct TreeNode
+    {
+        AABB fatAABB;
+        AABB aabb;              // tight AABB, leaves only
+        Sprite3D* sprite;       // leaves only
+        int parent;             // next free node when the node is in the free list
+        int child1;
+        int child2;
+        int height;             // 0 for leaves, -1 for free nodes
+        unsigned int visibleStamp;
+        unsigned int movedStamp;
+
+        bool isLeaf() const { return child1 == NULL_PROXY; }
+    };
+
+    int allocateNode();
+    void freeNode(int nodeId);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int nodeId);
+    void fattenAABB(const AABB& aabb, AABB& fatAABB) const;
+    void runFrustumQuery(const Camera* camera);
+
+    std::vector<TreeNode> _nodes;
+    int _root;
+    int _freeList;
+    int _proxyCount;
+    float _margin;
+
+    const Camera* _queryCamera;
+    unsigned int _queryFrame;
+    Mat4 _queryViewProjection; // a camera rendered twice in a frame may have moved in between
+    unsigned int _queryStamp;
+
+    std::vector<int> _stack;
+    Stats _stats;
+};
+
+// end of 3d group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_SCENE_BVH_H__
@@ -24,6 +24,7 @@
  ****************************************************************************/
 
 #include "3d/CCSkeleton3D.h"
+#include "xxhash.h"
 
 
 NS_CC_BEGIN
@@ -79,12 +80,19 @@ const Mat4& Bone3D::getWorldMat()
     if (_worldDirty)
     {
         updateLocalMat();
+        Mat4 world;
         if (_parent)
         {
-            _world = _parent->getWorldMat() * _local;
+            Mat4::multiply(_parent->getWorldMat(), _local, &world);
         }
         else
-            _world = _local;
+            world = _local;
+        
+        if (memcmp(world.m, _world.m, sizeof(world.m)) != 0)
+        {
+            _world = world;
+            ++_worldVersion;
+        }
         
         _worldDirty = false;
     }
@@ -185,6 +193,7 @@ Bone3D::Bone3D(const std::string& id)
 : _name(id)
 , _parent(nullptr)
 , _worldDirty(true)
+, _worldVersion(1)
 {
     
 }
@@ -236,9 +245,37 @@ void Bone3D::updateLocalMat()
             }
         }
         
-        Mat4::createTranslation(translate, &_local);
-        _local.rotate(quat);
-        _local.scale(scale);
+        // compose translate * rotate * scale directly instead of two full matrix multiplies
+        float x2 = quat.x + quat.x;
+        float y2 = quat.y + quat.y;
+        float z2 = quat.z + quat.z;
+        float xx2 = quat.x * x2;
+        float yy2 = quat.y * y2;
+        float zz2 = quat.z * z2;
+        float xy2 = quat.x * y2;
+        float xz2 = quat.x * z2;
+        float yz2 = quat.y * z2;
+        float wx2 = quat.w * x2;
+        float wy2 = quat.w * y2;
+        float wz2 = quat.w * z2;
+        
+        float* m = _local.m;
+        m[0] = (1.0f - yy2 - zz2) * scale.x;
+        m[1] = (xy2 + wz2) * scale.x;
+        m[2] = (xz2 - wy2) * scale.x;
+        m[3] = 0.0f;
+        m[4] = (xy2 - wz2) * scale.y;
+        m[5] = (1.0f - xx2 - zz2) * scale.y;
+        m[6] = (yz2 + wx2) * scale.y;
+        m[7] = 0.0f;
+        m[8] = (xz2 + wy2) * scale.z;
+        m[9] = (yz2 - wx2) * scale.z;
+        m[10] = (1.0f - xx2 - yy2) * scale.z;
+        m[11] = 0.0f;
+        m[12] = translate.x;
+        m[13] = translate.y;
+        m[14] = translate.z;
+        m[15] = 1.0f;
         
         _blendStates.clear();
     }
@@ -247,6 +284,9 @@ void Bone3D::updateLocalMat()
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 Skeleton3D::Skeleton3D()
+: _sortedBonesDirty(true)
+, _structureHash(0)
+, _poseApplied(false)
 {
     
 }
@@ -315,21 +355,103 @@ int Skeleton3D::getBoneIndex(Bone3D* bone) const
 //refresh bone world matrix
 void Skeleton3D::updateBoneMatrix()
 {
+    if (_sortedBonesDirty)
+        sortBones();
+    
+    if (_poseApplied)
+    {
+        _poseApplied = false;
+        return;
+    }
+    
+    // parents come first, so each bone only recomputes itself and reads an up-to-date parent
+    for (auto bone : _sortedBones) {
+        bone->_worldDirty = true;
+        bone->getWorldMat();
+    }
+}
+
+void Skeleton3D::sortBones()
+{
+    _sortedBones.clear();
+    _sortedBones.reserve(_bones.size());
     for (const auto& it : _rootBones) {
-        it->setWorldMatDirty(true);
-        it->updateWorldMat();
+        _sortedBones.push_back(it);
+    }
+    for (size_t i = 0; i < _sortedBones.size(); ++i) {
+        for (const auto& child : _sortedBones[i]->_children) {
+            _sortedBones.push_back(child);
+        }
+    }
+    
+    unsigned int hash = 0;
+    for (size_t i = 0; i < _sortedBones.size(); ++i) {
+        auto bone = _sortedBones[i];
+        int parent = -1;
+        if (bone->_parent)
+            parent = static_cast<int>(std::find(_sortedBones.begin(), _sortedBones.begin() + i, bone->_parent) - _sortedBones.begin());
+        hash = XXH32(bone->_name.c_str(), bone->_name.size(), hash);
+        hash = XXH32(&parent, sizeof(parent), hash);
+        hash = XXH32(bone->_oriPose.m, sizeof(bone->_oriPose.m), hash);
+    }
+    _structureHash = hash;
+    _sortedBonesDirty = false;
+}
+
+unsigned int Skeleton3D::getStructureHash()
+{
+    if (_sortedBonesDirty)
+        sortBones();
+    
+    return _structureHash;
+}
+
+void Skeleton3D::capturePose(std::vector<Mat4>& locals, std::vector<Mat4>& worlds)
+{
+    if (_sortedBonesDirty)
+        sortBones();
+    
+    locals.resize(_sortedBones.size());
+    worlds.resize(_sortedBones.size());
+    for (size_t i = 0; i < _sortedBones.size(); ++i) {
+        auto bone = _sortedBones[i];
+        locals[i] = bone->_local;
+        worlds[i] = bone->getWorldMat();
+    }
+}
+
+void Skeleton3D::applyPose(const std::vector<Mat4>& locals, const std::vector<Mat4>& worlds)
+{
+    if (_sortedBonesDirty)
+        sortBones();
+    
+    CCASSERT(locals.size() == _sortedBones.size() && worlds.size() == _sortedBones.size(), "pose does not match the skeleton");
+    for (size_t i = 0; i < _sortedBones.size(); ++i) {
+        auto bone = _sortedBones[i];
+        bone->_blendStates.clear();
+        bone->_local = locals[i];
+        if (memcmp(worlds[i].m, bone->_world.m, sizeof(bone->_world.m)) != 0)
+        {
+            bone->_world = worlds[i];
+            ++bone->_worldVersion;
+        }
+        bone->_worldDirty = false;
     }
+    _poseApplied = true;
 }
 
 void Skeleton3D::removeAllBones()
 {
     _bones.clear();
     _rootBones.clear();
+    _sortedBones.clear();
+    _sortedBonesDirty = true;
 }
 
 void Skeleton3D::addBone(Bone3D* bone)
 {
     _bones.pushBack(bone);
+    _sortedBonesDirty = true;
 }
 
 Bone3D* Skeleton3D::createBone3D(const NodeData& nodedata)
@@ -341,6 +463,7 @@ Bone3D* Skeleton3D::createBone3D(const NodeData& nodedata)
         child->_parent = bone;
     }
     _bones.pushBack(bone);
+    _sortedBonesDirty = true;
     bone->_oriPose = nodedata.transform;
     return bone;
 }
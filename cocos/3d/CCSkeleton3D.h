@@ -176,6 +176,7 @@ protected:
     Vector<Bone3D*> _children;
     
     bool          _worldDirty;
+    unsigned int  _worldVersion; // bumped whenever _world changes, lets MeshSkin skip unchanged palette entries
     Mat4          _world;
     Mat4          _local;
     
@@ -212,6 +213,24 @@ public:
     /**refresh bone world matrix*/
     void updateBoneMatrix();
     
+    /**
+     * get a hash of the bone names, hierarchy and original poses.
+     * Skeletons created from the same data share the same hash, so their poses are interchangeable.
+     */
+    unsigned int getStructureHash();
+    
+    /**copy every bone's local and world matrix, parents first*/
+    void capturePose(std::vector<Mat4>& locals, std::vector<Mat4>& worlds);
+    
+    /**
+     * overwrite every bone with matrices returned by capturePose of a skeleton with the same structure hash.
+     * The next updateBoneMatrix keeps them instead of recomputing.
+     */
+    void applyPose(const std::vector<Mat4>& locals, const std::vector<Mat4>& worlds);
+    
+    /**forget a pose set by applyPose, so that the next updateBoneMatrix recomputes every bone*/
+    void discardAppliedPose() { _poseApplied = false; }
+    
 CC_CONSTRUCTOR_ACCESS:
     
     Skeleton3D();
@@ -227,11 +246,19 @@ CC_CONSTRUCTOR_ACCESS:
     /** create Bone3D from NodeData */
     Bone3D* createBone3D(const NodeData& nodedata);
     
+    /** rebuild the parent-before-child bone order used by updateBoneMatrix */
+    void sortBones();
+    
 protected:
     
     Vector<Bone3D*> _bones; // bones
 
     Vector<Bone3D*> _rootBones;
+    
+    std::vector<Bone3D*> _sortedBones; // weak ref, root bones and their descendants, parents first
+    bool _sortedBonesDirty;
+    unsigned int _structureHash; // computed together with _sortedBones
+    bool _poseApplied; // world matrices were set by applyPose, skip the next updateBoneMatrix
 };
 
 // end of 3d group
@@ -30,12 +30,15 @@
 #include "3d/CCSprite3DMaterial.h"
 #include "3d/CCAttachNode.h"
 #include "3d/CCMesh.h"
+#include "3d/CCSceneBVH.h"
 
 #include "base/CCDirector.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCScheduler.h"
 #include "base/ccUTF8.h"
 #include "2d/CCLight.h"
 #include "2d/CCCamera.h"
+#include "2d/CCScene.h"
 #include "base/ccMacros.h"
 #include "platform/CCPlatformMacros.h"
 #include "platform/CCFileUtils.h"
@@ -47,8 +50,14 @@
 #include "renderer/CCTechnique.h"
 #include "renderer/CCPass.h"
 
+#include <chrono>
+#include <memory>
+
 NS_CC_BEGIN
 
+std::deque<Sprite3D*> Sprite3D::s_asyncFinishQueue;
+float Sprite3D::s_asyncLoadBudget = 0.004f;
+
 static Sprite3DMaterial* getSprite3DMaterialForAttribs(MeshVertexData* meshVertexData, bool usesLight);
 
 Sprite3D* Sprite3D::create()
@@ -110,68 +119,197 @@ void Sprite3D::createAsync(const std::string& modelPath, const std::string& text
     sprite->_asyncLoadParam.texPath = texturePath;
     sprite->_asyncLoadParam.modelPath = modelPath;
     sprite->_asyncLoadParam.callbackParam = callbackparam;
+    sprite->_asyncLoadParam.result = false;
+    sprite->_asyncLoadParam.meshdatas = nullptr;
+    sprite->_asyncLoadParam.materialdatas = nullptr;
+    sprite->_asyncLoadParam.nodeDatas = nullptr;
+    sprite->_asyncLoadParam.pendingTextures = 0;
+    
+    // the same file is already being parsed, finish together with that load
+    if (!Sprite3DCache::getInstance()->beginAsyncLoad(modelPath, sprite))
+        return;
+    
     sprite->_asyncLoadParam.materialdatas = new (std::nothrow) MaterialDatas();
     sprite->_asyncLoadParam.meshdatas = new (std::nothrow) MeshDatas();
     sprite->_asyncLoadParam.nodeDatas = new (std::nothrow) NodeDatas();
     AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, CC_CALLBACK_1(Sprite3D::afterAsyncLoad, sprite), (void*)(&sprite->_asyncLoadParam), [sprite]()
     {
-        sprite->_asyncLoadParam.result = sprite->loadFromFile(sprite->_asyncLoadParam.modelPath, sprite->_asyncLoadParam.nodeDatas, sprite->_asyncLoadParam.meshdatas, sprite->_asyncLoadParam.materialdatas);
+        auto& param = sprite->_asyncLoadParam;
+        param.result = sprite->loadFromFile(param.modelPath, param.nodeDatas, param.meshdatas, param.materialdatas);
+        if (param.result)
+        {
+            // do the vertex work MeshVertexData::create would otherwise do on the main thread
+            // mapped meshes always come with their AABBs, only copied data may need them calculated
+            for (auto meshdata : param.meshdatas->meshDatas)
+            {
+                if (meshdata->mappedBuffer || meshdata->subMeshAABB.size() == meshdata->getSubMeshCount())
+                    continue;
+                meshdata->subMeshAABB.clear();
+                for (const auto& indices : meshdata->subMeshIndices)
+                    meshdata->subMeshAABB.push_back(Bundle3D::calculateAABB(meshdata->vertex, meshdata->getPerVertexSize(), indices));
+            }
+        }
     });
-    
 }
 
 void Sprite3D::afterAsyncLoad(void* param)
 {
     Sprite3D::AsyncLoadParam* asyncParam = (Sprite3D::AsyncLoadParam*)param;
+    if (asyncParam == nullptr || !asyncParam->result)
+    {
+        scheduleAsyncFinish(this);
+        return;
+    }
+    
+    // decode the textures on the texture cache thread, createNode then finds them in the cache
+    std::vector<std::string> textures;
+    for (const auto& material : asyncParam->materialdatas->materials)
+    {
+        for (const auto& texture : material.textures)
+        {
+            if (!texture.filename.empty())
+                textures.push_back(texture.filename);
+        }
+    }
+    if (!asyncParam->texPath.empty())
+        textures.push_back(asyncParam->texPath);
+    
+    // Each request counts down once: when its texture arrives, or when TextureCache::unbindImageAsync
+    // or unbindAllImageAsync drops its callback unused. Then the load finishes without that texture
+    // instead of waiting forever, and createNode loads it synchronously if it's still needed.
+    struct TextureRequest
+    {
+        explicit TextureRequest(Sprite3D* sprite) : sprite(sprite), completed(false) {}
+        ~TextureRequest() { complete(); }
+
+        void complete()
+        {
+            if (completed)
+                return;
+            completed = true;
+            if (--sprite->_asyncLoadParam.pendingTextures == 0)
+                scheduleAsyncFinish(sprite);
+        }
+
+        Sprite3D* sprite;
+        bool completed;
+    };
+
+    // one extra count so that textures already in the cache can not finish the load while still queuing
+    asyncParam->pendingTextures = (int)textures.size() + 1;
+    auto textureCache = Director::getInstance()->getTextureCache();
+    for (const auto& texture : textures)
+    {
+        auto request = std::make_shared<TextureRequest>(this);
+        textureCache->addImageAsync(texture, [request](Texture2D*) {
+            request->complete();
+        });
+    }
+    if (--asyncParam->pendingTextures == 0)
+        scheduleAsyncFinish(this);
+}
+
+void Sprite3D::finishAsyncLoad()
+{
+    auto asyncParam = &_asyncLoadParam;
     autorelease();
-    if (asyncParam)
+    
+    if (asyncParam->meshdatas == nullptr)
     {
-        if (asyncParam->result)
+        // waited for another sprite loading the same file
+        if (loadFromCache(asyncParam->modelPath))
         {
-            _meshes.clear();
-            _meshVertexDatas.clear();
-            CC_SAFE_RELEASE_NULL(_skeleton);
-            removeAllAttachNode();
-            
-            //create in the main thread
-            auto& meshdatas = asyncParam->meshdatas;
-            auto& materialdatas = asyncParam->materialdatas;
-            auto&   nodeDatas = asyncParam->nodeDatas;
-            if (initFrom(*nodeDatas, *meshdatas, *materialdatas))
-            {
-                auto spritedata = Sprite3DCache::getInstance()->getSpriteData(asyncParam->modelPath);
-                if (spritedata == nullptr)
-                {
-                    //add to cache
-                    auto data = new (std::nothrow) Sprite3DCache::Sprite3DData();
-                    data->materialdatas = materialdatas;
-                    data->nodedatas = nodeDatas;
-                    data->meshVertexDatas = _meshVertexDatas;
-                    for (const auto mesh : _meshes) {
-                        data->glProgramStates.pushBack(mesh->getGLProgramState());
-                    }
-                    
-                    Sprite3DCache::getInstance()->addSprite3DData(asyncParam->modelPath, data);
-                    
-                    CC_SAFE_DELETE(meshdatas);
-                    materialdatas = nullptr;
-                    nodeDatas = nullptr;
-                }
-            }
-            CC_SAFE_DELETE(meshdatas);
-            CC_SAFE_DELETE(materialdatas);
-            CC_SAFE_DELETE(nodeDatas);
-            
             if (!asyncParam->texPath.empty())
-            {
                 setTexture(asyncParam->texPath);
-            }
         }
         else
         {
             CCLOG("file load failed: %s ", asyncParam->modelPath.c_str());
         }
         asyncParam->afterLoadCallback(this, asyncParam->callbackParam);
+        return;
+    }
+    
+    if (asyncParam->result)
+    {
+        _meshes.clear();
+        _meshVertexDatas.clear();
+        CC_SAFE_RELEASE_NULL(_skeleton);
+        removeAllAttachNode();
+        
+        //create in the main thread
+        auto& meshdatas = asyncParam->meshdatas;
+        auto& materialdatas = asyncParam->materialdatas;
+        auto&   nodeDatas = asyncParam->nodeDatas;
+        if (initFrom(*nodeDatas, *meshdatas, *materialdatas))
+        {
+            auto spritedata = Sprite3DCache::getInstance()->getSpriteData(asyncParam->modelPath);
+            if (spritedata == nullptr)
+            {
+                //add to cache
+                auto data = new (std::nothrow) Sprite3DCache::Sprite3DData();
+                data->materialdatas = materialdatas;
+                data->nodedatas = nodeDatas;
+                data->meshVertexDatas = _meshVertexDatas;
+                for (const auto mesh : _meshes) {
+                    data->glProgramStates.pushBack(mesh->getGLProgramState());
+                }
+                
+                Sprite3DCache::getInstance()->addSprite3DData(asyncParam->modelPath, data);
+                
+                CC_SAFE_DELETE(meshdatas);
+                materialdatas = nullptr;
+                nodeDatas = nullptr;
+            }
+        }
+        CC_SAFE_DELETE(meshdatas);
+        CC_SAFE_DELETE(materialdatas);
+        CC_SAFE_DELETE(nodeDatas);
+        
+        if (!asyncParam->texPath.empty())
+        {
+            setTexture(asyncParam->texPath);
+        }
+    }
+    else
+    {
+        CCLOG("file load failed: %s ", asyncParam->modelPath.c_str());
+        CC_SAFE_DELETE(asyncParam->meshdatas);
+        CC_SAFE_DELETE(asyncParam->materialdatas);
+        CC_SAFE_DELETE(asyncParam->nodeDatas);
+    }
+    
+    // sprites waiting for this file can now be created from the cache
+    auto waiting = Sprite3DCache::getInstance()->endAsyncLoad(asyncParam->modelPath);
+    for (auto sprite : waiting)
+        scheduleAsyncFinish(sprite);
+    
+    asyncParam->afterLoadCallback(this, asyncParam->callbackParam);
+}
+
+void Sprite3D::scheduleAsyncFinish(Sprite3D* sprite)
+{
+    if (s_asyncFinishQueue.empty())
+    {
+        Director::getInstance()->getScheduler()->schedule(&Sprite3D::processAsyncFinishQueue, &s_asyncFinishQueue, 0, false, "Sprite3DAsyncFinish");
+    }
+    s_asyncFinishQueue.push_back(sprite);
+}
+
+void Sprite3D::processAsyncFinishQueue(float /*dt*/)
+{
+    auto begin = std::chrono::steady_clock::now();
+    do
+    {
+        auto sprite = s_asyncFinishQueue.front();
+        s_asyncFinishQueue.pop_front();
+        sprite->finishAsyncLoad();
+    } while (!s_asyncFinishQueue.empty()
+             && std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count() < s_asyncLoadBudget);
+    
+    if (s_asyncFinishQueue.empty())
+    {
+        Director::getInstance()->getScheduler()->unschedule("Sprite3DAsyncFinish", &s_asyncFinishQueue);
     }
 }
 
@@ -264,11 +402,15 @@ Sprite3D::Sprite3D()
 , _shaderUsingLight(false)
 , _forceDepthWrite(false)
 , _usingAutogeneratedGLProgram(true)
+, _bvh(nullptr)
+, _bvhProxy(SceneBVH::NULL_PROXY)
 {
 }
 
 Sprite3D::~Sprite3D()
 {
+    if (_bvh)
+        _bvh->removeProxy(_bvhProxy);
     _meshes.clear();
     _meshVertexDatas.clear();
     CC_SAFE_RELEASE_NULL(_skeleton);
@@ -718,6 +860,10 @@ void Sprite3D::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTra
     
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
     flags |= FLAGS_RENDER_AS_3D;
+
+    // refit the BVH leaf only when the world transform or the meshes changed
+    if (_bvh && ((flags & FLAGS_DIRTY_MASK) || _aabbDirty))
+        _bvh->moveProxy(_bvhProxy, getAABB());
     
     //
     Director* director = Director::getInstance();
@@ -756,12 +902,46 @@ void Sprite3D::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTra
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 }
 
+void Sprite3D::onEnter()
+{
+    Node::onEnter();
+
+    auto scene = getScene();
+    if (scene && scene->getBVH() && !_bvh)
+    {
+        _bvh = scene->getBVH();
+        _bvhProxy = _bvh->addProxy(this, getAABB());
+    }
+}
+
+void Sprite3D::onExit()
+{
+    if (_bvh)
+    {
+        _bvh->removeProxy(_bvhProxy);
+        _bvh = nullptr;
+        _bvhProxy = SceneBVH::NULL_PROXY;
+    }
+
+    Node::onExit();
+}
+
 void Sprite3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
 #if CC_USE_CULLING
     // camera clipping
-    if(_children.empty() && Camera::getVisitingCamera() && !Camera::getVisitingCamera()->isVisibleInFrustum(&getAABB()))
-        return;
+    auto visitingCamera = Camera::getVisitingCamera();
+    if (visitingCamera)
+    {
+        // the BVH leaf only bounds this sprite's meshes, so the children are still visited when it is culled
+        if (_bvh)
+        {
+            if (!_bvh->isVisible(_bvhProxy, visitingCamera))
+                return;
+        }
+        else if (_children.empty() && !visitingCamera->isVisibleInFrustum(&getAABB()))
+            return;
+    }
 #endif
     
     if (_skeleton)
@@ -946,6 +1126,18 @@ void Sprite3D::setForce2DQueue(bool force2D)
     }
 }
 
+void Sprite3D::setInstancingEnabled(bool enabled)
+{
+    for (const auto &mesh : _meshes) {
+        mesh->setInstancingEnabled(enabled);
+    }
+    for (const auto &child : _children) {
+        auto sprite = dynamic_cast<Sprite3D*>(child);
+        if (sprite)
+            sprite->setInstancingEnabled(enabled);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 Sprite3DCache* Sprite3DCache::_cacheInstance = nullptr;
 Sprite3DCache* Sprite3DCache::getInstance()
@@ -963,6 +1155,30 @@ void Sprite3DCache::destroyInstance()
     }
 }
 
+bool Sprite3DCache::beginAsyncLoad(const std::string& key, Sprite3D* sprite)
+{
+    auto it = _asyncLoads.find(key);
+    if (it != _asyncLoads.end())
+    {
+        it->second.push_back(sprite);
+        return false;
+    }
+    _asyncLoads[key];
+    return true;
+}
+
+std::vector<Sprite3D*> Sprite3DCache::endAsyncLoad(const std::string& key)
+{
+    std::vector<Sprite3D*> waiting;
+    auto it = _asyncLoads.find(key);
+    if (it != _asyncLoads.end())
+    {
+        waiting.swap(it->second);
+        _asyncLoads.erase(it);
+    }
+    return waiting;
+}
+
 Sprite3DCache::Sprite3DData* Sprite3DCache::getSpriteData(const std::string& key) const
 {
     auto it = _spriteDatas.find(key);
@@ -27,6 +27,7 @@
 #define __CCSPRITE3D_H__
 
 #include <unordered_map>
+#include <deque>
 
 #include "base/CCVector.h"
 #include "base/ccTypes.h"
@@ -51,6 +52,7 @@ class Mesh;
 class Texture2D;
 class MeshSkin;
 class AttachNode;
+class SceneBVH;
 struct NodeData;
 /** @brief Sprite3D: A sprite can be loaded from 3D model files, .obj, .c3t, .c3b, then can be drawn as sprite */
 class CC_DLL Sprite3D : public Node, public BlendProtocol
@@ -81,6 +83,13 @@ public:
     
     static void createAsync(const std::string &modelPath, const std::string &texturePath, const std::function<void(Sprite3D*, void*)>& callback, void* callbackparam);
     
+    /**
+     * get & set the time in seconds createAsync may spend per frame creating GL objects on the main thread, default is 0.004.
+     * At least one sprite is finished per frame, whatever the budget.
+     */
+    static void setAsyncLoadBudget(float budget) { s_asyncLoadBudget = budget; }
+    static float getAsyncLoadBudget() { return s_asyncLoadBudget; }
+    
     /**set diffuse texture, set the first if multiple textures exist*/
     void setTexture(const std::string& texFile);
     void setTexture(Texture2D* texture);
@@ -201,6 +210,12 @@ public:
     */
     void setForce2DQueue(bool force2D);
 
+    /**
+    * Enables hardware instancing for the meshes of this sprite and of its Sprite3D children.
+    * Sprites created from the same model are then drawn with one draw call per mesh, see Mesh::setInstancingEnabled()
+    */
+    void setInstancingEnabled(bool enabled);
+
     /**
     * Get meshes used in sprite 3d
     */
@@ -228,6 +243,9 @@ CC_CONSTRUCTOR_ACCESS:
      * Note: all its children will rendered as 3D objects
      */
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
     
     /**generate default material*/
     void genMaterial(bool useLight = false);
@@ -243,7 +261,13 @@ CC_CONSTRUCTOR_ACCESS:
     
     void onAABBDirty() { _aabbDirty = true; }
     
+    /**called on the main thread once the model is parsed, starts loading its textures*/
     void afterAsyncLoad(void* param);
+    /**parsed data and textures are ready, create GL objects and run the callback*/
+    void finishAsyncLoad();
+    /**queue the sprite for finishAsyncLoad under the per-frame budget*/
+    static void scheduleAsyncFinish(Sprite3D* sprite);
+    static void processAsyncFinishQueue(float dt);
 
     static AABB getAABBRecursivelyImp(Node *node);
     
@@ -266,6 +290,10 @@ protected:
     bool                         _shaderUsingLight; // is current shader using light ?
     bool                         _forceDepthWrite; // Always write to depth buffer
     bool                         _usingAutogeneratedGLProgram;
+
+    friend class SceneBVH;
+    SceneBVH*                    _bvh; // the BVH of the running scene this sprite is registered in
+    int                          _bvhProxy;
     
     struct AsyncLoadParam
     {
@@ -277,8 +305,12 @@ protected:
         MeshDatas* meshdatas;
         MaterialDatas* materialdatas;
         NodeDatas*   nodeDatas;
+        int pendingTextures; // textures still decoding on the texture cache thread
     };
     AsyncLoadParam             _asyncLoadParam;
+    
+    static std::deque<Sprite3D*> s_asyncFinishQueue; // parsed sprites waiting for GL object creation
+    static float s_asyncLoadBudget;
 };
 
 ///////////////////////////////////////////////////////
@@ -330,6 +362,20 @@ public:
     /**remove all the SpriteData from Sprite3D*/
     void removeAllSprite3DData();
     
+    /**
+     * register an in-flight asynchronous load of key
+     * @return false if key is already being loaded, sprite then waits for that load instead of parsing the file again
+     * @lua NA
+     */
+    bool beginAsyncLoad(const std::string& key, Sprite3D* sprite);
+    
+    /**
+     * end the in-flight load of key
+     * @return the sprites that were waiting for it
+     * @lua NA
+     */
+    std::vector<Sprite3D*> endAsyncLoad(const std::string& key);
+    
     CC_CONSTRUCTOR_ACCESS:
     Sprite3DCache();
     ~Sprite3DCache();
@@ -339,6 +385,7 @@ protected:
     
     static Sprite3DCache*                        _cacheInstance;
     std::unordered_map<std::string, Sprite3DData*> _spriteDatas; //cached sprite data
+    std::unordered_map<std::string, std::vector<Sprite3D*>> _asyncLoads; //in-flight loads and the sprites waiting for them
 };
 
 // end of 3d group
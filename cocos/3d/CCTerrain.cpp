@@ -28,7 +28,7 @@ THE SOFTWARE.
 USING_NS_CC;
 #include <stdlib.h>
 #include <float.h>
-#include <set>
+#include <algorithm>
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
@@ -322,55 +322,71 @@ void Terrain::setChunksLOD(const Vec3& cameraPos)
 
 float Terrain::getHeight(float x, float z, Vec3 * normal) const
 {
-    Vec2 pos(x,z);
+    Vec2 tl, size;
+    getWorldSpaceExtent(tl, size);
 
-    //top-left
-    Vec2 tl(-1*_terrainData._mapScale*_imageWidth/2,-1*_terrainData._mapScale*_imageHeight/2);
-    auto mulResult = getNodeToWorldTransform() * Vec4(tl.x, 0.0f, tl.y, 1.0f);
-    tl.set(mulResult.x, mulResult.z);
-
-    Vec2 to_tl = pos - tl;
-
-    //real size
-    Vec2 size(_imageWidth*_terrainData._mapScale,_imageHeight*_terrainData._mapScale);
-    mulResult = getNodeToWorldTransform() * Vec4(size.x, 0.0f, size.y, 0.0f);
-    size.set(mulResult.x, mulResult.z);
-
-    float width_ratio = to_tl.x/size.x;
-    float height_ratio = to_tl.y/size.y;
+    float image_x = (x - tl.x) * (_imageWidth / size.x);
+    float image_y = (z - tl.y) * (_imageHeight / size.y);
+    return sampleHeight(image_x, image_y, getScaleY(), normal);
+}
 
-    float image_x = width_ratio * _imageWidth;
-    float image_y = height_ratio * _imageHeight;
-    float u =image_x - (int)image_x;
-    float v =image_y - (int)image_y;
-    float i = (int)image_x;
-    float j = (int)image_y;
+void Terrain::getHeights(const Vec2* points, float* heights, size_t count) const
+{
+    Vec2 tl, size;
+    getWorldSpaceExtent(tl, size);
 
+    const float ratioX = _imageWidth / size.x;
+    const float ratioY = _imageHeight / size.y;
+    const float scaleY = getScaleY();
+    for (size_t i = 0; i < count; ++i)
+    {
+        heights[i] = sampleHeight((points[i].x - tl.x) * ratioX, (points[i].y - tl.y) * ratioY, scaleY, nullptr);
+    }
+}
 
-    if(image_x>=_imageWidth-1 || image_y >=_imageHeight-1 || image_x<0 || image_y<0)
+float Terrain::sampleHeight(float imageX, float imageY, float scaleY, Vec3* normal) const
+{
+    if(imageX>=_imageWidth-1 || imageY >=_imageHeight-1 || imageX<0 || imageY<0)
     {
         if (normal)
         {
             normal->setZero();
         }
         return 0;
-    }else
-    {
-        float a = getImageHeight(i,j)*getScaleY();
-        float b = getImageHeight(i,j+1)*getScaleY();
-        float c = getImageHeight(i+1,j)*getScaleY();
-        float d = getImageHeight(i+1,j+1)*getScaleY();
-        if(normal)
-        {
-            normal->x = c - b;
-            normal->y = 2;
-            normal->z = d - a;
-            normal->normalize();
-            //(*normal) = (1-u)*(1-v)*getNormal(i,j)+ (1-u)*v*getNormal(i,j+1) + u*(1-v)*getNormal(i+1,j)+ u*v*getNormal(i+1,j+1);
-        }
-        float result = (1-u)*(1-v)*getImageHeight(i,j)*getScaleY() + (1-u)*v*getImageHeight(i,j+1)*getScaleY() + u*(1-v)*getImageHeight(i+1,j)*getScaleY() + u*v*getImageHeight(i+1,j+1)*getScaleY();
-        return result;
     }
+
+    int i = (int)imageX;
+    int j = (int)imageY;
+    float u = imageX - i;
+    float v = imageY - j;
+
+    const float* row = &_heights[j*_imageWidth + i];
+    float a = row[0]*scaleY;
+    float b = row[_imageWidth]*scaleY;
+    float c = row[1]*scaleY;
+    float d = row[_imageWidth + 1]*scaleY;
+    if(normal)
+    {
+        normal->x = c - b;
+        normal->y = 2;
+        normal->z = d - a;
+        normal->normalize();
+    }
+    return (1-u)*(1-v)*a + (1-u)*v*b + u*(1-v)*c + u*v*d;
+}
+
+void Terrain::getWorldSpaceExtent(Vec2& topLeft, Vec2& size) const
+{
+    const Mat4 transform = getNodeToWorldTransform();
+
+    //top-left
+    Vec2 tl(-1*_terrainData._mapScale*_imageWidth/2,-1*_terrainData._mapScale*_imageHeight/2);
+    auto mulResult = transform * Vec4(tl.x, 0.0f, tl.y, 1.0f);
+    topLeft.set(mulResult.x, mulResult.z);
+
+    //real size
+    mulResult = transform * Vec4(_imageWidth*_terrainData._mapScale, 0.0f, _imageHeight*_terrainData._mapScale, 0.0f);
+    size.set(mulResult.x, mulResult.z);
 }
 
 float Terrain::getHeight(const Vec2& pos, Vec3* normal) const
@@ -402,11 +418,14 @@ void Terrain::loadVertices()
 {
     _maxHeight = -99999;
     _minHeight = 99999;
+    _heights.clear();
+    _heights.reserve(_imageWidth * _imageHeight);
     for(int i =0;i<_imageHeight;++i)
     {
         for(int j =0;j<_imageWidth;j++)
         {
             float height = getImageHeight(j,i);
+            _heights.push_back(height);
             TerrainVertexData v;
             v._position = Vec3(j*_terrainData._mapScale- _imageWidth/2*_terrainData._mapScale, //x
                 height, //y
@@ -419,6 +438,62 @@ void Terrain::loadVertices()
             if(height<_minHeight) _minHeight = height;
         }
     }
+    buildHeightPyramid();
+}
+
+void Terrain::buildHeightPyramid()
+{
+    _heightPyramid.clear();
+    if (_imageWidth < 2 || _imageHeight < 2)
+        return;
+
+    // level 0: the height range of each grid cell
+    HeightPyramidLevel base;
+    base.width = _imageWidth - 1;
+    base.height = _imageHeight - 1;
+    base.minHeights.resize(base.width * base.height);
+    base.maxHeights.resize(base.width * base.height);
+    for (int i = 0; i < base.height; ++i)
+    {
+        for (int j = 0; j < base.width; ++j)
+        {
+            const float* row = &_heights[i * _imageWidth + j];
+            int idx = i * base.width + j;
+            base.minHeights[idx] = std::min(std::min(row[0], row[1]), std::min(row[_imageWidth], row[_imageWidth + 1]));
+            base.maxHeights[idx] = std::max(std::max(row[0], row[1]), std::max(row[_imageWidth], row[_imageWidth + 1]));
+        }
+    }
+    _heightPyramid.push_back(std::move(base));
+
+    // each upper level merges 2x2 entries of the level below, down to a single root entry
+    while (_heightPyramid.back().width > 1 || _heightPyramid.back().height > 1)
+    {
+        const HeightPyramidLevel& prev = _heightPyramid.back();
+        HeightPyramidLevel level;
+        level.width = (prev.width + 1) / 2;
+        level.height = (prev.height + 1) / 2;
+        level.minHeights.resize(level.width * level.height);
+        level.maxHeights.resize(level.width * level.height);
+        for (int i = 0; i < level.height; ++i)
+        {
+            for (int j = 0; j < level.width; ++j)
+            {
+                float minHeight = FLT_MAX;
+                float maxHeight = -FLT_MAX;
+                for (int y = i * 2; y < std::min(i * 2 + 2, prev.height); ++y)
+                {
+                    for (int x = j * 2; x < std::min(j * 2 + 2, prev.width); ++x)
+                    {
+                        minHeight = std::min(minHeight, prev.minHeights[y * prev.width + x]);
+                        maxHeight = std::max(maxHeight, prev.maxHeights[y * prev.width + x]);
+                    }
+                }
+                level.minHeights[i * level.width + j] = minHeight;
+                level.maxHeights[i * level.width + j] = maxHeight;
+            }
+        }
+        _heightPyramid.push_back(std::move(level));
+    }
 }
 
 void Terrain::calculateNormal()
@@ -547,62 +622,127 @@ cocos2d::Vec3 Terrain::getIntersectionPoint(const Ray & ray) const
 
 bool Terrain::getIntersectionPoint(const Ray & ray_, Vec3 & intersectionPoint) const
 {
+    if (_heightPyramid.empty())
+        return false;
+
     // convert ray from world space to local space
     Ray ray(ray_);
     getWorldToNodeTransform().transformPoint(&(ray._origin));
+    ray._direction.normalize();
+
+    float nearest = FLT_MAX;
+    return intersectHeightPyramid(ray, (int)_heightPyramid.size() - 1, 0, 0, nearest, intersectionPoint);
+}
+
+static bool intersectRayWithBox(const Ray& ray, const Vec3& boxMin, const Vec3& boxMax, float& enter)
+{
+    const float origin[3] = { ray._origin.x, ray._origin.y, ray._origin.z };
+    const float direction[3] = { ray._direction.x, ray._direction.y, ray._direction.z };
+    const float lower[3] = { boxMin.x, boxMin.y, boxMin.z };
+    const float upper[3] = { boxMax.x, boxMax.y, boxMax.z };
+
+    float tmin = 0.0f;
+    float tmax = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (std::abs(direction[axis]) < FLT_EPSILON)
+        {
+            if (origin[axis] < lower[axis] || origin[axis] > upper[axis])
+                return false;
+            continue;
+        }
+        float inv = 1.0f / direction[axis];
+        float t1 = (lower[axis] - origin[axis]) * inv;
+        float t2 = (upper[axis] - origin[axis]) * inv;
+        if (t1 > t2)
+            std::swap(t1, t2);
+        tmin = std::max(tmin, t1);
+        tmax = std::min(tmax, t2);
+        if (tmin > tmax)
+            return false;
+    }
+    enter = tmin;
+    return true;
+}
+
+bool Terrain::intersectHeightPyramid(const Ray& ray, int level, int x, int y, float& nearest, Vec3& intersectionPoint) const
+{
+    if (level == 0)
+    {
+        // same triangulation as Chunk::generate
+        const Vec3& p00 = _vertices[y * _imageWidth + x]._position;
+        const Vec3& p01 = _vertices[y * _imageWidth + x + 1]._position;
+        const Vec3& p10 = _vertices[(y + 1) * _imageWidth + x]._position;
+        const Vec3& p11 = _vertices[(y + 1) * _imageWidth + x + 1]._position;
+        const Triangle triangles[2] = { Triangle(p00, p10, p01), Triangle(p01, p10, p11) };
 
-    std::set<Chunk *> closeList;
-    Vec2 start = Vec2(ray_._origin.x,ray_._origin.z);
-    Vec2 dir = Vec2(ray._direction.x,ray._direction.z);
-    start = convertToTerrainSpace(start);
-    start.x /=(_terrainData._chunkSize.width+1);
-    start.y /=(_terrainData._chunkSize.height+1);
-    Vec2 delta = dir.getNormalized();
-    auto width = float(_imageWidth) / (_terrainData._chunkSize.width + 1);
-    auto height = float(_imageHeight) / (_terrainData._chunkSize.height + 1);
-    bool hasIntersect = false;
-    float intersectionDist = FLT_MAX;
-    Vec3 tmpIntersectionPoint;
-    for(;;)
-    {
-        int x1 = floorf(start.x);
-        int x2 = ceilf(start.x);
-        int y1 = floorf(start.y);
-        int y2 = ceilf(start.y);
-        for (int x = x1; x <= x2; x++) {
-            for (int y = y1; y <= y2; y++) {
-                auto chunk = getChunkByIndex(x, y);
-                if (chunk)
+        bool isFind = false;
+        for (const auto& triangle : triangles)
+        {
+            Vec3 p;
+            if (triangle.getIntersectPoint(ray, p))
+            {
+                float dist = ray._origin.distance(p);
+                if (dist < nearest)
                 {
-                    if (closeList.find(chunk) == closeList.end())
-                    {
-                        if (chunk->getIntersectPointWithRay(ray, tmpIntersectionPoint))
-                        {
-                            float dist = (ray._origin - tmpIntersectionPoint).length();
-                            if (intersectionDist > dist)
-                            {
-                                hasIntersect = true;
-                                intersectionDist = dist;
-                                intersectionPoint = tmpIntersectionPoint;
-                            }
-                        }
-                        closeList.insert(chunk);
-                    }
+                    nearest = dist;
+                    intersectionPoint = p;
+                    isFind = true;
                 }
             }
         }
-        if ((delta.x > 0 && start.x > width) || (delta.x <0 && start.x <0))
+        return isFind;
+    }
+
+    // collect the children hit by the ray, then visit them front-to-back so that
+    // farther children are skipped as soon as a closer hit is known
+    struct Candidate
+    {
+        int x;
+        int y;
+        float enter;
+    } candidates[4];
+    int candidateCount = 0;
+
+    const HeightPyramidLevel& child = _heightPyramid[level - 1];
+    const float cellSize = _terrainData._mapScale;
+    const float originX = -(_imageWidth / 2) * cellSize;
+    const float originZ = -(_imageHeight / 2) * cellSize;
+    const int cellsPerNode = 1 << (level - 1);
+    const int cellsX = _imageWidth - 1;
+    const int cellsY = _imageHeight - 1;
+    for (int cy = y * 2; cy < std::min(y * 2 + 2, child.height); ++cy)
+    {
+        for (int cx = x * 2; cx < std::min(x * 2 + 2, child.width); ++cx)
         {
-            break;
+            int idx = cy * child.width + cx;
+            Vec3 boxMin(originX + cx * cellsPerNode * cellSize, child.minHeights[idx], originZ + cy * cellsPerNode * cellSize);
+            Vec3 boxMax(originX + std::min((cx + 1) * cellsPerNode, cellsX) * cellSize, child.maxHeights[idx],
+                        originZ + std::min((cy + 1) * cellsPerNode, cellsY) * cellSize);
+            // pad a little so that rays grazing flat cells are not rejected by rounding
+            boxMin -= Vec3(0.001f, 0.001f, 0.001f);
+            boxMax += Vec3(0.001f, 0.001f, 0.001f);
+
+            float enter;
+            if (intersectRayWithBox(ray, boxMin, boxMax, enter) && enter < nearest)
+            {
+                candidates[candidateCount++] = { cx, cy, enter };
+            }
         }
-        if ((delta.y > 0 && start.y > height) || (delta.y < 0 && start.y < 0))
-        {
+    }
+    std::sort(candidates, candidates + candidateCount, [](const Candidate& a, const Candidate& b) {
+        return a.enter < b.enter;
+    });
+
+    bool isFind = false;
+    for (int i = 0; i < candidateCount; ++i)
+    {
+        if (candidates[i].enter >= nearest)
             break;
-        }
-        start.x += delta.x;
-        start.y += delta.y;
+        if (intersectHeightPyramid(ray, level - 1, candidates[i].x, candidates[i].y, nearest, intersectionPoint))
+            isFind = true;
     }
-    return hasIntersect;
+    return isFind;
 }
 
 void Terrain::setMaxDetailMapAmount(int max_value)
@@ -612,19 +752,10 @@ void Terrain::setMaxDetailMapAmount(int max_value)
 
 cocos2d::Vec2 Terrain::convertToTerrainSpace(const Vec2& worldSpaceXZ) const
 {
-    Vec2 pos(worldSpaceXZ.x,worldSpaceXZ.y);
+    Vec2 tl, size;
+    getWorldSpaceExtent(tl, size);
 
-    //top-left
-    Vec2 tl(-1*_terrainData._mapScale*_imageWidth/2,-1*_terrainData._mapScale*_imageHeight/2);
-    auto result  = getNodeToWorldTransform()*Vec4(tl.x,0.0f,tl.y,1.0f);
-    tl.set(result.x, result.z);
-
-    Vec2 to_tl = pos - tl;
-
-    //real size
-    Vec2 size(_imageWidth*_terrainData._mapScale,_imageHeight*_terrainData._mapScale);
-    result = getNodeToWorldTransform()*Vec4(size.x,0.0f,size.y,0.0f);
-    size.set(result.x, result.z);
+    Vec2 to_tl = worldSpaceXZ - tl;
 
     float width_ratio = to_tl.x/size.x;
     float height_ratio = to_tl.y/size.y;
@@ -344,6 +344,14 @@ public:
      **/
     float getHeight(const Vec2& pos, Vec3* normal = nullptr) const;
 
+    /**get the heights of a batch of positions, use bi-linear interpolation method
+     * The world to terrain transform is computed only once for the whole batch, so prefer this over calling getHeight in a loop.
+     * @param points the positions (X,Z) in world space
+     * @param heights receives the heights, must hold at least count elements. Positions out of the terrain bounds get 0.
+     * @param count the number of positions
+     **/
+    void getHeights(const Vec2* points, float* heights, size_t count) const;
+
     /**get the normal of the specified position in terrain
      * @return the normal vector of the specified position of the terrain.
      * @note the fast normal calculation may not get precise normal vector.
@@ -481,7 +489,36 @@ protected:
     
     Chunk * getChunkByIndex(int x,int y) const;
 
+    /**
+     * build the min/max height pyramid used by getIntersectionPoint.
+     **/
+    void buildHeightPyramid();
+
+    /**
+     * sample the cached height field at image coordinates, return 0 when out of bounds.
+     **/
+    float sampleHeight(float imageX, float imageY, float scaleY, Vec3* normal) const;
+
+    /**
+     * get the terrain's top-left corner and size projected on the world XZ plane.
+     **/
+    void getWorldSpaceExtent(Vec2& topLeft, Vec2& size) const;
+
+    /**
+     * intersect a local space ray with a node of the height pyramid, front-to-back.
+     **/
+    bool intersectHeightPyramid(const Ray& ray, int level, int x, int y, float& nearest, Vec3& intersectionPoint) const;
+
 protected:
+    /** min/max heights of one level of the height pyramid, level 0 holds one entry per grid cell */
+    struct HeightPyramidLevel
+    {
+        int width;
+        int height;
+        std::vector<float> minHeights;
+        std::vector<float> maxHeights;
+    };
+
     std::vector <ChunkLODIndices> _chunkLodIndicesSet;
     std::vector<ChunkLODIndicesSkirt> _chunkLodIndicesSkirtSet;
     Mat4 _CameraMatrix;
@@ -498,6 +535,9 @@ protected:
     QuadTree * _quadRoot;
     Chunk * _chunkesArray[MAX_CHUNKES][MAX_CHUNKES];
     std::vector<TerrainVertexData> _vertices;
+    /**the height field in local space, row major, decoded once from _data*/
+    std::vector<float> _heights;
+    std::vector<HeightPyramidLevel> _heightPyramid;
     std::vector<unsigned int> _indices;
     int _imageWidth;
     int _imageHeight;
@@ -95,6 +95,7 @@ platform/CCGLView.cpp \
 platform/CCImage.cpp \
 platform/CCSAXParser.cpp \
 platform/CCThread.cpp \
+platform/CCAsyncFileReader.cpp \
 $(MATHNEONFILE) \
 math/CCAffineTransform.cpp \
 math/CCGeometry.cpp \
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "base/CCEventCustom.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
+#include "renderer/CCGLProgram.h"
 
 NS_CC_BEGIN
 
@@ -53,6 +54,7 @@ Configuration::Configuration()
 , _supportsOESMapBuffer(false)
 , _supportsOESDepth24(false)
 , _supportsOESPackedDepthStencil(false)
+, _supportsInstancing(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -168,6 +170,19 @@ void Configuration::gatherGPUInfo()
     _supportsOESPackedDepthStencil = checkForGLExtension("GL_OES_packed_depth_stencil");
     _valueDict["gl.supports_OES_packed_depth_stencil"] = Value(_supportsOESPackedDepthStencil);
 
+#ifdef CC_PLATFORM_PC
+    _supportsInstancing = checkForGLExtension("GL_ARB_instanced_arrays") && checkForGLExtension("GL_ARB_draw_instanced");
+#else
+    _supportsInstancing = checkForGLExtension("GL_EXT_instanced_arrays");
+#endif
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+    _supportsInstancing = _supportsInstancing && glDrawElementsInstancedEXT && glVertexAttribDivisorEXT;
+#endif
+    GLint maxVertexAttribs = 0;
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxVertexAttribs);
+    _supportsInstancing = _supportsInstancing && maxVertexAttribs > GLProgram::VERTEX_ATTRIB_INSTANCE_COLOR;
+    _valueDict["gl.supports_instancing"] = Value(_supportsInstancing);
+
 
     CHECK_GL_ERROR_DEBUG();
 }
@@ -305,6 +320,11 @@ bool Configuration::supportsOESPackedDepthStencil() const
     return _supportsOESPackedDepthStencil;
 }
 
+bool Configuration::supportsInstancing() const
+{
+    return _supportsInstancing;
+}
+
 
 
 int Configuration::getMaxSupportDirLightInShader() const
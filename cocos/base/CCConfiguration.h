@@ -171,6 +171,16 @@ public:
      */
     bool supportsMapBuffer() const;
 
+    /** Whether or not instanced drawing (instanced arrays) is supported.
+     *
+     * On Desktop it checks for `GL_ARB_instanced_arrays` and `GL_ARB_draw_instanced`.
+     * On Mobile it checks for the extension `GL_EXT_instanced_arrays`.
+     * It also requires enough vertex attributes for the per-instance data used by the 3D renderer.
+     *
+     * @return Is true if supports instanced drawing.
+     */
+    bool supportsInstancing() const;
+
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -270,6 +280,7 @@ protected:
     bool            _supportsOESMapBuffer;
     bool            _supportsOESDepth24;
     bool            _supportsOESPackedDepthStencil;
+    bool            _supportsInstancing;
     
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
@@ -1105,11 +1105,13 @@ void Director::reset()
     SpriteFrameCache::destroyInstance();
     GLProgramCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
-    FileUtils::destroyInstance();
-    AsyncTaskPool::destroyInstance();
-    
+
     // cocos2d-x specific data structures
+    // UserDefault saves its pending values through FileUtils
     UserDefault::destroyInstance();
+
+    FileUtils::destroyInstance();
+    AsyncTaskPool::destroyInstance();
     
     GL::invalidateStateCache();
 
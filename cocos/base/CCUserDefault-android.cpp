@@ -534,6 +534,17 @@ void UserDefault::deleteValueForKey(const char* key)
 
     flush();
 }
+
+void UserDefault::setBinaryFormatEnabled(bool /*enabled*/)
+{
+    // values are stored natively on this platform
+}
+
+bool UserDefault::isBinaryFormatEnabled()
+{
+    return false;
+}
+
 NS_CC_END
 
 #endif // (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
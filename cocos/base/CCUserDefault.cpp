@@ -32,142 +32,382 @@ THE SOFTWARE.
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <io.h>
+#include "platform/win32/CCUtils-win32.h"
+#else
+#include <unistd.h>
+#endif
+
 // root name of xml
 #define USERDEFAULT_ROOT_NAME    "userDefaultRoot"
 
 #define XML_FILE_NAME "UserDefault.xml"
+#define BINARY_FILE_NAME "UserDefault.bin"
+
+// header of the binary format, followed by the version, the entry count and the length prefixed keys and values
+#define BINARY_FILE_MAGIC "CCUD"
+#define BINARY_FILE_VERSION 1
+
+// writes issued within this delay are saved together
+#define FLUSH_DELAY_MS 500
 
 using namespace std;
 
 NS_CC_BEGIN
 
+UserDefault* UserDefault::_userDefault = nullptr;
+// defined before s_store, which may still save to this path when it is destroyed
+string UserDefault::_filePath = string("");
+bool UserDefault::_isFilePathInitialized = false;
+
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * All the values are kept in memory as the strings stored in the file. Setters only update the map,
+ * a worker thread saves it shortly after to a temporary file which then replaces the real one.
  */
+class UserDefaultStore
+{
+public:
+    UserDefaultStore()
+    : _loaded(false)
+    , _dirty(false)
+    , _quit(false)
+    , _binaryFormat(false)
+    {
+    }
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
-{
-    tinyxml2::XMLElement* curNode = nullptr;
-
-    // check the key value
-    if (! pKey)
+    ~UserDefaultStore()
     {
-        return nullptr;
+        shutdown();
     }
 
-    do 
+    void setBinaryFormat(bool binary)
     {
-        tinyxml2::XMLDocument* xmlDoc = new (std::nothrow) tinyxml2::XMLDocument();
-        *doc = xmlDoc;
-        *rootNode = nullptr;
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_binaryFormat != binary)
+        {
+            _binaryFormat = binary;
+            // rewrite the values in the new format on next save
+            _dirty = _loaded;
+        }
+    }
 
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
+    bool isBinaryFormat() const { return _binaryFormat; }
 
-        if (!xmlBuffer.empty())
+    void load()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_loaded)
+            return;
+        _loaded = true;
+
+        auto fileUtils = FileUtils::getInstance();
+        _binaryFilePath = fileUtils->getWritablePath() + BINARY_FILE_NAME;
+        if (_binaryFormat && fileUtils->isFileExist(_binaryFilePath))
         {
-            xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
-
-            // get root node
-            *rootNode = xmlDoc->RootElement();
+            loadBinary(fileUtils->getDataFromFile(_binaryFilePath));
+        }
+        else
+        {
+            loadXML(fileUtils->getStringFromFile(UserDefault::getXMLFilePath()));
+            // migrate the xml content to the binary file
+            _dirty = _binaryFormat && !_values.empty();
         }
+    }
 
-        if (nullptr == *rootNode)
+    bool getValue(const char* key, std::string& value)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto iter = _values.find(key);
+        if (iter == _values.end())
+            return false;
+        value = iter->second;
+        return true;
+    }
+
+    void setValue(const char* key, const char* value)
+    {
         {
-            // try to insert xml declaration
-            if (!xmlDoc->FirstChild())
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto iter = _values.find(key);
+            if (iter != _values.end())
             {
-                tinyxml2::XMLDeclaration *xmlDeclaration = xmlDoc->NewDeclaration(nullptr);
-                if (nullptr != xmlDeclaration)
-                {
-                    xmlDoc->LinkEndChild(xmlDeclaration);
-                }
+                if (iter->second == value)
+                    return;
+                iter->second = value;
             }
+            else
+            {
+                _values.emplace(key, value);
+            }
+            markDirty();
+        }
+        _condition.notify_one();
+    }
 
-            // create root element
-            tinyxml2::XMLElement *rootEle = xmlDoc->NewElement(USERDEFAULT_ROOT_NAME);
-            if (nullptr == rootEle)
-                break;
+    void deleteValue(const char* key)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_values.erase(key) == 0)
+                return;
+            markDirty();
+        }
+        _condition.notify_one();
+    }
+
+    /** save the pending values on the calling thread */
+    void save()
+    {
+        // snapshots are taken and written in the same order
+        std::lock_guard<std::mutex> writeLock(_writeMutex);
 
-            xmlDoc->LinkEndChild(rootEle);
-            *rootNode = rootEle;
+        std::vector<std::pair<std::string, std::string>> snapshot;
+        bool binary;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_dirty)
+                return;
+            snapshot.assign(_values.begin(), _values.end());
+            binary = _binaryFormat;
+            _dirty = false;
         }
+        std::sort(snapshot.begin(), snapshot.end());
 
-        // find the node
-        curNode = (*rootNode)->FirstChildElement();
-        while (nullptr != curNode)
+        std::string content = binary ? encodeBinary(snapshot) : encodeXML(snapshot);
+        const std::string& path = binary ? _binaryFilePath : UserDefault::getXMLFilePath();
+        if (path.empty())
+            return;
+        if (!writeFileAtomically(path, content))
         {
-            const char* nodeName = curNode->Value();
-            if (!strcmp(nodeName, pKey))
-            {
+            CCLOG("UserDefault: fail to save %s", path.c_str());
+        }
+    }
+
+    /** save the pending values and stop the worker thread */
+    void shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _quit = true;
+        }
+        _condition.notify_one();
+        if (_worker.joinable())
+            _worker.join();
+        _quit = false;
+
+        save();
+    }
+
+private:
+    // must be called with _mutex locked
+    void markDirty()
+    {
+        _dirty = true;
+        if (!_worker.joinable())
+            _worker = std::thread(&UserDefaultStore::run, this);
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_quit)
+        {
+            _condition.wait(lock, [this]() { return _quit || _dirty; });
+            if (_quit)
+                break;
+
+            _condition.wait_for(lock, std::chrono::milliseconds(FLUSH_DELAY_MS), [this]() { return _quit; });
+            if (_quit)
                 break;
-            }
 
-            curNode = curNode->NextSiblingElement();
+            lock.unlock();
+            save();
+            lock.lock();
         }
-    } while (0);
+    }
 
-    return curNode;
-}
+    void loadXML(const std::string& xmlBuffer)
+    {
+        if (xmlBuffer.empty())
+            return;
 
-static void setValueForKey(const char* pKey, const char* pValue)
-{
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    // check the params
-    if (! pKey || ! pValue)
+        tinyxml2::XMLDocument doc;
+        doc.Parse(xmlBuffer.c_str(), xmlBuffer.size());
+        auto rootNode = doc.RootElement();
+        if (!rootNode)
+            return;
+
+        for (auto node = rootNode->FirstChildElement(); node; node = node->NextSiblingElement())
+        {
+            // elements without text were always read as missing keys
+            if (node->FirstChild() && node->FirstChild()->Value())
+                _values[node->Value()] = node->FirstChild()->Value();
+        }
+    }
+
+    void loadBinary(const Data& data)
     {
-        return;
+        const unsigned char* cursor = data.getBytes();
+        const unsigned char* end = cursor + data.getSize();
+        auto readUInt = [&cursor, end](uint32_t& value) {
+            if (end - cursor < 4)
+                return false;
+            value = cursor[0] | (cursor[1] << 8) | (cursor[2] << 16) | ((uint32_t)cursor[3] << 24);
+            cursor += 4;
+            return true;
+        };
+
+        uint32_t version = 0;
+        uint32_t count = 0;
+        if (data.getSize() < 4 || memcmp(cursor, BINARY_FILE_MAGIC, 4) != 0)
+        {
+            CCLOG("UserDefault: %s is not a valid file", _binaryFilePath.c_str());
+            return;
+        }
+        cursor += 4;
+        if (!readUInt(version) || version != BINARY_FILE_VERSION || !readUInt(count))
+        {
+            CCLOG("UserDefault: unsupported version of %s", _binaryFilePath.c_str());
+            return;
+        }
+
+        _values.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t keyLength, valueLength;
+            if (!readUInt(keyLength) || (uint32_t)(end - cursor) < keyLength)
+                break;
+            std::string key((const char*)cursor, keyLength);
+            cursor += keyLength;
+            if (!readUInt(valueLength) || (uint32_t)(end - cursor) < valueLength)
+                break;
+            _values[key].assign((const char*)cursor, valueLength);
+            cursor += valueLength;
+        }
     }
-    // find the node
-    node = getXMLNodeForKey(pKey, &rootNode, &doc);
-    // if node exist, change the content
-    if (node)
+
+    static std::string encodeXML(const std::vector<std::pair<std::string, std::string>>& values)
     {
-        if (node->FirstChild())
+        tinyxml2::XMLDocument doc;
+        doc.LinkEndChild(doc.NewDeclaration(nullptr));
+        auto rootNode = doc.NewElement(USERDEFAULT_ROOT_NAME);
+        doc.LinkEndChild(rootNode);
+        for (const auto& value : values)
         {
-            node->FirstChild()->SetValue(pValue);
+            auto node = doc.NewElement(value.first.c_str());
+            node->LinkEndChild(doc.NewText(value.second.c_str()));
+            rootNode->LinkEndChild(node);
         }
-        else
+
+        tinyxml2::XMLPrinter printer;
+        doc.Print(&printer);
+        return std::string(printer.CStr(), printer.CStrSize() > 0 ? printer.CStrSize() - 1 : 0);
+    }
+
+    static std::string encodeBinary(const std::vector<std::pair<std::string, std::string>>& values)
+    {
+        std::string content(BINARY_FILE_MAGIC);
+        auto writeUInt = [&content](uint32_t value) {
+            char bytes[4] = { (char)(value & 0xff), (char)((value >> 8) & 0xff), (char)((value >> 16) & 0xff), (char)((value >> 24) & 0xff) };
+            content.append(bytes, 4);
+        };
+
+        writeUInt(BINARY_FILE_VERSION);
+        writeUInt((uint32_t)values.size());
+        for (const auto& value : values)
         {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
+            writeUInt((uint32_t)value.first.size());
+            content += value.first;
+            writeUInt((uint32_t)value.second.size());
+            content += value.second;
         }
+        return content;
     }
-    else
+
+    // write to a temporary file, sync it and rename it over the destination, so a crash never leaves a truncated file
+    static bool writeFileAtomically(const std::string& path, const std::string& content)
     {
-        if (rootNode)
+        auto fileUtils = FileUtils::getInstance();
+        std::string tmpPath = path + ".tmp";
+        FILE* fp = fopen(fileUtils->getSuitableFOpen(tmpPath).c_str(), "wb");
+        if (!fp)
+            return false;
+
+        bool ok = fwrite(content.data(), 1, content.size(), fp) == content.size() && fflush(fp) == 0;
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        ok = ok && _commit(_fileno(fp)) == 0;
+#else
+        ok = ok && fsync(fileno(fp)) == 0;
+#endif
+        fclose(fp);
+        if (!ok)
         {
-            tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-            rootNode->LinkEndChild(tmpNode);
-            tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-            tmpNode->LinkEndChild(content);
-        }    
+            remove(fileUtils->getSuitableFOpen(tmpPath).c_str());
+            return false;
+        }
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        return MoveFileExW(StringUtf8ToWideChar(tmpPath).c_str(), StringUtf8ToWideChar(path).c_str(),
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return rename(tmpPath.c_str(), path.c_str()) == 0;
+#endif
     }
 
-    // save file and free doc
-    if (doc)
+    std::unordered_map<std::string, std::string> _values;
+    std::string _binaryFilePath;
+    std::mutex _mutex;
+    std::mutex _writeMutex;
+    std::condition_variable _condition;
+    std::thread _worker;
+    bool _loaded;
+    bool _dirty;
+    bool _quit;
+    bool _binaryFormat;
+};
+
+static UserDefaultStore s_store;
+
+static bool getValueForKey(const char* pKey, std::string& value)
+{
+    if (! pKey)
     {
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
+        return false;
     }
+    return s_store.getValue(pKey, value);
+}
+
+static void setValueForKey(const char* pKey, const char* pValue)
+{
+    // check the params
+    if (! pKey || ! pValue)
+    {
+        return;
+    }
+    s_store.setValue(pKey, pValue);
 }
 
 /**
  * implements of UserDefault
  */
 
-UserDefault* UserDefault::_userDefault = nullptr;
-string UserDefault::_filePath = string("");
-bool UserDefault::_isFilePathInitialized = false;
-
 UserDefault::~UserDefault()
 {
+    s_store.shutdown();
 }
 
 UserDefault::UserDefault()
 {
+    s_store.load();
 }
 
 bool UserDefault::getBoolForKey(const char* pKey)
@@ -177,27 +417,12 @@ bool UserDefault::getBoolForKey(const char* pKey)
 
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
+    std::string value;
+    if (getValueForKey(pKey, value))
     {
-        value = (const char*)(node->FirstChild()->Value());
+        return value == "true";
     }
-
-    bool ret = defaultValue;
-
-    if (value)
-    {
-        ret = (! strcmp(value, "true"));
-    }
-
-    delete doc;
-
-    return ret;
+    return defaultValue;
 }
 
 int UserDefault::getIntegerForKey(const char* pKey)
@@ -207,28 +432,12 @@ int UserDefault::getIntegerForKey(const char* pKey)
 
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
+    std::string value;
+    if (getValueForKey(pKey, value))
     {
-        value = (const char*)(node->FirstChild()->Value());
+        return atoi(value.c_str());
     }
-
-    int ret = defaultValue;
-
-    if (value)
-    {
-        ret = atoi(value);
-    }
-
-    delete doc;
-
-
-    return ret;
+    return defaultValue;
 }
 
 float UserDefault::getFloatForKey(const char* pKey)
@@ -250,27 +459,12 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
-
-    double ret = defaultValue;
-
-    if (value)
+    std::string value;
+    if (getValueForKey(pKey, value))
     {
-        ret = utils::atof(value);
+        return utils::atof(value.c_str());
     }
-
-    delete doc;
-
-    return ret;
+    return defaultValue;
 }
 
 std::string UserDefault::getStringForKey(const char* pKey)
@@ -280,27 +474,12 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
-
-    string ret = defaultValue;
-
-    if (value)
+    std::string value;
+    if (getValueForKey(pKey, value))
     {
-        ret = string(value);
+        return value;
     }
-
-    delete doc;
-
-    return ret;
+    return defaultValue;
 }
 
 Data UserDefault::getDataForKey(const char* pKey)
@@ -310,39 +489,23 @@ Data UserDefault::getDataForKey(const char* pKey)
 
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
-    const char* encodedData = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
+    std::string encodedData;
+    if (!getValueForKey(pKey, encodedData))
     {
-        encodedData = (const char*)(node->FirstChild()->Value());
+        return defaultValue;
     }
-    
+
     Data ret;
-    
-    if (encodedData)
-    {
-        unsigned char * decodedData = nullptr;
-        int decodedDataLen = base64Decode((unsigned char*)encodedData, (unsigned int)strlen(encodedData), &decodedData);
-        
-        if (decodedData) {
-            ret.fastSet(decodedData, decodedDataLen);
-        }
-    }
-    else
-    {
-        ret = defaultValue;
+    unsigned char * decodedData = nullptr;
+    int decodedDataLen = base64Decode((unsigned char*)encodedData.c_str(), (unsigned int)encodedData.size(), &decodedData);
+
+    if (decodedData) {
+        ret.fastSet(decodedData, decodedDataLen);
     }
     
-    delete doc;
-    
     return ret;    
 }
 
-
 void UserDefault::setBoolForKey(const char* pKey, bool value)
 {
     // save bool value as string
@@ -430,7 +593,7 @@ UserDefault* UserDefault::getInstance()
 
         // only create xml file one time
         // the file exists after the program exit
-        if ((!isXMLFileExist()) && (!createXMLFile()))
+        if (!s_store.isBinaryFormat() && (!isXMLFileExist()) && (!createXMLFile()))
         {
             return nullptr;
         }
@@ -517,14 +680,11 @@ const string& UserDefault::getXMLFilePath()
 
 void UserDefault::flush()
 {
+    s_store.save();
 }
 
 void UserDefault::deleteValueForKey(const char* key)
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-
     // check the params
     if (!key)
     {
@@ -532,25 +692,17 @@ void UserDefault::deleteValueForKey(const char* key)
         return;
     }
 
-    // find the node
-    node = getXMLNodeForKey(key, &rootNode, &doc);
-
-    // if node not exist, don't need to delete
-    if (!node)
-    {
-        CC_SAFE_DELETE(doc);
-        return;
-    }
+    s_store.deleteValue(key);
+}
 
-    // save file and free doc
-    if (doc)
-    {
-        doc->DeleteNode(node);
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
-    }
+void UserDefault::setBinaryFormatEnabled(bool enabled)
+{
+    s_store.setBinaryFormat(enabled);
+}
 
-    flush();
+bool UserDefault::isBinaryFormatEnabled()
+{
+    return s_store.isBinaryFormat();
 }
 
 NS_CC_END
@@ -47,6 +47,8 @@ NS_CC_BEGIN
  *
  * @warning: On windows, linux, use XML to store data, which means there are some limitations of
  * the key string, for example, `/` is not valid.
+ * The values are loaded once and kept in memory there, writes are saved on a background thread shortly after,
+ * call flush() to save them immediately.
  */
 class CC_DLL UserDefault
 {
@@ -254,6 +256,19 @@ public:
      */
     static bool isXMLFileExist();
 
+    /** On platforms using a xml file, store the values in a compact binary file instead.
+     * The values are still read from the xml file when the binary file does not exist yet, and saved to the binary file.
+     * Platforms storing the values natively ignore it.
+     * @param enabled True to use the binary file, it is false by default.
+     * @js NA
+     */
+    static void setBinaryFormatEnabled(bool enabled);
+
+    /** Whether the values are stored in the binary file, see setBinaryFormatEnabled().
+     * @js NA
+     */
+    static bool isBinaryFormatEnabled();
+
 protected:
     UserDefault();
     virtual ~UserDefault();
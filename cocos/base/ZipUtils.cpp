@@ -26,17 +26,14 @@
 
 #include "base/ZipUtils.h"
 
-#ifdef MINIZIP_FROM_SYSTEM
-#include <minizip/unzip.h>
-#else // from our embedded sources
-#include "unzip.h"
-#endif
-#include "ioapi_mem.h"
 #include <memory>
+#include <algorithm>
+#include <vector>
 
 #include <zlib.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <set>
 
 #include "base/CCData.h"
@@ -44,9 +41,15 @@
 #include "platform/CCFileUtils.h"
 #include <map>
 
-// minizip 1.2.0 is same with other platforms
-#define unzGoToFirstFile64(A,B,C,D) unzGoToFirstFile2(A,B,C,D, NULL, 0, NULL, 0)
-#define unzGoToNextFile64(A,B,C,D) unzGoToNextFile2(A,B,C,D, NULL, 0, NULL, 0)
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include "platform/win32/CCUtils-win32.h"
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CC_ZIPFILE_USE_MMAP
+#endif
 
 NS_CC_BEGIN
 
@@ -496,29 +499,363 @@ void ZipUtils::setPvrEncryptionKey(unsigned int keyPart1, unsigned int keyPart2,
 }
 
 // --------------------- ZipFile ---------------------
-// from unzip.cpp
-#define UNZ_MAXFILENAMEINZIP 256
 
 static const std::string emptyFilename("");
 
+#define ZIP_LOCAL_HEADER_SIGNATURE      0x04034b50
+#define ZIP_CENTRAL_HEADER_SIGNATURE    0x02014b50
+#define ZIP_END_SIGNATURE               0x06054b50
+#define ZIP64_END_SIGNATURE             0x06064b50
+#define ZIP64_END_LOCATOR_SIGNATURE     0x07064b50
+#define ZIP_LOCAL_HEADER_SIZE           30
+#define ZIP_CENTRAL_HEADER_SIZE         46
+#define ZIP_END_SIZE                    22
+#define ZIP64_END_LOCATOR_SIZE          20
+#define ZIP64_END_SIZE                  56
+#define ZIP_METHOD_STORED               0
+#define ZIP_METHOD_DEFLATED             8
+#define ZIP_FLAG_ENCRYPTED              0x1
+
+static inline uint16_t readZipU16(const unsigned char* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t readZipU32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t readZipU64(const unsigned char* p)
+{
+    return (uint64_t)readZipU32(p) | ((uint64_t)readZipU32(p + 4) << 32);
+}
+
 struct ZipEntryInfo
 {
-    unz_file_pos pos;
-    uLong uncompressed_size;
+    // the name is stored in ZipFilePrivate::names
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint64_t localHeaderOffset;
+    uint64_t compressedSize;
+    uint64_t uncompressedSize;
+    uint16_t method;
+    uint16_t flags;
 };
 
+/**
+ * The archive is mapped (or, for createWithBuffer, borrowed) as a whole and never modified,
+ * the central directory is parsed once into a name-sorted index. Reads only look at this
+ * immutable state and use their own inflate stream, so they can run on several threads at once.
+ */
 class ZipFilePrivate
 {
 public:
-    unzFile zipFile;
-    std::unique_ptr<ourmemory_s> memfs;
-    
-    // std::unordered_map is faster if available on the platform
-    typedef std::unordered_map<std::string, struct ZipEntryInfo> FileListContainer;
-    FileListContainer fileList;
+    ZipFilePrivate()
+    : data(nullptr)
+    , size(0)
+    , iterator(0)
+    {
+    }
+
+    bool init(std::shared_ptr<const unsigned char> archive, size_t archiveSize);
+
+    const ZipEntryInfo* findEntry(const std::string& fileName) const;
+    std::string getName(const ZipEntryInfo& entry) const { return names.substr(entry.nameOffset, entry.nameLength); }
+    bool isAccessible(const ZipEntryInfo& entry) const
+    {
+        return filter.empty() || (entry.nameLength >= filter.length()
+                                  && memcmp(names.data() + entry.nameOffset, filter.data(), filter.length()) == 0);
+    }
+    // Pointer to the (possibly compressed) data of an entry, nullptr if the entry is broken
+    const unsigned char* getEntryData(const ZipEntryInfo& entry) const;
+    bool readEntry(const ZipEntryInfo& entry, unsigned char* out) const;
+
+    std::shared_ptr<const unsigned char> archive;
+    const unsigned char* data;
+    size_t size;
+
+    // all names in one block, entries in archive order and their indices sorted by name
+    std::string names;
+    std::vector<ZipEntryInfo> entries;
+    std::vector<uint32_t> sortedEntries;
+
+    std::string filter;
+    // position of getFirstFilename/getNextFilename
+    size_t iterator;
+
+private:
+    bool parseCentralDirectory(uint64_t offset, uint64_t cdSize, uint64_t count);
+    int compareName(uint32_t index, const char* name, size_t length) const
+    {
+        const ZipEntryInfo& entry = entries[index];
+        int ret = memcmp(names.data() + entry.nameOffset, name, std::min((size_t)entry.nameLength, length));
+        if (ret != 0)
+            return ret;
+        return entry.nameLength < length ? -1 : (entry.nameLength > length ? 1 : 0);
+    }
 };
 
-ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
+bool ZipFilePrivate::init(std::shared_ptr<const unsigned char> archiveData, size_t archiveSize)
+{
+    archive = std::move(archiveData);
+    data = archive.get();
+    size = archiveSize;
+    if (!data || size < ZIP_END_SIZE)
+        return false;
+
+    // The end of central directory record is followed by a comment of at most 64KB
+    size_t searchStart = size > ZIP_END_SIZE + 0xFFFF ? size - ZIP_END_SIZE - 0xFFFF : 0;
+    size_t end = size - ZIP_END_SIZE + 1;
+    const unsigned char* record = nullptr;
+    while (end-- > searchStart)
+    {
+        if (readZipU32(data + end) == ZIP_END_SIGNATURE)
+        {
+            record = data + end;
+            break;
+        }
+    }
+    if (!record)
+        return false;
+
+    uint64_t count = readZipU16(record + 10);
+    uint64_t cdSize = readZipU32(record + 12);
+    uint64_t cdOffset = readZipU32(record + 16);
+
+    // Zip64 archives keep the real values in another record in front of a locator
+    size_t recordOffset = record - data;
+    if (recordOffset >= ZIP64_END_LOCATOR_SIZE
+        && readZipU32(record - ZIP64_END_LOCATOR_SIZE) == ZIP64_END_LOCATOR_SIGNATURE)
+    {
+        uint64_t zip64Offset = readZipU64(record - ZIP64_END_LOCATOR_SIZE + 8);
+        if (zip64Offset <= size - ZIP64_END_SIZE && readZipU32(data + zip64Offset) == ZIP64_END_SIGNATURE)
+        {
+            const unsigned char* zip64Record = data + zip64Offset;
+            count = readZipU64(zip64Record + 32);
+            cdSize = readZipU64(zip64Record + 40);
+            cdOffset = readZipU64(zip64Record + 48);
+        }
+    }
+
+    return parseCentralDirectory(cdOffset, cdSize, count);
+}
+
+bool ZipFilePrivate::parseCentralDirectory(uint64_t offset, uint64_t cdSize, uint64_t count)
+{
+    if (offset > size || cdSize > size - offset || count > cdSize / ZIP_CENTRAL_HEADER_SIZE)
+        return false;
+
+    entries.reserve((size_t)count);
+    const unsigned char* p = data + offset;
+    const unsigned char* end = p + cdSize;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        if (end - p < ZIP_CENTRAL_HEADER_SIZE || readZipU32(p) != ZIP_CENTRAL_HEADER_SIGNATURE)
+            return false;
+
+        uint16_t nameLength = readZipU16(p + 28);
+        uint16_t extraLength = readZipU16(p + 30);
+        uint16_t commentLength = readZipU16(p + 32);
+        size_t headerSize = ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+        if ((size_t)(end - p) < headerSize)
+            return false;
+
+        ZipEntryInfo entry;
+        entry.flags = readZipU16(p + 8);
+        entry.method = readZipU16(p + 10);
+        entry.compressedSize = readZipU32(p + 20);
+        entry.uncompressedSize = readZipU32(p + 24);
+        entry.localHeaderOffset = readZipU32(p + 42);
+        entry.nameOffset = (uint32_t)names.size();
+        entry.nameLength = nameLength;
+        names.append((const char*)p + ZIP_CENTRAL_HEADER_SIZE, nameLength);
+
+        // Zip64 extra field, only the values which overflowed are present, in this order
+        const unsigned char* extra = p + ZIP_CENTRAL_HEADER_SIZE + nameLength;
+        const unsigned char* extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4)
+        {
+            uint16_t id = readZipU16(extra);
+            uint16_t length = readZipU16(extra + 2);
+            const unsigned char* field = extra + 4;
+            if (extraEnd - field < length)
+                break;
+            if (id == 0x0001)
+            {
+                const unsigned char* fieldEnd = field + length;
+                if (entry.uncompressedSize == 0xFFFFFFFF && fieldEnd - field >= 8) { entry.uncompressedSize = readZipU64(field); field += 8; }
+                if (entry.compressedSize == 0xFFFFFFFF && fieldEnd - field >= 8) { entry.compressedSize = readZipU64(field); field += 8; }
+                if (entry.localHeaderOffset == 0xFFFFFFFF && fieldEnd - field >= 8) { entry.localHeaderOffset = readZipU64(field); }
+                break;
+            }
+            extra = field + length;
+        }
+
+        entries.push_back(entry);
+        p += headerSize;
+    }
+
+    sortedEntries.resize(entries.size());
+    for (size_t i = 0; i < sortedEntries.size(); ++i)
+    {
+        sortedEntries[i] = (uint32_t)i;
+    }
+    std::stable_sort(sortedEntries.begin(), sortedEntries.end(), [this](uint32_t a, uint32_t b) {
+        const ZipEntryInfo& entry = entries[b];
+        return compareName(a, names.data() + entry.nameOffset, entry.nameLength) < 0;
+    });
+    return true;
+}
+
+const ZipEntryInfo* ZipFilePrivate::findEntry(const std::string& fileName) const
+{
+    auto it = std::lower_bound(sortedEntries.begin(), sortedEntries.end(), fileName, [this](uint32_t index, const std::string& name) {
+        return compareName(index, name.data(), name.length()) < 0;
+    });
+    if (it == sortedEntries.end() || compareName(*it, fileName.data(), fileName.length()) != 0)
+        return nullptr;
+
+    // like minizip, the last entry wins if a name was added twice
+    while ((it + 1) != sortedEntries.end() && compareName(*(it + 1), fileName.data(), fileName.length()) == 0)
+        ++it;
+
+    const ZipEntryInfo& entry = entries[*it];
+    return isAccessible(entry) ? &entry : nullptr;
+}
+
+const unsigned char* ZipFilePrivate::getEntryData(const ZipEntryInfo& entry) const
+{
+    if (entry.flags & ZIP_FLAG_ENCRYPTED)
+        return nullptr;
+
+    uint64_t offset = entry.localHeaderOffset;
+    if (offset > size || size - offset < ZIP_LOCAL_HEADER_SIZE || readZipU32(data + offset) != ZIP_LOCAL_HEADER_SIGNATURE)
+        return nullptr;
+
+    // name and extra field of the local header may differ from the central directory
+    offset += ZIP_LOCAL_HEADER_SIZE + readZipU16(data + offset + 26) + readZipU16(data + offset + 28);
+    if (offset > size || size - offset < entry.compressedSize)
+        return nullptr;
+
+    return data + offset;
+}
+
+bool ZipFilePrivate::readEntry(const ZipEntryInfo& entry, unsigned char* out) const
+{
+    const unsigned char* in = getEntryData(entry);
+    if (!in)
+        return false;
+
+    // out may be nullptr for empty files
+    if (entry.uncompressedSize == 0)
+        return true;
+
+    if (entry.method == ZIP_METHOD_STORED)
+    {
+        if (entry.compressedSize != entry.uncompressedSize)
+            return false;
+        memcpy(out, in, (size_t)entry.uncompressedSize);
+        return true;
+    }
+
+    if (entry.method != ZIP_METHOD_DEFLATED)
+    {
+        CCLOG("ZipFile: unsupported compression method %d", (int)entry.method);
+        return false;
+    }
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // raw deflate data without zlib header
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+
+    // zlib counts in uInt, feed entries larger than that piecewise
+    const uint64_t maxChunk = 0x40000000;
+    uint64_t inputLeft = entry.compressedSize;
+    uint64_t outputLeft = entry.uncompressedSize;
+    stream.next_in = const_cast<Bytef*>(in);
+    stream.next_out = out;
+    int err;
+    do
+    {
+        if (stream.avail_in == 0)
+        {
+            stream.avail_in = (uInt)std::min(inputLeft, maxChunk);
+            inputLeft -= stream.avail_in;
+        }
+        if (stream.avail_out == 0)
+        {
+            stream.avail_out = (uInt)std::min(outputLeft, maxChunk);
+            outputLeft -= stream.avail_out;
+        }
+        err = inflate(&stream, Z_NO_FLUSH);
+    } while (err == Z_OK
+             || (err == Z_BUF_ERROR && ((stream.avail_in == 0 && inputLeft > 0) || (stream.avail_out == 0 && outputLeft > 0))));
+    inflateEnd(&stream);
+
+    return err == Z_STREAM_END && stream.avail_out == 0 && outputLeft == 0;
+}
+
+// Maps the archive read-only, nullptr if the file can't be mapped
+static std::shared_ptr<const unsigned char> mapZipFile(const std::string& path, size_t* size)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    HANDLE file = CreateFileW(StringUtf8ToWideChar(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return nullptr;
+
+    // the view keeps the mapping alive
+    void* addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!addr)
+        return nullptr;
+
+    *size = static_cast<size_t>(fileSize.QuadPart);
+    return std::shared_ptr<const unsigned char>(static_cast<const unsigned char*>(addr), [](const unsigned char* p) {
+        UnmapViewOfFile(p);
+    });
+#elif defined(CC_ZIPFILE_USE_MMAP)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    size_t length = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return nullptr;
+
+    *size = length;
+    return std::shared_ptr<const unsigned char>(static_cast<const unsigned char*>(addr), [length](const unsigned char* p) {
+        munmap(const_cast<unsigned char*>(p), length);
+    });
+#else
+    return nullptr;
+#endif
+}
+
+ZipFile *ZipFile::createWithBuffer(const void* buffer, unsigned long size)
 {
     ZipFile *zip = new (std::nothrow) ZipFile();
     if (zip && zip->initWithBuffer(buffer, size)) {
@@ -532,23 +869,34 @@ ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
 ZipFile::ZipFile()
 : _data(new ZipFilePrivate)
 {
-    _data->zipFile = nullptr;
 }
 
 ZipFile::ZipFile(const std::string &zipFile, const std::string &filter)
 : _data(new ZipFilePrivate)
 {
-    _data->zipFile = unzOpen(FileUtils::getInstance()->getSuitableFOpen(zipFile).c_str());
+    size_t size = 0;
+    std::shared_ptr<const unsigned char> archive = mapZipFile(zipFile, &size);
+    if (!archive)
+    {
+        // not mappable on this platform, keep the whole archive in memory instead
+        Data data = FileUtils::getInstance()->getDataFromFile(zipFile);
+        if (!data.isNull())
+        {
+            ssize_t dataSize = 0;
+            archive.reset(data.takeBuffer(&dataSize), free);
+            size = static_cast<size_t>(dataSize);
+        }
+    }
+
+    if (!_data->init(std::move(archive), size))
+    {
+        CCLOG("ZipFile: can not open zip file %s", zipFile.c_str());
+    }
     setFilter(filter);
 }
 
 ZipFile::~ZipFile()
 {
-    if (_data && _data->zipFile)
-    {
-        unzClose(_data->zipFile);
-    }
-
     CC_SAFE_DELETE(_data);
 }
 
@@ -558,39 +906,10 @@ bool ZipFile::setFilter(const std::string &filter)
     do
     {
         CC_BREAK_IF(!_data);
-        CC_BREAK_IF(!_data->zipFile);
+        CC_BREAK_IF(!_data->data);
         
-        // clear existing file list
-        _data->fileList.clear();
-        
-        // UNZ_MAXFILENAMEINZIP + 1 - it is done so in unzLocateFile
-        char szCurrentFileName[UNZ_MAXFILENAMEINZIP + 1];
-        unz_file_info64 fileInfo;
-        
-        // go through all files and store position information about the required files
-        int err = unzGoToFirstFile64(_data->zipFile, &fileInfo,
-                                     szCurrentFileName, sizeof(szCurrentFileName) - 1);
-        while (err == UNZ_OK)
-        {
-            unz_file_pos posInfo;
-            int posErr = unzGetFilePos(_data->zipFile, &posInfo);
-            if (posErr == UNZ_OK)
-            {
-                std::string currentFileName = szCurrentFileName;
-                // cache info about filtered files only (like 'assets/')
-                if (filter.empty()
-                    || currentFileName.substr(0, filter.length()) == filter)
-                {
-                    ZipEntryInfo entry;
-                    entry.pos = posInfo;
-                    entry.uncompressed_size = (uLong)fileInfo.uncompressed_size;
-                    _data->fileList[currentFileName] = entry;
-                }
-            }
-            // next file - also get the information about it
-            err = unzGoToNextFile64(_data->zipFile, &fileInfo,
-                                    szCurrentFileName, sizeof(szCurrentFileName) - 1);
-        }
+        // entries outside of the filter are skipped by lookups, the index stays as it is
+        _data->filter = filter;
         ret = true;
         
     } while(false);
@@ -605,7 +924,7 @@ bool ZipFile::fileExists(const std::string &fileName) const
     {
         CC_BREAK_IF(!_data);
         
-        ret = _data->fileList.find(fileName) != _data->fileList.end();
+        ret = _data->findEntry(fileName) != nullptr;
     } while(false);
     
     return ret;
@@ -618,27 +937,37 @@ std::vector<std::string> ZipFile::listFiles(const std::string &pathname) const
     // then make each path unique
 
     std::set<std::string> fileSet;
-    ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.begin();
-    ZipFilePrivate::FileListContainer::const_iterator end = _data->fileList.end();
     //ensure pathname ends with `/` as a directory
     std::string dirname = pathname[pathname.length() -1] == '/' ? pathname : pathname + "/";
-    while(it != end)
+
+    // names with this prefix are next to each other in the sorted index
+    const std::string& names = _data->names;
+    auto it = std::lower_bound(_data->sortedEntries.begin(), _data->sortedEntries.end(), dirname, [this, &names](uint32_t index, const std::string& name) {
+        const ZipEntryInfo& entry = _data->entries[index];
+        return names.compare(entry.nameOffset, entry.nameLength, name) < 0;
+    });
+    for (; it != _data->sortedEntries.end(); ++it)
     {
-        const std::string &filename = it->first;
-        if(filename.substr(0, dirname.length()) == dirname)
+        const ZipEntryInfo& entry = _data->entries[*it];
+        if (entry.nameLength < dirname.length() || names.compare(entry.nameOffset, dirname.length(), dirname) != 0)
         {
-            std::string suffix = filename.substr(dirname.length());
-            auto pos = suffix.find('/');
-            if (pos == std::string::npos)
-            {
-                fileSet.insert(suffix);
-            }
-            else {
-                //fileSet.insert(parts[0] + "/");
-                fileSet.insert(suffix.substr(0, pos + 1));
-            }
+            break;
+        }
+        if (!_data->isAccessible(entry))
+        {
+            continue;
+        }
+
+        std::string suffix = names.substr(entry.nameOffset + dirname.length(), entry.nameLength - dirname.length());
+        auto pos = suffix.find('/');
+        if (pos == std::string::npos)
+        {
+            fileSet.insert(suffix);
+        }
+        else {
+            //fileSet.insert(parts[0] + "/");
+            fileSet.insert(suffix.substr(0, pos + 1));
         }
-        it++;
     }
 
     return std::vector<std::string>(fileSet.begin(), fileSet.end());
@@ -652,29 +981,25 @@ unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
 
     do
     {
-        CC_BREAK_IF(!_data->zipFile);
         CC_BREAK_IF(fileName.empty());
         
-        ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
-        CC_BREAK_IF(it ==  _data->fileList.end());
+        const ZipEntryInfo* fileInfo = _data->findEntry(fileName);
+        CC_BREAK_IF(!fileInfo);
         
-        ZipEntryInfo fileInfo = it->second;
-        
-        int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        nRet = unzOpenCurrentFile(_data->zipFile);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        buffer = (unsigned char*)malloc(fileInfo.uncompressed_size);
-        int CC_UNUSED nSize = unzReadCurrentFile(_data->zipFile, buffer, static_cast<unsigned int>(fileInfo.uncompressed_size));
-        CCASSERT(nSize == 0 || nSize == (int)fileInfo.uncompressed_size, "the file size is wrong");
+        buffer = (unsigned char*)malloc((size_t)fileInfo->uncompressedSize);
+        CC_BREAK_IF(!buffer);
+        if (!_data->readEntry(*fileInfo, buffer))
+        {
+            CCLOG("ZipFile: can not read %s", fileName.c_str());
+            free(buffer);
+            buffer = nullptr;
+            break;
+        }
         
         if (size)
         {
-            *size = fileInfo.uncompressed_size;
+            *size = (ssize_t)fileInfo->uncompressedSize;
         }
-        unzCloseCurrentFile(_data->zipFile);
     } while (0);
     
     return buffer;
@@ -685,76 +1010,75 @@ bool ZipFile::getFileData(const std::string &fileName, ResizableBuffer* buffer)
     bool res = false;
     do
     {
-        CC_BREAK_IF(!_data->zipFile);
         CC_BREAK_IF(fileName.empty());
         
-        ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
-        CC_BREAK_IF(it ==  _data->fileList.end());
+        const ZipEntryInfo* fileInfo = _data->findEntry(fileName);
+        CC_BREAK_IF(!fileInfo);
         
-        ZipEntryInfo fileInfo = it->second;
-        
-        int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        nRet = unzOpenCurrentFile(_data->zipFile);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        buffer->resize(fileInfo.uncompressed_size);
-        int CC_UNUSED nSize = unzReadCurrentFile(_data->zipFile, buffer->buffer(), static_cast<unsigned int>(fileInfo.uncompressed_size));
-        CCASSERT(nSize == 0 || nSize == (int)fileInfo.uncompressed_size, "the file size is wrong");
-        unzCloseCurrentFile(_data->zipFile);
-        res = true;
+        buffer->resize((size_t)fileInfo->uncompressedSize);
+        res = _data->readEntry(*fileInfo, (unsigned char*)buffer->buffer());
+        if (!res)
+        {
+            CCLOG("ZipFile: can not read %s", fileName.c_str());
+        }
     } while (0);
     
     return res;
 }
 
+const unsigned char *ZipFile::getStoredFileData(const std::string &fileName, ssize_t *size) const
+{
+    if (size)
+        *size = 0;
+
+    const ZipEntryInfo* fileInfo = _data->findEntry(fileName);
+    if (!fileInfo || fileInfo->method != ZIP_METHOD_STORED || fileInfo->compressedSize != fileInfo->uncompressedSize)
+        return nullptr;
+
+    const unsigned char* data = _data->getEntryData(*fileInfo);
+    if (data && size)
+    {
+        *size = (ssize_t)fileInfo->uncompressedSize;
+    }
+    return data;
+}
+
 std::string ZipFile::getFirstFilename()
 {
-    if (unzGoToFirstFile(_data->zipFile) != UNZ_OK) return emptyFilename;
-    std::string path;
-    unz_file_info info;
-    getCurrentFileInfo(&path, &info);
-    return path;
+    _data->iterator = 0;
+    return getNextAccessibleFilename();
 }
 
 std::string ZipFile::getNextFilename()
 {
-    if (unzGoToNextFile(_data->zipFile) != UNZ_OK) return emptyFilename;
-    std::string path;
-    unz_file_info info;
-    getCurrentFileInfo(&path, &info);
-    return path;
+    if (_data->iterator < _data->entries.size())
+    {
+        ++_data->iterator;
+    }
+    return getNextAccessibleFilename();
 }
 
-int ZipFile::getCurrentFileInfo(std::string *filename, unz_file_info *info)
+std::string ZipFile::getNextAccessibleFilename()
 {
-    char path[FILENAME_MAX + 1];
-    int ret = unzGetCurrentFileInfo(_data->zipFile, info, path, sizeof(path), nullptr, 0, nullptr, 0);
-    if (ret != UNZ_OK) {
-        *filename = emptyFilename;
-    } else {
-        filename->assign(path);
+    while (_data->iterator < _data->entries.size())
+    {
+        const ZipEntryInfo& entry = _data->entries[_data->iterator];
+        if (_data->isAccessible(entry))
+        {
+            return _data->getName(entry);
+        }
+        ++_data->iterator;
     }
-    return ret;
+    return emptyFilename;
 }
 
-bool ZipFile::initWithBuffer(const void *buffer, uLong size)
+bool ZipFile::initWithBuffer(const void *buffer, unsigned long size)
 {
     if (!buffer || size == 0) return false;
 
-    zlib_filefunc_def memory_file = { 0 };
-    
-    std::unique_ptr<ourmemory_t> memfs(new(std::nothrow) ourmemory_t{ (char*)const_cast<void*>(buffer), static_cast<uint32_t>(size), 0, 0, 0 });
-    if (!memfs) return false;
-    fill_memory_filefunc(&memory_file, memfs.get());
-    
-    _data->zipFile = unzOpen2(nullptr, &memory_file);
-    if (!_data->zipFile) return false;
-    _data->memfs = std::move(memfs);
-
-    setFilter(emptyFilename);
-    return true;
+    // the caller keeps ownership of the buffer
+    std::shared_ptr<const unsigned char> archive(static_cast<const unsigned char*>(buffer), [](const unsigned char*) {});
+    return _data->init(std::move(archive), size);
 }
 
 NS_CC_END
@@ -46,9 +46,6 @@ THE SOFTWARE.
 
 namespace cocos2d
 {
-#ifndef _unz64_H
-typedef struct unz_file_info_s unz_file_info;
-#endif
     /** XXX: pragma pack ???
      * @struct CCZHeader
      */
@@ -219,13 +216,14 @@ typedef struct unz_file_info_s unz_file_info;
 
     // forward declaration
     class ZipFilePrivate;
-    struct unz_file_info_s;
 
     /**
     * Zip file - reader helper class.
     *
-    * It will cache the file list of a particular zip file with positions inside an archive,
-    * so it would be much faster to read some particular files or to check their existence.
+    * The archive is memory mapped where the platform supports it and its central directory is
+    * indexed once by file name, so it is fast to read some particular files or to check their existence.
+    * fileExists, listFiles, getFileData and getStoredFileData don't modify the ZipFile and may be
+    * called from several threads at the same time, setFilter and getFirstFilename/getNextFilename may not.
     *
     * @since v2.0.5
     */
@@ -245,7 +243,7 @@ typedef struct unz_file_info_s unz_file_info;
         virtual ~ZipFile();
 
         /**
-        * Regenerate accessible file list based on a new filter string.
+        * Change the accessible files based on a new filter string.
         *
         * @param filter New filter string (first part of files names)
         * @return true whenever zip file is open successfully and it is possible to locate
@@ -294,6 +292,15 @@ typedef struct unz_file_info_s unz_file_info;
         */
         bool getFileData(const std::string &fileName, ResizableBuffer* buffer);
 
+        /**
+        * Get the data of an uncompressed file without copying it.
+        * @param fileName File name
+        * @param[out] size If the file is found and stored without compression, it will be the data size, otherwise 0.
+        * @return A pointer into the archive, valid as long as the ZipFile lives, or nullptr if the file
+        *         doesn't exist or is compressed. Use getFileData for compressed files.
+        */
+        const unsigned char *getStoredFileData(const std::string &fileName, ssize_t *size) const;
+
         std::string getFirstFilename();
         std::string getNextFilename();
         
@@ -304,7 +311,7 @@ typedef struct unz_file_info_s unz_file_info;
         ZipFile();
         
         bool initWithBuffer(const void *buffer, unsigned long size);
-        int getCurrentFileInfo(std::string *filename, unz_file_info *info);
+        std::string getNextAccessibleFilename();
         
         /** Internal data like zip file pointer / file list array and so on */
         ZipFilePrivate *_data;
@@ -279,6 +279,7 @@ THE SOFTWARE.
 #include "3d/CCOBB.h"
 #include "3d/CCPlane.h"
 #include "3d/CCRay.h"
+#include "3d/CCSceneBVH.h"
 #include "3d/CCSkeleton3D.h"
 #include "3d/CCSkybox.h"
 #include "3d/CCSprite3D.h"
@@ -25,6 +25,8 @@ THE SOFTWARE.
 
 #include "editor-support/cocostudio/ActionTimeline/CCActionTimeline.h"
 
+#include <algorithm>
+#include <typeinfo>
 #include <utility>
 
 #include "editor-support/cocostudio/CCComExtensionData.h"
@@ -33,6 +35,8 @@ USING_NS_CC;
 
 NS_TIMELINE_BEGIN
 
+static bool s_channelsEnabled = true;
+
 // ActionTimelineData
 ActionTimelineData* ActionTimelineData::create(int actionTag)
 {
@@ -84,6 +88,8 @@ ActionTimeline::ActionTimeline()
     , _endFrame(0)
     , _frameEventListener(nullptr)
     , _lastFrameListener(nullptr)
+    , _channelsDirty(true)
+    , _channelsUsed(false)
 {
 }
 
@@ -269,6 +275,8 @@ void ActionTimeline::startWithTarget(Node *target)
             }
         }
     });
+
+    _channelsDirty = true;
 }
 
 void ActionTimeline::addTimeline(Timeline* timeline)
@@ -284,6 +292,7 @@ void ActionTimeline::addTimeline(Timeline* timeline)
         _timelineList.pushBack(timeline);
         _timelineMap[tag].pushBack(timeline);
         timeline->setActionTimeline(this);
+        _channelsDirty = true;
     }
 }
 
@@ -297,6 +306,7 @@ void ActionTimeline::removeTimeline(Timeline* timeline)
             _timelineMap[tag].eraseObject(timeline);
             _timelineList.eraseObject(timeline);
             timeline->setActionTimeline(nullptr);
+            _channelsDirty = true;
         }
     }
 }
@@ -428,19 +438,260 @@ void ActionTimeline::gotoFrame(int frameIndex)
     if(_target == nullptr)
         return;
 
+    // Switching between channels and timelines leaves the other side behind, a seek resyncs both.
+    if (_channelsUsed != s_channelsEnabled)
+    {
+        _channelsUsed = s_channelsEnabled;
+        _channelsDirty = true;
+    }
+    if (_channelsUsed && _channelsDirty)
+    {
+        buildChannels();
+    }
+
     ssize_t size = _timelineList.size();
     for(ssize_t i = 0; i < size; i++)
-    {      
-        _timelineList.at(i)->gotoFrame(frameIndex);
+    {
+        int channel = _channelsUsed ? _timelineChannels[i] : -1;
+        if (channel >= 0)
+        {
+            updateChannel(_channels[channel], frameIndex, true);
+        }
+        else
+        {
+            _timelineList.at(i)->gotoFrame(frameIndex);
+        }
     }
 }
 
 void ActionTimeline::stepToFrame(int frameIndex)
 {
+    if (_channelsUsed != s_channelsEnabled)
+    {
+        gotoFrame(frameIndex);
+        return;
+    }
+    if (_channelsUsed && _channelsDirty)
+    {
+        buildChannels();
+    }
+
     ssize_t size = _timelineList.size();
     for(ssize_t i = 0; i < size; i++)
-    {      
-        _timelineList.at(i)->stepToFrame(frameIndex);
+    {
+        int channel = _channelsUsed ? _timelineChannels[i] : -1;
+        if (channel >= 0)
+        {
+            updateChannel(_channels[channel], frameIndex, false);
+        }
+        else
+        {
+            _timelineList.at(i)->stepToFrame(frameIndex);
+        }
+    }
+}
+
+void ActionTimeline::setChannelsEnabled(bool enabled)
+{
+    s_channelsEnabled = enabled;
+}
+
+bool ActionTimeline::isChannelsEnabled()
+{
+    return s_channelsEnabled;
+}
+
+void ActionTimeline::buildChannels()
+{
+    _channels.clear();
+    _channelKeys.clear();
+    _timelineChannels.clear();
+
+    for (auto timeline : _timelineList)
+    {
+        _timelineChannels.push_back(buildChannel(timeline) ? (int)_channels.size() - 1 : -1);
+    }
+
+    _channelsDirty = false;
+}
+
+bool ActionTimeline::buildChannel(Timeline* timeline)
+{
+    const auto& frames = timeline->getFrames();
+    if (frames.empty() || frames.at(0)->getNode() == nullptr)
+    {
+        return false;
+    }
+
+    // Only the engine's own frame classes are compiled, a subclass may override onEnter or onApply.
+    Channel channel;
+    const std::type_info& frameType = typeid(*frames.at(0));
+    if (frameType == typeid(PositionFrame))
+        channel.type = ChannelType::POSITION;
+    else if (frameType == typeid(ScaleFrame))
+        channel.type = ChannelType::SCALE;
+    else if (frameType == typeid(RotationFrame))
+        channel.type = ChannelType::ROTATION;
+    else if (frameType == typeid(SkewFrame))
+        channel.type = ChannelType::SKEW;
+    else if (frameType == typeid(RotationSkewFrame))
+        channel.type = ChannelType::ROTATION_SKEW;
+    else if (frameType == typeid(AnchorPointFrame))
+        channel.type = ChannelType::ANCHOR_POINT;
+    else if (frameType == typeid(AlphaFrame))
+        channel.type = ChannelType::ALPHA;
+    else if (frameType == typeid(ColorFrame))
+        channel.type = ChannelType::COLOR;
+    else
+        return false;
+
+    channel.node = frames.at(0)->getNode();
+    channel.firstKey = (int)_channelKeys.size();
+    channel.keyCount = (int)frames.size();
+    channel.cursor = 0;
+    channel.constant = true;
+    channel.applied = false;
+
+    for (auto frame : frames)
+    {
+        // Timeline finds its key frames by binary search, which needs them in order as well
+        if (typeid(*frame) != frameType || frame->getNode() != channel.node
+            || (_channelKeys.size() > (size_t)channel.firstKey && frame->getFrameIndex() <= _channelKeys.back().frameIndex))
+        {
+            _channelKeys.resize(channel.firstKey);
+            return false;
+        }
+
+        ChannelKey key;
+        key.frameIndex = frame->getFrameIndex();
+        key.tween = frame->isTween();
+        key.tweenType = frame->getTweenType();
+        key.value[0] = key.value[1] = key.value[2] = 0;
+        key.frame = frame;
+
+        switch (channel.type)
+        {
+            case ChannelType::POSITION:
+                key.value[0] = static_cast<PositionFrame*>(frame)->getX();
+                key.value[1] = static_cast<PositionFrame*>(frame)->getY();
+                break;
+            case ChannelType::SCALE:
+                key.value[0] = static_cast<ScaleFrame*>(frame)->getScaleX();
+                key.value[1] = static_cast<ScaleFrame*>(frame)->getScaleY();
+                break;
+            case ChannelType::ROTATION:
+                key.value[0] = static_cast<RotationFrame*>(frame)->getRotation();
+                break;
+            case ChannelType::SKEW:
+            case ChannelType::ROTATION_SKEW:
+                key.value[0] = static_cast<SkewFrame*>(frame)->getSkewX();
+                key.value[1] = static_cast<SkewFrame*>(frame)->getSkewY();
+                break;
+            case ChannelType::ANCHOR_POINT:
+                key.value[0] = static_cast<AnchorPointFrame*>(frame)->getAnchorPoint().x;
+                key.value[1] = static_cast<AnchorPointFrame*>(frame)->getAnchorPoint().y;
+                break;
+            case ChannelType::ALPHA:
+                key.value[0] = static_cast<AlphaFrame*>(frame)->getAlpha();
+                break;
+            case ChannelType::COLOR:
+                key.value[0] = static_cast<ColorFrame*>(frame)->getColor().r;
+                key.value[1] = static_cast<ColorFrame*>(frame)->getColor().g;
+                key.value[2] = static_cast<ColorFrame*>(frame)->getColor().b;
+                break;
+        }
+
+        if (_channelKeys.size() > (size_t)channel.firstKey)
+        {
+            const ChannelKey& first = _channelKeys[channel.firstKey];
+            channel.constant = channel.constant && std::equal(key.value, key.value + 3, first.value);
+        }
+        _channelKeys.push_back(key);
+    }
+
+    _channels.push_back(channel);
+    return true;
+}
+
+void ActionTimeline::updateChannel(Channel& channel, unsigned int frameIndex, bool seek)
+{
+    // Like Timeline::gotoFrame, a seek always writes the property, other code may have changed it meanwhile
+    if (!seek && channel.constant && channel.applied)
+    {
+        return;
+    }
+
+    const ChannelKey* keys = _channelKeys.data() + channel.firstKey;
+
+    if (seek || frameIndex < keys[channel.cursor].frameIndex)
+    {
+        // last key at or before frameIndex, or the first key if frameIndex is before all of them
+        auto key = std::upper_bound(keys, keys + channel.keyCount, frameIndex,
+                                    [](unsigned int index, const ChannelKey& key) { return index < key.frameIndex; });
+        channel.cursor = key == keys ? 0 : (int)(key - keys) - 1;
+    }
+    else
+    {
+        while (channel.cursor + 1 < channel.keyCount && keys[channel.cursor + 1].frameIndex <= frameIndex)
+        {
+            ++channel.cursor;
+        }
+    }
+
+    // Same arithmetic as the frames: key value plus the tweened difference to the next key
+    const ChannelKey& from = keys[channel.cursor];
+    float value[3] = { from.value[0], from.value[1], from.value[2] };
+    if (from.tween && frameIndex > from.frameIndex && channel.cursor + 1 < channel.keyCount)
+    {
+        const ChannelKey& to = keys[channel.cursor + 1];
+        float percent = (frameIndex - from.frameIndex) / (float)(to.frameIndex - from.frameIndex);
+        if (from.tweenType != tweenfunc::TWEEN_EASING_MAX && from.tweenType != tweenfunc::Linear)
+        {
+            percent = tweenfunc::tweenTo(percent, from.tweenType, const_cast<float*>(from.frame->getEasingParams().data()));
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            value[i] = from.value[i] + (to.value[i] - from.value[i]) * percent;
+        }
+    }
+
+    if (!seek && channel.applied && std::equal(value, value + 3, channel.value))
+    {
+        return;
+    }
+    std::copy(value, value + 3, channel.value);
+    channel.applied = true;
+
+    Node* node = channel.node;
+    switch (channel.type)
+    {
+        case ChannelType::POSITION:
+            node->setPosition(Vec2(value[0], value[1]));
+            break;
+        case ChannelType::SCALE:
+            node->setScaleX(value[0]);
+            node->setScaleY(value[1]);
+            break;
+        case ChannelType::ROTATION:
+            node->setRotation(value[0]);
+            break;
+        case ChannelType::SKEW:
+            node->setSkewX(value[0]);
+            node->setSkewY(value[1]);
+            break;
+        case ChannelType::ROTATION_SKEW:
+            node->setRotationSkewX(value[0]);
+            node->setRotationSkewY(value[1]);
+            break;
+        case ChannelType::ANCHOR_POINT:
+            node->setAnchorPoint(Vec2(value[0], value[1]));
+            break;
+        case ChannelType::ALPHA:
+            node->setOpacity((GLubyte)value[0]);
+            break;
+        case ChannelType::COLOR:
+            node->setColor(Color3B((GLubyte)value[0], (GLubyte)value[1], (GLubyte)value[2]));
+            break;
     }
 }
 
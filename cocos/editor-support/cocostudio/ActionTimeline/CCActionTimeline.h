@@ -205,10 +205,62 @@ public:
     virtual void stop() override;
     /// @} end of PlayableProtocol
 
+    /**
+     * Whether position, scale, rotation, skew, anchor point, opacity and color timelines are
+     * compiled into flat key arrays and evaluated without going through Timeline and Frame.
+     * A compiled property is only set on the node when its value changed. Enabled by default.
+     */
+    static void setChannelsEnabled(bool enabled);
+    static bool isChannelsEnabled();
+
+    /** Compile the timelines again before the next frame, call it after changing the values of frames. */
+    void invalidateChannels() { _channelsDirty = true; }
+
 protected:
     virtual void gotoFrame(int frameIndex);
     virtual void stepToFrame(int frameIndex);
 
+    enum class ChannelType
+    {
+        POSITION,
+        SCALE,
+        ROTATION,
+        SKEW,
+        ROTATION_SKEW,
+        ANCHOR_POINT,
+        ALPHA,
+        COLOR,
+    };
+
+    struct ChannelKey
+    {
+        unsigned int frameIndex;
+        bool tween;
+        cocos2d::tweenfunc::TweenType tweenType;
+        float value[3];
+        // only read for the easing params
+        Frame* frame;
+    };
+
+    /* A compiled timeline: its keys are a range of _channelKeys. */
+    struct Channel
+    {
+        ChannelType type;
+        cocos2d::Node* node;
+        int firstKey;
+        int keyCount;
+        // key the current frame is in, it only moves forward while the action plays
+        int cursor;
+        // every key has the same value, nothing to do once it was applied
+        bool constant;
+        bool applied;
+        float value[3];
+    };
+
+    void buildChannels();
+    bool buildChannel(Timeline* timeline);
+    void updateChannel(Channel& channel, unsigned int frameIndex, bool seek);
+
     // emit call back after frameIndex played
     virtual void emitFrameEndCallFuncs(int frameIndex);
 
@@ -232,6 +284,13 @@ protected:
     std::function<void()> _lastFrameListener;
     std::map<int, std::map<std::string, std::function<void()> > > _frameEndCallFuncs;
     std::map<std::string, AnimationInfo> _animationInfos;
+
+    std::vector<Channel> _channels;
+    std::vector<ChannelKey> _channelKeys;
+    // channel index of every timeline in _timelineList, -1 for timelines that are not compiled
+    std::vector<int> _timelineChannels;
+    bool _channelsDirty;
+    bool _channelsUsed;
 };
 
 NS_TIMELINE_END
@@ -94,18 +94,27 @@ void Timeline::addFrame(Frame* frame)
 {
     _frames.pushBack(frame);
     frame->setTimeline(this);
+
+    if (_ActionTimeline)
+        _ActionTimeline->invalidateChannels();
 }
 
 void Timeline::insertFrame(Frame* frame, int index)
 {
     _frames.insert(index, frame);
     frame->setTimeline(this);
+
+    if (_ActionTimeline)
+        _ActionTimeline->invalidateChannels();
 }
 
 void Timeline::removeFrame(Frame* frame)
 {
     _frames.eraseObject(frame);
     frame->setTimeline(nullptr);
+
+    if (_ActionTimeline)
+        _ActionTimeline->invalidateChannels();
 }
 
 void Timeline::setNode(Node* node)
@@ -114,6 +123,9 @@ void Timeline::setNode(Node* node)
     {
         frame->setNode(node);
     }
+
+    if (_ActionTimeline)
+        _ActionTimeline->invalidateChannels();
 }
 
 Node* Timeline::getNode() const
@@ -198,6 +198,7 @@ CSLoader::CSLoader()
 , _monoCocos2dxVersion("")
 , _rootNode(nullptr)
 , _csBuildID("2.1.0.0")
+, _flatBuffersCacheEnabled(true)
 {
     CREATE_CLASS_NODE_READER_INFO(NodeReader);
     CREATE_CLASS_NODE_READER_INFO(SingleNodeReader);
@@ -951,6 +952,19 @@ Node* CSLoader::nodeWithFlatBuffersFile(const std::string &fileName, const ccNod
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(fileName);
     
+    if (_flatBuffersCacheEnabled)
+    {
+        auto entry = getFlatBuffersCacheEntry(fullPath);
+        if (!entry)
+        {
+            CCLOG("CSLoader::nodeWithFlatBuffersFile - failed read file: %s", fileName.c_str());
+            CC_ASSERT(false);
+            return nullptr;
+        }
+        
+        return nodeWithFlatBuffersCacheEntry(*entry, callback);
+    }
+    
     CC_ASSERT(FileUtils::getInstance()->isFileExist(fullPath));
     
     Data buf = FileUtils::getInstance()->getDataFromFile(fullPath);
@@ -1010,44 +1024,19 @@ Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree *nodetree, const
         
         std::string classname = nodetree->classname()->c_str();
         
-        auto options = nodetree->options();
-        
         if (classname == "ProjectNode")
         {
-            auto reader = ProjectNodeReader::getInstance();
-            auto projectNodeOptions = (ProjectNodeOptions*)options->data();
+            auto projectNodeOptions = (ProjectNodeOptions*)nodetree->options()->data();
             std::string filePath = projectNodeOptions->fileName()->c_str();
-            
-            cocostudio::timeline::ActionTimeline* action = nullptr;
-            if (!filePath.empty() && FileUtils::getInstance()->isFileExist(filePath))
-            {
-                Data buf = FileUtils::getInstance()->getDataFromFile(filePath);
-                node = createNode(buf, callback);
-                action = createTimeline(buf, filePath);
-            }
-            else
+            if (!filePath.empty() && !FileUtils::getInstance()->isFileExist(filePath))
             {
-                node = Node::create();
-            }
-            reader->setPropsWithFlatBuffers(node, options->data());
-            if (action)
-            {
-                action->setTimeSpeed(projectNodeOptions->innerActionSpeed());
-                node->runAction(action);
-                action->gotoFrameAndPause(0);
+                filePath.clear();
             }
+            node = createProjectNode(nodetree, filePath, callback);
         }
         else if (classname == "SimpleAudio")
         {
-            node = Node::create();
-            auto reader = ComAudioReader::getInstance();
-            Component* component = reader->createComAudioWithFlatBuffers(options->data());
-            if (component)
-            {
-                component->setName(PlayableFrame::PLAYABLE_EXTENTION);
-                node->addComponent(component);
-                reader->setPropsWithFlatBuffers(node, options->data());
-            }
+            node = createSimpleAudioNode(nodetree);
         }
         else
         {
@@ -1056,33 +1045,8 @@ Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree *nodetree, const
             {
                 classname = customClassName;
             }
-            std::string readername = getGUIClassName(classname);
-            readername.append("Reader");
-            
-            NodeReaderProtocol* reader = dynamic_cast<NodeReaderProtocol*>(ObjectFactory::getInstance()->createObject(readername));
-            if (reader)
-            {
-                node = reader->createNodeWithFlatBuffers(options->data());
-            }
-            
-            Widget* widget = dynamic_cast<Widget*>(node);
-            if (widget)
-            {
-                std::string callbackName = widget->getCallbackName();
-                std::string callbackType = widget->getCallbackType();
-                
-                bindCallback(callbackName, callbackType, widget, _rootNode);
-            }
             
-            /* To reconstruct nest node as WidgetCallBackHandlerProtocol. */
-            auto callbackHandler = dynamic_cast<WidgetCallBackHandlerProtocol *>(node);
-            if (callbackHandler)
-            {
-                _callbackHandlers.pushBack(node);
-                _rootNode = _callbackHandlers.back();
-            }
-            /**/
-            //        _loadingNodeParentHierarchy.push_back(node);
+            node = createNodeWithReader(getNodeReader(classname), nodetree);
         }
         
         // If node is invalid, there is no necessity to process children of node.
@@ -1099,42 +1063,330 @@ Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree *nodetree, const
             Node* child = nodeWithFlatBuffers(subNodeTree, callback);
             if (child)
             {
-                PageView* pageView = dynamic_cast<PageView*>(node);
-                ListView* listView = dynamic_cast<ListView*>(node);
-                if (pageView)
-                {
-                    Layout* layout = dynamic_cast<Layout*>(child);
-                    if (layout)
-                    {
-                        pageView->addPage(layout);
-                    }
-                }
-                else if (listView)
-                {
-                    Widget* widget = dynamic_cast<Widget*>(child);
-                    if (widget)
-                    {
-                        listView->pushBackCustomItem(widget);
-                    }
-                }
-                else
-                {
-                    node->addChild(child);
-                }
-                
-                if (callback)
-                {
-                    callback(child);
-                }
+                addFlatBuffersChild(node, child, callback);
             }
         }
         
-        //    _loadingNodeParentHierarchy.pop_back();
-        
         return node;
     }
 }
 
+Node* CSLoader::createProjectNode(const flatbuffers::NodeTree *nodetree, const std::string &filePath, const ccNodeLoadCallback &callback)
+{
+    Node* node = nullptr;
+    
+    auto options = nodetree->options();
+    auto reader = ProjectNodeReader::getInstance();
+    auto projectNodeOptions = (ProjectNodeOptions*)options->data();
+    
+    cocostudio::timeline::ActionTimeline* action = nullptr;
+    if (!filePath.empty())
+    {
+        if (_flatBuffersCacheEnabled)
+        {
+            auto entry = getFlatBuffersCacheEntry(FileUtils::getInstance()->fullPathForFilename(filePath));
+            if (entry)
+            {
+                node = nodeWithFlatBuffersCacheEntry(*entry, callback);
+                reconstructNestNode(node);
+                action = createTimeline(entry->data, filePath);
+            }
+        }
+        else
+        {
+            Data buf = FileUtils::getInstance()->getDataFromFile(filePath);
+            node = createNode(buf, callback);
+            action = createTimeline(buf, filePath);
+        }
+    }
+    if (!node)
+    {
+        node = Node::create();
+    }
+    reader->setPropsWithFlatBuffers(node, options->data());
+    if (action)
+    {
+        action->setTimeSpeed(projectNodeOptions->innerActionSpeed());
+        node->runAction(action);
+        action->gotoFrameAndPause(0);
+    }
+    
+    return node;
+}
+
+Node* CSLoader::createSimpleAudioNode(const flatbuffers::NodeTree *nodetree)
+{
+    auto options = nodetree->options();
+    
+    Node* node = Node::create();
+    auto reader = ComAudioReader::getInstance();
+    Component* component = reader->createComAudioWithFlatBuffers(options->data());
+    if (component)
+    {
+        component->setName(PlayableFrame::PLAYABLE_EXTENTION);
+        node->addComponent(component);
+        reader->setPropsWithFlatBuffers(node, options->data());
+    }
+    
+    return node;
+}
+
+Node* CSLoader::createNodeWithReader(NodeReaderProtocol *reader, const flatbuffers::NodeTree *nodetree)
+{
+    Node* node = nullptr;
+    
+    if (reader)
+    {
+        node = reader->createNodeWithFlatBuffers(nodetree->options()->data());
+    }
+    
+    Widget* widget = dynamic_cast<Widget*>(node);
+    if (widget)
+    {
+        std::string callbackName = widget->getCallbackName();
+        std::string callbackType = widget->getCallbackType();
+        
+        bindCallback(callbackName, callbackType, widget, _rootNode);
+    }
+    
+    /* To reconstruct nest node as WidgetCallBackHandlerProtocol. */
+    auto callbackHandler = dynamic_cast<WidgetCallBackHandlerProtocol *>(node);
+    if (callbackHandler)
+    {
+        _callbackHandlers.pushBack(node);
+        _rootNode = _callbackHandlers.back();
+    }
+    /**/
+    
+    return node;
+}
+
+void CSLoader::addFlatBuffersChild(Node *node, Node *child, const ccNodeLoadCallback &callback)
+{
+    PageView* pageView = dynamic_cast<PageView*>(node);
+    ListView* listView = dynamic_cast<ListView*>(node);
+    if (pageView)
+    {
+        Layout* layout = dynamic_cast<Layout*>(child);
+        if (layout)
+        {
+            pageView->addPage(layout);
+        }
+    }
+    else if (listView)
+    {
+        Widget* widget = dynamic_cast<Widget*>(child);
+        if (widget)
+        {
+            listView->pushBackCustomItem(widget);
+        }
+    }
+    else
+    {
+        node->addChild(child);
+    }
+    
+    if (callback)
+    {
+        callback(child);
+    }
+}
+
+NodeReaderProtocol* CSLoader::getNodeReader(const std::string &classname)
+{
+    auto iter = _nodeReaders.find(classname);
+    if (iter != _nodeReaders.end())
+    {
+        return iter->second;
+    }
+    
+    std::string readername = getGUIClassName(classname);
+    readername.append("Reader");
+    
+    NodeReaderProtocol* reader = dynamic_cast<NodeReaderProtocol*>(ObjectFactory::getInstance()->createObject(readername));
+    // Unknown readers are not remembered, they may still be registered to ObjectFactory later.
+    if (reader)
+    {
+        _nodeReaders[classname] = reader;
+    }
+    
+    return reader;
+}
+
+void CSLoader::setFlatBuffersCacheEnabled(bool enabled)
+{
+    _flatBuffersCacheEnabled = enabled;
+    
+    if (!enabled)
+    {
+        removeAllFlatBuffersCache();
+    }
+}
+
+void CSLoader::removeFlatBuffersCache(const std::string &filename)
+{
+    _flatBuffersCache.erase(FileUtils::getInstance()->fullPathForFilename(filename));
+}
+
+void CSLoader::removeAllFlatBuffersCache()
+{
+    _flatBuffersCache.clear();
+}
+
+std::shared_ptr<CSLoader::FlatBuffersCacheEntry> CSLoader::getFlatBuffersCacheEntry(const std::string &fullPath)
+{
+    auto iter = _flatBuffersCache.find(fullPath);
+    if (iter != _flatBuffersCache.end())
+    {
+        return iter->second;
+    }
+    
+    if (fullPath.empty())
+    {
+        return nullptr;
+    }
+    
+    Data buf = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (buf.isNull())
+    {
+        return nullptr;
+    }
+    
+    // The buffer is verified once here, instances created from the cache trust it.
+    flatbuffers::Verifier verifier(buf.getBytes(), buf.getSize());
+    if (!VerifyCSParseBinaryBuffer(verifier))
+    {
+        CCLOG("CSLoader::getFlatBuffersCacheEntry - invalid csb file: %s", fullPath.c_str());
+        return nullptr;
+    }
+    
+    auto entry = std::make_shared<FlatBuffersCacheEntry>();
+    entry->data = std::move(buf);
+    initNodeTemplate(entry->root, GetCSParseBinary(entry->data.getBytes())->nodeTree());
+    
+    _flatBuffersCache[fullPath] = entry;
+    
+    return entry;
+}
+
+void CSLoader::initNodeTemplate(NodeTemplate &nodeTemplate, const flatbuffers::NodeTree *nodetree)
+{
+    nodeTemplate.type = NodeTemplate::Type::READER;
+    nodeTemplate.nodeTree = nodetree;
+    nodeTemplate.reader = nullptr;
+    
+    if (nodetree == nullptr)
+        return;
+    
+    std::string classname = nodetree->classname()->c_str();
+    
+    if (classname == "ProjectNode")
+    {
+        nodeTemplate.type = NodeTemplate::Type::PROJECT_NODE;
+        
+        auto projectNodeOptions = (ProjectNodeOptions*)nodetree->options()->data();
+        std::string filePath = projectNodeOptions->fileName()->c_str();
+        if (!filePath.empty() && FileUtils::getInstance()->isFileExist(filePath))
+        {
+            nodeTemplate.projectFileName = filePath;
+        }
+    }
+    else if (classname == "SimpleAudio")
+    {
+        nodeTemplate.type = NodeTemplate::Type::SIMPLE_AUDIO;
+    }
+    else
+    {
+        std::string customClassName = nodetree->customClassName()->c_str();
+        if (!customClassName.empty())
+        {
+            classname = customClassName;
+        }
+        
+        nodeTemplate.reader = getNodeReader(classname);
+        // Nodes without reader are not created, neither are their children.
+        if (!nodeTemplate.reader)
+            return;
+    }
+    
+    auto children = nodetree->children();
+    int size = children->size();
+    nodeTemplate.children.resize(size);
+    for (int i = 0; i < size; ++i)
+    {
+        initNodeTemplate(nodeTemplate.children[i], children->Get(i));
+    }
+}
+
+Node* CSLoader::nodeWithFlatBuffersCacheEntry(const FlatBuffersCacheEntry &entry, const ccNodeLoadCallback &callback)
+{
+    auto csparsebinary = GetCSParseBinary(entry.data.getBytes());
+    
+    auto csBuildId = csparsebinary->version();
+    if (csBuildId)
+    {
+        CCASSERT(strcmp(_csBuildID.c_str(), csBuildId->c_str()) == 0,
+                 StringUtils::format("%s%s%s%s%s%s%s%s%s%s",
+                                          "The reader build id of your Cocos exported file(",
+                                          csBuildId->c_str(),
+                                          ") and the reader build id in your Cocos2d-x(",
+                                          _csBuildID.c_str(),
+                                          ") are not match.\n",
+                                          "Please get the correct reader(build id ",
+                                          csBuildId->c_str(),
+                                          ")from ",
+                                          "http://www.cocos2d-x.org/filedown/cocos-reader",
+                                          " and replace it in your Cocos2d-x").c_str());
+    }
+    
+    // decode plist, the frames may have been removed from the cache since the last load
+    auto textures = csparsebinary->textures();
+    int textureSize = textures->size();
+    for (int i = 0; i < textureSize; ++i)
+    {
+        SpriteFrameCache::getInstance()->addSpriteFramesWithFile(textures->Get(i)->c_str());
+    }
+    
+    return nodeWithNodeTemplate(entry.root, callback);
+}
+
+Node* CSLoader::nodeWithNodeTemplate(const NodeTemplate &nodeTemplate, const ccNodeLoadCallback &callback)
+{
+    if (nodeTemplate.nodeTree == nullptr)
+        return nullptr;
+    
+    Node* node = nullptr;
+    
+    switch (nodeTemplate.type)
+    {
+        case NodeTemplate::Type::PROJECT_NODE:
+            node = createProjectNode(nodeTemplate.nodeTree, nodeTemplate.projectFileName, callback);
+            break;
+        case NodeTemplate::Type::SIMPLE_AUDIO:
+            node = createSimpleAudioNode(nodeTemplate.nodeTree);
+            break;
+        default:
+            node = createNodeWithReader(nodeTemplate.reader, nodeTemplate.nodeTree);
+            break;
+    }
+    
+    if (!node)
+    {
+        return nullptr;
+    }
+    
+    for (const auto& childTemplate : nodeTemplate.children)
+    {
+        Node* child = nodeWithNodeTemplate(childTemplate, callback);
+        if (child)
+        {
+            addFlatBuffersChild(node, child, callback);
+        }
+    }
+    
+    return node;
+}
+
 bool CSLoader::bindCallback(const std::string &callbackName,
                             const std::string &callbackType,
                             cocos2d::ui::Widget *sender,
@@ -1321,6 +1573,10 @@ void CSLoader::registReaderObject(const std::string &className,
     t._fun = ins;
     
     ObjectFactory::getInstance()->registerType(t);
+    
+    // a reader may be replaced, resolve the readers again
+    _nodeReaders.clear();
+    removeAllFlatBuffersCache();
 }
 
 Node* CSLoader::createNodeWithFlatBuffersForSimulator(const std::string& filename)
@@ -33,6 +33,8 @@
 #include "base/CCData.h"
 #include "ui/UIWidget.h"
 
+#include <memory>
+
 namespace flatbuffers
 {
     class FlatBufferBuilder;
@@ -53,6 +55,7 @@ namespace flatbuffers
 namespace cocostudio
 {
     class ComAudio;
+    class NodeReaderProtocol;
 }
 
 namespace cocostudio
@@ -119,6 +122,19 @@ public:
     
     cocos2d::Node* createNodeWithFlatBuffersForSimulator(const std::string& filename);
     cocos2d::Node* nodeWithFlatBuffersForSimulator(const flatbuffers::NodeTree* nodetree);
+    
+    /**
+     * Keep the verified content of every loaded .csb file, together with a node template that
+     * has its readers resolved, so that creating the same file again costs no file reading,
+     * no verification and no reader lookup. Nested project nodes are cached the same way.
+     * Enabled by default; disabling it also clears the cache.
+     */
+    void setFlatBuffersCacheEnabled(bool enabled);
+    bool isFlatBuffersCacheEnabled() const { return _flatBuffersCacheEnabled; }
+    
+    /** Remove the cached content of a .csb file, e.g. after it was replaced by a hot update. */
+    void removeFlatBuffersCache(const std::string& filename);
+    void removeAllFlatBuffersCache();
 
 protected:
 
@@ -154,6 +170,43 @@ protected:
     
     inline void reconstructNestNode(cocos2d::Node * node);
     static inline std::string getExtentionName(const std::string& name);
+    
+    /* Node tree of a cached .csb file with the reader of every node resolved up front. */
+    struct NodeTemplate
+    {
+        enum class Type
+        {
+            READER,
+            PROJECT_NODE,
+            SIMPLE_AUDIO,
+        };
+        
+        Type type;
+        const flatbuffers::NodeTree* nodeTree;
+        cocostudio::NodeReaderProtocol* reader;
+        // file name of a project node, empty if the file does not exist
+        std::string projectFileName;
+        std::vector<NodeTemplate> children;
+    };
+    
+    struct FlatBuffersCacheEntry
+    {
+        Data data;
+        NodeTemplate root;
+    };
+    
+    std::shared_ptr<FlatBuffersCacheEntry> getFlatBuffersCacheEntry(const std::string& fullPath);
+    void initNodeTemplate(NodeTemplate& nodeTemplate, const flatbuffers::NodeTree* nodetree);
+    cocos2d::Node* nodeWithFlatBuffersCacheEntry(const FlatBuffersCacheEntry& entry, const ccNodeLoadCallback& callback);
+    cocos2d::Node* nodeWithNodeTemplate(const NodeTemplate& nodeTemplate, const ccNodeLoadCallback& callback);
+    
+    cocos2d::Node* createProjectNode(const flatbuffers::NodeTree* nodetree, const std::string& filePath, const ccNodeLoadCallback& callback);
+    cocos2d::Node* createSimpleAudioNode(const flatbuffers::NodeTree* nodetree);
+    cocos2d::Node* createNodeWithReader(cocostudio::NodeReaderProtocol* reader, const flatbuffers::NodeTree* nodetree);
+    void addFlatBuffersChild(cocos2d::Node* node, cocos2d::Node* child, const ccNodeLoadCallback& callback);
+    
+    /* Readers by class name as stored in the .csb file, replaces the per node ObjectFactory lookup. */
+    cocostudio::NodeReaderProtocol* getNodeReader(const std::string& classname);
 
     typedef std::function<cocos2d::Node*(const rapidjson::Value& json)> NodeCreateFunc;
     typedef std::pair<std::string, NodeCreateFunc> Pair;
@@ -176,6 +229,10 @@ protected:
     
     std::string _csBuildID;
     
+    bool _flatBuffersCacheEnabled;
+    std::unordered_map<std::string, std::shared_ptr<FlatBuffersCacheEntry>> _flatBuffersCache;
+    std::unordered_map<std::string, cocostudio::NodeReaderProtocol*> _nodeReaders;
+    
 };
 
 NS_CC_END
@@ -25,6 +25,7 @@ CCDisplayManager.cpp \
 CCSkin.cpp \
 CCColliderDetector.cpp \
 CCArmatureDataManager.cpp \
+CCArmatureBinary.cpp \
 CCArmatureDefine.cpp \
 CCDataReaderHelper.cpp \
 CCSpriteFrameCacheHelper.cpp \
@@ -0,0 +1,778 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "editor-support/cocostudio/CCArmatureBinary.h"
+
+#include <string.h>
+#include <stdint.h>
+#include <unordered_map>
+
+using namespace cocos2d;
+
+namespace cocostudio {
+
+/*
+ *  File layout: FileHeader, string offsets (uint32 each), string bytes,
+ *  then one array per record type in the order of the counts in FileHeader,
+ *  then the easing parameter/contour vertex floats and the config file
+ *  string indices. String index 0 is always the empty string.
+ */
+
+static const char ARMATURE_BINARY_MAGIC[4] = { 'C', 'S', 'A', 'B' };
+static const uint32_t ARMATURE_BINARY_VERSION = 1;
+
+struct FileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t stringCount;
+    uint32_t stringBytes;
+    uint32_t armatureCount;
+    uint32_t boneCount;
+    uint32_t displayCount;
+    uint32_t animationCount;
+    uint32_t movementCount;
+    uint32_t movementBoneCount;
+    uint32_t frameCount;
+    uint32_t textureCount;
+    uint32_t contourCount;
+    uint32_t floatCount;
+    uint32_t configFileCount;
+};
+
+struct NodeRecord
+{
+    float x;
+    float y;
+    float skewX;
+    float skewY;
+    float scaleX;
+    float scaleY;
+    float tweenRotate;
+    int32_t zOrder;
+    int32_t isUseColorInfo;
+    int32_t a, r, g, b;
+};
+
+struct ArmatureRecord
+{
+    uint32_t name;
+    float dataVersion;
+    uint32_t firstBone;
+    uint32_t boneCount;
+};
+
+struct BoneRecord
+{
+    NodeRecord node;
+    uint32_t name;
+    int32_t parent;             //! index among the bones of the same armature, -1 for a root bone
+    uint32_t firstDisplay;
+    uint32_t displayCount;
+};
+
+struct DisplayRecord
+{
+    NodeRecord skin;
+    int32_t displayType;
+    uint32_t name;
+};
+
+struct AnimationRecord
+{
+    uint32_t name;
+    uint32_t firstMovement;
+    uint32_t movementCount;
+};
+
+struct MovementRecord
+{
+    uint32_t name;
+    int32_t duration;
+    float scale;
+    int32_t durationTo;
+    int32_t durationTween;
+    int32_t loop;
+    int32_t tweenEasing;
+    uint32_t firstBone;
+    uint32_t boneCount;
+};
+
+struct MovementBoneRecord
+{
+    uint32_t name;
+    float delay;
+    float scale;
+    float duration;
+    uint32_t firstFrame;
+    uint32_t frameCount;
+};
+
+struct FrameRecord
+{
+    NodeRecord node;
+    int32_t frameID;
+    int32_t duration;
+    int32_t tweenEasing;
+    int32_t isTween;
+    int32_t displayIndex;
+    uint32_t blendSrc;
+    uint32_t blendDst;
+    uint32_t firstEasingParam;
+    uint32_t easingParamCount;
+    uint32_t event;
+    uint32_t movement;
+    uint32_t sound;
+    uint32_t soundEffect;
+};
+
+struct TextureRecord
+{
+    uint32_t name;
+    float width;
+    float height;
+    float pivotX;
+    float pivotY;
+    uint32_t firstContour;
+    uint32_t contourCount;
+};
+
+struct ContourRecord
+{
+    uint32_t firstFloat;
+    uint32_t vertexCount;
+};
+
+static void writeNode(const BaseData& node, NodeRecord& record)
+{
+    record.x = node.x;
+    record.y = node.y;
+    record.skewX = node.skewX;
+    record.skewY = node.skewY;
+    record.scaleX = node.scaleX;
+    record.scaleY = node.scaleY;
+    record.tweenRotate = node.tweenRotate;
+    record.zOrder = node.zOrder;
+    record.isUseColorInfo = node.isUseColorInfo;
+    record.a = node.a;
+    record.r = node.r;
+    record.g = node.g;
+    record.b = node.b;
+}
+
+static void readNode(const NodeRecord& record, BaseData& node)
+{
+    node.x = record.x;
+    node.y = record.y;
+    node.skewX = record.skewX;
+    node.skewY = record.skewY;
+    node.scaleX = record.scaleX;
+    node.scaleY = record.scaleY;
+    node.tweenRotate = record.tweenRotate;
+    node.zOrder = record.zOrder;
+    node.isUseColorInfo = record.isUseColorInfo != 0;
+    node.a = record.a;
+    node.r = record.r;
+    node.g = record.g;
+    node.b = record.b;
+}
+
+static bool startsWith(const std::string& str, const std::string& prefix)
+{
+    return !prefix.empty() && str.compare(0, prefix.size(), prefix) == 0;
+}
+
+namespace {
+
+class StringTable
+{
+public:
+    StringTable()
+    {
+        add("");
+    }
+
+    uint32_t add(const std::string& str)
+    {
+        auto iter = _indices.find(str);
+        if (iter != _indices.end())
+        {
+            return iter->second;
+        }
+
+        uint32_t index = (uint32_t)_offsets.size();
+        _offsets.push_back((uint32_t)_bytes.size());
+        _bytes.insert(_bytes.end(), str.begin(), str.end());
+        _bytes.push_back('\0');
+        _indices.emplace(str, index);
+        return index;
+    }
+
+    const std::vector<uint32_t>& getOffsets() const { return _offsets; }
+    const std::vector<char>& getBytes() const { return _bytes; }
+
+private:
+    std::unordered_map<std::string, uint32_t> _indices;
+    std::vector<uint32_t> _offsets;
+    std::vector<char> _bytes;
+};
+
+class BinaryReader
+{
+public:
+    BinaryReader(const unsigned char* bytes, ssize_t size)
+        : _bytes(bytes)
+        , _size(size > 0 ? (size_t)size : 0)
+        , _offset(0)
+    {
+    }
+
+    template <typename T>
+    bool read(std::vector<T>& out, uint32_t count)
+    {
+        if (count > (_size - _offset) / sizeof(T))
+        {
+            return false;
+        }
+        out.resize(count);
+        if (count > 0)
+        {
+            memcpy(out.data(), _bytes + _offset, count * sizeof(T));
+        }
+        _offset += count * sizeof(T);
+        return true;
+    }
+
+private:
+    const unsigned char* _bytes;
+    size_t _size;
+    size_t _offset;
+};
+
+template <typename T>
+void append(std::vector<unsigned char>& buffer, const std::vector<T>& items)
+{
+    if (!items.empty())
+    {
+        const unsigned char* begin = reinterpret_cast<const unsigned char*>(items.data());
+        buffer.insert(buffer.end(), begin, begin + items.size() * sizeof(T));
+    }
+}
+
+bool isRangeValid(uint32_t first, uint32_t count, size_t total)
+{
+    return (uint64_t)first + count <= total;
+}
+
+}
+
+bool ArmatureBinary::isArmatureBinary(const unsigned char* bytes, ssize_t size)
+{
+    return bytes != nullptr && size >= (ssize_t)sizeof(FileHeader) && memcmp(bytes, ARMATURE_BINARY_MAGIC, sizeof(ARMATURE_BINARY_MAGIC)) == 0;
+}
+
+bool ArmatureBinary::encode(const Content& content, const std::string& baseFilePath, Data& data)
+{
+    StringTable strings;
+    std::vector<ArmatureRecord> armatures;
+    std::vector<BoneRecord> bones;
+    std::vector<DisplayRecord> displays;
+    std::vector<AnimationRecord> animations;
+    std::vector<MovementRecord> movements;
+    std::vector<MovementBoneRecord> movementBones;
+    std::vector<FrameRecord> frames;
+    std::vector<TextureRecord> textures;
+    std::vector<ContourRecord> contours;
+    std::vector<float> floats;
+    std::vector<uint32_t> configFiles;
+
+    for (const auto& armatureData : content.armatureDatas)
+    {
+        ArmatureRecord armature;
+        armature.name = strings.add(armatureData->name);
+        armature.dataVersion = armatureData->dataVersion;
+        armature.firstBone = (uint32_t)bones.size();
+        armature.boneCount = (uint32_t)armatureData->boneDataDic.size();
+
+        // assign the bone indices first so parents can be referenced by index
+        std::unordered_map<std::string, int32_t> boneIndices;
+        std::vector<BoneData*> boneDatas;
+        for (const auto& element : armatureData->boneDataDic)
+        {
+            boneIndices.emplace(element.first, (int32_t)boneDatas.size());
+            boneDatas.push_back(element.second);
+        }
+
+        for (const auto& boneData : boneDatas)
+        {
+            BoneRecord bone;
+            writeNode(*boneData, bone.node);
+            bone.name = strings.add(boneData->name);
+
+            auto parent = boneIndices.find(boneData->parentName);
+            bone.parent = (boneData->parentName.empty() || parent == boneIndices.end()) ? -1 : parent->second;
+
+            bone.firstDisplay = (uint32_t)displays.size();
+            bone.displayCount = (uint32_t)boneData->displayDataList.size();
+            for (const auto& displayData : boneData->displayDataList)
+            {
+                DisplayRecord display;
+                writeNode(BaseData(), display.skin);
+                display.displayType = displayData->displayType;
+
+                std::string displayName = displayData->displayName;
+                switch (displayData->displayType)
+                {
+                case CS_DISPLAY_SPRITE:
+                    writeNode(static_cast<SpriteDisplayData*>(displayData)->skinData, display.skin);
+                    break;
+                case CS_DISPLAY_PARTICLE:
+                    if (startsWith(displayName, baseFilePath))
+                    {
+                        displayName = displayName.substr(baseFilePath.size());
+                    }
+                    break;
+                default:
+                    break;
+                }
+                display.name = strings.add(displayName);
+                displays.push_back(display);
+            }
+            bones.push_back(bone);
+        }
+        armatures.push_back(armature);
+    }
+
+    for (const auto& animationData : content.animationDatas)
+    {
+        AnimationRecord animation;
+        animation.name = strings.add(animationData->name);
+        animation.firstMovement = (uint32_t)movements.size();
+        animation.movementCount = 0;
+
+        for (const auto& movementName : animationData->movementNames)
+        {
+            MovementData *movementData = animationData->getMovement(movementName);
+            if (movementData == nullptr)
+            {
+                continue;
+            }
+
+            MovementRecord movement;
+            movement.name = strings.add(movementData->name);
+            movement.duration = movementData->duration;
+            movement.scale = movementData->scale;
+            movement.durationTo = movementData->durationTo;
+            movement.durationTween = movementData->durationTween;
+            movement.loop = movementData->loop;
+            movement.tweenEasing = movementData->tweenEasing;
+            movement.firstBone = (uint32_t)movementBones.size();
+            movement.boneCount = (uint32_t)movementData->movBoneDataDic.size();
+
+            for (const auto& element : movementData->movBoneDataDic)
+            {
+                MovementBoneData *movementBoneData = element.second;
+
+                MovementBoneRecord movementBone;
+                movementBone.name = strings.add(movementBoneData->name);
+                movementBone.delay = movementBoneData->delay;
+                movementBone.scale = movementBoneData->scale;
+                movementBone.duration = movementBoneData->duration;
+                movementBone.firstFrame = (uint32_t)frames.size();
+                movementBone.frameCount = (uint32_t)movementBoneData->frameList.size();
+
+                for (const auto& frameData : movementBoneData->frameList)
+                {
+                    FrameRecord frame;
+                    writeNode(*frameData, frame.node);
+                    frame.frameID = frameData->frameID;
+                    frame.duration = frameData->duration;
+                    frame.tweenEasing = frameData->tweenEasing;
+                    frame.isTween = frameData->isTween;
+                    frame.displayIndex = frameData->displayIndex;
+                    frame.blendSrc = frameData->blendFunc.src;
+                    frame.blendDst = frameData->blendFunc.dst;
+                    frame.firstEasingParam = (uint32_t)floats.size();
+                    frame.easingParamCount = frameData->easingParams ? (uint32_t)frameData->easingParamNumber : 0;
+                    floats.insert(floats.end(), frameData->easingParams, frameData->easingParams + frame.easingParamCount);
+                    frame.event = strings.add(frameData->strEvent);
+                    frame.movement = strings.add(frameData->strMovement);
+                    frame.sound = strings.add(frameData->strSound);
+                    frame.soundEffect = strings.add(frameData->strSoundEffect);
+                    frames.push_back(frame);
+                }
+                movementBones.push_back(movementBone);
+            }
+            movements.push_back(movement);
+            ++animation.movementCount;
+        }
+        animations.push_back(animation);
+    }
+
+    for (const auto& textureData : content.textureDatas)
+    {
+        TextureRecord texture;
+        texture.name = strings.add(textureData->name);
+        texture.width = textureData->width;
+        texture.height = textureData->height;
+        texture.pivotX = textureData->pivotX;
+        texture.pivotY = textureData->pivotY;
+        texture.firstContour = (uint32_t)contours.size();
+        texture.contourCount = (uint32_t)textureData->contourDataList.size();
+
+        for (const auto& contourData : textureData->contourDataList)
+        {
+            ContourRecord contour;
+            contour.firstFloat = (uint32_t)floats.size();
+            contour.vertexCount = (uint32_t)contourData->vertexList.size();
+            for (const auto& vertex : contourData->vertexList)
+            {
+                floats.push_back(vertex.x);
+                floats.push_back(vertex.y);
+            }
+            contours.push_back(contour);
+        }
+        textures.push_back(texture);
+    }
+
+    for (const auto& configFile : content.configFiles)
+    {
+        configFiles.push_back(strings.add(configFile));
+    }
+
+    FileHeader header;
+    memcpy(header.magic, ARMATURE_BINARY_MAGIC, sizeof(header.magic));
+    header.version = ARMATURE_BINARY_VERSION;
+    header.stringCount = (uint32_t)strings.getOffsets().size();
+    header.stringBytes = (uint32_t)strings.getBytes().size();
+    header.armatureCount = (uint32_t)armatures.size();
+    header.boneCount = (uint32_t)bones.size();
+    header.displayCount = (uint32_t)displays.size();
+    header.animationCount = (uint32_t)animations.size();
+    header.movementCount = (uint32_t)movements.size();
+    header.movementBoneCount = (uint32_t)movementBones.size();
+    header.frameCount = (uint32_t)frames.size();
+    header.textureCount = (uint32_t)textures.size();
+    header.contourCount = (uint32_t)contours.size();
+    header.floatCount = (uint32_t)floats.size();
+    header.configFileCount = (uint32_t)configFiles.size();
+
+    std::vector<unsigned char> buffer;
+    append(buffer, std::vector<FileHeader>(1, header));
+    append(buffer, strings.getOffsets());
+    append(buffer, strings.getBytes());
+    append(buffer, armatures);
+    append(buffer, bones);
+    append(buffer, displays);
+    append(buffer, animations);
+    append(buffer, movements);
+    append(buffer, movementBones);
+    append(buffer, frames);
+    append(buffer, textures);
+    append(buffer, contours);
+    append(buffer, floats);
+    append(buffer, configFiles);
+
+    data.copy(buffer.data(), buffer.size());
+    return true;
+}
+
+bool ArmatureBinary::decode(const unsigned char* bytes, ssize_t size, const std::string& baseFilePath, Content& content)
+{
+    if (!isArmatureBinary(bytes, size))
+    {
+        CCLOG("ArmatureBinary: not a precompiled armature file");
+        return false;
+    }
+
+    BinaryReader reader(bytes, size);
+
+    std::vector<FileHeader> headers;
+    reader.read(headers, 1);
+    const FileHeader& header = headers[0];
+    if (header.version != ARMATURE_BINARY_VERSION)
+    {
+        CCLOG("ArmatureBinary: unsupported version %u", header.version);
+        return false;
+    }
+
+    std::vector<uint32_t> stringOffsets;
+    std::vector<char> stringBytes;
+    std::vector<ArmatureRecord> armatures;
+    std::vector<BoneRecord> bones;
+    std::vector<DisplayRecord> displays;
+    std::vector<AnimationRecord> animations;
+    std::vector<MovementRecord> movements;
+    std::vector<MovementBoneRecord> movementBones;
+    std::vector<FrameRecord> frames;
+    std::vector<TextureRecord> textures;
+    std::vector<ContourRecord> contours;
+    std::vector<float> floats;
+    std::vector<uint32_t> configFiles;
+
+    bool valid = reader.read(stringOffsets, header.stringCount)
+        && reader.read(stringBytes, header.stringBytes)
+        && reader.read(armatures, header.armatureCount)
+        && reader.read(bones, header.boneCount)
+        && reader.read(displays, header.displayCount)
+        && reader.read(animations, header.animationCount)
+        && reader.read(movements, header.movementCount)
+        && reader.read(movementBones, header.movementBoneCount)
+        && reader.read(frames, header.frameCount)
+        && reader.read(textures, header.textureCount)
+        && reader.read(contours, header.contourCount)
+        && reader.read(floats, header.floatCount)
+        && reader.read(configFiles, header.configFileCount);
+
+    valid = valid && !stringOffsets.empty() && !stringBytes.empty() && stringBytes.back() == '\0';
+    for (size_t i = 0; valid && i < stringOffsets.size(); ++i)
+    {
+        valid = stringOffsets[i] < stringBytes.size();
+    }
+    if (!valid)
+    {
+        CCLOG("ArmatureBinary: file is truncated");
+        return false;
+    }
+
+    // every string index is checked here, so the lookups below can't go out of bounds
+    auto isStringValid = [&](uint32_t index) { return index < stringOffsets.size(); };
+    auto getString = [&](uint32_t index) { return &stringBytes[stringOffsets[index]]; };
+
+    for (const auto& armature : armatures)
+    {
+        valid = valid && isStringValid(armature.name) && isRangeValid(armature.firstBone, armature.boneCount, bones.size());
+    }
+    for (const auto& bone : bones)
+    {
+        valid = valid && isStringValid(bone.name) && isRangeValid(bone.firstDisplay, bone.displayCount, displays.size());
+    }
+    for (const auto& display : displays)
+    {
+        valid = valid && isStringValid(display.name);
+    }
+    for (const auto& animation : animations)
+    {
+        valid = valid && isStringValid(animation.name) && isRangeValid(animation.firstMovement, animation.movementCount, movements.size());
+    }
+    for (const auto& movement : movements)
+    {
+        valid = valid && isStringValid(movement.name) && isRangeValid(movement.firstBone, movement.boneCount, movementBones.size());
+    }
+    for (const auto& movementBone : movementBones)
+    {
+        valid = valid && isStringValid(movementBone.name) && isRangeValid(movementBone.firstFrame, movementBone.frameCount, frames.size());
+    }
+    for (const auto& frame : frames)
+    {
+        valid = valid && isRangeValid(frame.firstEasingParam, frame.easingParamCount, floats.size())
+            && isStringValid(frame.event) && isStringValid(frame.movement) && isStringValid(frame.sound) && isStringValid(frame.soundEffect);
+    }
+    for (const auto& texture : textures)
+    {
+        valid = valid && isStringValid(texture.name) && isRangeValid(texture.firstContour, texture.contourCount, contours.size());
+    }
+    for (const auto& contour : contours)
+    {
+        valid = valid && (uint64_t)contour.vertexCount * 2 <= floats.size() && isRangeValid(contour.firstFloat, contour.vertexCount * 2, floats.size());
+    }
+    for (const auto& configFile : configFiles)
+    {
+        valid = valid && isStringValid(configFile);
+    }
+    if (!valid)
+    {
+        CCLOG("ArmatureBinary: file is malformed");
+        return false;
+    }
+
+    for (const auto& armature : armatures)
+    {
+        ArmatureData *armatureData = new (std::nothrow) ArmatureData();
+        armatureData->init();
+        armatureData->name = getString(armature.name);
+        armatureData->dataVersion = armature.dataVersion;
+
+        const BoneRecord *armatureBones = bones.data() + armature.firstBone;
+        for (uint32_t i = 0; i < armature.boneCount; ++i)
+        {
+            const BoneRecord& bone = armatureBones[i];
+
+            BoneData *boneData = new (std::nothrow) BoneData();
+            boneData->init();
+            readNode(bone.node, *boneData);
+            boneData->name = getString(bone.name);
+            if (bone.parent >= 0 && (uint32_t)bone.parent < armature.boneCount)
+            {
+                boneData->parentName = getString(armatureBones[bone.parent].name);
+            }
+
+            for (uint32_t j = 0; j < bone.displayCount; ++j)
+            {
+                const DisplayRecord& display = displays[bone.firstDisplay + j];
+
+                DisplayData *displayData = nullptr;
+                switch (display.displayType)
+                {
+                case CS_DISPLAY_ARMATURE:
+                    displayData = new (std::nothrow) ArmatureDisplayData();
+                    displayData->displayName = getString(display.name);
+                    break;
+                case CS_DISPLAY_PARTICLE:
+                    displayData = new (std::nothrow) ParticleDisplayData();
+                    displayData->displayName = baseFilePath + getString(display.name);
+                    break;
+                default:
+                {
+                    SpriteDisplayData *spriteDisplayData = new (std::nothrow) SpriteDisplayData();
+                    spriteDisplayData->displayName = getString(display.name);
+                    readNode(display.skin, spriteDisplayData->skinData);
+                    displayData = spriteDisplayData;
+                    break;
+                }
+                }
+                displayData->displayType = (DisplayType)display.displayType;
+
+                boneData->addDisplayData(displayData);
+                displayData->release();
+            }
+
+            armatureData->addBoneData(boneData);
+            boneData->release();
+        }
+
+        content.armatureDatas.pushBack(armatureData);
+        armatureData->release();
+    }
+
+    for (const auto& animation : animations)
+    {
+        AnimationData *animationData = new (std::nothrow) AnimationData();
+        animationData->name = getString(animation.name);
+
+        for (uint32_t i = 0; i < animation.movementCount; ++i)
+        {
+            const MovementRecord& movement = movements[animation.firstMovement + i];
+
+            MovementData *movementData = new (std::nothrow) MovementData();
+            movementData->name = getString(movement.name);
+            movementData->duration = movement.duration;
+            movementData->scale = movement.scale;
+            movementData->durationTo = movement.durationTo;
+            movementData->durationTween = movement.durationTween;
+            movementData->loop = movement.loop != 0;
+            movementData->tweenEasing = (tweenfunc::TweenType)movement.tweenEasing;
+
+            for (uint32_t j = 0; j < movement.boneCount; ++j)
+            {
+                const MovementBoneRecord& movementBone = movementBones[movement.firstBone + j];
+
+                MovementBoneData *movementBoneData = new (std::nothrow) MovementBoneData();
+                movementBoneData->init();
+                movementBoneData->name = getString(movementBone.name);
+                movementBoneData->delay = movementBone.delay;
+                movementBoneData->scale = movementBone.scale;
+                movementBoneData->duration = movementBone.duration;
+                movementBoneData->frameList.reserve(movementBone.frameCount);
+
+                for (uint32_t k = 0; k < movementBone.frameCount; ++k)
+                {
+                    const FrameRecord& frame = frames[movementBone.firstFrame + k];
+
+                    FrameData *frameData = new (std::nothrow) FrameData();
+                    readNode(frame.node, *frameData);
+                    frameData->frameID = frame.frameID;
+                    frameData->duration = frame.duration;
+                    frameData->tweenEasing = (tweenfunc::TweenType)frame.tweenEasing;
+                    frameData->isTween = frame.isTween != 0;
+                    frameData->displayIndex = frame.displayIndex;
+                    frameData->blendFunc.src = (GLenum)frame.blendSrc;
+                    frameData->blendFunc.dst = (GLenum)frame.blendDst;
+                    if (frame.easingParamCount > 0)
+                    {
+                        frameData->easingParamNumber = (int)frame.easingParamCount;
+                        frameData->easingParams = new (std::nothrow) float[frame.easingParamCount];
+                        memcpy(frameData->easingParams, floats.data() + frame.firstEasingParam, frame.easingParamCount * sizeof(float));
+                    }
+                    frameData->strEvent = getString(frame.event);
+                    frameData->strMovement = getString(frame.movement);
+                    frameData->strSound = getString(frame.sound);
+                    frameData->strSoundEffect = getString(frame.soundEffect);
+
+                    movementBoneData->addFrameData(frameData);
+                    frameData->release();
+                }
+
+                movementData->addMovementBoneData(movementBoneData);
+                movementBoneData->release();
+            }
+
+            animationData->addMovement(movementData);
+            movementData->release();
+        }
+
+        content.animationDatas.pushBack(animationData);
+        animationData->release();
+    }
+
+    for (const auto& texture : textures)
+    {
+        TextureData *textureData = new (std::nothrow) TextureData();
+        textureData->init();
+        textureData->name = getString(texture.name);
+        textureData->width = texture.width;
+        textureData->height = texture.height;
+        textureData->pivotX = texture.pivotX;
+        textureData->pivotY = texture.pivotY;
+
+        for (uint32_t i = 0; i < texture.contourCount; ++i)
+        {
+            const ContourRecord& contour = contours[texture.firstContour + i];
+
+            ContourData *contourData = new (std::nothrow) ContourData();
+            contourData->init();
+            contourData->vertexList.reserve(contour.vertexCount);
+            for (uint32_t j = 0; j < contour.vertexCount; ++j)
+            {
+                const float *vertex = floats.data() + contour.firstFloat + j * 2;
+                contourData->vertexList.push_back(Vec2(vertex[0], vertex[1]));
+            }
+
+            textureData->addContourData(contourData);
+            contourData->release();
+        }
+
+        content.textureDatas.pushBack(textureData);
+        textureData->release();
+    }
+
+    for (const auto& configFile : configFiles)
+    {
+        content.configFiles.push_back(getString(configFile));
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,81 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCARMATUREBINARY_H__
+#define __CCARMATUREBINARY_H__
+
+#include "base/CCData.h"
+#include "editor-support/cocostudio/CCDatas.h"
+#include "editor-support/cocostudio/CocosStudioExport.h"
+
+#include <string>
+#include <vector>
+
+namespace cocostudio {
+
+/**
+ *  @brief  Reads and writes precompiled armature files (.csab).
+ *
+ *  A precompiled file holds the same armature, animation and texture data as
+ *  the .ExportJson/.csb it was saved from, already scaled and converted, so it
+ *  can be loaded without a parse tree. All names live in one string table and
+ *  are referenced by index, bones refer to their parent by bone index, and
+ *  every kind of record (bones, frames, easing parameters, ...) is stored in
+ *  one contiguous array per file.
+ *
+ *  Files are written by ArmatureDataManager::saveArmatureFileInfoBinary and
+ *  loaded by ArmatureDataManager::addArmatureFileInfo like any other config file.
+ *  They use the byte order of the device that wrote them.
+ *
+ *  @js NA
+ *  @lua NA
+ */
+class CC_STUDIO_DLL ArmatureBinary
+{
+public:
+    struct Content
+    {
+        cocos2d::Vector<ArmatureData*> armatureDatas;
+        cocos2d::Vector<AnimationData*> animationDatas;
+        cocos2d::Vector<TextureData*> textureDatas;
+        //! sprite sheet plists, relative to the config file
+        std::vector<std::string> configFiles;
+    };
+
+    /**
+     *  @brief  Serialize content. Particle display paths starting with baseFilePath are stored relative to it.
+     */
+    static bool encode(const Content& content, const std::string& baseFilePath, cocos2d::Data& data);
+
+    /**
+     *  @brief  Rebuild the datas of a precompiled file. Returns false if the file is truncated or malformed.
+     */
+    static bool decode(const unsigned char* bytes, ssize_t size, const std::string& baseFilePath, Content& content);
+
+    static bool isArmatureBinary(const unsigned char* bytes, ssize_t size);
+};
+
+}
+
+#endif /*__CCARMATUREBINARY_H__*/
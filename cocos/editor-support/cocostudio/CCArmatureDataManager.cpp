@@ -24,11 +24,13 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "2d/CCSpriteFrameCache.h"
+#include "platform/CCFileUtils.h"
 
 #include "editor-support/cocostudio/CCArmatureDataManager.h"
 #include "editor-support/cocostudio/CCTransformHelp.h"
 #include "editor-support/cocostudio/CCDataReaderHelper.h"
 #include "editor-support/cocostudio/CCSpriteFrameCacheHelper.h"
+#include "editor-support/cocostudio/CCArmatureBinary.h"
 
 using namespace cocos2d;
 
@@ -227,6 +229,59 @@ void ArmatureDataManager::addSpriteFrameFromFile(const std::string& plistPath, c
 }
 
 
+bool ArmatureDataManager::saveArmatureFileInfoBinary(const std::string& configFilePath, const std::string& binaryFilePath)
+{
+    auto iter = _relativeDatas.find(configFilePath);
+    if (iter == _relativeDatas.end())
+    {
+        CCLOG("%s is not loaded", configFilePath.c_str());
+        return false;
+    }
+    const RelativeData& data = iter->second;
+
+    std::string baseFilePath = configFilePath;
+    size_t pos = baseFilePath.find_last_of('/');
+    baseFilePath = pos != std::string::npos ? baseFilePath.substr(0, pos + 1) : "";
+
+    ArmatureBinary::Content content;
+    for (const std::string& name : data.armatures)
+    {
+        if (ArmatureData *armatureData = getArmatureData(name))
+        {
+            content.armatureDatas.pushBack(armatureData);
+        }
+    }
+    for (const std::string& name : data.animations)
+    {
+        if (AnimationData *animationData = getAnimationData(name))
+        {
+            content.animationDatas.pushBack(animationData);
+        }
+    }
+    for (const std::string& name : data.textures)
+    {
+        if (TextureData *textureData = getTextureData(name))
+        {
+            content.textureDatas.pushBack(textureData);
+        }
+    }
+    // only sprite sheets next to the config file can be found again by the loader
+    for (const std::string& plistPath : data.plistFiles)
+    {
+        if (plistPath.compare(0, baseFilePath.size(), baseFilePath) == 0)
+        {
+            content.configFiles.push_back(plistPath.substr(baseFilePath.size()));
+        }
+    }
+
+    Data bytes;
+    if (!ArmatureBinary::encode(content, baseFilePath, bytes))
+    {
+        return false;
+    }
+    return FileUtils::getInstance()->writeDataToFile(bytes, binaryFilePath);
+}
+
 bool ArmatureDataManager::isAutoLoadSpriteFile()
 {
     return _autoLoadSpriteFile;
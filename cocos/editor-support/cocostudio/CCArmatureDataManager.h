@@ -162,6 +162,14 @@ public:
 
     virtual void removeArmatureFileInfo(const std::string& configFilePath);
 
+    /**
+     *    @brief    Save the datas loaded from configFilePath into a precompiled armature file (.csab).
+     *              The saved file can be passed to addArmatureFileInfo in place of the original one and loads
+     *              without parsing. Save it next to the original file so the sprite sheets are found.
+     *    @return   false if configFilePath isn't loaded or the file can't be written
+     */
+    bool saveArmatureFileInfoBinary(const std::string& configFilePath, const std::string& binaryFilePath);
+
 
     /**
      *    @brief    Judge whether or not need auto load sprite file
@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "editor-support/cocostudio/CCDatas.h"
 
 #include "editor-support/cocostudio/CocoLoader.h"
+#include "editor-support/cocostudio/CCArmatureBinary.h"
 
 
 using namespace cocos2d;
@@ -212,6 +213,10 @@ void DataReaderHelper::loadData()
         {
             DataReaderHelper::addDataFromBinaryCache(pAsyncStruct->fileContent.c_str(),pDataInfo);
         }
+        else if(pAsyncStruct->configType == CocoStudio_ArmatureBinary)
+        {
+            DataReaderHelper::addDataFromArmatureBinaryCache(pAsyncStruct->fileContent, pDataInfo);
+        }
 
         // put the image info into the queue
         _dataInfoMutex.lock();
@@ -311,7 +316,8 @@ void DataReaderHelper::addDataFromFile(const std::string& filePath)
 
     // Read content from file
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
-    bool isbinaryfilesrc = fileExtension == ".csb";
+    bool isprecompiledfilesrc = fileExtension == ".csab";
+    bool isbinaryfilesrc = fileExtension == ".csb" || isprecompiledfilesrc;
 
     _dataReaderHelper->_getFileMutex.lock();
     std::string contentStr(readFileContent(fullPath, isbinaryfilesrc));
@@ -329,6 +335,10 @@ void DataReaderHelper::addDataFromFile(const std::string& filePath)
     {
         DataReaderHelper::addDataFromJsonCache(contentStr, &dataInfo);
     }
+    else if(isprecompiledfilesrc)
+    {
+        DataReaderHelper::addDataFromArmatureBinaryCache(contentStr, &dataInfo);
+    }
     else if(isbinaryfilesrc)
     {
         DataReaderHelper::addDataFromBinaryCache(contentStr.c_str(),&dataInfo);
@@ -413,7 +423,8 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     std::string fileExtension = cocos2d::FileUtils::getInstance()->getFileExtension(filePath);
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
 
-    bool isbinaryfilesrc = fileExtension == ".csb";
+    bool isprecompiledfilesrc = fileExtension == ".csab";
+    bool isbinaryfilesrc = fileExtension == ".csb" || isprecompiledfilesrc;
 
     // This only read exportJson file, it takes only a little time.
     // Large image files are loaded in DataReaderHelper::addDataFromJsonCache(dataInfo) asynchronously.
@@ -429,6 +440,10 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     {
         data->configType = CocoStudio_JSON;
     }
+    else if(isprecompiledfilesrc)
+    {
+        data->configType = CocoStudio_ArmatureBinary;
+    }
     else if(isbinaryfilesrc)
     {
         data->configType = CocoStudio_Binary;
@@ -2574,4 +2589,64 @@ void DataReaderHelper::decodeNode(BaseData *node, const rapidjson::Value& json,
         }
     }
 
+void DataReaderHelper::addDataFromArmatureBinaryCache(const std::string& fileContent, DataInfo *dataInfo)
+{
+    ArmatureBinary::Content content;
+    if (!ArmatureBinary::decode((const unsigned char *)fileContent.c_str(), fileContent.size(), dataInfo->baseFilePath, content))
+    {
+        CCLOG("load precompiled armature file %s error.", dataInfo->filename.c_str());
+        return;
+    }
+
+    // The datas were scaled when the file was written
+    dataInfo->contentScale = 1.0f;
+
+    if (dataInfo->asyncStruct)
+    {
+        _dataReaderHelper->_addDataMutex.lock();
+    }
+    for (const auto& armatureData : content.armatureDatas)
+    {
+        ArmatureDataManager::getInstance()->addArmatureData(armatureData->name, armatureData, dataInfo->filename);
+    }
+    for (const auto& animationData : content.animationDatas)
+    {
+        ArmatureDataManager::getInstance()->addAnimationData(animationData->name, animationData, dataInfo->filename);
+    }
+    for (const auto& textureData : content.textureDatas)
+    {
+        ArmatureDataManager::getInstance()->addTextureData(textureData->name, textureData, dataInfo->filename);
+    }
+    if (dataInfo->asyncStruct)
+    {
+        _dataReaderHelper->_addDataMutex.unlock();
+    }
+
+    // Auto load sprite file
+    bool autoLoad = dataInfo->asyncStruct == nullptr ? ArmatureDataManager::getInstance()->isAutoLoadSpriteFile() : dataInfo->asyncStruct->autoLoadSpriteFile;
+    if (autoLoad)
+    {
+        for (std::string filePath : content.configFiles)
+        {
+            size_t pos = filePath.find_last_of('.');
+            if (pos != std::string::npos)
+            {
+                filePath.erase(pos);
+            }
+
+            if (dataInfo->asyncStruct)
+            {
+                dataInfo->configFileQueue.push(filePath);
+            }
+            else
+            {
+                std::string plistPath = filePath + ".plist";
+                std::string pngPath =  filePath + ".png";
+
+                ArmatureDataManager::getInstance()->addSpriteFrameFromFile((dataInfo->baseFilePath + plistPath), (dataInfo->baseFilePath + pngPath), dataInfo->filename);
+            }
+        }
+    }
+}
+
 }
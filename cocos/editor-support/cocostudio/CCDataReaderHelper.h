@@ -60,7 +60,8 @@ protected:
     {
         DragonBone_XML,
         CocoStudio_JSON,
-        CocoStudio_Binary
+        CocoStudio_Binary,
+        CocoStudio_ArmatureBinary
     };
 
     typedef struct _AsyncStruct
@@ -193,7 +194,11 @@ public:
     static ContourData *decodeContour(CocoLoader *cocoLoader, stExpCocoNode *pCocoNode);
     
     static void decodeNode(BaseData *node, CocoLoader *cocoLoader, stExpCocoNode *pCocoNode, DataInfo *dataInfo);
-    
+
+// for precompiled armature binary (.csab) decode, see ArmatureBinary
+public:
+    static void addDataFromArmatureBinaryCache(const std::string& fileContent, DataInfo *dataInfo = nullptr);
+
 protected:
     void loadData();
 
@@ -279,17 +279,21 @@ void FrameData::copy(const BaseData *baseData)
         displayIndex = frameData->displayIndex;
         
         tweenEasing = frameData->tweenEasing;
-        easingParamNumber = frameData->easingParamNumber;
         
-        CC_SAFE_DELETE_ARRAY(easingParams);
-        if (easingParamNumber != 0)
+        // Tween copies every key frame it passes into the same FrameData, keep the buffer if the size matches
+        if (easingParamNumber != frameData->easingParamNumber || easingParams == nullptr)
         {
-            easingParams = new (std::nothrow) float[easingParamNumber];
-            for (int i = 0; i<easingParamNumber; i++)
+            CC_SAFE_DELETE_ARRAY(easingParams);
+            easingParamNumber = frameData->easingParamNumber;
+            if (easingParamNumber != 0)
             {
-                easingParams[i] = frameData->easingParams[i];
+                easingParams = new (std::nothrow) float[easingParamNumber];
             }
         }
+        for (int i = 0; i<easingParamNumber && easingParams != nullptr; i++)
+        {
+            easingParams[i] = frameData->easingParams[i];
+        }
 
         blendFunc = frameData->blendFunc;
         isTween = frameData->isTween;
@@ -36,6 +36,63 @@ namespace cocostudio {
 
 using cocos2d::tweenfunc::Linear;
 
+static bool s_easingTableEnabled = true;
+
+//! Samples per easing table, linear interpolation between them stays within 1e-3 of the tween function
+static const int EASING_TABLE_SAMPLES = 512;
+static std::vector<float> s_easingTables[cocos2d::tweenfunc::Elastic_EaseInOut + 1];
+
+//! Only the easings that call sin/pow are worth a table lookup
+static bool hasEasingTable(TweenType tweenType)
+{
+    switch (tweenType)
+    {
+    case cocos2d::tweenfunc::Sine_EaseIn:
+    case cocos2d::tweenfunc::Sine_EaseOut:
+    case cocos2d::tweenfunc::Sine_EaseInOut:
+    case cocos2d::tweenfunc::Expo_EaseIn:
+    case cocos2d::tweenfunc::Expo_EaseOut:
+    case cocos2d::tweenfunc::Expo_EaseInOut:
+    case cocos2d::tweenfunc::Elastic_EaseIn:
+    case cocos2d::tweenfunc::Elastic_EaseOut:
+    case cocos2d::tweenfunc::Elastic_EaseInOut:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static float tweenToWithTable(float percent, TweenType tweenType)
+{
+    std::vector<float> &table = s_easingTables[tweenType];
+    if (table.empty())
+    {
+        table.resize(EASING_TABLE_SAMPLES + 1);
+        for (int i = 0; i <= EASING_TABLE_SAMPLES; i++)
+        {
+            table[i] = cocos2d::tweenfunc::tweenTo((float)i / EASING_TABLE_SAMPLES, tweenType, nullptr);
+        }
+    }
+
+    float position = percent * EASING_TABLE_SAMPLES;
+    int index = (int)position;
+    if (index >= EASING_TABLE_SAMPLES)
+    {
+        return table[EASING_TABLE_SAMPLES];
+    }
+    return table[index] + (position - index) * (table[index + 1] - table[index]);
+}
+
+void Tween::setEasingTableEnabled(bool enabled)
+{
+    s_easingTableEnabled = enabled;
+}
+
+bool Tween::isEasingTableEnabled()
+{
+    return s_easingTableEnabled;
+}
+
 Tween *Tween::create(Bone *bone)
 {
     Tween *pTween = new (std::nothrow) Tween();
@@ -479,7 +536,15 @@ float Tween::updateFrameData(float currentPercent)
     TweenType tweenType = (_frameTweenEasing != Linear) ? _frameTweenEasing : _tweenEasing;
     if (tweenType != cocos2d::tweenfunc::TWEEN_EASING_MAX && tweenType != Linear && !_passLastFrame)
     {
-        currentPercent = cocos2d::tweenfunc::tweenTo(currentPercent, tweenType, _from->easingParams);
+        if (s_easingTableEnabled && _from->easingParams == nullptr && hasEasingTable(tweenType)
+            && currentPercent >= 0 && currentPercent <= 1)
+        {
+            currentPercent = tweenToWithTable(currentPercent, tweenType);
+        }
+        else
+        {
+            currentPercent = cocos2d::tweenfunc::tweenTo(currentPercent, tweenType, _from->easingParams);
+        }
     }
 
     return currentPercent;
@@ -49,6 +49,13 @@ public:
      * @param bone the Bone Tween will bind to
      */
     static Tween *create(Bone *bone);
+
+    /**
+     * Whether frame easings without easing params are looked up in precomputed tables
+     * instead of calling the tween function every frame. Enabled by default.
+     */
+    static void setEasingTableEnabled(bool enabled);
+    static bool isEasingTableEnabled();
 public:
     Tween();
     virtual ~Tween();
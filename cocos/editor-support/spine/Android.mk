@@ -47,6 +47,7 @@ SkeletonData.c \
 SkeletonJson.c \
 SkeletonRenderer.cpp \
 SkeletonTwoColorBatch.cpp \
+SkeletonUpdater.cpp \
 Skin.c \
 Slot.c \
 SlotData.c \
@@ -30,6 +30,7 @@
 
 #include "spine/SkeletonAnimation.h"
 #include "spine/spine-cocos2dx.h"
+#include "spine/SkeletonUpdater.h"
 #include "spine/extension.h"
 #include <algorithm>
 
@@ -117,7 +118,8 @@ void SkeletonAnimation::initialize () {
 }
 
 SkeletonAnimation::SkeletonAnimation ()
-		: SkeletonRenderer() {
+		: SkeletonRenderer(), _updateQueued(false), _hasTrackListeners(false), _deferredStateUpdate(false), _deferredDeltaTime(0),
+		_deferredPrepare(false), _deferredTwoColorTint(false), _deferredFrame(0) {
 }
 
 SkeletonAnimation::~SkeletonAnimation () {
@@ -129,11 +131,61 @@ void SkeletonAnimation::update (float deltaTime) {
 	super::update(deltaTime);
 
 	deltaTime *= _timeScale;
+
+	SkeletonUpdater* updater = SkeletonUpdater::getInstance();
+	if (updater->isEnabled()) {
+		if (hasListeners()) {
+			// listeners must be called on the main thread
+			spAnimationState_update(_state, _deferredDeltaTime + deltaTime);
+			spAnimationState_apply(_state, _skeleton);
+			_deferredDeltaTime = 0;
+			_deferredStateUpdate = false;
+		} else {
+			_deferredDeltaTime += deltaTime;
+			_deferredStateUpdate = true;
+		}
+		updater->add(this);
+		return;
+	}
+
 	spAnimationState_update(_state, deltaTime);
 	spAnimationState_apply(_state, _skeleton);
 	spSkeleton_updateWorldTransform(_skeleton);
 }
 
+bool SkeletonAnimation::hasListeners () const {
+	return _hasTrackListeners || _state->listener != animationCallback
+		|| _startListener || _interruptListener || _endListener || _disposeListener || _completeListener || _eventListener;
+}
+
+void SkeletonAnimation::beginDeferredUpdate (unsigned int frame) {
+	// vertex effects are usually shared between skeletons, so those are prepared in draw
+	_deferredPrepare = !_effect;
+	for (Node* node = this; _deferredPrepare && node; node = node->getParent()) {
+		_deferredPrepare = node->isVisible();
+	}
+	if (_deferredPrepare) {
+		_deferredNodeColor = getNodeColor();
+		_deferredTwoColorTint = isTwoColorTint();
+		_deferredFrame = frame;
+	}
+}
+
+void SkeletonAnimation::deferredUpdate () {
+	if (_deferredStateUpdate) {
+		spAnimationState_update(_state, _deferredDeltaTime);
+		spAnimationState_apply(_state, _skeleton);
+		_deferredDeltaTime = 0;
+		_deferredStateUpdate = false;
+	}
+	spSkeleton_updateWorldTransform(_skeleton);
+
+	if (_deferredPrepare) {
+		prepareVertices(_deferredNodeColor, _deferredTwoColorTint);
+		_preparedFrame = _deferredFrame;
+	}
+}
+
 void SkeletonAnimation::setAnimationStateData (spAnimationStateData* stateData) {
 	CCASSERT(stateData, "stateData cannot be null.");
 
@@ -269,26 +321,32 @@ void SkeletonAnimation::setEventListener (const EventListener& listener) {
 }
 
 void SkeletonAnimation::setTrackStartListener (spTrackEntry* entry, const StartListener& listener) {
+	_hasTrackListeners = true;
 	getListeners(entry)->startListener = listener;
 }
     
 void SkeletonAnimation::setTrackInterruptListener (spTrackEntry* entry, const InterruptListener& listener) {
+    _hasTrackListeners = true;
     getListeners(entry)->interruptListener = listener;
 }
 
 void SkeletonAnimation::setTrackEndListener (spTrackEntry* entry, const EndListener& listener) {
+	_hasTrackListeners = true;
 	getListeners(entry)->endListener = listener;
 }
     
 void SkeletonAnimation::setTrackDisposeListener (spTrackEntry* entry, const DisposeListener& listener) {
+    _hasTrackListeners = true;
     getListeners(entry)->disposeListener = listener;
 }
 
 void SkeletonAnimation::setTrackCompleteListener (spTrackEntry* entry, const CompleteListener& listener) {
+	_hasTrackListeners = true;
 	getListeners(entry)->completeListener = listener;
 }
 
 void SkeletonAnimation::setTrackEventListener (spTrackEntry* entry, const EventListener& listener) {
+	_hasTrackListeners = true;
 	getListeners(entry)->eventListener = listener;
 }
 
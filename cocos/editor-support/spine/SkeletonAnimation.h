@@ -117,6 +117,24 @@ protected:
 	CompleteListener _completeListener;
 	EventListener _eventListener;
 
+	// --- Deferred update, see SkeletonUpdater.
+	bool hasListeners () const;
+	/* Called on the main thread before the queued skeletons are updated. */
+	void beginDeferredUpdate (unsigned int frame);
+	/* Called on a worker thread, must only touch this skeleton. */
+	void deferredUpdate ();
+
+	bool _updateQueued;
+	bool _hasTrackListeners;
+	bool _deferredStateUpdate;
+	float _deferredDeltaTime;
+	bool _deferredPrepare;
+	cocos2d::Color4F _deferredNodeColor;
+	bool _deferredTwoColorTint;
+	unsigned int _deferredFrame;
+
+	friend class SkeletonUpdater;
+
 private:
 	typedef SkeletonRenderer super;
 };
@@ -138,10 +138,58 @@ cocos2d::TrianglesCommand* SkeletonBatch::addCommand(cocos2d::Renderer* renderer
 	return command;
 }
 
+TrianglesCommand* SkeletonBatch::addMergedTriangles(Renderer* renderer, float globalOrder, Texture2D* texture, GLProgramState* glProgramState, BlendFunc blendType, const TrianglesCommand::Triangles& triangles, const Mat4& mv, uint32_t flags) {
+	TrianglesCommand* command = _mergeCommand;
+	if (command) {
+		const TrianglesCommand::Triangles& merged = command->getTriangles();
+		bool canMerge = _mergeStamp == renderer->getQueueStamp() &&
+			// the dirty flags don't change the command, only rendering as 3D does
+			((_mergeFlags ^ flags) & Node::FLAGS_RENDER_AS_3D) == 0 &&
+			command->getGlobalOrder() == globalOrder && command->getTextureID() == texture->getName() &&
+			command->getGLProgramState() == glProgramState && command->getBlendType() == blendType &&
+			// indices are relative to the first vertex of the command
+			merged.vertCount + triangles.vertCount < Renderer::VBO_SIZE &&
+			merged.indexCount + triangles.indexCount < Renderer::INDEX_VBO_SIZE &&
+			// the merged triangles must be the last ones allocated
+			merged.verts + merged.vertCount == _vertices.data() + _numVertices &&
+			merged.indices + merged.indexCount == _indices->items + _indices->size;
+		if (!canMerge) command = nullptr;
+	}
+	
+	unsigned short vertexOffset = command ? (unsigned short)command->getTriangles().vertCount : 0;
+	cocos2d::V3F_C4B_T2F* vertices = allocateVertices(triangles.vertCount);
+	unsigned short* indices = allocateIndices(triangles.indexCount);
+	memcpy(vertices, triangles.verts, sizeof(cocos2d::V3F_C4B_T2F) * triangles.vertCount);
+	for (int i = 0; i < triangles.vertCount; i++) {
+		mv.transformPoint(&vertices[i].vertices);
+	}
+	for (int i = 0; i < triangles.indexCount; i++) {
+		indices[i] = triangles.indices[i] + vertexOffset;
+	}
+	
+	if (command) {
+		cocos2d::TrianglesCommand::Triangles& merged = (cocos2d::TrianglesCommand::Triangles&)command->getTriangles();
+		merged.vertCount += triangles.vertCount;
+		merged.indexCount += triangles.indexCount;
+	} else {
+		cocos2d::TrianglesCommand::Triangles transformed;
+		transformed.verts = vertices;
+		transformed.vertCount = triangles.vertCount;
+		transformed.indices = indices;
+		transformed.indexCount = triangles.indexCount;
+		command = addCommand(renderer, globalOrder, texture, glProgramState, blendType, transformed, Mat4::IDENTITY, flags);
+		_mergeCommand = command;
+		_mergeFlags = flags;
+	}
+	_mergeStamp = renderer->getQueueStamp();
+	return command;
+}
+
 void SkeletonBatch::reset() {
 	_nextFreeCommand = 0;
 	_numVertices = 0;
 	_indices->size = 0;
+	_mergeCommand = nullptr;
 }
 
 cocos2d::TrianglesCommand* SkeletonBatch::nextFreeCommand() {
@@ -50,6 +50,13 @@ namespace spine {
 		unsigned short* allocateIndices(uint32_t numIndices);
 		void deallocateIndices(uint32_t numVertices);
 		cocos2d::TrianglesCommand* addCommand(cocos2d::Renderer* renderer, float globalOrder, cocos2d::Texture2D* texture, cocos2d::GLProgramState* glProgramState, cocos2d::BlendFunc blendType, const cocos2d::TrianglesCommand::Triangles& triangles, const cocos2d::Mat4& mv, uint32_t flags);
+		
+		// Appends the triangles, transformed by mv, to the last command added with this method if it has the same
+		// material, is still the last command queued in the renderer and has room left. Otherwise adds a new command
+		// with an identity transform.
+		cocos2d::TrianglesCommand* addMergedTriangles(cocos2d::Renderer* renderer, float globalOrder, cocos2d::Texture2D* texture, cocos2d::GLProgramState* glProgramState, cocos2d::BlendFunc blendType, const cocos2d::TrianglesCommand::Triangles& triangles, const cocos2d::Mat4& mv, uint32_t flags);
+		
+		uint32_t getNumCommands () const { return _nextFreeCommand; }
         
     protected:
         SkeletonBatch ();
@@ -69,6 +76,11 @@ namespace spine {
 		
 		// pool of indices
 		spUnsignedShortArray* _indices;
+		
+		// last command of addMergedTriangles and the renderer queue stamp right after it was added or extended
+		cocos2d::TrianglesCommand* _mergeCommand;
+		uint32_t _mergeFlags;
+		unsigned int _mergeStamp;
     };
 	
 }
@@ -35,6 +35,7 @@
 #include "spine/AttachmentVertices.h"
 #include "spine/Cocos2dAttachmentLoader.h"
 #include <algorithm>
+#include <climits>
 
 USING_NS_CC;
 using std::min;
@@ -42,6 +43,8 @@ using std::max;
 
 namespace spine {
 
+static bool batchingAcrossSkeletons = false;
+
 SkeletonRenderer* SkeletonRenderer::createWithData (spSkeletonData* skeletonData, bool ownsSkeletonData) {
 	SkeletonRenderer* node = new SkeletonRenderer(skeletonData, ownsSkeletonData);
 	node->autorelease();
@@ -68,6 +71,11 @@ void SkeletonRenderer::initialize () {
 	_blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 	setOpacityModifyRGB(true);
 
+	_numPreparedVertices = 0;
+	_numPreparedIndices = 0;
+	_preparedTwoColorTint = false;
+	_preparedFrame = UINT_MAX;
+
 	setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
 }
 
@@ -181,89 +189,158 @@ void SkeletonRenderer::update (float deltaTime) {
 }
 
 void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t transformFlags) {
-	SkeletonBatch* batch = SkeletonBatch::getInstance();
-	SkeletonTwoColorBatch* twoColorBatch = SkeletonTwoColorBatch::getInstance();
+	Color4F nodeColor = getNodeColor();
 	bool isTwoColorTint = this->isTwoColorTint();
-	
-	if (_effect) _effect->begin(_effect, _skeleton);
 
+	// vertices prepared by SkeletonUpdater in this frame are reused unless the colors or the shader changed since
+	if (_preparedFrame != Director::getInstance()->getTotalFrames() || _preparedNodeColor != nodeColor || _preparedTwoColorTint != isTwoColorTint) {
+		prepareVertices(nodeColor, isTwoColorTint);
+	}
+
+	TwoColorTrianglesCommand* lastTwoColorTrianglesCommand = submitPreparedVertices(renderer, transform, transformFlags);
+
+	// merged two color commands are always flushed
+	if (lastTwoColorTrianglesCommand && !lastTwoColorTrianglesCommand->isForceFlush()) {
+		Node* parent = this->getParent();
+
+		// We need to decide if we can postpone flushing the current
+		// batch. We can postpone if the next sibling node is a
+		// two color tinted skeleton with the same global-z.
+		// The parent->getChildrenCount() > 100 check is a hack
+		// as checking for a sibling is an O(n) operation, and if
+		// all children of this nodes parent are skeletons, we
+		// are in O(n2) territory.
+		if (!parent || parent->getChildrenCount() > 100 || getChildrenCount() != 0) {
+			lastTwoColorTrianglesCommand->setForceFlush(true);
+		} else {
+			Vector<Node*>& children = parent->getChildren();
+			Node* sibling = nullptr;
+			for (ssize_t i = 0; i < children.size(); i++) {
+				if (children.at(i) == this) {
+					if (i < children.size() - 1) {
+						sibling = children.at(i+1);
+						break;
+					}
+				}
+			}
+			if (!sibling) {
+				lastTwoColorTrianglesCommand->setForceFlush(true);
+			} else {
+				SkeletonRenderer* siblingSkeleton = dynamic_cast<SkeletonRenderer*>(sibling);
+				if (!siblingSkeleton || // flush is next sibling isn't a SkeletonRenderer
+					!siblingSkeleton->isTwoColorTint() || // flush if next sibling isn't two color tinted
+					!siblingSkeleton->isVisible() || // flush if next sibling is two color tinted but not visible
+					(siblingSkeleton->getGlobalZOrder() != this->getGlobalZOrder())) { // flush if next sibling is two color tinted but z-order differs
+					lastTwoColorTrianglesCommand->setForceFlush(true);
+				}
+			}
+		}
+	}
+
+	if (_debugSlots || _debugBones || _debugMeshes) {
+        drawDebug(renderer, transform, transformFlags);
+	}
+}
+
+Color4F SkeletonRenderer::getNodeColor () const {
 	Color4F nodeColor;
 	nodeColor.r = getDisplayedColor().r / (float)255;
 	nodeColor.g = getDisplayedColor().g / (float)255;
 	nodeColor.b = getDisplayedColor().b / (float)255;
 	nodeColor.a = getDisplayedOpacity() / (float)255;
-	
+	return nodeColor;
+}
+
+// Grows pool by doubling and hands out the next count items, like SkeletonBatch::allocateVertices.
+template <typename T>
+static T* allocatePrepared (std::vector<T>& pool, int& size, int count) {
+	if ((int)pool.size() - size < count) {
+		pool.resize((size + count) * 2 + 1);
+	}
+	T* items = pool.data() + size;
+	size += count;
+	return items;
+}
+
+void SkeletonRenderer::prepareVertices (const Color4F& nodeColor, bool isTwoColorTint) {
+	_preparedAttachments.clear();
+	_numPreparedVertices = 0;
+	_numPreparedIndices = 0;
+	_preparedNodeColor = nodeColor;
+	_preparedTwoColorTint = isTwoColorTint;
+
+	if (_effect) _effect->begin(_effect, _skeleton);
+
     Color4F color;
 	Color4F darkColor;
 	AttachmentVertices* attachmentVertices = nullptr;
-	TwoColorTrianglesCommand* lastTwoColorTrianglesCommand = nullptr;
 	for (int i = 0, n = _skeleton->slotsCount; i < n; ++i) {
 		spSlot* slot = _skeleton->drawOrder[i];
 		if (!slot->attachment) {
 			spSkeletonClipping_clipEnd(_clipper, slot);
 			continue;
 		}
-		
+
 		cocos2d::TrianglesCommand::Triangles triangles;
 		TwoColorTriangles trianglesTwoColor;
-		
+
 		switch (slot->attachment->type) {
 		case SP_ATTACHMENT_REGION: {
 			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
 			attachmentVertices = getAttachmentVertices(attachment);
-			
+
 			if (!isTwoColorTint) {
 				triangles.indices = attachmentVertices->_triangles->indices;
 				triangles.indexCount = attachmentVertices->_triangles->indexCount;
-				triangles.verts = batch->allocateVertices(attachmentVertices->_triangles->vertCount);
+				triangles.verts = allocatePrepared(_preparedVertices, _numPreparedVertices, attachmentVertices->_triangles->vertCount);
 				triangles.vertCount = attachmentVertices->_triangles->vertCount;
 				memcpy(triangles.verts, attachmentVertices->_triangles->verts, sizeof(cocos2d::V3F_C4B_T2F) * attachmentVertices->_triangles->vertCount);
 				spRegionAttachment_computeWorldVertices(attachment, slot->bone, (float*)triangles.verts, 0, 6);
 			} else {
 				trianglesTwoColor.indices = attachmentVertices->_triangles->indices;
 				trianglesTwoColor.indexCount = attachmentVertices->_triangles->indexCount;
-				trianglesTwoColor.verts = twoColorBatch->allocateVertices(attachmentVertices->_triangles->vertCount);
+				trianglesTwoColor.verts = allocatePrepared(_preparedTwoColorVertices, _numPreparedVertices, attachmentVertices->_triangles->vertCount);
 				trianglesTwoColor.vertCount = attachmentVertices->_triangles->vertCount;
 				for (int ii = 0; ii < trianglesTwoColor.vertCount; ii++) {
 					trianglesTwoColor.verts[ii].texCoords = attachmentVertices->_triangles->verts[ii].texCoords;
 				}
 				spRegionAttachment_computeWorldVertices(attachment, slot->bone, (float*)trianglesTwoColor.verts, 0, 7);
 			}
-			
+
             color.r = attachment->color.r;
 			color.g = attachment->color.g;
 			color.b = attachment->color.b;
 			color.a = attachment->color.a;
-			
+
 			break;
 		}
 		case SP_ATTACHMENT_MESH: {
 			spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
 			attachmentVertices = getAttachmentVertices(attachment);
-			
+
 			if (!isTwoColorTint) {
 				triangles.indices = attachmentVertices->_triangles->indices;
 				triangles.indexCount = attachmentVertices->_triangles->indexCount;
-				triangles.verts = batch->allocateVertices(attachmentVertices->_triangles->vertCount);
+				triangles.verts = allocatePrepared(_preparedVertices, _numPreparedVertices, attachmentVertices->_triangles->vertCount);
 				triangles.vertCount = attachmentVertices->_triangles->vertCount;
 				memcpy(triangles.verts, attachmentVertices->_triangles->verts, sizeof(cocos2d::V3F_C4B_T2F) * attachmentVertices->_triangles->vertCount);
 				spVertexAttachment_computeWorldVertices(SUPER(attachment), slot, 0, triangles.vertCount * sizeof(cocos2d::V3F_C4B_T2F) / 4, (float*)triangles.verts, 0, 6);
 			} else {
 				trianglesTwoColor.indices = attachmentVertices->_triangles->indices;
 				trianglesTwoColor.indexCount = attachmentVertices->_triangles->indexCount;
-				trianglesTwoColor.verts = twoColorBatch->allocateVertices(attachmentVertices->_triangles->vertCount);
+				trianglesTwoColor.verts = allocatePrepared(_preparedTwoColorVertices, _numPreparedVertices, attachmentVertices->_triangles->vertCount);
 				trianglesTwoColor.vertCount = attachmentVertices->_triangles->vertCount;
 				for (int ii = 0; ii < trianglesTwoColor.vertCount; ii++) {
 					trianglesTwoColor.verts[ii].texCoords = attachmentVertices->_triangles->verts[ii].texCoords;
 				}
 				spVertexAttachment_computeWorldVertices(SUPER(attachment), slot, 0, trianglesTwoColor.vertCount * sizeof(V3F_C4B_C4B_T2F) / 4, (float*)trianglesTwoColor.verts, 0, 7);
 			}
-			
+
 			color.r = attachment->color.r;
 			color.g = attachment->color.g;
 			color.b = attachment->color.b;
 			color.a = attachment->color.a;
-			
+
 			break;
 		}
 		case SP_ATTACHMENT_CLIPPING: {
@@ -274,7 +351,7 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 			spSkeletonClipping_clipEnd(_clipper, slot);
 			continue;
 		}
-		
+
 		if (slot->darkColor) {
 			darkColor.r = slot->darkColor->r * 255;
 			darkColor.g = slot->darkColor->g * 255;
@@ -284,10 +361,11 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 			darkColor.g = 0;
 			darkColor.b = 0;
 		}
-		
+
 		color.a *= nodeColor.a * _skeleton->color.a * slot->color.a * 255;
 		// skip rendering if the color of this attachment is 0
 		if (color.a == 0){
+			_numPreparedVertices -= isTwoColorTint ? trianglesTwoColor.vertCount : triangles.vertCount;
 			spSkeletonClipping_clipEnd(_clipper, slot);
 			continue;
 		}
@@ -295,44 +373,45 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 		color.r *= nodeColor.r * _skeleton->color.r * slot->color.r * multiplier;
 		color.g *= nodeColor.g * _skeleton->color.g * slot->color.g * multiplier;
 		color.b *= nodeColor.b * _skeleton->color.b * slot->color.b * multiplier;
-		
-		BlendFunc blendFunc;
+
+		PreparedAttachment prepared;
+		prepared.attachmentVertices = attachmentVertices;
+		prepared.firstIndex = -1;
 		switch (slot->data->blendMode) {
 			case SP_BLEND_MODE_ADDITIVE:
-				blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
-				blendFunc.dst = GL_ONE;
+				prepared.blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
+				prepared.blendFunc.dst = GL_ONE;
 				break;
 			case SP_BLEND_MODE_MULTIPLY:
-				blendFunc.src = GL_DST_COLOR;
-				blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
+				prepared.blendFunc.src = GL_DST_COLOR;
+				prepared.blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
 				break;
 			case SP_BLEND_MODE_SCREEN:
-				blendFunc.src = GL_ONE;
-				blendFunc.dst = GL_ONE_MINUS_SRC_COLOR;
+				prepared.blendFunc.src = GL_ONE;
+				prepared.blendFunc.dst = GL_ONE_MINUS_SRC_COLOR;
 				break;
 			default:
-				blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
-				blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
+				prepared.blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
+				prepared.blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
 		}
-		
+
 		if (!isTwoColorTint) {
 			if (spSkeletonClipping_isClipping(_clipper)) {
 				spSkeletonClipping_clipTriangles(_clipper, (float*)&triangles.verts[0].vertices, triangles.vertCount * sizeof(cocos2d::V3F_C4B_T2F) / 4, triangles.indices, triangles.indexCount, (float*)&triangles.verts[0].texCoords, 6);
-				batch->deallocateVertices(triangles.vertCount);
-				
+				_numPreparedVertices -= triangles.vertCount;
+
 				if (_clipper->clippedTriangles->size == 0){
 					spSkeletonClipping_clipEnd(_clipper, slot);
 					continue;
 				}
-				
+
 				triangles.vertCount = _clipper->clippedVertices->size >> 1;
-				triangles.verts = batch->allocateVertices(triangles.vertCount);
+				triangles.verts = allocatePrepared(_preparedVertices, _numPreparedVertices, triangles.vertCount);
 				triangles.indexCount = _clipper->clippedTriangles->size;
-				triangles.indices = batch->allocateIndices(triangles.indexCount);
+				prepared.firstIndex = _numPreparedIndices;
+				triangles.indices = allocatePrepared(_preparedIndices, _numPreparedIndices, triangles.indexCount);
 				memcpy(triangles.indices, _clipper->clippedTriangles->items, sizeof(unsigned short) * _clipper->clippedTriangles->size);
-				
-				cocos2d::TrianglesCommand* batchedTriangles = batch->addCommand(renderer, _globalZOrder, attachmentVertices->_texture, _glProgramState, blendFunc, triangles, transform, transformFlags);
-				
+
 				float* verts = _clipper->clippedVertices->items;
 				float* uvs = _clipper->clippedUVs->items;
 				if (_effect) {
@@ -343,8 +422,8 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 					light.b = color.b / 255.0f;
 					light.a = color.a / 255.0f;
 					dark.r = dark.g = dark.b = dark.a = 0;
-					for (int v = 0, vn = batchedTriangles->getTriangles().vertCount, vv = 0; v < vn; ++v, vv+=2) {
-						V3F_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
+					for (int v = 0, vn = triangles.vertCount, vv = 0; v < vn; ++v, vv+=2) {
+						V3F_C4B_T2F* vertex = triangles.verts + v;
 						spColor lightCopy = light;
 						spColor darkCopy = dark;
 						vertex->vertices.x = verts[vv];
@@ -358,8 +437,8 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 						vertex->colors.a = (GLubyte)(lightCopy.a * 255);
 					}
 				} else {
-					for (int v = 0, vn = batchedTriangles->getTriangles().vertCount, vv = 0; v < vn; ++v, vv+=2) {
-						V3F_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
+					for (int v = 0, vn = triangles.vertCount, vv = 0; v < vn; ++v, vv+=2) {
+						V3F_C4B_T2F* vertex = triangles.verts + v;
 						vertex->vertices.x = verts[vv];
 						vertex->vertices.y = verts[vv + 1];
 						vertex->texCoords.u = uvs[vv];
@@ -371,8 +450,6 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 					}
 				}
 			} else {
-				cocos2d::TrianglesCommand* batchedTriangles = batch->addCommand(renderer, _globalZOrder, attachmentVertices->_texture, _glProgramState, blendFunc, triangles, transform, transformFlags);
-				
 				if (_effect) {
 					spColor light;
 					spColor dark;
@@ -381,8 +458,8 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 					light.b = color.b / 255.0f;
 					light.a = color.a / 255.0f;
 					dark.r = dark.g = dark.b = dark.a = 0;
-					for (int v = 0, vn = batchedTriangles->getTriangles().vertCount; v < vn; ++v) {
-						V3F_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
+					for (int v = 0, vn = triangles.vertCount; v < vn; ++v) {
+						V3F_C4B_T2F* vertex = triangles.verts + v;
 						spColor lightCopy = light;
 						spColor darkCopy = dark;
 						_effect->transform(_effect, &vertex->vertices.x, &vertex->vertices.y, &vertex->texCoords.u, &vertex->texCoords.v, &lightCopy, &darkCopy);
@@ -392,8 +469,8 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 						vertex->colors.a = (GLubyte)(lightCopy.a * 255);
 					}
 				} else {
-					for (int v = 0, vn = batchedTriangles->getTriangles().vertCount; v < vn; ++v) {
-						V3F_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
+					for (int v = 0, vn = triangles.vertCount; v < vn; ++v) {
+						V3F_C4B_T2F* vertex = triangles.verts + v;
 						vertex->colors.r = (GLubyte)color.r;
 						vertex->colors.g = (GLubyte)color.g;
 						vertex->colors.b = (GLubyte)color.b;
@@ -401,27 +478,29 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 					}
 				}
 			}
+			prepared.firstVertex = (int)(triangles.verts - _preparedVertices.data());
+			prepared.vertexCount = triangles.vertCount;
+			prepared.indexCount = triangles.indexCount;
 		} else {
 			if (spSkeletonClipping_isClipping(_clipper)) {
 				spSkeletonClipping_clipTriangles(_clipper, (float*)&trianglesTwoColor.verts[0].position, trianglesTwoColor.vertCount * sizeof(V3F_C4B_C4B_T2F) / 4, trianglesTwoColor.indices, trianglesTwoColor.indexCount, (float*)&trianglesTwoColor.verts[0].texCoords, 7);
-				twoColorBatch->deallocateVertices(trianglesTwoColor.vertCount);
-				
+				_numPreparedVertices -= trianglesTwoColor.vertCount;
+
 				if (_clipper->clippedTriangles->size == 0){
 					spSkeletonClipping_clipEnd(_clipper, slot);
 					continue;
 				}
-				
+
 				trianglesTwoColor.vertCount = _clipper->clippedVertices->size >> 1;
-				trianglesTwoColor.verts = twoColorBatch->allocateVertices(trianglesTwoColor.vertCount);
+				trianglesTwoColor.verts = allocatePrepared(_preparedTwoColorVertices, _numPreparedVertices, trianglesTwoColor.vertCount);
 				trianglesTwoColor.indexCount = _clipper->clippedTriangles->size;
-				trianglesTwoColor.indices = twoColorBatch->allocateIndices(trianglesTwoColor.indexCount);
+				prepared.firstIndex = _numPreparedIndices;
+				trianglesTwoColor.indices = allocatePrepared(_preparedIndices, _numPreparedIndices, trianglesTwoColor.indexCount);
 				memcpy(trianglesTwoColor.indices, _clipper->clippedTriangles->items, sizeof(unsigned short) * _clipper->clippedTriangles->size);
-				
-				TwoColorTrianglesCommand* batchedTriangles = lastTwoColorTrianglesCommand = twoColorBatch->addCommand(renderer, _globalZOrder, attachmentVertices->_texture->getName(), _glProgramState, blendFunc, trianglesTwoColor, transform, transformFlags);
-				
+
 				float* verts = _clipper->clippedVertices->items;
 				float* uvs = _clipper->clippedUVs->items;
-				
+
 				if (_effect) {
 					spColor light;
 					spColor dark;
@@ -433,8 +512,8 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 					dark.g = darkColor.g / 255.0f;
 					dark.b = darkColor.b / 255.0f;
 					dark.a = darkColor.a / 255.0f;
-					for (int v = 0, vn = batchedTriangles->getTriangles().vertCount, vv = 0; v < vn; ++v, vv += 2) {
-						V3F_C4B_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
+					for (int v = 0, vn = trianglesTwoColor.vertCount, vv = 0; v < vn; ++v, vv += 2) {
+						V3F_C4B_C4B_T2F* vertex = trianglesTwoColor.verts + v;
 						spColor lightCopy = light;
 						spColor darkCopy = dark;
 						vertex->position.x = verts[vv];
@@ -452,8 +531,8 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 						vertex->color2.a = 1;
 					}
 				} else {
-					for (int v = 0, vn = batchedTriangles->getTriangles().vertCount, vv = 0; v < vn; ++v, vv += 2) {
-						V3F_C4B_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
+					for (int v = 0, vn = trianglesTwoColor.vertCount, vv = 0; v < vn; ++v, vv += 2) {
+						V3F_C4B_C4B_T2F* vertex = trianglesTwoColor.verts + v;
 						vertex->position.x = verts[vv];
 						vertex->position.y = verts[vv + 1];
 						vertex->texCoords.u = uvs[vv];
@@ -469,8 +548,6 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 					}
 				}
 			} else {
-				TwoColorTrianglesCommand* batchedTriangles = lastTwoColorTrianglesCommand = twoColorBatch->addCommand(renderer, _globalZOrder, attachmentVertices->_texture->getName(), _glProgramState, blendFunc, trianglesTwoColor, transform, transformFlags);
-				
 				if (_effect) {
 					spColor light;
 					spColor dark;
@@ -482,9 +559,9 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 					dark.g = darkColor.g / 255.0f;
 					dark.b = darkColor.b / 255.0f;
 					dark.a = darkColor.a / 255.0f;
-					
-					for (int v = 0, vn = batchedTriangles->getTriangles().vertCount; v < vn; ++v) {
-						V3F_C4B_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
+
+					for (int v = 0, vn = trianglesTwoColor.vertCount; v < vn; ++v) {
+						V3F_C4B_C4B_T2F* vertex = trianglesTwoColor.verts + v;
 						spColor lightCopy = light;
 						spColor darkCopy = dark;
 						_effect->transform(_effect, &vertex->position.x, &vertex->position.y, &vertex->texCoords.u, &vertex->texCoords.v, &lightCopy, &darkCopy);
@@ -498,8 +575,8 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 						vertex->color2.a = 1;
 					}
 				} else {
-					for (int v = 0, vn = batchedTriangles->getTriangles().vertCount; v < vn; ++v) {
-						V3F_C4B_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
+					for (int v = 0, vn = trianglesTwoColor.vertCount; v < vn; ++v) {
+						V3F_C4B_C4B_T2F* vertex = trianglesTwoColor.verts + v;
 						vertex->color.r = (GLubyte)color.r;
 						vertex->color.g = (GLubyte)color.g;
 						vertex->color.b = (GLubyte)color.b;
@@ -511,53 +588,73 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 					}
 				}
 			}
+			prepared.firstVertex = (int)(trianglesTwoColor.verts - _preparedTwoColorVertices.data());
+			prepared.vertexCount = trianglesTwoColor.vertCount;
+			prepared.indexCount = trianglesTwoColor.indexCount;
 		}
+		_preparedAttachments.push_back(prepared);
 		spSkeletonClipping_clipEnd(_clipper, slot);
 	}
 	spSkeletonClipping_clipEnd2(_clipper);
-	
-	if (lastTwoColorTrianglesCommand) {
-		Node* parent = this->getParent();
-		
-		// We need to decide if we can postpone flushing the current
-		// batch. We can postpone if the next sibling node is a
-		// two color tinted skeleton with the same global-z.
-		// The parent->getChildrenCount() > 100 check is a hack
-		// as checking for a sibling is an O(n) operation, and if
-		// all children of this nodes parent are skeletons, we
-		// are in O(n2) territory.
-		if (!parent || parent->getChildrenCount() > 100 || getChildrenCount() != 0) {
-			lastTwoColorTrianglesCommand->setForceFlush(true);
-		} else {
-			Vector<Node*>& children = parent->getChildren();
-			Node* sibling = nullptr;
-			for (ssize_t i = 0; i < children.size(); i++) {
-				if (children.at(i) == this) {
-					if (i < children.size() - 1) {
-						sibling = children.at(i+1);
-						break;
-					}
-				}
+
+	if (_effect) _effect->end(_effect);
+}
+
+TwoColorTrianglesCommand* SkeletonRenderer::submitPreparedVertices (Renderer* renderer, const Mat4& transform, uint32_t transformFlags) {
+	SkeletonBatch* batch = SkeletonBatch::getInstance();
+	SkeletonTwoColorBatch* twoColorBatch = SkeletonTwoColorBatch::getInstance();
+	TwoColorTrianglesCommand* lastTwoColorTrianglesCommand = nullptr;
+	bool merge = batchingAcrossSkeletons && !(transformFlags & FLAGS_RENDER_AS_3D);
+
+	for (const PreparedAttachment& prepared : _preparedAttachments) {
+		AttachmentVertices* attachmentVertices = prepared.attachmentVertices;
+		unsigned short* indices = prepared.firstIndex < 0 ? attachmentVertices->_triangles->indices : _preparedIndices.data() + prepared.firstIndex;
+
+		if (merge) {
+			if (!_preparedTwoColorTint) {
+				cocos2d::TrianglesCommand::Triangles triangles;
+				triangles.verts = _preparedVertices.data() + prepared.firstVertex;
+				triangles.vertCount = prepared.vertexCount;
+				triangles.indices = indices;
+				triangles.indexCount = prepared.indexCount;
+				batch->addMergedTriangles(renderer, _globalZOrder, attachmentVertices->_texture, _glProgramState, prepared.blendFunc, triangles, transform, transformFlags);
+			} else {
+				TwoColorTriangles trianglesTwoColor;
+				trianglesTwoColor.verts = _preparedTwoColorVertices.data() + prepared.firstVertex;
+				trianglesTwoColor.vertCount = prepared.vertexCount;
+				trianglesTwoColor.indices = indices;
+				trianglesTwoColor.indexCount = prepared.indexCount;
+				lastTwoColorTrianglesCommand = twoColorBatch->addMergedTriangles(renderer, _globalZOrder, attachmentVertices->_texture->getName(), _glProgramState, prepared.blendFunc, trianglesTwoColor, transform, transformFlags);
 			}
-			if (!sibling) {
-				lastTwoColorTrianglesCommand->setForceFlush(true);
+		} else if (!_preparedTwoColorTint) {
+			cocos2d::TrianglesCommand::Triangles triangles;
+			triangles.vertCount = prepared.vertexCount;
+			triangles.verts = batch->allocateVertices(prepared.vertexCount);
+			memcpy(triangles.verts, _preparedVertices.data() + prepared.firstVertex, sizeof(cocos2d::V3F_C4B_T2F) * prepared.vertexCount);
+			triangles.indexCount = prepared.indexCount;
+			if (prepared.firstIndex < 0) {
+				triangles.indices = indices;
 			} else {
-				SkeletonRenderer* siblingSkeleton = dynamic_cast<SkeletonRenderer*>(sibling);
-				if (!siblingSkeleton || // flush is next sibling isn't a SkeletonRenderer
-					!siblingSkeleton->isTwoColorTint() || // flush if next sibling isn't two color tinted
-					!siblingSkeleton->isVisible() || // flush if next sibling is two color tinted but not visible
-					(siblingSkeleton->getGlobalZOrder() != this->getGlobalZOrder())) { // flush if next sibling is two color tinted but z-order differs
-					lastTwoColorTrianglesCommand->setForceFlush(true);
-				}
+				triangles.indices = batch->allocateIndices(prepared.indexCount);
+				memcpy(triangles.indices, indices, sizeof(unsigned short) * prepared.indexCount);
 			}
+			batch->addCommand(renderer, _globalZOrder, attachmentVertices->_texture, _glProgramState, prepared.blendFunc, triangles, transform, transformFlags);
+		} else {
+			TwoColorTriangles trianglesTwoColor;
+			trianglesTwoColor.vertCount = prepared.vertexCount;
+			trianglesTwoColor.verts = twoColorBatch->allocateVertices(prepared.vertexCount);
+			memcpy(trianglesTwoColor.verts, _preparedTwoColorVertices.data() + prepared.firstVertex, sizeof(V3F_C4B_C4B_T2F) * prepared.vertexCount);
+			trianglesTwoColor.indexCount = prepared.indexCount;
+			if (prepared.firstIndex < 0) {
+				trianglesTwoColor.indices = indices;
+			} else {
+				trianglesTwoColor.indices = twoColorBatch->allocateIndices(prepared.indexCount);
+				memcpy(trianglesTwoColor.indices, indices, sizeof(unsigned short) * prepared.indexCount);
+			}
+			lastTwoColorTrianglesCommand = twoColorBatch->addCommand(renderer, _globalZOrder, attachmentVertices->_texture->getName(), _glProgramState, prepared.blendFunc, trianglesTwoColor, transform, transformFlags);
 		}
 	}
-	
-	if (_effect) _effect->end(_effect);
-
-	if (_debugSlots || _debugBones || _debugMeshes) {
-        drawDebug(renderer, transform, transformFlags);
-	}
+	return lastTwoColorTrianglesCommand;
 }
 
 void SkeletonRenderer::drawDebug (Renderer* renderer, const Mat4 &transform, uint32_t transformFlags) {
@@ -722,6 +819,14 @@ void SkeletonRenderer::setVertexEffect(spVertexEffect *effect) {
 	this->_effect = effect;
 }
 
+void SkeletonRenderer::setBatchingAcrossSkeletons(bool enabled) {
+	batchingAcrossSkeletons = enabled;
+}
+
+bool SkeletonRenderer::isBatchingAcrossSkeletons() {
+	return batchingAcrossSkeletons;
+}
+
 spSkeleton* SkeletonRenderer::getSkeleton () {
 	return _skeleton;
 }
@@ -32,7 +32,9 @@
 #define SPINE_SKELETONRENDERER_H_
 
 #include "spine/spine.h"
+#include "spine/SkeletonTwoColorBatch.h"
 #include "cocos2d.h"
+#include <vector>
 
 namespace spine {
 
@@ -102,6 +104,12 @@ public:
 	
 	/* Sets the vertex effect to be used, set to 0 to disable vertex effects */
 	void setVertexEffect(spVertexEffect* effect);
+	
+	/* Enables/disables merging the triangles of consecutively drawn skeletons into one command per texture, blend mode
+	 * and shader, instead of one command per attachment. Vertices are then transformed when they are copied to the
+	 * batch. Skeletons rendered as 3D are never merged. Disabled by default. */
+	static void setBatchingAcrossSkeletons(bool enabled);
+	static bool isBatchingAcrossSkeletons();
 
     // --- BlendProtocol
     virtual void setBlendFunc (const cocos2d::BlendFunc& blendFunc)override;
@@ -130,6 +138,24 @@ protected:
 	virtual AttachmentVertices* getAttachmentVertices (spRegionAttachment* attachment) const;
 	virtual AttachmentVertices* getAttachmentVertices (spMeshAttachment* attachment) const;	
 
+	/* Computes the world vertices of all drawn attachments into this renderer's own buffers. Only touches the skeleton,
+	 * its clipper and its vertex effect, so it can run on a worker thread as long as no effect is set. */
+	void prepareVertices (const cocos2d::Color4F& nodeColor, bool isTwoColorTint);
+	/* Copies the prepared vertices into the shared batches and adds their commands to the renderer. Returns the last
+	 * two color command, if any. */
+	TwoColorTrianglesCommand* submitPreparedVertices (cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t transformFlags);
+	cocos2d::Color4F getNodeColor () const;
+
+	struct PreparedAttachment {
+		AttachmentVertices* attachmentVertices;
+		cocos2d::BlendFunc blendFunc;
+		int firstVertex;
+		int vertexCount;
+		// -1 if the attachment's own indices are drawn, otherwise an offset into _preparedIndices
+		int firstIndex;
+		int indexCount;
+	};
+
 	bool _ownsSkeletonData;
 	spAtlas* _atlas;
 	spAttachmentLoader* _attachmentLoader;
@@ -144,6 +170,17 @@ protected:
 	bool _debugMeshes;
 	spSkeletonClipping* _clipper;
 	spVertexEffect* _effect;
+
+	std::vector<PreparedAttachment> _preparedAttachments;
+	std::vector<cocos2d::V3F_C4B_T2F> _preparedVertices;
+	std::vector<V3F_C4B_C4B_T2F> _preparedTwoColorVertices;
+	std::vector<unsigned short> _preparedIndices;
+	int _numPreparedVertices;
+	int _numPreparedIndices;
+	cocos2d::Color4F _preparedNodeColor;
+	bool _preparedTwoColorTint;
+	// frame in which SkeletonUpdater prepared the vertices, draw reuses them during that frame only
+	unsigned int _preparedFrame;
 };
 
 }
@@ -264,6 +264,54 @@ TwoColorTrianglesCommand* SkeletonTwoColorBatch::addCommand(cocos2d::Renderer* r
 	return command;
 }
 	
+TwoColorTrianglesCommand* SkeletonTwoColorBatch::addMergedTriangles(cocos2d::Renderer* renderer, float globalOrder, GLuint textureID, cocos2d::GLProgramState* glProgramState, cocos2d::BlendFunc blendType, const TwoColorTriangles& triangles, const cocos2d::Mat4& mv, uint32_t flags) {
+	TwoColorTrianglesCommand* command = _mergeCommand;
+	if (command) {
+		const TwoColorTriangles& merged = command->getTriangles();
+		bool canMerge = _mergeStamp == renderer->getQueueStamp() &&
+			// the dirty flags don't change the command, only rendering as 3D does
+			((_mergeFlags ^ flags) & Node::FLAGS_RENDER_AS_3D) == 0 &&
+			command->getGlobalOrder() == globalOrder && command->getTextureID() == textureID &&
+			command->getGLProgramState() == glProgramState && command->getBlendType() == blendType &&
+			// a command has to fit into the vertex buffer used by batch()
+			merged.vertCount + triangles.vertCount < MAX_VERTICES &&
+			merged.indexCount + triangles.indexCount < MAX_INDICES &&
+			merged.verts + merged.vertCount == _vertices.data() + _numVertices &&
+			merged.indices + merged.indexCount == _indices->items + _indices->size;
+		if (!canMerge) command = nullptr;
+	}
+	
+	unsigned short vertexOffset = command ? (unsigned short)command->getTriangles().vertCount : 0;
+	V3F_C4B_C4B_T2F* vertices = allocateVertices(triangles.vertCount);
+	unsigned short* indices = allocateIndices(triangles.indexCount);
+	memcpy(vertices, triangles.verts, sizeof(V3F_C4B_C4B_T2F) * triangles.vertCount);
+	for (int i = 0; i < triangles.vertCount; i++) {
+		mv.transformPoint(&vertices[i].position);
+	}
+	for (int i = 0; i < triangles.indexCount; i++) {
+		indices[i] = triangles.indices[i] + vertexOffset;
+	}
+	
+	if (command) {
+		TwoColorTriangles& merged = (TwoColorTriangles&)command->getTriangles();
+		merged.vertCount += triangles.vertCount;
+		merged.indexCount += triangles.indexCount;
+	} else {
+		TwoColorTriangles transformed;
+		transformed.verts = vertices;
+		transformed.vertCount = triangles.vertCount;
+		transformed.indices = indices;
+		transformed.indexCount = triangles.indexCount;
+		command = addCommand(renderer, globalOrder, textureID, glProgramState, blendType, transformed, Mat4::IDENTITY, flags);
+		// whatever gets queued after this command can't be drawn before it
+		command->setForceFlush(true);
+		_mergeCommand = command;
+		_mergeFlags = flags;
+	}
+	_mergeStamp = renderer->getQueueStamp();
+	return command;
+}
+
 void SkeletonTwoColorBatch::batch (TwoColorTrianglesCommand* command) {
 	if (_numVerticesBuffer + command->getTriangles().vertCount >= MAX_VERTICES || _numIndicesBuffer + command->getTriangles().indexCount >= MAX_INDICES) {
 		flush(_lastCommand);
@@ -319,6 +367,10 @@ void SkeletonTwoColorBatch::flush (TwoColorTrianglesCommand* materialCommand) {
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	
+	Renderer* renderer = Director::getInstance()->getRenderer();
+	renderer->addDrawnBatches(1);
+	renderer->addDrawnVertices(_numIndicesBuffer);
+	
 	_numVerticesBuffer = 0;
 	_numIndicesBuffer = 0;
 	_numBatches++;
@@ -332,6 +384,7 @@ void SkeletonTwoColorBatch::reset() {
 	_numIndicesBuffer = 0;
 	_lastCommand = nullptr;
 	_numBatches = 0;
+	_mergeCommand = nullptr;
 }
 
 TwoColorTrianglesCommand* SkeletonTwoColorBatch::nextFreeCommand() {
@@ -114,6 +114,9 @@ namespace spine {
 		void deallocateIndices(uint32_t numIndices);
 
 		TwoColorTrianglesCommand* addCommand(cocos2d::Renderer* renderer, float globalOrder, GLuint textureID, cocos2d::GLProgramState* glProgramState, cocos2d::BlendFunc blendType, const TwoColorTriangles& triangles, const cocos2d::Mat4& mv, uint32_t flags);
+		
+		// Same as SkeletonBatch::addMergedTriangles. The returned command is always flushed after it was batched.
+		TwoColorTrianglesCommand* addMergedTriangles(cocos2d::Renderer* renderer, float globalOrder, GLuint textureID, cocos2d::GLProgramState* glProgramState, cocos2d::BlendFunc blendType, const TwoColorTriangles& triangles, const cocos2d::Mat4& mv, uint32_t flags);
 
 		cocos2d::GLProgramState* getTwoColorTintProgramState () { return _twoColorTintShaderState; }
 		
@@ -123,6 +126,8 @@ namespace spine {
 		
 		uint32_t getNumBatches () { return _numBatches; };
 		
+		uint32_t getNumCommands () const { return _nextFreeCommand; }
+		
     protected:
         SkeletonTwoColorBatch ();
         virtual ~SkeletonTwoColorBatch ();
@@ -163,6 +168,11 @@ namespace spine {
 		
 		// number of batches in the last frame
 		uint32_t _numBatches;
+		
+		// last command of addMergedTriangles and the renderer queue stamp right after it was added or extended
+		TwoColorTrianglesCommand* _mergeCommand;
+		uint32_t _mergeFlags;
+		unsigned int _mergeStamp;
 	};
 }
 
@@ -0,0 +1,168 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "spine/SkeletonUpdater.h"
+#include "spine/SkeletonAnimation.h"
+#include <algorithm>
+
+USING_NS_CC;
+
+namespace spine {
+
+static SkeletonUpdater* instance = nullptr;
+
+// Below this many queued skeletons waking the workers costs more than it saves.
+static const size_t MIN_PARALLEL_JOBS = 4;
+
+SkeletonUpdater* SkeletonUpdater::getInstance () {
+	if (!instance) instance = new SkeletonUpdater();
+	return instance;
+}
+
+void SkeletonUpdater::destroyInstance () {
+	if (instance) {
+		delete instance;
+		instance = nullptr;
+	}
+}
+
+SkeletonUpdater::SkeletonUpdater ()
+	: _enabled(false), _afterUpdateListener(nullptr), _nextJob(0), _generation(0), _busyThreads(0), _quit(false) {
+	// the queued skeletons are updated once every node has run its update for this frame
+	_afterUpdateListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom* eventCustom){
+		this->update(0);
+	});
+}
+
+SkeletonUpdater::~SkeletonUpdater () {
+	update(0);
+	stopThreads();
+	Director::getInstance()->getEventDispatcher()->removeEventListener(_afterUpdateListener);
+}
+
+void SkeletonUpdater::setEnabled (bool enabled) {
+	if (_enabled == enabled) return;
+
+	if (enabled) {
+		startThreads();
+	} else {
+		update(0);
+		stopThreads();
+	}
+	_enabled = enabled;
+}
+
+void SkeletonUpdater::add (SkeletonAnimation* skeleton) {
+	if (skeleton->_updateQueued) return;
+	skeleton->_updateQueued = true;
+	skeleton->retain();
+	_pending.push_back(skeleton);
+}
+
+void SkeletonUpdater::update (float delta) {
+	if (_pending.empty()) return;
+
+	_jobs.swap(_pending);
+	unsigned int frame = Director::getInstance()->getTotalFrames();
+	for (SkeletonAnimation* skeleton : _jobs) {
+		skeleton->beginDeferredUpdate(frame);
+	}
+
+	_nextJob = 0;
+	if (_threads.empty() || _jobs.size() < MIN_PARALLEL_JOBS) {
+		runJobs();
+	} else {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_busyThreads = _threads.size();
+			++_generation;
+		}
+		_startCondition.notify_all();
+
+		runJobs();
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		_doneCondition.wait(lock, [this]{ return _busyThreads == 0; });
+	}
+
+	for (SkeletonAnimation* skeleton : _jobs) {
+		skeleton->_updateQueued = false;
+		skeleton->release();
+	}
+	_jobs.clear();
+}
+
+void SkeletonUpdater::runJobs () {
+	size_t count = _jobs.size();
+	for (size_t i = _nextJob++; i < count; i = _nextJob++) {
+		_jobs[i]->deferredUpdate();
+	}
+}
+
+void SkeletonUpdater::startThreads () {
+	// the main thread works on the jobs too
+	unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+	unsigned int numThreads = std::min(cores - 1, 7u);
+
+	_quit = false;
+	for (unsigned int i = 0; i < numThreads; ++i) {
+		_threads.emplace_back(&SkeletonUpdater::workerLoop, this, _generation);
+	}
+}
+
+void SkeletonUpdater::stopThreads () {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_startCondition.notify_all();
+	for (std::thread& thread : _threads) {
+		thread.join();
+	}
+	_threads.clear();
+}
+
+void SkeletonUpdater::workerLoop (unsigned int generation) {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_startCondition.wait(lock, [&]{ return _quit || _generation != generation; });
+			if (_quit) return;
+			generation = _generation;
+		}
+
+		runJobs();
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (--_busyThreads == 0) _doneCondition.notify_one();
+	}
+}
+
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONUPDATER_H_
+#define SPINE_SKELETONUPDATER_H_
+
+#include "cocos2d.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spine {
+
+class SkeletonAnimation;
+
+/* Updates the animation state, world transform and vertices of all SkeletonAnimations on worker threads after the
+ * scheduler has run and before the scene is drawn. Disabled by default.
+ *
+ * While enabled, SkeletonAnimation::update only queues the skeleton and everything is computed at once when the
+ * update phase ends, so bone positions read from other update callbacks are those of the previous frame. Call
+ * update() to compute the queued skeletons right away. Skeletons with listeners still apply their animation state on
+ * the main thread so that listeners are never called from a worker, and skeletons with a vertex effect prepare their
+ * vertices in draw as before, since effects are usually shared between skeletons. */
+class SkeletonUpdater {
+public:
+	static SkeletonUpdater* getInstance ();
+
+	static void destroyInstance ();
+
+	void setEnabled (bool enabled);
+	bool isEnabled () const { return _enabled; }
+
+	/* Queues a skeleton for the next update, retaining it until then. */
+	void add (SkeletonAnimation* skeleton);
+
+	/* Updates all queued skeletons, using the calling thread and the worker threads. Called automatically after each
+	 * scheduler update. */
+	void update (float delta);
+
+protected:
+	SkeletonUpdater ();
+	virtual ~SkeletonUpdater ();
+
+	void startThreads ();
+	void stopThreads ();
+	// generation is the value of _generation when the thread was started
+	void workerLoop (unsigned int generation);
+	void runJobs ();
+
+	bool _enabled;
+	cocos2d::EventListenerCustom* _afterUpdateListener;
+
+	std::vector<SkeletonAnimation*> _pending;
+	std::vector<SkeletonAnimation*> _jobs;
+	std::atomic<size_t> _nextJob;
+
+	std::vector<std::thread> _threads;
+	std::mutex _mutex;
+	std::condition_variable _startCondition;
+	std::condition_variable _doneCondition;
+	unsigned int _generation;
+	size_t _busyThreads;
+	bool _quit;
+};
+
+}
+
+#endif // SPINE_SKELETONUPDATER_H_
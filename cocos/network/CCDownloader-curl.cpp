@@ -28,6 +28,7 @@
 #include <set>
 
 #include <curl/curl.h>
+#include "zlib.h"
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
@@ -40,6 +41,10 @@
 // member function without suffix designed called in main thread
 
 #define CC_CURL_POLL_TIMEOUT_MS 50 //wait until DNS query done
+#define CC_CURL_MIN_CHUNK_SIZE (4 * 1024 * 1024) // files are split only if every chunk gets at least this size
+#define CC_CURL_CHUNK_STATE_SAVE_INTERVAL (8 * 1024 * 1024) // bytes received between two saves of the chunk state file
+#define CC_CURL_CHUNK_STATE_SUFFIX ".chunks"
+#define CC_CURL_CHUNK_STATE_VERSION 1
 
 namespace cocos2d { namespace network {
     using namespace std;
@@ -47,6 +52,31 @@ namespace cocos2d { namespace network {
 ////////////////////////////////////////////////////////////////////////////////
 //  Implementation DownloadTaskCURL
 
+    static int _seekFile(FILE *fp, int64_t offset)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        return _fseeki64(fp, offset, SEEK_SET);
+#else
+        return fseeko(fp, (off_t)offset, SEEK_SET);
+#endif
+    }
+
+    // One range of a file task downloaded over its own connection.
+    // The crc covers the bytes received so far, it's saved in the chunk state file and checked again before resuming.
+    struct DownloadChunkCURL
+    {
+        DownloadTaskCURL*   task;
+        CURL*               handle;
+        curl_slist*         headers;
+        FILE*               fp;
+        int64_t             offset;
+        int64_t             size;
+        int64_t             received;
+        uLong               crc;
+        bool                rangeChecked;   // the response is a 206 for the requested range
+        string              error;
+    };
+
     class DownloadTaskCURL : public IDownloadTask
     {
         static int _sSerialId;
@@ -78,6 +108,7 @@ namespace cocos2d { namespace network {
                 fclose(_fp);
                 _fp = nullptr;
             }
+            closeChunksProc();
             DLLOG("Destruct DownloadTaskCURL %p", this);
         }
 
@@ -191,6 +222,206 @@ namespace cocos2d { namespace network {
             return ret;
         }
 
+        size_t writeChunkDataProc(DownloadChunkCURL& chunk, unsigned char *buffer, size_t len)
+        {
+            if (chunk.received + (int64_t)len > chunk.size)
+            {
+                chunk.error = "Server sent more data than the requested range.";
+                return 0;
+            }
+            if (fwrite(buffer, 1, len, chunk.fp) != len)
+            {
+                chunk.error = "Can't write file:";
+                chunk.error.append(_tempFileName);
+                return 0;
+            }
+            chunk.crc = crc32(chunk.crc, buffer, (uInt)len);
+            chunk.received += len;
+
+            {
+                lock_guard<mutex> lock(_mutex);
+                _bytesReceived += len;
+                _totalBytesReceived += len;
+            }
+
+            // checkpoint, so a crash loses at most CC_CURL_CHUNK_STATE_SAVE_INTERVAL bytes
+            _unsavedBytes += len;
+            if (_unsavedBytes >= CC_CURL_CHUNK_STATE_SAVE_INTERVAL)
+            {
+                saveChunkStateProc();
+            }
+            return len;
+        }
+
+        string chunkStateFileName() const
+        {
+            return _tempFileName + CC_CURL_CHUNK_STATE_SUFFIX;
+        }
+
+        // split the file in chunks, the bytes already in the temp file are kept as received
+        void splitChunksProc(uint32_t maxChunks, int64_t receivedSize)
+        {
+            int64_t count = std::min((int64_t)maxChunks, _totalBytesExpected / CC_CURL_MIN_CHUNK_SIZE);
+            int64_t chunkSize = _totalBytesExpected / count;
+            _chunks.resize((size_t)count);
+            for (int64_t i = 0; i < count; ++i)
+            {
+                DownloadChunkCURL& chunk = _chunks[(size_t)i];
+                chunk.offset = i * chunkSize;
+                chunk.size = (i == count - 1) ? _totalBytesExpected - chunk.offset : chunkSize;
+                chunk.received = std::max((int64_t)0, std::min(chunk.size, receivedSize - chunk.offset));
+            }
+            _initChunksProc();
+        }
+
+        // load the chunks saved by a previous download of the same file version
+        bool loadChunkStateProc()
+        {
+            FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(chunkStateFileName()).c_str(), "rb");
+            if (nullptr == fp)
+            {
+                return false;
+            }
+
+            bool ret = false;
+            do
+            {
+                char line[1024];
+                int version = 0;
+                long long totalSize = 0;
+                int count = 0;
+                if (nullptr == fgets(line, sizeof(line), fp) || 1 != sscanf(line, "%d", &version) || CC_CURL_CHUNK_STATE_VERSION != version)
+                {
+                    break;
+                }
+                if (nullptr == fgets(line, sizeof(line), fp) || 2 != sscanf(line, "%lld %d", &totalSize, &count)
+                    || totalSize != _totalBytesExpected || count <= 0)
+                {
+                    break;
+                }
+                // the validator line tells whether the file changed on the server since the chunks were received
+                if (nullptr == fgets(line, sizeof(line), fp) || _validator != string(line, strcspn(line, "\r\n")))
+                {
+                    break;
+                }
+
+                _chunks.resize(count);
+                _initChunksProc();
+                int64_t expectedOffset = 0;
+                int i = 0;
+                for (; i < count; ++i)
+                {
+                    DownloadChunkCURL& chunk = _chunks[i];
+                    long long offset = 0, size = 0, received = 0;
+                    unsigned long crc = 0;
+                    if (nullptr == fgets(line, sizeof(line), fp)
+                        || 4 != sscanf(line, "%lld %lld %lld %lu", &offset, &size, &received, &crc)
+                        || offset != expectedOffset || size <= 0 || received < 0 || received > size)
+                    {
+                        break;
+                    }
+                    chunk.offset = offset;
+                    chunk.size = size;
+                    chunk.received = received;
+                    chunk.crc = (uLong)crc;
+                    expectedOffset += size;
+                }
+                ret = (i == count && expectedOffset == _totalBytesExpected);
+            } while (0);
+            fclose(fp);
+
+            if (!ret)
+            {
+                _chunks.clear();
+            }
+            return ret;
+        }
+
+        void saveChunkStateProc()
+        {
+            _unsavedBytes = 0;
+            // the state must never claim bytes that are still in a write buffer
+            for (auto& chunk : _chunks)
+            {
+                if (chunk.fp)
+                {
+                    fflush(chunk.fp);
+                }
+            }
+
+            FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(chunkStateFileName()).c_str(), "wb");
+            if (nullptr == fp)
+            {
+                return;
+            }
+            fprintf(fp, "%d\n%lld %d\n%s\n", CC_CURL_CHUNK_STATE_VERSION, (long long)_totalBytesExpected, (int)_chunks.size(), _validator.c_str());
+            for (auto& chunk : _chunks)
+            {
+                fprintf(fp, "%lld %lld %lld %lu\n", (long long)chunk.offset, (long long)chunk.size, (long long)chunk.received, (unsigned long)chunk.crc);
+            }
+            fclose(fp);
+        }
+
+        // compute the crc of the received part of each chunk from the temp file,
+        // chunks whose data doesn't match the saved crc are downloaded again
+        void verifyChunksProc(bool adopt)
+        {
+            FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(_tempFileName).c_str(), "rb");
+            vector<unsigned char> buf(64 * 1024);
+            for (auto& chunk : _chunks)
+            {
+                if (0 == chunk.received)
+                {
+                    continue;
+                }
+
+                uLong crc = crc32(0L, Z_NULL, 0);
+                int64_t remain = chunk.received;
+                if (fp && 0 == _seekFile(fp, chunk.offset))
+                {
+                    while (remain > 0)
+                    {
+                        size_t len = fread(buf.data(), 1, (size_t)std::min(remain, (int64_t)buf.size()), fp);
+                        if (0 == len)
+                        {
+                            break;
+                        }
+                        crc = crc32(crc, buf.data(), (uInt)len);
+                        remain -= len;
+                    }
+                }
+
+                if (remain > 0 || (!adopt && crc != chunk.crc))
+                {
+                    DLLOG("    DownloadTaskCURL: chunk at %lld of %s is damaged, download it again", (long long)chunk.offset, _tempFileName.c_str());
+                    chunk.received = 0;
+                    crc = crc32(0L, Z_NULL, 0);
+                }
+                chunk.crc = crc;
+            }
+            if (fp)
+            {
+                fclose(fp);
+            }
+        }
+
+        void closeChunksProc()
+        {
+            for (auto& chunk : _chunks)
+            {
+                if (chunk.fp)
+                {
+                    fclose(chunk.fp);
+                    chunk.fp = nullptr;
+                }
+                if (chunk.headers)
+                {
+                    curl_slist_free_all(chunk.headers);
+                    chunk.headers = nullptr;
+                }
+            }
+        }
+
     private:
         friend class DownloaderCURL;
 
@@ -219,6 +450,24 @@ namespace cocos2d { namespace network {
         vector<unsigned char> _buf;
         FILE*  _fp;
 
+        // for chunked download, only used in thread proc
+        string _validator;      // ETag or Last-Modified of the file, sent as If-Range with every chunk
+        vector<DownloadChunkCURL> _chunks;
+        int64_t _unsavedBytes;
+
+        void _initChunksProc()
+        {
+            for (auto& chunk : _chunks)
+            {
+                chunk.task = this;
+                chunk.handle = nullptr;
+                chunk.headers = nullptr;
+                chunk.fp = nullptr;
+                chunk.crc = crc32(0L, Z_NULL, 0);
+                chunk.rangeChecked = false;
+            }
+        }
+
         void _initInternal()
         {
             _acceptRanges = (false);
@@ -230,12 +479,17 @@ namespace cocos2d { namespace network {
             _errCodeInternal = (CURLE_OK);
             _header.resize(0);
             _header.reserve(384);   // pre alloc header string buffer
+            _validator.clear();
+            closeChunksProc();
+            _chunks.clear();
+            _unsavedBytes = 0;
         }
     };
     int DownloadTaskCURL::_sSerialId;
     set<string> DownloadTaskCURL::_sStoragePathSet;
 
     typedef pair< shared_ptr<const DownloadTask>, DownloadTaskCURL *> TaskWrapper;
+    typedef unordered_map<CURL*, pair<TaskWrapper, DownloadChunkCURL*>> ChunkMap;
 
 ////////////////////////////////////////////////////////////////////////////////
 //  Implementation DownloaderCURL::Impl
@@ -329,6 +583,97 @@ namespace cocos2d { namespace network {
             return coTask->writeDataProc((unsigned char *)buffer, size, count);
         }
 
+        // name should be in lower case
+        static bool _isHeaderField(const string& line, const char *name)
+        {
+            size_t len = strlen(name);
+            if (line.size() < len)
+            {
+                return false;
+            }
+            for (size_t i = 0; i < len; ++i)
+            {
+                if (tolower((unsigned char)line[i]) != name[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static size_t _chunkHeaderCallbackProc(void *buffer, size_t size, size_t count, void *userdata)
+        {
+            size_t len = size * count;
+            DownloadChunkCURL& chunk = *((DownloadChunkCURL*)userdata);
+            string line((const char *)buffer, len);
+            if (0 == line.compare(0, 5, "HTTP/"))
+            {
+                // a new response begins, after a redirection for example
+                chunk.rangeChecked = false;
+            }
+            else if (_isHeaderField(line, "content-range:"))
+            {
+                long long first = -1, last = -1, total = -1;
+                sscanf(line.c_str() + 14, " bytes %lld-%lld/%lld", &first, &last, &total);
+                chunk.rangeChecked = (first == chunk.offset + chunk.received
+                                      && last == chunk.offset + chunk.size - 1
+                                      && total == chunk.task->_totalBytesExpected);
+            }
+            return len;
+        }
+
+        static size_t _outputChunkCallbackProc(void *buffer, size_t size, size_t count, void *userdata)
+        {
+            DownloadChunkCURL& chunk = *((DownloadChunkCURL*)userdata);
+            // a server ignoring the range or If-Range sends the whole file with 200
+            if (!chunk.rangeChecked)
+            {
+                chunk.error = "Server did not return the requested range.";
+                return 0;
+            }
+            return chunk.task->writeChunkDataProc(chunk, (unsigned char *)buffer, size * count);
+        }
+
+        // the ETag, or the Last-Modified date if there is no strong ETag, of the last response in the header string
+        static string _getValidator(const string& header)
+        {
+            string etag;
+            string lastModified;
+            size_t begin = 0;
+            while (begin < header.size())
+            {
+                size_t end = header.find('\n', begin);
+                if (string::npos == end)
+                {
+                    end = header.size();
+                }
+                string line = header.substr(begin, end - begin);
+                begin = end + 1;
+
+                size_t valueEnd = line.find_last_not_of(" \t\r");
+                line.resize(string::npos == valueEnd ? 0 : valueEnd + 1);
+                if (0 == line.compare(0, 5, "HTTP/"))
+                {
+                    etag.clear();
+                    lastModified.clear();
+                }
+                else if (_isHeaderField(line, "etag:"))
+                {
+                    etag = line.substr(std::min(line.size(), line.find_first_not_of(" \t", 5)));
+                }
+                else if (_isHeaderField(line, "last-modified:"))
+                {
+                    lastModified = line.substr(std::min(line.size(), line.find_first_not_of(" \t", 14)));
+                }
+            }
+            // If-Range only accepts strong validators
+            if (etag.length() && 0 != etag.compare(0, 2, "W/"))
+            {
+                return etag;
+            }
+            return lastModified;
+        }
+
         // this function designed call in work thread
         // the curl handle destroyed in _threadProc
         // handle inited for get header
@@ -398,6 +743,32 @@ namespace cocos2d { namespace network {
             }
         }
 
+        // handle inited for download a range of the file
+        void _initChunkHandleProc(CURL *handle, TaskWrapper& wrapper, DownloadChunkCURL& chunk)
+        {
+            _initCurlHandleProc(handle, wrapper, true);
+
+            curl_easy_setopt(handle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+            curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, DownloaderCURL::Impl::_outputChunkCallbackProc);
+            curl_easy_setopt(handle, CURLOPT_WRITEDATA, &chunk);
+            curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, DownloaderCURL::Impl::_chunkHeaderCallbackProc);
+            curl_easy_setopt(handle, CURLOPT_HEADERDATA, &chunk);
+
+            char range[64];
+            sprintf(range, "%lld-%lld", (long long)(chunk.offset + chunk.received), (long long)(chunk.offset + chunk.size - 1));
+            curl_easy_setopt(handle, CURLOPT_RANGE, range);
+
+            // if the file changed on the server, it returns the whole new file instead of the range
+            const string& validator = wrapper.second->_validator;
+            if (validator.length())
+            {
+                chunk.headers = curl_slist_append(nullptr, ("If-Range: " + validator).c_str());
+                curl_easy_setopt(handle, CURLOPT_HTTPHEADER, chunk.headers);
+            }
+            chunk.rangeChecked = false;
+            chunk.error.clear();
+        }
+
         // get header info, if success set handle to content download state
         bool _getHeaderInfoProc(CURL *handle, TaskWrapper& wrapper)
         {
@@ -433,8 +804,10 @@ namespace cocos2d { namespace network {
                 bool acceptRanges = (string::npos != coTask._header.find("Accept-Ranges")) ? true : false;
 
                 // get current file size
+                // the temp file of a chunked download has the full size, the received size is in the chunk state file
                 int64_t fileSize = 0;
-                if (acceptRanges && coTask._tempFileName.length())
+                if (acceptRanges && coTask._tempFileName.length()
+                    && false == FileUtils::getInstance()->isFileExist(coTask.chunkStateFileName()))
                 {
                     fileSize = FileUtils::getInstance()->getFileSize(coTask._tempFileName);
                 }
@@ -443,6 +816,7 @@ namespace cocos2d { namespace network {
                 lock_guard<mutex> lock(coTask._mutex);
                 coTask._totalBytesExpected = (int64_t)contentLen;
                 coTask._acceptRanges = acceptRanges;
+                coTask._validator = _getValidator(coTask._header);
                 if (acceptRanges && fileSize > 0)
                 {
                     coTask._totalBytesReceived = fileSize;
@@ -457,6 +831,250 @@ namespace cocos2d { namespace network {
             return coTask._headerAchieved;
         }
 
+        void _truncateTempFileProc(DownloadTaskCURL& coTask)
+        {
+            lock_guard<mutex> lock(coTask._mutex);
+            if (coTask._fp)
+            {
+                fclose(coTask._fp);
+            }
+            coTask._fp = fopen(FileUtils::getInstance()->getSuitableFOpen(coTask._tempFileName).c_str(), "wb");
+            coTask._totalBytesReceived = 0;
+            if (nullptr == coTask._fp)
+            {
+                coTask._errCode = DownloadTask::ERROR_FILE_OP_FAILED;
+                coTask._errCodeInternal = 0;
+                coTask._errDescription = "Can't open file:";
+                coTask._errDescription.append(coTask._tempFileName);
+            }
+        }
+
+        // after get header info, decide whether the content of a file task is downloaded in chunks,
+        // either resuming the chunks of the state file or splitting a large file
+        bool _prepareChunksProc(TaskWrapper& wrapper)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            if (0 == coTask._tempFileName.length())
+            {
+                return false;
+            }
+
+            auto util = FileUtils::getInstance();
+            bool canSplit = coTask._acceptRanges && coTask._totalBytesExpected > 0;
+            if (util->isFileExist(coTask.chunkStateFileName()))
+            {
+                if (canSplit && coTask.loadChunkStateProc())
+                {
+                    coTask.verifyChunksProc(false);
+                }
+                else
+                {
+                    // the file changed on the server or the state is broken, the data in the temp file can't be used
+                    util->removeFile(coTask.chunkStateFileName());
+                    _truncateTempFileProc(coTask);
+                }
+            }
+
+            if (coTask._chunks.empty())
+            {
+                if (!canSplit
+                    || hints.countOfMaxChunksPerTask < 2
+                    || coTask._totalBytesExpected < 2 * CC_CURL_MIN_CHUNK_SIZE
+                    || DownloadTask::ERROR_NO_ERROR != coTask._errCode)
+                {
+                    return false;
+                }
+                if (coTask._totalBytesReceived > coTask._totalBytesExpected)
+                {
+                    _truncateTempFileProc(coTask);
+                }
+                coTask.splitChunksProc(hints.countOfMaxChunksPerTask, coTask._totalBytesReceived);
+                coTask.verifyChunksProc(true);
+            }
+
+            // save the state before the temp file grows to the full size,
+            // a full size temp file without state file is taken as a finished download
+            coTask.saveChunkStateProc();
+            if (util->getFileSize(coTask._tempFileName) < coTask._totalBytesExpected)
+            {
+                FILE *fp = fopen(util->getSuitableFOpen(coTask._tempFileName).c_str(), "r+b");
+                bool resized = fp && 0 == _seekFile(fp, coTask._totalBytesExpected - 1) && EOF != fputc(0, fp);
+                if (fp && 0 != fclose(fp))
+                {
+                    resized = false;
+                }
+                if (!resized)
+                {
+                    string desc = "Can't resize file:" + coTask._tempFileName;
+                    coTask.setErrorProc(DownloadTask::ERROR_FILE_OP_FAILED, 0, desc.c_str());
+                    return false;
+                }
+            }
+
+            int64_t received = 0;
+            for (auto& chunk : coTask._chunks)
+            {
+                received += chunk.received;
+            }
+            lock_guard<mutex> lock(coTask._mutex);
+            coTask._totalBytesReceived = received;
+            return true;
+        }
+
+        // returns the count of chunks started, none is started if the task failed or all chunks have been received
+        int _startChunksProc(CURLM *curlmHandle, TaskWrapper& wrapper, ChunkMap& chunkMap)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            auto util = FileUtils::getInstance();
+            int started = 0;
+            for (auto& chunk : coTask._chunks)
+            {
+                if (chunk.received == chunk.size)
+                {
+                    continue;
+                }
+
+                chunk.fp = fopen(util->getSuitableFOpen(coTask._tempFileName).c_str(), "r+b");
+                if (nullptr == chunk.fp || 0 != _seekFile(chunk.fp, chunk.offset + chunk.received))
+                {
+                    string desc = "Can't open file:" + coTask._tempFileName;
+                    coTask.setErrorProc(DownloadTask::ERROR_FILE_OP_FAILED, 0, desc.c_str());
+                    break;
+                }
+
+                chunk.handle = curl_easy_init();
+                if (nullptr == chunk.handle)
+                {
+                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, 0, "Alloc curl handle failed.");
+                    break;
+                }
+                _initChunkHandleProc(chunk.handle, wrapper, chunk);
+                CURLMcode mcode = curl_multi_add_handle(curlmHandle, chunk.handle);
+                if (CURLM_OK != mcode)
+                {
+                    curl_easy_cleanup(chunk.handle);
+                    chunk.handle = nullptr;
+                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+                    break;
+                }
+                chunkMap[chunk.handle] = make_pair(wrapper, &chunk);
+                ++started;
+            }
+
+            if (DownloadTask::ERROR_NO_ERROR != coTask._errCode)
+            {
+                for (auto& chunk : coTask._chunks)
+                {
+                    if (chunk.handle)
+                    {
+                        _cleanupChunkProc(curlmHandle, chunk, chunkMap);
+                    }
+                }
+                coTask.closeChunksProc();
+                return 0;
+            }
+            if (0 == started)
+            {
+                FileUtils::getInstance()->removeFile(coTask.chunkStateFileName());
+            }
+            DLLOG("    _threadProc task start %d of %d chunks", started, (int)coTask._chunks.size());
+            return started;
+        }
+
+        void _cleanupChunkProc(CURLM *curlmHandle, DownloadChunkCURL& chunk, ChunkMap& chunkMap)
+        {
+            curl_multi_remove_handle(curlmHandle, chunk.handle);
+            curl_easy_cleanup(chunk.handle);
+            chunkMap.erase(chunk.handle);
+            chunk.handle = nullptr;
+            if (chunk.fp)
+            {
+                fclose(chunk.fp);
+                chunk.fp = nullptr;
+            }
+            if (chunk.headers)
+            {
+                curl_slist_free_all(chunk.headers);
+                chunk.headers = nullptr;
+            }
+        }
+
+        // returns true if it is the last running chunk of the task
+        bool _finishChunkProc(CURLM *curlmHandle, CURL *curlHandle, CURLcode errCode, ChunkMap& chunkMap)
+        {
+            auto item = chunkMap[curlHandle];
+            DownloadTaskCURL& coTask = *item.first.second;
+            DownloadChunkCURL& chunk = *item.second;
+            _cleanupChunkProc(curlmHandle, chunk, chunkMap);
+
+            string error;
+            if (chunk.error.length())
+            {
+                // the transfer was aborted by the write callback
+                error = chunk.error;
+            }
+            else if (CURLE_OK != errCode)
+            {
+                error = curl_easy_strerror(errCode);
+            }
+            else if (chunk.received != chunk.size)
+            {
+                error = "Connection closed before the whole range was received.";
+            }
+
+            if (error.length())
+            {
+                if (DownloadTask::ERROR_NO_ERROR == coTask._errCode)
+                {
+                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, error.c_str());
+                }
+                // stop the other chunks, the data received is kept for the next try
+                for (auto& other : coTask._chunks)
+                {
+                    if (other.handle)
+                    {
+                        _cleanupChunkProc(curlmHandle, other, chunkMap);
+                    }
+                }
+            }
+
+            for (auto& other : coTask._chunks)
+            {
+                if (other.handle)
+                {
+                    coTask.saveChunkStateProc();
+                    return false;
+                }
+            }
+
+            if (DownloadTask::ERROR_NO_ERROR == coTask._errCode)
+            {
+                FileUtils::getInstance()->removeFile(coTask.chunkStateFileName());
+            }
+            else
+            {
+                coTask.saveChunkStateProc();
+            }
+            return true;
+        }
+
+        void _finishTaskProc(TaskWrapper& wrapper)
+        {
+            // remove from _processSet
+            {
+                lock_guard<mutex> lock(_processMutex);
+                if (_processSet.end() != _processSet.find(wrapper)) {
+                    _processSet.erase(wrapper);
+                }
+            }
+
+            // add to finishedQueue
+            {
+                lock_guard<mutex> lock(_finishedMutex);
+                _finishedQueue.push_back(wrapper);
+            }
+        }
+
         void _threadProc()
         {
             DLLOG("++++DownloaderCURL::Impl::_threadProc begin %p", this);
@@ -467,6 +1085,8 @@ namespace cocos2d { namespace network {
             // init curl content
             CURLM* curlmHandle = curl_multi_init();
             unordered_map<CURL*, TaskWrapper> coTaskMap;
+            ChunkMap chunkMap;          // handles of the tasks downloaded in chunks
+            size_t countOfChunkedTasks = 0;
             int runningHandles = 0;
             CURLMcode mcode = CURLM_OK;
             int rc = 0;                 // select return code
@@ -532,7 +1152,7 @@ namespace cocos2d { namespace network {
                     }
                 }
 
-                if (!coTaskMap.empty())
+                if (!coTaskMap.empty() || !chunkMap.empty())
                 {
                     mcode = CURLM_CALL_MULTI_PERFORM;
                     while(CURLM_CALL_MULTI_PERFORM == mcode)
@@ -553,11 +1173,23 @@ namespace cocos2d { namespace network {
                             CURL *curlHandle = m->easy_handle;
                             CURLcode errCode = m->data.result;
 
+                            if (chunkMap.end() != chunkMap.find(curlHandle))
+                            {
+                                TaskWrapper wrapper = chunkMap[curlHandle].first;
+                                if (_finishChunkProc(curlmHandle, curlHandle, errCode, chunkMap))
+                                {
+                                    --countOfChunkedTasks;
+                                    _finishTaskProc(wrapper);
+                                }
+                                continue;
+                            }
+
                             TaskWrapper wrapper = coTaskMap[curlHandle];
 
                             // remove from multi-handle
                             curl_multi_remove_handle(curlmHandle, curlHandle);
                             bool reinited = false;
+                            bool chunked = false;
                             do
                             {
                                 if (CURLE_OK != errCode)
@@ -590,6 +1222,20 @@ namespace cocos2d { namespace network {
                                     // break to move this task to finish queue
                                     break;
                                 }
+
+                                // large file is downloaded in chunks over several connections
+                                bool split = _prepareChunksProc(wrapper);
+                                if (DownloadTask::ERROR_NO_ERROR != wrapper.second->_errCode)
+                                {
+                                    break;
+                                }
+                                if (split)
+                                {
+                                    // if no chunk started, the task failed or the chunks have been received before
+                                    chunked = (_startChunksProc(curlmHandle, wrapper, chunkMap) > 0);
+                                    break;
+                                }
+
                                 // reinit curl handle for download content
                                 curl_easy_reset(curlHandle);
                                 _initCurlHandleProc(curlHandle, wrapper, true);
@@ -612,25 +1258,20 @@ namespace cocos2d { namespace network {
                            // remove from coTaskMap
                             coTaskMap.erase(curlHandle);
 
-                            // remove from _processSet
+                            // the task goes on with the chunk handles
+                            if (chunked)
                             {
-                                lock_guard<mutex> lock(_processMutex);
-                                if (_processSet.end() != _processSet.find(wrapper)) {
-                                    _processSet.erase(wrapper);
-                                }
+                                ++countOfChunkedTasks;
+                                continue;
                             }
 
-                            // add to finishedQueue
-                            {
-                                lock_guard<mutex> lock(_finishedMutex);
-                                _finishedQueue.push_back(wrapper);
-                            }
+                            _finishTaskProc(wrapper);
                         }
                     } while(m);
                 }
 
                 // process tasks in _requestList
-                auto size = coTaskMap.size();
+                auto size = coTaskMap.size() + countOfChunkedTasks;
                 while (0 == countOfMaxProcessingTasks || size < countOfMaxProcessingTasks)
                 {
                     // get task wrapper from request queue
@@ -678,10 +1319,11 @@ namespace cocos2d { namespace network {
 
                     DLLOG("    _threadProc task create curl handle:%p", curlHandle);
                     coTaskMap[curlHandle] = wrapper;
+                    ++size;
                     lock_guard<mutex> lock(_processMutex);
                     _processSet.insert(wrapper);
                 }
-            } while (!coTaskMap.empty());
+            } while (!coTaskMap.empty() || !chunkMap.empty());
 
             curl_multi_cleanup(curlmHandle);
             this->stop();
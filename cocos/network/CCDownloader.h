@@ -64,6 +64,9 @@ namespace cocos2d { namespace network {
         uint32_t countOfMaxProcessingTasks;
         uint32_t timeoutInSeconds;
         std::string tempFileNameSuffix;
+        // Large file tasks are split into up to this many ranges downloaded over parallel connections
+        // when the server accepts ranges, 0 or 1 downloads every file over a single connection.
+        uint32_t countOfMaxChunksPerTask;
     };
 
     class CC_DLL Downloader final
@@ -710,6 +710,9 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
         recvBuffer->insert(recvBuffer->begin(), (char*)contentInfo, ((char*)contentInfo) + urlConnection.getContentLength());
     }
     free(contentInfo);
+
+    // the whole body arrives at once, hand it to the destination selected on the request
+    bool sinkSucceed = response->flushResponseDataToSink();
     
     char *messageInfo = urlConnection.getResponseMessage();
     if (messageInfo)
@@ -728,6 +731,10 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
         response->setSucceed(false);
         response->setErrorBuffer(responseMessage);
     }
+    else if (!sinkSucceed)
+    {
+        response->setSucceed(false);
+    }
     else
     {
         response->setSucceed(true);
@@ -859,6 +866,14 @@ void HttpClient::destroyInstance()
     CCLOG("HttpClient::destroyInstance() finished!");
 }
 
+void HttpClient::resume(HttpResponse* response)
+{
+    if (response)
+    {
+        response->requestResume();
+    }
+}
+
 void HttpClient::enableCookies(const char* cookieFile) 
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
@@ -882,6 +897,8 @@ HttpClient::HttpClient()
 : _isInited(false)
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConnections(16)
+, _maxConnectionsPerHost(6)
 , _threadCount(0)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
@@ -1074,6 +1091,30 @@ int HttpClient::getTimeoutForRead()
     return _timeoutForRead;
 }
     
+void HttpClient::setMaxConnections(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    _maxConnections = value;
+}
+    
+int HttpClient::getMaxConnections()
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    return _maxConnections;
+}
+    
+void HttpClient::setMaxConnectionsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    _maxConnectionsPerHost = value;
+}
+    
+int HttpClient::getMaxConnectionsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    return _maxConnectionsPerHost;
+}
+    
 const std::string& HttpClient::getCookieFilename()
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
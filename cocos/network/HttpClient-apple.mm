@@ -336,6 +336,14 @@ void HttpClient::destroyInstance()
     CCLOG("HttpClient::destroyInstance() finished!");
 }
 
+void HttpClient::resume(HttpResponse* response)
+{
+    if (response)
+    {
+        response->requestResume();
+    }
+}
+
 void HttpClient::enableCookies(const char* cookieFile)
 {
     _cookieFileMutex.lock();
@@ -368,6 +376,8 @@ HttpClient::HttpClient()
 : _isInited(false)
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConnections(16)
+, _maxConnectionsPerHost(6)
 , _threadCount(0)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
@@ -523,6 +533,15 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
                            response->getResponseHeader(),
                            responseMessage);
 
+    // the whole body arrives at once, hand it to the destination selected on the request
+    if (retValue != 0 && !response->flushResponseDataToSink())
+    {
+        // the reason is already in the error buffer
+        response->setResponseCode(responseCode);
+        response->setSucceed(false);
+        return;
+    }
+
     // write data to HttpResponse
     response->setResponseCode(responseCode);
 
@@ -618,6 +637,30 @@ int HttpClient::getTimeoutForRead()
     return _timeoutForRead;
 }
 
+void HttpClient::setMaxConnections(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    _maxConnections = value;
+}
+
+int HttpClient::getMaxConnections()
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    return _maxConnections;
+}
+
+void HttpClient::setMaxConnectionsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    _maxConnectionsPerHost = value;
+}
+
+int HttpClient::getMaxConnectionsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    return _maxConnectionsPerHost;
+}
+
 const std::string& HttpClient::getCookieFilename()
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
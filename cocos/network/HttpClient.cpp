@@ -26,7 +26,12 @@
  ****************************************************************************/
 
 #include "network/HttpClient.h"
+#include <algorithm>
+#include <memory>
 #include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
 #include <errno.h>
 #include <curl/curl.h>
 #include "base/CCDirector.h"
@@ -42,96 +47,211 @@ typedef int int32_t;
 
 static HttpClient* _httpClient = nullptr; // pointer to singleton
 
+// multi handle of the network thread, guarded by the request queue mutex
+static CURLM* s_multiHandle = nullptr;
+
+// how long the network thread waits for socket activity before it checks for new requests
+static const int HTTP_MULTI_POLL_TIMEOUT_MS = 1000;
+static const int HTTP_MULTI_WAIT_TIMEOUT_MS = 10;
+
+// idle connections kept alive when the number of connections is not limited
+static const int HTTP_MIN_CACHED_CONNECTIONS = 16;
+
+// minimum time between two progress notifications of a request
+static const int HTTP_PROGRESS_INTERVAL_MS = 100;
+
 typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
 
+// Cookies of every transfer live in one share handle, so concurrent requests see each other's cookies.
+// The cookie file is only read and written by jarHandle, rather than by the cleanup of every transfer.
+struct HttpCookieShare
+{
+    std::mutex mutex;                       // guards the members below
+    std::mutex locks[CURL_LOCK_DATA_LAST];  // taken by libcurl through the share callbacks
+    CURLSH* share;
+    CURL* jarHandle;
+    std::string filename;
+};
+static HttpCookieShare s_cookieShare = {};
+
+static void lockCookieShare(CURL* /*handle*/, curl_lock_data data, curl_lock_access /*access*/, void* /*userptr*/)
+{
+    s_cookieShare.locks[data].lock();
+}
+
+static void unlockCookieShare(CURL* /*handle*/, curl_lock_data data, void* /*userptr*/)
+{
+    s_cookieShare.locks[data].unlock();
+}
+
+// Share handle holding the cookies of filename, the file is loaded on first use
+static CURLSH* getCookieShare(const std::string& filename)
+{
+    std::lock_guard<std::mutex> lock(s_cookieShare.mutex);
+    if (!s_cookieShare.share)
+    {
+        s_cookieShare.share = curl_share_init();
+        s_cookieShare.jarHandle = curl_easy_init();
+        if (!s_cookieShare.share || !s_cookieShare.jarHandle)
+        {
+            CCLOGERROR("HttpClient: can't create the cookie share");
+            return nullptr;
+        }
+        curl_share_setopt(s_cookieShare.share, CURLSHOPT_LOCKFUNC, lockCookieShare);
+        curl_share_setopt(s_cookieShare.share, CURLSHOPT_UNLOCKFUNC, unlockCookieShare);
+        curl_share_setopt(s_cookieShare.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+        curl_easy_setopt(s_cookieShare.jarHandle, CURLOPT_SHARE, s_cookieShare.share);
+    }
+    if (s_cookieShare.filename != filename)
+    {
+        // enableCookies switched files: save the cookies of the old one and start over from the new one
+        if (!s_cookieShare.filename.empty())
+        {
+            curl_easy_setopt(s_cookieShare.jarHandle, CURLOPT_COOKIELIST, "FLUSH");
+            curl_easy_setopt(s_cookieShare.jarHandle, CURLOPT_COOKIELIST, "ALL");
+        }
+        s_cookieShare.filename = filename;
+        curl_easy_setopt(s_cookieShare.jarHandle, CURLOPT_COOKIEFILE, filename.c_str());
+        curl_easy_setopt(s_cookieShare.jarHandle, CURLOPT_COOKIEJAR, filename.c_str());
+        curl_easy_setopt(s_cookieShare.jarHandle, CURLOPT_COOKIELIST, "RELOAD");
+    }
+    return s_cookieShare.share;
+}
+
+// Write the shared cookies to the cookie file
+static void flushCookieShare()
+{
+    std::lock_guard<std::mutex> lock(s_cookieShare.mutex);
+    if (s_cookieShare.jarHandle && !s_cookieShare.filename.empty())
+    {
+        curl_easy_setopt(s_cookieShare.jarHandle, CURLOPT_COOKIELIST, "FLUSH");
+    }
+}
+
+// Must only be called once no transfer uses the share anymore, the cleanup of jarHandle writes the cookie file
+static void destroyCookieShare()
+{
+    std::lock_guard<std::mutex> lock(s_cookieShare.mutex);
+    if (s_cookieShare.jarHandle)
+    {
+        curl_easy_cleanup(s_cookieShare.jarHandle);
+        s_cookieShare.jarHandle = nullptr;
+    }
+    if (s_cookieShare.share)
+    {
+        curl_share_cleanup(s_cookieShare.share);
+        s_cookieShare.share = nullptr;
+    }
+    s_cookieShare.filename.clear();
+}
+
 // Callback function used by libcurl for collect response data
 static size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream)
 {
-    std::vector<char> *recvBuffer = (std::vector<char>*)stream;
+    HttpResponse* response = (HttpResponse*)stream;
     size_t sizes = size * nmemb;
-    
-    // add data to the end of recvBuffer
+
+    // hand data to the destination selected on the request
     // write data maybe called more than once in a single request
-    recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+sizes);
-    
-    return sizes;
+    switch (response->writeResponseData((const char*)ptr, sizes))
+    {
+    case HttpResponse::WriteResult::SUCCEED:
+        return sizes;
+    case HttpResponse::WriteResult::PAUSED:
+        return CURL_WRITEFUNC_PAUSE;
+    default:
+        return 0;
+    }
+}
+
+// Callback function used by libcurl for collect response data of sendImmediate requests,
+// these have a thread of their own that simply waits while the transfer is paused
+static size_t writeDataBlocking(void *ptr, size_t size, size_t nmemb, void *stream)
+{
+    HttpResponse* response = (HttpResponse*)stream;
+    size_t sizes = size * nmemb;
+
+    HttpResponse::WriteResult result;
+    while ((result = response->writeResponseData((const char*)ptr, sizes)) == HttpResponse::WriteResult::PAUSED)
+    {
+        response->waitForResume();
+    }
+    return result == HttpResponse::WriteResult::SUCCEED ? sizes : 0;
 }
 
 // Callback function used by libcurl for collect header data
 static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream)
 {
-    std::vector<char> *recvBuffer = (std::vector<char>*)stream;
+    HttpResponse* response = (HttpResponse*)stream;
+    std::vector<char> *recvBuffer = response->getResponseHeader();
     size_t sizes = size * nmemb;
     
     // add data to the end of recvBuffer
     // write data maybe called more than once in a single request
     recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+sizes);
+
+    // libcurl passes one header line per call, the body size lets the response allocate its memory at once
+    static const char CONTENT_LENGTH[] = "content-length:";
+    const size_t nameLength = sizeof(CONTENT_LENGTH) - 1;
+    if (sizes > nameLength && std::equal(CONTENT_LENGTH, CONTENT_LENGTH + nameLength, (const char*)ptr,
+                                         [](char a, char b) { return a == tolower(b); }))
+    {
+        std::string value((const char*)ptr + nameLength, sizes - nameLength);
+        response->setExpectedDataSize(strtoll(value.c_str(), nullptr, 10));
+    }
     
     return sizes;
 }
 
-
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPutTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processDeleteTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
-
-// Worker thread
-void HttpClient::networkThread()
+// Download progress of a request, shared with the notifications waiting for the cocos thread
+struct HttpProgress
 {
-    increaseThreadCount();
-
-    while (true)
+    std::mutex mutex;
+    HttpRequest* request;   // nullptr once the transfer is finished
+    int64_t receivedSize;
+    int64_t totalSize;
+    bool dispatching;
+    std::chrono::steady_clock::time_point lastDispatch;
+
+    explicit HttpProgress(HttpRequest* r)
+    : request(r)
+    , receivedSize(0)
+    , totalSize(-1)
+    , dispatching(false)
     {
-        HttpRequest *request;
-
-        // step 1: send http request if the requestQueue isn't empty
-        {
-            std::lock_guard<std::mutex> lock(_requestQueueMutex);
-            while (_requestQueue.empty())
-            {
-                _sleepCondition.wait(_requestQueueMutex);
-            }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
-        }
-
-        if (request == _requestSentinel) {
-            break;
-        }
-
-        // step 2: libcurl sync access
-        
-        // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = new (std::nothrow) HttpResponse(request);
+    }
+};
 
-        processResponse(response, _responseMessage);
+// Callback function used by libcurl for report transfer progress, forwards it to the cocos thread at a limited rate
+static int onTransferProgress(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t /*ultotal*/, curl_off_t /*ulnow*/)
+{
+    std::shared_ptr<HttpProgress> progress = *(std::shared_ptr<HttpProgress>*)clientp;
 
+    std::lock_guard<std::mutex> lock(progress->mutex);
+    if (progress->receivedSize == dlnow)
+    {
+        return 0;
+    }
+    progress->receivedSize = dlnow;
+    progress->totalSize = dltotal > 0 ? dltotal : -1;
 
-        // add response packet into queue
-        _responseQueueMutex.lock();
-        _responseQueue.pushBack(response);
-        _responseQueueMutex.unlock();
+    auto now = std::chrono::steady_clock::now();
+    if (progress->dispatching || now - progress->lastDispatch < std::chrono::milliseconds(HTTP_PROGRESS_INTERVAL_MS))
+    {
+        return 0;
+    }
+    progress->dispatching = true;
+    progress->lastDispatch = now;
 
-        _schedulerMutex.lock();
-        if (nullptr != _scheduler)
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread([progress]() {
+        std::lock_guard<std::mutex> lock(progress->mutex);
+        progress->dispatching = false;
+        if (progress->request)
         {
-            _scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+            progress->request->getProgressCallback()(progress->request, progress->receivedSize, progress->totalSize);
         }
-        _schedulerMutex.unlock();
-    }
-    
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    _requestQueueMutex.lock();
-    _requestQueue.clear();
-    _requestQueueMutex.unlock();
-
-    _responseQueueMutex.lock();
-    _responseQueue.clear();
-    _responseQueueMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
+    });
+    return 0;
 }
 
 // Worker thread
@@ -208,12 +328,27 @@ static bool configureCURL(HttpClient* client, CURL* handle, char* errorBuffer)
     return true;
 }
 
+// Only 2xx responses of a finished transfer count as succeeded
+static bool getResponseCode(CURL* handle, CURLcode result, long* responseCode)
+{
+    if (CURLE_OK != result)
+        return false;
+    CURLcode code = curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, responseCode);
+    if (code != CURLE_OK || !(*responseCode >= 200 && *responseCode < 300)) {
+        CCLOGERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
+        return false;
+    }
+    return true;
+}
+
 class CURLRaii
 {
     /// Instance of CURL
     CURL *_curl;
     /// Keeps custom header data
     curl_slist *_headers;
+    /// Download progress reported to the request
+    std::shared_ptr<HttpProgress> _progress;
 public:
     CURLRaii()
         : _curl(curl_easy_init())
@@ -228,6 +363,12 @@ public:
         /* free the linked list for header data */
         if (_headers)
             curl_slist_free_all(_headers);
+        /* progress notifications still queued for the cocos thread must not call back */
+        if (_progress)
+        {
+            std::lock_guard<std::mutex> lock(_progress->mutex);
+            _progress->request = nullptr;
+        }
     }
 
     template <class T>
@@ -262,10 +403,12 @@ public:
         }
         std::string cookieFilename = client->getCookieFilename();
         if (!cookieFilename.empty()) {
-            if (!setOption(CURLOPT_COOKIEFILE, cookieFilename.c_str())) {
+            CURLSH* share = getCookieShare(cookieFilename);
+            if (!share || !setOption(CURLOPT_SHARE, share)) {
                 return false;
             }
-            if (!setOption(CURLOPT_COOKIEJAR, cookieFilename.c_str())) {
+            // an empty name turns the cookie engine on, the file itself is loaded into the share
+            if (!setOption(CURLOPT_COOKIEFILE, "")) {
                 return false;
             }
         }
@@ -278,65 +421,315 @@ public:
         
     }
 
+    CURL* getHandle() const
+    {
+        return _curl;
+    }
+
+    /// Reports the download progress to the progress callback of the request
+    bool setProgress(HttpRequest* request)
+    {
+        _progress = std::make_shared<HttpProgress>(request);
+        return setOption(CURLOPT_XFERINFOFUNCTION, onTransferProgress)
+                && setOption(CURLOPT_XFERINFODATA, &_progress)
+                && setOption(CURLOPT_NOPROGRESS, 0L);
+    }
+
     /// @param responseCode Null not allowed
     bool perform(long *responseCode)
     {
-        if (CURLE_OK != curl_easy_perform(_curl))
-            return false;
-        CURLcode code = curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, responseCode);
-        if (code != CURLE_OK || !(*responseCode >= 200 && *responseCode < 300)) {
-            CCLOGERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
-            return false;
-        }
-        // Get some mor data.
-        
-        return true;
+        return getResponseCode(_curl, curl_easy_perform(_curl), responseCode);
     }
 };
 
-//Process Get Request
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+// Sets the method specific options of a request on top of the common ones
+static bool configureRequest(CURLRaii& curl, HttpClient* client, HttpRequest* request, HttpResponse* response, write_callback callback, char* errorBuffer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    if (!response->openResponseSink())
+        return false;
+    if (!curl.init(client, request, callback, response, writeHeaderData, response, errorBuffer))
+        return false;
+    if (request->getProgressCallback() && !curl.setProgress(request))
+        return false;
+
+    switch (request->getRequestType())
+    {
+    case HttpRequest::Type::GET: // HTTP GET
+        return curl.setOption(CURLOPT_FOLLOWLOCATION, true);
+
+    case HttpRequest::Type::POST: // HTTP POST
+        return curl.setOption(CURLOPT_POST, 1)
+            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
+
+    case HttpRequest::Type::PUT:
+        return curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
+            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
+
+    case HttpRequest::Type::DELETE:
+        return curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
+            && curl.setOption(CURLOPT_FOLLOWLOCATION, true);
+
+    default:
+        CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
+        return false;
+    }
 }
 
-//Process POST Request
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+// Write the result of a finished transfer to the response
+static void setResponseResult(HttpResponse* response, bool succeed, long responseCode, char* responseMessage)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_POST, 1)
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    // a response file is only kept when the request succeeded
+    succeed = response->closeResponseSink(succeed) && succeed;
+
+    response->setResponseCode(responseCode);
+    response->setSucceed(succeed);
+    // keep the more precise reason set by the response itself, e.g. a response file that can't be written
+    if (!succeed && response->getErrorBuffer()[0] == '\0')
+    {
+        response->setErrorBuffer(responseMessage);
+    }
 }
 
-//Process PUT Request
-static int processPutTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+// Connection limits are counted per "host:port" of the url
+static std::string getHostFromUrl(const std::string& url)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    size_t begin = url.find("://");
+    begin = (begin == std::string::npos) ? 0 : begin + 3;
+    size_t end = url.find_first_of("/?#", begin);
+    std::string host = url.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+    size_t userInfo = host.rfind('@');
+    if (userInfo != std::string::npos)
+    {
+        host.erase(0, userInfo + 1);
+    }
+    return host;
 }
 
-//Process DELETE Request
-static int processDeleteTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+// A queued request while it is performed by the multi handle
+struct HttpTransfer
 {
+    HttpRequest* request;
+    HttpResponse* response;
+    std::string host;
     CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    char errorBuffer[HttpClient::RESPONSE_BUFFER_SIZE];
+
+    HttpTransfer(HttpRequest* r, const std::string& h)
+    : request(r)
+    , response(new (std::nothrow) HttpResponse(r))
+    , host(h)
+    {
+        memset(errorBuffer, 0, sizeof(errorBuffer));
+    }
+};
+
+// Worker thread
+void HttpClient::networkThread()
+{
+    increaseThreadCount();
+
+    // All queued requests share the connection and DNS caches of this multi handle,
+    // so keep-alive connections are reused and many requests run at the same time.
+    CURLM* multiHandle = curl_multi_init();
+#ifdef CURLPIPE_MULTIPLEX
+    curl_multi_setopt(multiHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+    {
+        std::lock_guard<std::mutex> lock(_requestQueueMutex);
+        s_multiHandle = multiHandle;
+    }
+
+    std::unordered_map<std::string, int> hostTransfers;
+    std::unordered_set<HttpTransfer*> transfers;
+    std::vector<HttpTransfer*> finishedTransfers;
+    int cachedConnections = -1;
+
+    while (true)
+    {
+        // step 1: start queued requests as long as the connection limits allow it
+        {
+            std::lock_guard<std::mutex> lock(_requestQueueMutex);
+            while (_requestQueue.empty() && transfers.empty())
+            {
+                _sleepCondition.wait(_requestQueueMutex);
+            }
+
+            if (!_requestQueue.empty() && _requestQueue.back() == _requestSentinel)
+            {
+                break;
+            }
+
+            int maxConnections = getMaxConnections();
+            int maxConnectionsPerHost = getMaxConnectionsPerHost();
+            if (maxConnections != cachedConnections)
+            {
+                // keep every idle connection alive, by default libcurl shrinks its cache along with the number of handles
+                cachedConnections = maxConnections;
+                curl_multi_setopt(multiHandle, CURLMOPT_MAXCONNECTS, (long)std::max(cachedConnections, HTTP_MIN_CACHED_CONNECTIONS));
+            }
+
+            // Requests stay in the queue until they start, so clearResponseAndRequestQueue() can still
+            // remove them, and libcurl does not count the time spent waiting against CURLOPT_TIMEOUT.
+            for (ssize_t i = 0; i < _requestQueue.size();)
+            {
+                if (maxConnections > 0 && (int)transfers.size() >= maxConnections)
+                {
+                    break;
+                }
+
+                HttpRequest* request = _requestQueue.at(i);
+                std::string host = getHostFromUrl(request->getUrl());
+                auto hostIter = hostTransfers.find(host);
+                if (maxConnectionsPerHost > 0 && hostIter != hostTransfers.end() && hostIter->second >= maxConnectionsPerHost)
+                {
+                    ++i;
+                    continue;
+                }
+
+                auto transfer = new (std::nothrow) HttpTransfer(request, host);
+                if (!transfer || !transfer->response)
+                {
+                    // out of memory, the request stays queued and is tried again on the next pass
+                    CCLOGERROR("HttpClient: can't allocate the transfer of %s", request->getUrl());
+                    delete transfer;
+                    break;
+                }
+                _requestQueue.erase(i);
+
+                if (configureRequest(transfer->curl, this, request, transfer->response, writeData, transfer->errorBuffer)
+                    && transfer->curl.setOption(CURLOPT_PRIVATE, transfer)
+#ifdef CURLPIPE_MULTIPLEX
+                    && transfer->curl.setOption(CURLOPT_PIPEWAIT, 1L)
+#endif
+                    && CURLM_OK == curl_multi_add_handle(multiHandle, transfer->curl.getHandle()))
+                {
+                    transfers.insert(transfer);
+                    ++hostTransfers[host];
+                }
+                else
+                {
+                    setResponseResult(transfer->response, false, -1, transfer->errorBuffer);
+                    finishedTransfers.push_back(transfer);
+                }
+            }
+        }
+
+        // step 2: libcurl async access
+        for (auto transfer : transfers)
+        {
+            // continue transfers paused by the data callback of their request
+            if (transfer->response->takeResumeRequest())
+            {
+                curl_easy_pause(transfer->curl.getHandle(), CURLPAUSE_CONT);
+            }
+        }
+
+        int runningHandles = 0;
+        curl_multi_perform(multiHandle, &runningHandles);
+
+        CURLMsg* message = nullptr;
+        int messagesLeft = 0;
+        bool connectionsFreed = false;
+        while ((message = curl_multi_info_read(multiHandle, &messagesLeft)))
+        {
+            if (message->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
+
+            HttpTransfer* transfer = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &transfer);
+            curl_multi_remove_handle(multiHandle, message->easy_handle);
+            transfers.erase(transfer);
+            connectionsFreed = true;
+            if (--hostTransfers[transfer->host] == 0)
+            {
+                hostTransfers.erase(transfer->host);
+            }
+
+            long responseCode = -1;
+            bool succeed = getResponseCode(message->easy_handle, message->data.result, &responseCode);
+            setResponseResult(transfer->response, succeed, responseCode, transfer->errorBuffer);
+            finishedTransfers.push_back(transfer);
+        }
+
+        // add response packets into queue, one dispatch handles the whole batch
+        if (!finishedTransfers.empty())
+        {
+            _responseQueueMutex.lock();
+            for (auto transfer : finishedTransfers)
+            {
+                _responseQueue.pushBack(transfer->response);
+                delete transfer;
+            }
+            _responseQueueMutex.unlock();
+            finishedTransfers.clear();
+
+            // one write of the cookie file for the whole batch
+            flushCookieShare();
+
+            _schedulerMutex.lock();
+            if (nullptr != _scheduler)
+            {
+                _scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+            }
+            _schedulerMutex.unlock();
+        }
+
+        // start queued requests right away when finished transfers freed their connections
+        if (runningHandles > 0 && !connectionsFreed)
+        {
+#if LIBCURL_VERSION_NUM >= 0x074400
+            curl_multi_poll(multiHandle, nullptr, 0, HTTP_MULTI_POLL_TIMEOUT_MS, nullptr);
+#else
+            // without curl_multi_wakeup new requests are only picked up after the wait returns
+            int numfds = 0;
+            curl_multi_wait(multiHandle, nullptr, 0, HTTP_MULTI_WAIT_TIMEOUT_MS, &numfds);
+            if (numfds == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(HTTP_MULTI_WAIT_TIMEOUT_MS));
+            }
+#endif
+        }
+    }
+
+    // cleanup: if worker thread received quit signal, abort the transfers in flight
+    for (auto transfer : transfers)
+    {
+        auto request = transfer->request;
+        auto response = transfer->response;
+        curl_multi_remove_handle(multiHandle, transfer->curl.getHandle());
+        delete transfer;
+        response->release();
+        request->release();
+    }
+
+    _requestQueueMutex.lock();
+    s_multiHandle = nullptr;
+    _requestQueue.clear();
+    _requestQueueMutex.unlock();
+
+    curl_multi_cleanup(multiHandle);
+
+    _responseQueueMutex.lock();
+    _responseQueue.clear();
+    _responseQueueMutex.unlock();
+
+    decreaseThreadCountAndMayDeleteThis();
+}
+
+
+// Interrupt the network thread waiting for socket activity, must be called with the request queue locked
+static void wakeupNetworkThread()
+{
+#if LIBCURL_VERSION_NUM >= 0x074400
+    if (s_multiHandle)
+    {
+        curl_multi_wakeup(s_multiHandle);
+    }
+#endif
 }
 
 // HttpClient implementation
@@ -369,6 +762,7 @@ void HttpClient::destroyInstance()
 
     thiz->_requestQueueMutex.lock();
     thiz->_requestQueue.pushBack(thiz->_requestSentinel);
+    wakeupNetworkThread();
     thiz->_requestQueueMutex.unlock();
 
     thiz->_sleepCondition.notify_one();
@@ -377,6 +771,19 @@ void HttpClient::destroyInstance()
     CCLOG("HttpClient::destroyInstance() finished!");
 }
 
+void HttpClient::resume(HttpResponse* response)
+{
+    if (!response)
+    {
+        return;
+    }
+
+    response->requestResume();
+
+    std::lock_guard<std::mutex> lock(_requestQueueMutex);
+    wakeupNetworkThread();
+}
+
 void HttpClient::enableCookies(const char* cookieFile)
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
@@ -400,6 +807,8 @@ HttpClient::HttpClient()
 : _isInited(false)
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConnections(16)
+, _maxConnectionsPerHost(6)
 , _threadCount(0)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
@@ -414,6 +823,8 @@ HttpClient::HttpClient()
 
 HttpClient::~HttpClient()
 {
+    // every worker thread is done at this point, nothing uses the cookie share anymore
+    destroyCookieShare();
     CC_SAFE_RELEASE(_requestSentinel);
     CCLOG("HttpClient destructor");
 }
@@ -452,6 +863,7 @@ void HttpClient::send(HttpRequest* request)
 
     _requestQueueMutex.lock();
     _requestQueue.pushBack(request);
+    wakeupNetworkThread();
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
@@ -478,18 +890,24 @@ void HttpClient::dispatchResponseCallbacks()
 {
     // log("CCHttpClient::dispatchResponseCallbacks is running");
     //occurs when cocos thread fires but the network thread has already quited
-    HttpResponse* response = nullptr;
-
-    _responseQueueMutex.lock();
-    if (!_responseQueue.empty())
-    {
-        response = _responseQueue.at(0);
-        _responseQueue.erase(0);
-    }
-    _responseQueueMutex.unlock();
-    
-    if (response)
+    // the network thread schedules one dispatch for every batch of finished requests
+    while (true)
     {
+        HttpResponse* response = nullptr;
+
+        _responseQueueMutex.lock();
+        if (!_responseQueue.empty())
+        {
+            response = _responseQueue.at(0);
+            _responseQueue.erase(0);
+        }
+        _responseQueueMutex.unlock();
+
+        if (!response)
+        {
+            break;
+        }
+
         HttpRequest *request = response->getHttpRequest();
         const ccHttpRequestCallback& callback = request->getCallback();
         Ref* pTarget = request->getTarget();
@@ -503,7 +921,7 @@ void HttpClient::dispatchResponseCallbacks()
         {
             (pTarget->*pSelector)(this, response);
         }
-        
+
         response->release();
         // do not release in other thread
         request->release();
@@ -515,67 +933,15 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
 {
     auto request = response->getHttpRequest();
     long responseCode = -1;
-    int retValue = 0;
 
     // Process the request -> get response packet
-    switch (request->getRequestType())
-    {
-    case HttpRequest::Type::GET: // HTTP GET
-        retValue = processGetTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::POST: // HTTP POST
-        retValue = processPostTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::PUT:
-        retValue = processPutTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::DELETE:
-        retValue = processDeleteTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    default:
-        CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
-        break;
-    }
+    CURLRaii curl;
+    bool succeed = configureRequest(curl, this, request, response, writeDataBlocking, responseMessage)
+            && curl.perform(&responseCode);
+    flushCookieShare();
 
     // write data to HttpResponse
-    response->setResponseCode(responseCode);
-    if (retValue != 0)
-    {
-        response->setSucceed(false);
-        response->setErrorBuffer(responseMessage);
-    }
-    else
-    {
-        response->setSucceed(true);
-    }
+    setResponseResult(response, succeed, responseCode, responseMessage);
 }
     
 void HttpClient::clearResponseAndRequestQueue()
@@ -659,6 +1025,30 @@ int HttpClient::getTimeoutForRead()
     return _timeoutForRead;
 }
     
+void HttpClient::setMaxConnections(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    _maxConnections = value;
+}
+    
+int HttpClient::getMaxConnections()
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    return _maxConnections;
+}
+    
+void HttpClient::setMaxConnectionsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    _maxConnectionsPerHost = value;
+}
+    
+int HttpClient::getMaxConnectionsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsMutex);
+    return _maxConnectionsPerHost;
+}
+    
 const std::string& HttpClient::getCookieFilename()
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
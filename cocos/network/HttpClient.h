@@ -117,6 +117,14 @@ public:
      */
     void sendImmediate(HttpRequest* request);
 
+    /**
+     * Continue a transfer paused by the data callback of its request, see HttpRequest::setResponseDataCallback.
+     * It can be called from any thread.
+     *
+     * @param response the response passed to the data callback.
+     */
+    void resume(HttpResponse* response);
+
     /**
      * Set the timeout value for connecting.
      *
@@ -145,6 +153,35 @@ public:
      */
     int getTimeoutForRead();
 
+    /**
+     * Set the maximum number of connections used for queued requests at the same time.
+     * Requests beyond the limit wait until a connection becomes free.
+     *
+     * @param value the maximum number of connections, 0 means no limit.
+     */
+    void setMaxConnections(int value);
+
+    /**
+     * Get the maximum number of connections used for queued requests at the same time.
+     *
+     * @return int the maximum number of connections.
+     */
+    int getMaxConnections();
+
+    /**
+     * Set the maximum number of connections opened to a single host at the same time.
+     *
+     * @param value the maximum number of connections per host, 0 means no limit.
+     */
+    void setMaxConnectionsPerHost(int value);
+
+    /**
+     * Get the maximum number of connections opened to a single host at the same time.
+     *
+     * @return int the maximum number of connections per host.
+     */
+    int getMaxConnectionsPerHost();
+
     HttpCookie* getCookie() const {return _cookie; }
 
     std::mutex& getCookieFileMutex() {return _cookieFileMutex;}
@@ -206,6 +243,10 @@ private:
     int _timeoutForRead;
     std::mutex _timeoutForReadMutex;
 
+    int _maxConnections;
+    int _maxConnectionsPerHost;
+    std::mutex _maxConnectionsMutex;
+
     int  _threadCount;
     std::mutex _threadCountMutex;
 
@@ -29,6 +29,8 @@
 
 #include <string>
 #include <vector>
+#include <functional>
+#include <stdint.h>
 #include "base/CCRef.h"
 #include "base/ccMacros.h"
 
@@ -42,10 +44,13 @@ NS_CC_BEGIN
 namespace network {
 
 class HttpClient;
+class HttpRequest;
 class HttpResponse;
 
 typedef std::function<void(HttpClient* client, HttpResponse* response)> ccHttpRequestCallback;
 typedef void (cocos2d::Ref::*SEL_HttpResponse)(HttpClient* client, HttpResponse* response);
+typedef std::function<bool(HttpResponse* response, const char* data, size_t size)> ccHttpRequestDataCallback;
+typedef std::function<void(HttpRequest* request, int64_t receivedSize, int64_t totalSize)> ccHttpRequestProgressCallback;
 #define httpresponse_selector(_SELECTOR) (cocos2d::network::SEL_HttpResponse)(&_SELECTOR)
 
 /**
@@ -90,6 +95,8 @@ public:
         , _pSelector(nullptr)
         , _pCallback(nullptr)
         , _pUserData(nullptr)
+        , _responseBuffer(nullptr)
+        , _responseBufferCapacity(0)
     {
     }
 
@@ -339,6 +346,103 @@ public:
         return _headers;
     }
 
+    /**
+     * Write the response body to a file instead of keeping it in memory.
+     * The body is written to "path.tmp" first and moved to path when the request succeeds.
+     *
+     * @param path the full path of the file.
+     */
+    void setResponseFilePath(const std::string& path)
+    {
+        _responseFilePath = path;
+    }
+
+    /**
+     * Get the file the response body is written to.
+     *
+     * @return const std::string& the full path of the file, empty if the body is kept in memory.
+     */
+    const std::string& getResponseFilePath() const
+    {
+        return _responseFilePath;
+    }
+
+    /**
+     * Write the response body into a buffer owned by the caller instead of HttpResponse::getResponseData().
+     * The request fails if the body is larger than the buffer. The buffer must stay valid until the response callback.
+     *
+     * @param buffer the buffer receiving the body.
+     * @param capacity the size of the buffer in bytes.
+     */
+    void setResponseBuffer(char* buffer, size_t capacity)
+    {
+        _responseBuffer = buffer;
+        _responseBufferCapacity = capacity;
+    }
+
+    /**
+     * Get the buffer the response body is written to.
+     *
+     * @return char* the buffer, nullptr if the body is kept in memory.
+     */
+    char* getResponseBuffer() const
+    {
+        return _responseBuffer;
+    }
+
+    /**
+     * Get the size of the buffer the response body is written to.
+     *
+     * @return size_t the size of the buffer in bytes.
+     */
+    size_t getResponseBufferCapacity() const
+    {
+        return _responseBufferCapacity;
+    }
+
+    /**
+     * Receive the response body in chunks instead of keeping it in memory.
+     * The callback is invoked on the network thread. Returning false pauses the transfer without
+     * consuming the chunk, it is passed again after HttpClient::resume() is called for the response.
+     *
+     * @param callback the ccHttpRequestDataCallback function.
+     */
+    void setResponseDataCallback(const ccHttpRequestDataCallback& callback)
+    {
+        _dataCallback = callback;
+    }
+
+    /**
+     * Get the callback receiving the response body in chunks.
+     *
+     * @return const ccHttpRequestDataCallback& the ccHttpRequestDataCallback function.
+     */
+    const ccHttpRequestDataCallback& getResponseDataCallback() const
+    {
+        return _dataCallback;
+    }
+
+    /**
+     * Set a callback reporting the download progress, it is invoked on the cocos thread a few times per second at most.
+     * The total size is -1 when the server does not tell the size of the body.
+     *
+     * @param callback the ccHttpRequestProgressCallback function.
+     */
+    void setProgressCallback(const ccHttpRequestProgressCallback& callback)
+    {
+        _progressCallback = callback;
+    }
+
+    /**
+     * Get the callback reporting the download progress.
+     *
+     * @return const ccHttpRequestProgressCallback& the ccHttpRequestProgressCallback function.
+     */
+    const ccHttpRequestProgressCallback& getProgressCallback() const
+    {
+        return _progressCallback;
+    }
+
 private:
     void doSetResponseCallback(Ref* pTarget, SEL_HttpResponse pSelector)
     {
@@ -366,6 +470,11 @@ protected:
     ccHttpRequestCallback       _pCallback;      /// C++11 style callbacks
     void*                       _pUserData;      /// You can add your customed data here
     std::vector<std::string>    _headers;        /// custom http headers
+    std::string                 _responseFilePath;  /// write the response body to this file
+    char*                       _responseBuffer;    /// write the response body to this buffer owned by the caller
+    size_t                      _responseBufferCapacity;
+    ccHttpRequestDataCallback   _dataCallback;      /// receive the response body in chunks on the network thread
+    ccHttpRequestProgressCallback _progressCallback; /// download progress, called on the cocos thread
 };
 
 }
@@ -0,0 +1,205 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "network/HttpResponse.h"
+#include "platform/CCFileUtils.h"
+#include <algorithm>
+
+NS_CC_BEGIN
+
+namespace network {
+
+// the memory reserved up front for a body of announced size, a larger body grows the buffer as it arrives
+static const int64_t MAX_RESERVED_DATA_SIZE = 64 * 1024 * 1024;
+
+// the chunk size used to pass a body that arrived at once to a data callback
+static const size_t FLUSH_CHUNK_SIZE = 64 * 1024;
+
+static std::string getTemporaryPath(const std::string& path)
+{
+    return path + ".tmp";
+}
+
+bool HttpResponse::openResponseSink()
+{
+    const std::string& path = _pHttpRequest->getResponseFilePath();
+    if (path.empty())
+    {
+        return true;
+    }
+
+    std::string tempPath = getTemporaryPath(path);
+    _sinkFile = fopen(FileUtils::getInstance()->getSuitableFOpen(tempPath).c_str(), "wb");
+    if (!_sinkFile)
+    {
+        setErrorBuffer(("Can't open response file " + tempPath).c_str());
+        return false;
+    }
+    return true;
+}
+
+HttpResponse::WriteResult HttpResponse::writeResponseData(const char* data, size_t size)
+{
+    if (_sinkFile)
+    {
+        if (fwrite(data, 1, size, _sinkFile) != size)
+        {
+            setErrorBuffer(("Can't write response file " + getTemporaryPath(_pHttpRequest->getResponseFilePath())).c_str());
+            return WriteResult::FAILED;
+        }
+    }
+    else if (_pHttpRequest->getResponseBuffer())
+    {
+        if (_receivedDataSize + (int64_t)size > (int64_t)_pHttpRequest->getResponseBufferCapacity())
+        {
+            setErrorBuffer("Response buffer is too small");
+            return WriteResult::FAILED;
+        }
+        memcpy(_pHttpRequest->getResponseBuffer() + _receivedDataSize, data, size);
+    }
+    else if (_pHttpRequest->getResponseDataCallback())
+    {
+        if (!_pHttpRequest->getResponseDataCallback()(this, data, size))
+        {
+            std::lock_guard<std::mutex> lock(_resumeMutex);
+            _paused = true;
+            return WriteResult::PAUSED;
+        }
+    }
+    else
+    {
+        if (_responseData.empty() && _expectedDataSize > 0)
+        {
+            _responseData.reserve((size_t)std::min(_expectedDataSize, MAX_RESERVED_DATA_SIZE));
+        }
+        _responseData.insert(_responseData.end(), data, data + size);
+    }
+
+    _receivedDataSize += size;
+    return WriteResult::SUCCEED;
+}
+
+bool HttpResponse::closeResponseSink(bool succeed)
+{
+    if (!_sinkFile)
+    {
+        return true;
+    }
+
+    bool closed = (fclose(_sinkFile) == 0);
+    _sinkFile = nullptr;
+
+    auto fileUtils = FileUtils::getInstance();
+    const std::string& path = _pHttpRequest->getResponseFilePath();
+    std::string tempPath = getTemporaryPath(path);
+    if (!succeed || !closed)
+    {
+        fileUtils->removeFile(tempPath);
+        if (!closed)
+        {
+            setErrorBuffer(("Can't write response file " + tempPath).c_str());
+        }
+        return closed;
+    }
+
+    if (fileUtils->isFileExist(path))
+    {
+        fileUtils->removeFile(path);
+    }
+    if (!fileUtils->renameFile(tempPath, path))
+    {
+        fileUtils->removeFile(tempPath);
+        setErrorBuffer(("Can't move response file to " + path).c_str());
+        return false;
+    }
+    return true;
+}
+
+bool HttpResponse::flushResponseDataToSink()
+{
+    if (_pHttpRequest->getResponseFilePath().empty()
+        && !_pHttpRequest->getResponseBuffer()
+        && !_pHttpRequest->getResponseDataCallback())
+    {
+        _receivedDataSize = _responseData.size();
+        return true;
+    }
+
+    std::vector<char> data;
+    data.swap(_responseData);
+    if (!openResponseSink())
+    {
+        return false;
+    }
+
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+        size_t size = std::min(FLUSH_CHUNK_SIZE, data.size() - offset);
+        WriteResult result = writeResponseData(data.data() + offset, size);
+        if (result == WriteResult::FAILED)
+        {
+            closeResponseSink(false);
+            return false;
+        }
+        if (result == WriteResult::PAUSED)
+        {
+            waitForResume();
+            continue;
+        }
+        offset += size;
+    }
+    return closeResponseSink(true);
+}
+
+void HttpResponse::requestResume()
+{
+    std::lock_guard<std::mutex> lock(_resumeMutex);
+    _resumeRequested = true;
+    _resumeCondition.notify_all();
+}
+
+bool HttpResponse::takeResumeRequest()
+{
+    std::lock_guard<std::mutex> lock(_resumeMutex);
+    if (!_paused || !_resumeRequested)
+    {
+        return false;
+    }
+    _paused = false;
+    _resumeRequested = false;
+    return true;
+}
+
+void HttpResponse::waitForResume()
+{
+    std::unique_lock<std::mutex> lock(_resumeMutex);
+    _resumeCondition.wait(lock, [this]() { return _resumeRequested; });
+    _paused = false;
+    _resumeRequested = false;
+}
+
+}
+
+NS_CC_END
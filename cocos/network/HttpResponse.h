@@ -28,6 +28,9 @@
 #define __HTTP_RESPONSE__
 
 #include "network/HttpRequest.h"
+#include <stdio.h>
+#include <mutex>
+#include <condition_variable>
 
 /**
  * @addtogroup network
@@ -47,6 +50,16 @@ namespace network {
 class CC_DLL HttpResponse : public cocos2d::Ref
 {
 public:
+    /**
+     * Result of writing a chunk of the response body, see writeResponseData.
+     */
+    enum class WriteResult
+    {
+        SUCCEED,
+        PAUSED,
+        FAILED,
+    };
+
     /**
      * Constructor, it's used by HttpClient internal, users don't need to create HttpResponse manually.
      * @param request the corresponding HttpRequest which leads to this response.
@@ -54,7 +67,13 @@ public:
     HttpResponse(HttpRequest* request)
         : _pHttpRequest(request)
         , _succeed(false)
+        , _responseCode(-1)
         , _responseDataString("")
+        , _receivedDataSize(0)
+        , _expectedDataSize(-1)
+        , _sinkFile(nullptr)
+        , _paused(false)
+        , _resumeRequested(false)
     {
         if (_pHttpRequest)
         {
@@ -68,6 +87,7 @@ public:
      */
     virtual ~HttpResponse()
     {
+        closeResponseSink(false);
         if (_pHttpRequest)
         {
             _pHttpRequest->release();
@@ -118,6 +138,16 @@ public:
         return &_responseData;
     }
 
+    /**
+     * Get the number of bytes of the response body received so far.
+     * It is also counted when the request writes the body to a file, a buffer or a data callback.
+     * @return int64_t the number of received bytes.
+     */
+    int64_t getReceivedDataSize() const
+    {
+        return _receivedDataSize;
+    }
+
     /**
      * Get the response headers.
      * @return std::vector<char>* the pointer that point to the _responseHeader.
@@ -220,6 +250,59 @@ public:
         return _responseDataString.c_str();
     }
 
+    /**
+     * Set the size of the body announced by the server, it is used by HttpClient to allocate the memory at once.
+     * @param size the size in bytes, -1 if unknown.
+     */
+    void setExpectedDataSize(int64_t size)
+    {
+        _expectedDataSize = size;
+    }
+
+    /**
+     * Prepare the destination selected on the request for the response body, it is used by HttpClient.
+     * @return bool false if the destination can't be used, the reason is in getErrorBuffer().
+     */
+    bool openResponseSink();
+
+    /**
+     * Write a chunk of the response body to the destination selected on the request, it is used by HttpClient.
+     * @return WriteResult PAUSED if the data callback of the request didn't take the chunk,
+     *         it has to be written again after resume.
+     */
+    WriteResult writeResponseData(const char* data, size_t size);
+
+    /**
+     * Finish writing the response body, it is used by HttpClient.
+     * The response file is moved to its path if the request succeeded, and removed otherwise.
+     * @param succeed whether the request succeeded.
+     * @return bool false if the body couldn't be stored, the reason is in getErrorBuffer().
+     */
+    bool closeResponseSink(bool succeed);
+
+    /**
+     * Hand the body collected in getResponseData() to the destination selected on the request,
+     * it is used by HttpClient implementations that receive the whole body at once.
+     * @return bool false if the body couldn't be stored, the reason is in getErrorBuffer().
+     */
+    bool flushResponseDataToSink();
+
+    /**
+     * Continue a transfer paused by the data callback of the request, it is used by HttpClient::resume.
+     */
+    void requestResume();
+
+    /**
+     * Consume a resume request of a paused transfer, it is used by HttpClient.
+     * @return bool true if the transfer is paused and should continue.
+     */
+    bool takeResumeRequest();
+
+    /**
+     * Block the calling network thread until the paused transfer is resumed, it is used by HttpClient.
+     */
+    void waitForResume();
+
 protected:
     bool initWithRequest(HttpRequest* request);
 
@@ -231,6 +314,13 @@ protected:
     long                _responseCode;    /// the status code returned from libcurl, e.g. 200, 404
     std::string         _errorBuffer;   /// if _responseCode != 200, please read _errorBuffer to find the reason
     std::string         _responseDataString; // the returned raw data. You can also dump it as a string
+    int64_t             _receivedDataSize;  /// the number of body bytes received, whatever the destination is
+    int64_t             _expectedDataSize;  /// the body size announced by the server, -1 if unknown
+    FILE*               _sinkFile;          /// the temporary file while the body is written to a file
+    bool                _paused;            /// the data callback of the request asked to pause the transfer
+    bool                _resumeRequested;
+    std::mutex          _resumeMutex;
+    std::condition_variable _resumeCondition;
 
 };
 
@@ -40,6 +40,8 @@
 #include <mutex>
 #include <queue>
 #include <list>
+#include <deque>
+#include <algorithm>
 #include <signal.h>
 #include <errno.h>
 
@@ -50,6 +52,13 @@
 
 #define WS_RX_BUFFER_SIZE (65536)
 #define WS_RESERVE_RECEIVE_BUFFER_SIZE (4096)
+// Buffers that grew larger than this are freed instead of going back to the pool
+#define WS_MAX_POOLED_BUFFER_SIZE (65536)
+#define WS_MESSAGE_QUEUE_CAPACITY (256)
+#define WS_RECYCLE_QUEUE_CAPACITY (32)
+// 'lws_service' is interrupted by 'lws_cancel_service' whenever there is work to do,
+// so the timeout only bounds how long an idle websocket thread sleeps.
+#define WS_SERVICE_TIMEOUT_MS (50)
 
 //#define WEBSOCKETS_LOGGING
 #define  LOG_TAG    "WebSocket.cpp"
@@ -172,9 +181,7 @@ static void printWebSocketLog(int level, const char *line)
 NS_NETWORK_BEGIN
 
 enum WS_MSG {
-    WS_MSG_TO_SUBTRHEAD_SENDING_STRING = 0,
-    WS_MSG_TO_SUBTRHEAD_SENDING_BINARY,
-    WS_MSG_TO_SUBTHREAD_CREATE_CONNECTION
+    WS_MSG_TO_SUBTHREAD_CREATE_CONNECTION = 0
 };
 
 static std::vector<WebSocket*>* __websocketInstances = nullptr;
@@ -251,6 +258,162 @@ private:
 
 unsigned int WsMessage::__id = 0;
 
+// Payload of a message. Buffers are handed back through the recycle queues once they
+// were sent or delivered, so a steady stream of messages doesn't allocate.
+struct WsBuffer
+{
+    WsBuffer() : isBinary(false) {}
+    std::vector<unsigned char> data;
+    bool isBinary;
+};
+
+/**
+ *  @brief Lock-free single-producer single-consumer ring of pointers.
+ *  When the ring is full, 'push' spills into a locked overflow list and keeps using it until
+ *  the consumer has drained it, which keeps the items in order.
+ */
+template <typename T, size_t CAPACITY>
+class WsRingQueue
+{
+public:
+    WsRingQueue() : _head(0), _tail(0), _overflowSize(0) {}
+
+    ~WsRingQueue()
+    {
+        T* item = nullptr;
+        while ((item = pop()) != nullptr)
+        {
+            delete item;
+        }
+    }
+
+    // Producer side, returns false rather than spilling if the ring is full.
+    bool tryPush(T* item)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) % CAPACITY;
+        if (next == _head.load(std::memory_order_acquire))
+            return false;
+
+        _items[tail] = item;
+        _tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side.
+    void push(T* item)
+    {
+        if (_overflowSize.load(std::memory_order_acquire) == 0 && tryPush(item))
+            return;
+
+        std::lock_guard<std::mutex> lk(_overflowMutex);
+        _overflow.push_back(item);
+        _overflowSize.fetch_add(1, std::memory_order_release);
+    }
+
+    // Consumer side, returns nullptr if the queue is empty.
+    T* pop()
+    {
+        T* item = popRing();
+        if (item != nullptr || _overflowSize.load(std::memory_order_acquire) == 0)
+            return item;
+
+        std::lock_guard<std::mutex> lk(_overflowMutex);
+        // The producer may have filled the ring between the two checks above,
+        // those items are older than anything in the overflow list.
+        item = popRing();
+        if (item == nullptr && !_overflow.empty())
+        {
+            item = _overflow.front();
+            _overflow.pop_front();
+            _overflowSize.fetch_sub(1, std::memory_order_release);
+        }
+        return item;
+    }
+
+    // Consumer side.
+    bool empty() const
+    {
+        return _head.load(std::memory_order_relaxed) == _tail.load(std::memory_order_acquire)
+            && _overflowSize.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    T* popRing()
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return nullptr;
+
+        T* item = _items[head];
+        _head.store((head + 1) % CAPACITY, std::memory_order_release);
+        return item;
+    }
+
+    T* _items[CAPACITY];
+    std::atomic<size_t> _head;
+    std::atomic<size_t> _tail;
+
+    std::deque<T*> _overflow;
+    std::atomic<size_t> _overflowSize;
+    std::mutex _overflowMutex;
+};
+
+typedef WsRingQueue<WsBuffer, WS_MESSAGE_QUEUE_CAPACITY> WsMessageQueue;
+typedef WsRingQueue<WsBuffer, WS_RECYCLE_QUEUE_CAPACITY> WsBufferPool;
+
+struct WsBufferQueues
+{
+    WsBufferQueues()
+    : sending(nullptr)
+    , sendingOffset(0)
+    , receiving(nullptr)
+    , writePending(false)
+    , dispatchPending(false)
+    {}
+
+    ~WsBufferQueues()
+    {
+        delete sending;
+        delete receiving;
+    }
+
+    WsMessageQueue outgoing;     // cocos thread -> websocket thread
+    WsBufferPool outgoingPool;   // websocket thread -> cocos thread
+    WsMessageQueue incoming;     // websocket thread -> cocos thread
+    WsBufferPool incomingPool;   // cocos thread -> websocket thread
+
+    // Only touched by websocket thread
+    WsBuffer* sending;
+    size_t sendingOffset;
+    WsBuffer* receiving;
+
+    // Set while a writable request or a dispatch to cocos thread is outstanding,
+    // so a burst of messages wakes the other thread only once.
+    std::atomic<bool> writePending;
+    std::atomic<bool> dispatchPending;
+};
+
+static WsBuffer* obtainBuffer(WsBufferPool& pool)
+{
+    WsBuffer* buffer = pool.pop();
+    if (buffer == nullptr)
+    {
+        buffer = new WsBuffer();
+        buffer->data.reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
+    }
+    buffer->data.clear();
+    return buffer;
+}
+
+static void recycleBuffer(WsBufferPool& pool, WsBuffer* buffer)
+{
+    if (buffer->data.capacity() > WS_MAX_POOLED_BUFFER_SIZE || !pool.tryPush(buffer))
+    {
+        delete buffer;
+    }
+}
+
 /**
  *  @brief Websocket thread helper, it's used for sending message between UI thread and websocket thread.
  */
@@ -271,6 +434,13 @@ public:
     // Sends message to Websocket thread. It's needs to be invoked in Cocos thread.
     void sendMessageToWebSocketThread(WsMessage *msg);
 
+    // Asks websocket thread to call 'lws_callback_on_writable' for the websocket.
+    void requestWritable(WebSocket* ws);
+    // Drops pending writable requests of a websocket that is being destroyed.
+    void cancelWritableRequests(WebSocket* ws);
+    // Interrupts 'lws_service' so that websocket thread handles new work immediately.
+    void wakeUp();
+
     // Waits the sub-thread (websocket thread) to exit,
     void joinWebSocketThread();
 
@@ -285,6 +455,8 @@ public:
     std::mutex   _subThreadWsMessageQueueMutex;
     std::thread* _subThreadInstance;
 private:
+    std::vector<WebSocket*> _writableRequests;
+    std::mutex _writableRequestsMutex;
     bool _needQuit;
 };
 
@@ -341,6 +513,7 @@ bool WsThreadHelper::createWebSocketThread()
 void WsThreadHelper::quitWebSocketThread()
 {
     _needQuit = true;
+    wakeUp();
 }
 
 void WsThreadHelper::onSubThreadLoop()
@@ -375,14 +548,24 @@ void WsThreadHelper::onSubThreadLoop()
         }
         __wsHelper->_subThreadWsMessageQueueMutex.unlock();
 
-        // The second parameter passed to 'lws_service' means the timeout in milliseconds while polling websocket events.
-        // The lower value the better, otherwise, it may trigger high CPU usage.
-        // We set 2ms in 'lws_service' then sleep 3ms to make lower CPU cost.
-        // Since messages are received in websocket thread and user code is in cocos thread, we need to post event to
-        // cocos thread and trigger user callbacks by 'Scheduler::performFunctionInCocosThread'. If game's fps is set
-        // to 60 (16.66ms), the latency will be (2ms + 3ms + 16.66ms + internet delay) > 21ms
-        lws_service(__wsContext, 2);
-        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+        // 'lws_callback_on_writable' may only be called in websocket thread, so cocos thread
+        // queues the request here and wakes us up.
+        {
+            std::lock_guard<std::mutex> lk(_writableRequestsMutex);
+            for (auto ws : _writableRequests)
+            {
+                if (ws->_wsInstance != nullptr)
+                {
+                    lws_callback_on_writable(ws->_wsInstance);
+                }
+            }
+            _writableRequests.clear();
+        }
+
+        // Writable callbacks are only requested while there is something to send, so 'lws_service' really
+        // blocks until the socket is ready or 'wakeUp' interrupts it. Messages reach cocos thread on its next
+        // frame through 'Scheduler::performFunctionInCocosThread'.
+        lws_service(__wsContext, WS_SERVICE_TIMEOUT_MS);
     }
 }
 
@@ -409,6 +592,7 @@ void WsThreadHelper::onSubThreadEnded()
     if (__wsContext != nullptr)
     {
         lws_context_destroy(__wsContext);
+        __wsContext = nullptr;
     }
 }
 
@@ -434,70 +618,48 @@ void WsThreadHelper::sendMessageToCocosThread(const std::function<void()>& cb)
 
 void WsThreadHelper::sendMessageToWebSocketThread(WsMessage *msg)
 {
-    std::lock_guard<std::mutex> lk(_subThreadWsMessageQueueMutex);
-    _subThreadWsMessageQueue->push_back(msg);
-}
-
-void WsThreadHelper::joinWebSocketThread()
-{
-    if (_subThreadInstance->joinable())
     {
-        _subThreadInstance->join();
+        std::lock_guard<std::mutex> lk(_subThreadWsMessageQueueMutex);
+        _subThreadWsMessageQueue->push_back(msg);
     }
+    wakeUp();
 }
 
-// Define a WebSocket frame
-class WebSocketFrame
+void WsThreadHelper::requestWritable(WebSocket* ws)
 {
-public:
-    WebSocketFrame()
-        : _payload(nullptr)
-        , _payloadLength(0)
-        , _frameLength(0)
     {
-    }
-
-    bool init(unsigned char* buf, ssize_t len)
-    {
-        if (buf == nullptr && len > 0)
-            return false;
-
-        if (!_data.empty())
+        std::lock_guard<std::mutex> lk(_writableRequestsMutex);
+        if (std::find(_writableRequests.begin(), _writableRequests.end(), ws) == _writableRequests.end())
         {
-            LOGD("WebSocketFrame was initialized, should not init it again!\n");
-            return false;
+            _writableRequests.push_back(ws);
         }
+    }
+    wakeUp();
+}
 
-        _data.resize(LWS_PRE + len);
-        
-        if (len > 0)
-        {
-            std::copy(buf, buf + len, _data.begin() + LWS_PRE);
-        }
+void WsThreadHelper::cancelWritableRequests(WebSocket* ws)
+{
+    std::lock_guard<std::mutex> lk(_writableRequestsMutex);
+    _writableRequests.erase(std::remove(_writableRequests.begin(), _writableRequests.end(), ws), _writableRequests.end());
+}
 
-        _payload = _data.data() + LWS_PRE;
-        _payloadLength = len;
-        _frameLength = len;
-        return true;
+void WsThreadHelper::wakeUp()
+{
+    // The context is created in websocket thread, anything queued before that is handled by its first loop.
+    if (__wsContext != nullptr)
+    {
+        lws_cancel_service(__wsContext);
     }
+}
 
-    void update(ssize_t issued)
+void WsThreadHelper::joinWebSocketThread()
+{
+    if (_subThreadInstance->joinable())
     {
-        _payloadLength -= issued;
-        _payload += issued;
+        _subThreadInstance->join();
     }
+}
 
-    unsigned char* getPayload() const { return _payload; }
-    ssize_t getPayloadLength() const { return _payloadLength; }
-    ssize_t getFrameLength() const { return _frameLength; }
-private:
-    unsigned char* _payload;
-    ssize_t _payloadLength;
-
-    ssize_t _frameLength;
-    std::vector<unsigned char> _data;
-};
-//
 
 void WebSocket::closeAllConnections()
 {
@@ -519,14 +681,13 @@ void WebSocket::closeAllConnections()
 
 WebSocket::WebSocket()
 : _readyState(State::CONNECTING)
+, _queues(new WsBufferQueues())
 , _wsInstance(nullptr)
 , _lwsProtocols(nullptr)
 , _isDestroyed(std::make_shared<std::atomic<bool>>(false))
 , _delegate(nullptr)
 , _closeState(CloseState::NONE)
 {
-    // reserve data buffer to avoid allocate memory frequently
-    _receivedData.reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
     if (__websocketInstances == nullptr)
     {
         __websocketInstances = new (std::nothrow) std::vector<WebSocket*>();
@@ -545,7 +706,12 @@ WebSocket::WebSocket()
 WebSocket::~WebSocket()
 {
     LOGD("In the destructor of WebSocket (%p)\n", this);
-    
+
+    if (__wsHelper != nullptr)
+    {
+        __wsHelper->cancelWritableRequests(this);
+    }
+
     std::lock_guard<std::mutex> lk(__instanceMutex);
 
     if (__websocketInstances != nullptr)
@@ -575,7 +741,8 @@ WebSocket::~WebSocket()
         free(name);
     }
     free(_lwsProtocols);
-    
+    delete _queues;
+
     Director::getInstance()->getEventDispatcher()->removeEventListener(_resetDirectorListener);
     
     *_isDestroyed = true;
@@ -652,18 +819,7 @@ void WebSocket::send(const std::string& message)
     if (_readyState == State::OPEN)
     {
         // In main thread
-        Data* data = new (std::nothrow) Data();
-        data->bytes = (char*)malloc(message.length() + 1);
-        // Make sure the last byte is '\0'
-        data->bytes[message.length()] = '\0';
-        strcpy(data->bytes, message.c_str());
-        data->len = static_cast<ssize_t>(message.length());
-
-        WsMessage* msg = new (std::nothrow) WsMessage();
-        msg->what = WS_MSG_TO_SUBTRHEAD_SENDING_STRING;
-        msg->data = data;
-        msg->user = this;
-        __wsHelper->sendMessageToWebSocketThread(msg);
+        enqueueMessage((const unsigned char*)message.data(), message.length(), false);
     }
     else
     {
@@ -676,25 +832,7 @@ void WebSocket::send(const unsigned char* binaryMsg, unsigned int len)
     if (_readyState == State::OPEN)
     {
         // In main thread
-        Data* data = new (std::nothrow) Data();
-        if (len == 0)
-        {
-            // If data length is zero, allocate 1 byte for safe.
-            data->bytes = (char*)malloc(1);
-            data->bytes[0] = '\0';
-        }
-        else
-        {
-            data->bytes = (char*)malloc(len);
-            memcpy((void*)data->bytes, (void*)binaryMsg, len);
-        }
-        data->len = len;
-
-        WsMessage* msg = new (std::nothrow) WsMessage();
-        msg->what = WS_MSG_TO_SUBTRHEAD_SENDING_BINARY;
-        msg->data = data;
-        msg->user = this;
-        __wsHelper->sendMessageToWebSocketThread(msg);
+        enqueueMessage(binaryMsg, len, true);
     }
     else
     {
@@ -702,6 +840,24 @@ void WebSocket::send(const unsigned char* binaryMsg, unsigned int len)
     }
 }
 
+void WebSocket::enqueueMessage(const unsigned char* bytes, size_t len, bool isBinary)
+{
+    WsBuffer* buffer = obtainBuffer(_queues->outgoingPool);
+    buffer->isBinary = isBinary;
+    // lws_write needs LWS_PRE bytes in front of the payload for the frame header
+    buffer->data.resize(LWS_PRE);
+    if (len > 0)
+    {
+        buffer->data.insert(buffer->data.end(), bytes, bytes + len);
+    }
+    _queues->outgoing.push(buffer);
+
+    if (!_queues->writePending.exchange(true))
+    {
+        __wsHelper->requestWritable(this);
+    }
+}
+
 void WebSocket::close()
 {
     if (_closeState != CloseState::NONE)
@@ -728,6 +884,9 @@ void WebSocket::close()
         _readyStateMutex.unlock();
     }
 
+    // Websocket thread closes the connection in its next writable callback
+    __wsHelper->requestWritable(this);
+
     {
         std::unique_lock<std::mutex> lkClose(_closeMutex);
         _closeCondition.wait(lkClose);
@@ -758,6 +917,7 @@ void WebSocket::closeAsync()
     }
 
     _readyState = State::CLOSING;
+    __wsHelper->requestWritable(this);
 }
 
 WebSocket::State WebSocket::getReadyState()
@@ -945,154 +1105,69 @@ int WebSocket::onClientWritable()
         }
     }
 
-    do
-    {
-        std::lock_guard<std::mutex> lk(__wsHelper->_subThreadWsMessageQueueMutex);
-
-        if (__wsHelper->_subThreadWsMessageQueue->empty())
-        {
-            break;
-        }
+    // Messages queued from now on need a new writable request
+    _queues->writePending = false;
 
-        std::list<WsMessage*>::iterator iter = __wsHelper->_subThreadWsMessageQueue->begin();
-
-        while (iter != __wsHelper->_subThreadWsMessageQueue->end())
+    // Write as many queued messages as the socket takes in this callback instead of one fragment per callback
+    while (!lws_send_pipe_choked(_wsInstance))
+    {
+        WsBuffer* buffer = _queues->sending;
+        if (buffer == nullptr)
         {
-            WsMessage* msg = *iter;
-            if (msg->user == this)
+            buffer = _queues->outgoing.pop();
+            if (buffer == nullptr)
             {
                 break;
             }
-            else
-            {
-                ++iter;
-            }
+            _queues->sending = buffer;
+            _queues->sendingOffset = 0;
         }
 
-        ssize_t bytesWrite = 0;
-        if (iter != __wsHelper->_subThreadWsMessageQueue->end())
-        {
-            WsMessage* subThreadMsg = *iter;
-
-            Data* data = (Data*)subThreadMsg->data;
-
-            const ssize_t c_bufferSize = WS_RX_BUFFER_SIZE;
-
-            const ssize_t remaining = data->len - data->issued;
-            const ssize_t n = std::min(remaining, c_bufferSize);
-
-            WebSocketFrame* frame = nullptr;
-
-            if (data->ext)
-            {
-                frame = (WebSocketFrame*)data->ext;
-            }
-            else
-            {
-                frame = new (std::nothrow) WebSocketFrame();
-                bool success = frame && frame->init((unsigned char*)(data->bytes + data->issued), n);
-                if (success)
-                {
-                    data->ext = frame;
-                }
-                else
-                { // If frame initialization failed, delete the frame and drop the sending data
-                  // These codes should never be called.
-                    LOGD("WebSocketFrame initialization failed, drop the sending data, msg(%d)\n", (int)subThreadMsg->id);
-                    delete frame;
-                    CC_SAFE_FREE(data->bytes);
-                    CC_SAFE_DELETE(data);
-                    __wsHelper->_subThreadWsMessageQueue->erase(iter);
-                    CC_SAFE_DELETE(subThreadMsg);
-                    break;
-                }
-            }
+        const size_t offset = _queues->sendingOffset;
+        const size_t remaining = buffer->data.size() - LWS_PRE - offset;
+        const size_t n = std::min(remaining, (size_t)WS_RX_BUFFER_SIZE);
 
-            int writeProtocol;
-
-            if (data->issued == 0)
-            {
-                if (WS_MSG_TO_SUBTRHEAD_SENDING_STRING == subThreadMsg->what)
-                {
-                    writeProtocol = LWS_WRITE_TEXT;
-                }
-                else
-                {
-                    writeProtocol = LWS_WRITE_BINARY;
-                }
-
-                // If we have more than 1 fragment
-                if (data->len > c_bufferSize)
-                    writeProtocol |= LWS_WRITE_NO_FIN;
-            } else {
-                // we are in the middle of fragments
-                writeProtocol = LWS_WRITE_CONTINUATION;
-                // and if not in the last fragment
-                if (remaining != n)
-                    writeProtocol |= LWS_WRITE_NO_FIN;
-            }
-
-            bytesWrite = lws_write(_wsInstance, frame->getPayload(), frame->getPayloadLength(), (lws_write_protocol)writeProtocol);
+        int writeProtocol;
+        if (offset == 0)
+        {
+            writeProtocol = buffer->isBinary ? LWS_WRITE_BINARY : LWS_WRITE_TEXT;
+        }
+        else
+        {
+            // we are in the middle of fragments
+            writeProtocol = LWS_WRITE_CONTINUATION;
+        }
 
-            // Handle the result of lws_write
-            // Buffer overrun?
-            if (bytesWrite < 0)
-            {
-                LOGD("ERROR: msg(%u), lws_write return: %d, but it should be %d, drop this message.\n", subThreadMsg->id, (int)bytesWrite, (int)n);
-                // socket error, we need to close the socket connection
-                CC_SAFE_FREE(data->bytes);
-                delete ((WebSocketFrame*)data->ext);
-                data->ext = nullptr;
-                CC_SAFE_DELETE(data);
-                __wsHelper->_subThreadWsMessageQueue->erase(iter);
-                CC_SAFE_DELETE(subThreadMsg);
-
-                closeAsync();
-            }
-            else if (bytesWrite < frame->getPayloadLength())
-            {
-                frame->update(bytesWrite);
-                LOGD("frame wasn't sent completely, bytesWrite: %d, remain: %d\n", (int)bytesWrite, (int)frame->getPayloadLength());
-            }
-            // Do we have another fragments to send?
-            else if (remaining > frame->getFrameLength() && bytesWrite == frame->getPayloadLength())
-            {
-                // A frame was totally sent, plus data->issued to send next frame
-                LOGD("msg(%u) append: %d + %d = %d\n", subThreadMsg->id, (int)data->issued, (int)frame->getFrameLength(), (int)(data->issued + frame->getFrameLength()));
-                data->issued += frame->getFrameLength();
-                delete ((WebSocketFrame*)data->ext);
-                data->ext = nullptr;
-            }
-            // Safely done!
-            else
-            {
-                LOGD("Safely done, msg(%d)!\n", subThreadMsg->id);
-                if (remaining == frame->getFrameLength())
-                {
-                    LOGD("msg(%u) append: %d + %d = %d\n", subThreadMsg->id, (int)data->issued, (int)frame->getFrameLength(), (int)(data->issued + frame->getFrameLength()));
-                    LOGD("msg(%u) was totally sent!\n", subThreadMsg->id);
-                }
-                else
-                {
-                    LOGD("ERROR: msg(%u), remaining(%d) < bytesWrite(%d)\n", subThreadMsg->id, (int)remaining, (int)frame->getFrameLength());
-                    LOGD("Drop the msg(%u)\n", subThreadMsg->id);
-                    closeAsync();
-                }
+        // If this isn't the last fragment
+        if (remaining > n)
+            writeProtocol |= LWS_WRITE_NO_FIN;
 
-                CC_SAFE_FREE(data->bytes);
-                delete ((WebSocketFrame*)data->ext);
-                data->ext = nullptr;
-                CC_SAFE_DELETE(data);
-                __wsHelper->_subThreadWsMessageQueue->erase(iter);
-                CC_SAFE_DELETE(subThreadMsg);
+        // The frame header is written into the LWS_PRE bytes in front of the fragment, which are either
+        // the reserved headroom or payload that was already sent.
+        int bytesWrite = lws_write(_wsInstance, buffer->data.data() + LWS_PRE + offset, n, (lws_write_protocol)writeProtocol);
 
-                LOGD("-----------------------------------------------------------\n");
-            }
+        if (bytesWrite < 0)
+        {
+            LOGD("ERROR: lws_write return: %d, but it should be %d, drop this message.\n", bytesWrite, (int)n);
+            // socket error, we need to close the socket connection
+            delete buffer;
+            _queues->sending = nullptr;
+            closeAsync();
+            return 0;
         }
 
-    } while(false);
+        // libwebsockets buffers a partially sent frame itself and flushes it before the next writable callback,
+        // so the whole fragment is consumed here.
+        _queues->sendingOffset += n;
+        if (_queues->sendingOffset + LWS_PRE >= buffer->data.size())
+        {
+            LOGD("msg(%d bytes) was totally sent!\n", (int)(buffer->data.size() - LWS_PRE));
+            _queues->sending = nullptr;
+            recycleBuffer(_queues->outgoingPool, buffer);
+        }
+    }
 
-    if (_wsInstance != nullptr)
+    if (_queues->sending != nullptr || !_queues->outgoing.empty())
     {
         lws_callback_on_writable(_wsInstance);
     }
@@ -1105,12 +1180,20 @@ int WebSocket::onClientReceivedData(void* in, ssize_t len)
     // In websocket thread
     static int packageIndex = 0;
     packageIndex++;
+
+    WsBuffer* buffer = _queues->receiving;
+    if (buffer == nullptr)
+    {
+        buffer = obtainBuffer(_queues->incomingPool);
+        _queues->receiving = buffer;
+    }
+
     if (in != nullptr && len > 0)
     {
         LOGD("Receiving data:index:%d, len=%d\n", packageIndex, (int)len);
 
         unsigned char* inData = (unsigned char*)in;
-        _receivedData.insert(_receivedData.end(), inData, inData + len);
+        buffer->data.insert(buffer->data.end(), inData, inData + len);
     }
     else
     {
@@ -1124,44 +1207,69 @@ int WebSocket::onClientReceivedData(void* in, ssize_t len)
 
     if (remainingSize == 0 && isFinalFragment)
     {
-        std::vector<char>* frameData = new (std::nothrow) std::vector<char>(std::move(_receivedData));
+        _queues->receiving = nullptr;
+        buffer->isBinary = (lws_frame_is_binary(_wsInstance) != 0);
 
-        // reset capacity of received data buffer
-        _receivedData.reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
+        if (!buffer->isBinary)
+        {
+            buffer->data.push_back('\0');
+        }
 
-        ssize_t frameSize = frameData->size();
+        _queues->incoming.push(buffer);
 
-        bool isBinary = (lws_frame_is_binary(_wsInstance) != 0);
+        // Messages that arrive before cocos thread runs the dispatch are delivered by the same callback
+        if (!_queues->dispatchPending.exchange(true))
+        {
+            std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
+            __wsHelper->sendMessageToCocosThread([this, isDestroyed](){
+                if (*isDestroyed)
+                {
+                    LOGD("WebSocket instance was destroyed!\n");
+                }
+                else
+                {
+                    dispatchReceivedMessages();
+                }
+            });
+        }
+    }
+
+    return 0;
+}
+
+void WebSocket::dispatchReceivedMessages()
+{
+    // In UI thread
+    _queues->dispatchPending = false;
 
-        if (!isBinary)
+    std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
+    WsBuffer* buffer = nullptr;
+    while ((buffer = _queues->incoming.pop()) != nullptr)
+    {
+        ssize_t frameSize = static_cast<ssize_t>(buffer->data.size());
+        if (!buffer->isBinary)
         {
-            frameData->push_back('\0');
+            // Exclude the appended '\0'
+            --frameSize;
         }
+        LOGD("Notify data len %d to Cocos thread.\n", (int)frameSize);
 
-        std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
-        __wsHelper->sendMessageToCocosThread([this, frameData, frameSize, isBinary, isDestroyed](){
-            // In UI thread
-            LOGD("Notify data len %d to Cocos thread.\n", (int)frameSize);
+        Data data;
+        data.isBinary = buffer->isBinary;
+        data.bytes = (char*)buffer->data.data();
+        data.len = frameSize;
 
-            Data data;
-            data.isBinary = isBinary;
-            data.bytes = (char*)frameData->data();
-            data.len = frameSize;
+        _delegate->onMessage(this, data);
 
-            if (*isDestroyed)
-            {
-                LOGD("WebSocket instance was destroyed!\n");
-            }
-            else
-            {
-                _delegate->onMessage(this, data);
-            }
+        if (*isDestroyed)
+        {
+            // The websocket was deleted in onMessage, the buffer is ours alone now
+            delete buffer;
+            return;
+        }
 
-            delete frameData;
-        });
+        recycleBuffer(_queues->incomingPool, buffer);
     }
-
-    return 0;
 }
 
 int WebSocket::onConnectionOpened()
@@ -1316,6 +1424,8 @@ int WebSocket::onSocketCallback(struct lws *wsi,
 
         case LWS_CALLBACK_WSI_DESTROY:
             ret = onConnectionClosed();
+            // Pending writable requests must not touch the destroyed wsi
+            _wsInstance = nullptr;
             break;
 
         case LWS_CALLBACK_CLIENT_RECEIVE:
@@ -55,6 +55,7 @@ class EventListenerCustom;
 namespace network {
 
 class WsThreadHelper;
+struct WsBufferQueues;
 
 /**
  * WebSocket is wrapper of the libwebsockets-protocol, let the develop could call the websocket easily.
@@ -139,6 +140,8 @@ public:
          *
          * @param ws The WebSocket object connected.
          * @param data Data object for message.
+         * @note data.bytes points into a pooled receive buffer and is only valid until onMessage returns,
+         *       copy it if it needs to be kept.
          */
         virtual void onMessage(WebSocket* ws, const Data& data) = 0;
         /**
@@ -179,6 +182,8 @@ public:
      *  @brief Sends string data to websocket server.
      *  
      *  @param message string data.
+     *  @note Messages are queued on a lock-free ring buffer that has a single producer,
+     *        so send should only be invoked from the cocos thread.
      *  @lua sendstring
      */
     void send(const std::string& message);
@@ -234,6 +239,11 @@ private:
     int onConnectionError(void* in, ssize_t len);
     int onConnectionClosed();
 
+    // Invoked in cocos thread, copies the message into a pooled buffer and queues it for websocket thread
+    void enqueueMessage(const unsigned char* bytes, size_t len, bool isBinary);
+    // Invoked in cocos thread, delivers all received messages with one scheduled callback
+    void dispatchReceivedMessages();
+
     struct lws_vhost* createVhost(struct lws_protocols* protocols, int& sslConnection);
 
 private:
@@ -243,7 +253,7 @@ private:
 
     std::string _url;
 
-    std::vector<char> _receivedData;
+    WsBufferQueues* _queues;
 
     struct lws* _wsInstance;
     struct lws_protocols* _lwsProtocols;
@@ -0,0 +1,581 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCAsyncFileReader.h"
+
+#include <algorithm>
+
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define CC_ASYNC_FILE_READER_USE_IO_URING
+#endif
+#endif
+
+#ifdef CC_ASYNC_FILE_READER_USE_IO_URING
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace
+{
+    // at most this many requests are read by one worker before their callbacks are dispatched
+    const size_t WORKER_BATCH_SIZE = 8;
+    // number of reads the ring keeps in flight
+    const unsigned int RING_ENTRIES = 64;
+}
+
+struct AsyncFileReader::Request
+{
+    unsigned int id;
+    int priority;
+    unsigned int sequence;
+    std::string fullPath;
+    std::shared_ptr<ResizableBuffer> buffer;
+    Callback callback;
+    FileUtils::Status status;
+
+    // used by direct reads
+    int fd;
+    size_t size;
+    size_t offset;
+#ifdef CC_ASYNC_FILE_READER_USE_IO_URING
+    struct iovec iov;
+#endif
+};
+
+#ifdef CC_ASYNC_FILE_READER_USE_IO_URING
+
+// The kernel interface of io_uring, without liburing
+class AsyncFileReader::Ring
+{
+public:
+    static Ring* create(unsigned int entries)
+    {
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0)
+        {
+            // the kernel is too old or io_uring is disabled
+            return nullptr;
+        }
+
+        Ring* ring = new (std::nothrow) Ring(fd);
+        if (ring && !ring->map(params))
+        {
+            delete ring;
+            ring = nullptr;
+        }
+        return ring;
+    }
+
+    ~Ring()
+    {
+        if (_sqes)
+            munmap(_sqes, _sqesSize);
+        if (_cqRing && _cqRing != _sqRing)
+            munmap(_cqRing, _cqRingSize);
+        if (_sqRing)
+            munmap(_sqRing, _sqRingSize);
+        close(_fd);
+    }
+
+    unsigned int getEntries() const { return _sqEntries; }
+
+    // The returned entry is submitted with the next call of submit
+    struct io_uring_sqe* getSqe()
+    {
+        unsigned int head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+        if (_sqTailLocal - head >= _sqEntries)
+            return nullptr;
+
+        unsigned int index = _sqTailLocal & _sqMask;
+        _sqArray[index] = index;
+        ++_sqTailLocal;
+        struct io_uring_sqe* sqe = &_sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    // Submits the new entries and waits until at least waitCount reads finished
+    int submit(unsigned int waitCount)
+    {
+        __atomic_store_n(_sqTail, _sqTailLocal, __ATOMIC_RELEASE);
+        unsigned int count = _sqTailLocal - _sqSubmitted;
+        int ret;
+        do
+        {
+            ret = (int)syscall(__NR_io_uring_enter, _fd, count, waitCount, waitCount > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        } while (ret < 0 && errno == EINTR);
+
+        if (ret > 0)
+            _sqSubmitted += ret;
+        return ret;
+    }
+
+    template <typename F>
+    void reap(F&& handler)
+    {
+        unsigned int head = *_cqHead;
+        unsigned int tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail)
+        {
+            const struct io_uring_cqe& cqe = _cqes[head & _cqMask];
+            handler(cqe.user_data, cqe.res);
+            ++head;
+        }
+        __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    explicit Ring(int fd)
+    : _fd(fd)
+    , _sqRing(nullptr)
+    , _cqRing(nullptr)
+    , _sqes(nullptr)
+    , _sqRingSize(0)
+    , _cqRingSize(0)
+    , _sqesSize(0)
+    , _sqTailLocal(0)
+    , _sqSubmitted(0)
+    {
+    }
+
+    bool map(const struct io_uring_params& params)
+    {
+        _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        bool singleMap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+        singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap)
+            _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+#endif
+
+        void* sqRing = mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED)
+            return false;
+        _sqRing = static_cast<unsigned char*>(sqRing);
+
+        if (singleMap)
+        {
+            _cqRing = _sqRing;
+        }
+        else
+        {
+            void* cqRing = mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+            if (cqRing == MAP_FAILED)
+                return false;
+            _cqRing = static_cast<unsigned char*>(cqRing);
+        }
+
+        _sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+        void* sqes = mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+            return false;
+        _sqes = static_cast<struct io_uring_sqe*>(sqes);
+
+        _sqEntries = params.sq_entries;
+        _sqHead = reinterpret_cast<unsigned int*>(_sqRing + params.sq_off.head);
+        _sqTail = reinterpret_cast<unsigned int*>(_sqRing + params.sq_off.tail);
+        _sqMask = *reinterpret_cast<unsigned int*>(_sqRing + params.sq_off.ring_mask);
+        _sqArray = reinterpret_cast<unsigned int*>(_sqRing + params.sq_off.array);
+        _sqTailLocal = _sqSubmitted = *_sqTail;
+
+        _cqHead = reinterpret_cast<unsigned int*>(_cqRing + params.cq_off.head);
+        _cqTail = reinterpret_cast<unsigned int*>(_cqRing + params.cq_off.tail);
+        _cqMask = *reinterpret_cast<unsigned int*>(_cqRing + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<struct io_uring_cqe*>(_cqRing + params.cq_off.cqes);
+        return true;
+    }
+
+    int _fd;
+    unsigned char* _sqRing;
+    unsigned char* _cqRing;
+    struct io_uring_sqe* _sqes;
+    size_t _sqRingSize;
+    size_t _cqRingSize;
+    size_t _sqesSize;
+
+    unsigned int _sqEntries;
+    unsigned int* _sqHead;
+    unsigned int* _sqTail;
+    unsigned int _sqMask;
+    unsigned int* _sqArray;
+    unsigned int _sqTailLocal;
+    unsigned int _sqSubmitted;
+
+    unsigned int* _cqHead;
+    unsigned int* _cqTail;
+    unsigned int _cqMask;
+    struct io_uring_cqe* _cqes;
+};
+
+#else
+
+class AsyncFileReader::Ring
+{
+};
+
+#endif // CC_ASYNC_FILE_READER_USE_IO_URING
+
+AsyncFileReader::AsyncFileReader(const FileUtils* fileUtils)
+: _fileUtils(fileUtils)
+, _stopped(false)
+, _nextRequestId(1)
+, _nextSequence(0)
+{
+#ifdef CC_ASYNC_FILE_READER_USE_IO_URING
+    _ring.reset(Ring::create(RING_ENTRIES));
+    if (_ring)
+    {
+        _ringThread = std::thread(&AsyncFileReader::ringLoop, this);
+    }
+#endif
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopped = true;
+    }
+    _workerCondition.notify_all();
+    _ringCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+    if (_ringThread.joinable())
+    {
+        // waits for the reads in flight, they still write to their buffers
+        _ringThread.join();
+    }
+}
+
+unsigned int AsyncFileReader::read(const std::string& fullPath, std::shared_ptr<ResizableBuffer> buffer, int priority, bool direct, Callback callback)
+{
+    std::unique_ptr<Request> request(new Request);
+    unsigned int id = _nextRequestId++;
+    if (id == 0)
+        id = _nextRequestId++;
+    request->id = id;
+    request->priority = priority;
+    request->fullPath = fullPath;
+    request->buffer = std::move(buffer);
+    request->callback = std::move(callback);
+    request->status = FileUtils::Status::OK;
+    request->fd = -1;
+    request->size = 0;
+    request->offset = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        request->sequence = _nextSequence++;
+        if (direct && _ring)
+        {
+            pushRequest(_directQueue, std::move(request));
+        }
+        else
+        {
+            startWorkers();
+            pushRequest(_queue, std::move(request));
+        }
+    }
+
+    if (direct && _ring)
+        _ringCondition.notify_one();
+    else
+        _workerCondition.notify_one();
+    return id;
+}
+
+bool AsyncFileReader::cancel(unsigned int requestId)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (RequestQueue* queue : { &_queue, &_directQueue })
+    {
+        auto it = std::find_if(queue->begin(), queue->end(), [requestId](const std::unique_ptr<Request>& request) {
+            return request->id == requestId;
+        });
+        if (it != queue->end())
+        {
+            queue->erase(it);
+            std::make_heap(queue->begin(), queue->end(), isLowerPriority);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AsyncFileReader::isLowerPriority(const std::unique_ptr<Request>& a, const std::unique_ptr<Request>& b)
+{
+    // requests with equal priorities are read in the order they were made
+    return a->priority < b->priority || (a->priority == b->priority && a->sequence > b->sequence);
+}
+
+void AsyncFileReader::pushRequest(RequestQueue& queue, std::unique_ptr<Request> request)
+{
+    queue.push_back(std::move(request));
+    std::push_heap(queue.begin(), queue.end(), isLowerPriority);
+}
+
+std::unique_ptr<AsyncFileReader::Request> AsyncFileReader::popRequest(RequestQueue& queue)
+{
+    std::pop_heap(queue.begin(), queue.end(), isLowerPriority);
+    std::unique_ptr<Request> request = std::move(queue.back());
+    queue.pop_back();
+    return request;
+}
+
+void AsyncFileReader::startWorkers()
+{
+    if (!_workers.empty())
+        return;
+
+    unsigned int count = std::max(2u, std::min(4u, std::thread::hardware_concurrency() / 2));
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _workers.emplace_back(&AsyncFileReader::workerLoop, this);
+    }
+}
+
+void AsyncFileReader::workerLoop()
+{
+    RequestQueue batch;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _workerCondition.wait(lock, [this]() { return _stopped || !_queue.empty(); });
+            if (_stopped)
+                break;
+
+            // share a long queue with the other workers, but don't post every small file on its own
+            size_t count = std::max((size_t)1, std::min(WORKER_BATCH_SIZE, _queue.size() / _workers.size()));
+            while (batch.size() < count && !_queue.empty())
+            {
+                batch.push_back(popRequest(_queue));
+            }
+        }
+
+        for (auto& request : batch)
+        {
+            request->status = _fileUtils->getContents(request->fullPath, request->buffer.get());
+        }
+        dispatchFinished(batch);
+    }
+}
+
+#ifdef CC_ASYNC_FILE_READER_USE_IO_URING
+
+void AsyncFileReader::ringLoop()
+{
+    RequestQueue batch;
+    RequestQueue finished;
+    unsigned int inFlight = 0;
+    unsigned int capacity = std::min(RING_ENTRIES, _ring->getEntries());
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (inFlight == 0)
+            {
+                _ringCondition.wait(lock, [this]() { return _stopped || !_directQueue.empty(); });
+                if (_stopped)
+                    break;
+            }
+
+            // stop taking new requests once stopped, but let the reads in flight finish
+            while (!_stopped && inFlight + batch.size() < capacity && !_directQueue.empty())
+            {
+                batch.push_back(popRequest(_directQueue));
+            }
+        }
+
+        for (auto& request : batch)
+        {
+            if (openRequest(request.get()))
+            {
+                submitRequest(request.release());
+                ++inFlight;
+            }
+            else
+            {
+                finished.push_back(std::move(request));
+            }
+        }
+        batch.clear();
+
+        if (inFlight > 0)
+        {
+            if (_ring->submit(1) < 0)
+            {
+                CCLOG("AsyncFileReader: io_uring_enter failed, errno: %d", errno);
+            }
+
+            _ring->reap([&](uint64_t userData, int result) {
+                Request* request = reinterpret_cast<Request*>(userData);
+                if (result == -EINTR || result == -EAGAIN)
+                {
+                    submitRequest(request);
+                    return;
+                }
+
+                if (result > 0)
+                {
+                    request->offset += result;
+                    if (request->offset < request->size)
+                    {
+                        // short read, continue where it stopped
+                        submitRequest(request);
+                        return;
+                    }
+                }
+                else
+                {
+                    // an error, or the file got shorter since it was opened
+                    request->status = FileUtils::Status::ReadFailed;
+                    request->buffer->resize(request->offset);
+                }
+
+                close(request->fd);
+                request->fd = -1;
+                --inFlight;
+                finished.push_back(std::unique_ptr<Request>(request));
+            });
+        }
+
+        dispatchFinished(finished);
+    }
+}
+
+bool AsyncFileReader::openRequest(Request* request)
+{
+    request->fd = open(request->fullPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (request->fd < 0)
+    {
+        request->status = errno == ENOENT ? FileUtils::Status::NotExists : FileUtils::Status::OpenFailed;
+        return false;
+    }
+
+    struct stat statBuf;
+    if (fstat(request->fd, &statBuf) != 0 || !S_ISREG(statBuf.st_mode))
+    {
+        request->status = FileUtils::Status::NotRegularFileType;
+        close(request->fd);
+        request->fd = -1;
+        return false;
+    }
+
+    request->size = static_cast<size_t>(statBuf.st_size);
+    request->buffer->resize(request->size);
+    if (request->size == 0)
+    {
+        close(request->fd);
+        request->fd = -1;
+        return false;
+    }
+    return true;
+}
+
+void AsyncFileReader::submitRequest(Request* request)
+{
+    struct io_uring_sqe* sqe = _ring->getSqe();
+    if (!sqe)
+    {
+        // never happens, there are not more reads in flight than entries
+        _ring->submit(0);
+        sqe = _ring->getSqe();
+    }
+
+    request->iov.iov_base = static_cast<char*>(request->buffer->buffer()) + request->offset;
+    request->iov.iov_len = request->size - request->offset;
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = request->fd;
+    sqe->off = request->offset;
+    sqe->addr = reinterpret_cast<uint64_t>(&request->iov);
+    sqe->len = 1;
+    sqe->user_data = reinterpret_cast<uint64_t>(request);
+}
+
+#else
+
+void AsyncFileReader::ringLoop()
+{
+}
+
+bool AsyncFileReader::openRequest(Request* /*request*/)
+{
+    return false;
+}
+
+void AsyncFileReader::submitRequest(Request* /*request*/)
+{
+}
+
+#endif // CC_ASYNC_FILE_READER_USE_IO_URING
+
+void AsyncFileReader::dispatchFinished(RequestQueue& finished)
+{
+    if (finished.empty())
+        return;
+
+    {
+        // the reader is being destroyed, drop the results like the queued requests
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stopped)
+        {
+            finished.clear();
+            return;
+        }
+    }
+
+    auto requests = std::make_shared<RequestQueue>(std::move(finished));
+    finished.clear();
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread([requests]() {
+        for (auto& request : *requests)
+        {
+            if (request->callback)
+                request->callback(request->status);
+        }
+    });
+}
+
+NS_CC_END
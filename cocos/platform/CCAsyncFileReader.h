@@ -0,0 +1,113 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_ASYNC_FILE_READER_H__
+#define __CC_ASYNC_FILE_READER_H__
+/// @cond DO_NOT_SHOW
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+/**
+ * Reads files on background threads for FileUtils::getContentsAsync.
+ *
+ * Queued requests are served by priority, then in the order they were made. Files which FileUtils
+ * allows to be read directly are read with io_uring on Linux, everything else goes through
+ * FileUtils::getContents on a small thread pool. Finished requests are handed to the cocos thread
+ * in batches.
+ */
+class CC_DLL AsyncFileReader
+{
+public:
+    typedef std::function<void(FileUtils::Status)> Callback;
+
+    explicit AsyncFileReader(const FileUtils* fileUtils);
+    /** Stops the threads, queued requests are dropped without calling their callbacks. */
+    ~AsyncFileReader();
+
+    /**
+     * Queues a read.
+     *
+     * @param fullPath The full path of the file.
+     * @param buffer Receives the contents, it is kept alive until the callback was called.
+     * @param priority Requests with a higher priority are read first.
+     * @param direct Whether the file may be opened directly instead of calling FileUtils::getContents.
+     * @param callback Called on the cocos thread once the file was read.
+     * @return The id of the request.
+     */
+    unsigned int read(const std::string& fullPath, std::shared_ptr<ResizableBuffer> buffer, int priority, bool direct, Callback callback);
+
+    /**
+     * Removes a request which hasn't started yet.
+     * @return false if the request is being read or finished, its callback will be called.
+     */
+    bool cancel(unsigned int requestId);
+
+private:
+    struct Request;
+    class Ring;
+    typedef std::vector<std::unique_ptr<Request>> RequestQueue;
+
+    static bool isLowerPriority(const std::unique_ptr<Request>& a, const std::unique_ptr<Request>& b);
+    void pushRequest(RequestQueue& queue, std::unique_ptr<Request> request);
+    std::unique_ptr<Request> popRequest(RequestQueue& queue);
+    void startWorkers();
+    void workerLoop();
+    void ringLoop();
+    bool openRequest(Request* request);
+    void submitRequest(Request* request);
+    void dispatchFinished(RequestQueue& finished);
+
+    const FileUtils* _fileUtils;
+
+    std::mutex _mutex;
+    std::condition_variable _workerCondition;
+    std::condition_variable _ringCondition;
+    // binary heaps, see pushRequest
+    RequestQueue _queue;
+    RequestQueue _directQueue;
+    std::vector<std::thread> _workers;
+    bool _stopped;
+
+    std::unique_ptr<Ring> _ring;
+    std::thread _ringThread;
+
+    std::atomic<unsigned int> _nextRequestId;
+    unsigned int _nextSequence;
+};
+
+NS_CC_END
+
+/// @endcond
+#endif // __CC_ASYNC_FILE_READER_H__
@@ -27,10 +27,14 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 
 #include <stack>
+#include <unordered_set>
+#include <algorithm>
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
+#include "base/ZipUtils.h"
+#include "platform/CCAsyncFileReader.h"
 #include "platform/CCSAXParser.h"
 //#include "base/ccUtils.h"
 
@@ -542,16 +546,54 @@ FileUtils* FileUtils::s_sharedFileUtils = nullptr;
 
 void FileUtils::destroyInstance()
 {
+    if (s_sharedFileUtils)
+    {
+        // the reader threads call virtual functions, stop them before the subclass is destroyed
+        s_sharedFileUtils->_asyncFileReader.reset();
+    }
     CC_SAFE_DELETE(s_sharedFileUtils);
 }
 
 void FileUtils::setDelegate(FileUtils *delegate)
 {
+    if (s_sharedFileUtils)
+    {
+        s_sharedFileUtils->_asyncFileReader.reset();
+    }
     delete s_sharedFileUtils;
 
     s_sharedFileUtils = delegate;
 }
 
+struct FileUtils::MountPoint
+{
+    // the path passed to mountPack/mountManifest
+    std::string path;
+    // full path of the mounted directory, ends with '/'
+    std::string root;
+    int priority;
+    // nullptr for manifests
+    std::unique_ptr<ZipFile> pack;
+    // files of a manifest and the directories of both, relative to root
+    std::unordered_set<std::string> files;
+    std::unordered_set<std::string> directories;
+
+    bool hasFile(const std::string& relativePath) const
+    {
+        return pack ? pack->fileExists(relativePath) : files.find(relativePath) != files.end();
+    }
+
+    void addDirectories(const std::string& relativePath)
+    {
+        size_t pos = relativePath.find('/');
+        while (pos != std::string::npos)
+        {
+            directories.insert(relativePath.substr(0, pos + 1));
+            pos = relativePath.find('/', pos + 1);
+        }
+    }
+};
+
 FileUtils::FileUtils()
     : _writablePath("")
 {
@@ -626,6 +668,195 @@ void FileUtils::purgeCachedEntries()
     _fullPathCacheDir.clear();
 }
 
+bool FileUtils::mountPack(const std::string& packPath, const std::string& mountPoint, int priority)
+{
+    std::string fullPath = fullPathForFilename(packPath);
+    if (fullPath.empty())
+        return false;
+
+    auto mount = std::make_shared<MountPoint>();
+    mount->path = packPath;
+    mount->root = mountPoint;
+    mount->priority = priority;
+    mount->pack.reset(new (std::nothrow) ZipFile(fullPath));
+    if (!mount->pack)
+        return false;
+
+    std::string name = mount->pack->getFirstFilename();
+    if (name.empty())
+    {
+        CCLOG("cocos2d: mountPack: %s is not a zip file or empty", fullPath.c_str());
+        return false;
+    }
+    for (; !name.empty(); name = mount->pack->getNextFilename())
+    {
+        mount->addDirectories(name);
+    }
+
+    return addMount(std::move(mount));
+}
+
+bool FileUtils::mountManifest(const std::string& manifestPath, const std::string& directory, int priority)
+{
+    std::string manifest = getStringFromFile(manifestPath);
+    if (manifest.empty())
+        return false;
+
+    auto mount = std::make_shared<MountPoint>();
+    mount->path = manifestPath;
+    mount->root = directory;
+    mount->priority = priority;
+
+    size_t begin = 0;
+    while (begin < manifest.length())
+    {
+        size_t end = manifest.find('\n', begin);
+        if (end == std::string::npos)
+            end = manifest.length();
+
+        size_t length = end - begin;
+        if (length > 0 && manifest[end - 1] == '\r')
+            --length;
+        if (length > 0)
+        {
+            std::string file = manifest.substr(begin, length);
+            mount->addDirectories(file);
+            mount->files.insert(std::move(file));
+        }
+        begin = end + 1;
+    }
+
+    return addMount(std::move(mount));
+}
+
+bool FileUtils::addMount(std::shared_ptr<MountPoint> mount)
+{
+    DECLARE_GUARD;
+
+    if (!isAbsolutePath(mount->root))
+        mount->root = _defaultResRootPath + mount->root;
+    if (!mount->root.empty() && mount->root[mount->root.length() - 1] != '/')
+        mount->root += '/';
+
+    for (const auto& mounted : _mounts)
+    {
+        if (mounted->path == mount->path)
+        {
+            CCLOG("cocos2d: %s is already mounted", mount->path.c_str());
+            return false;
+        }
+    }
+
+    // keep the mounting order for equal priorities
+    auto it = std::upper_bound(_mounts.begin(), _mounts.end(), mount->priority, [](int priority, const std::shared_ptr<MountPoint>& mounted) {
+        return priority > mounted->priority;
+    });
+    _mounts.insert(it, std::move(mount));
+
+    // any cached path may now be hidden by a file of the mount
+    _fullPathCache.clear();
+    _fullPathCacheDir.clear();
+    return true;
+}
+
+bool FileUtils::unmount(const std::string& path)
+{
+    DECLARE_GUARD;
+
+    auto it = std::find_if(_mounts.begin(), _mounts.end(), [&path](const std::shared_ptr<MountPoint>& mounted) {
+        return mounted->path == path;
+    });
+    if (it == _mounts.end())
+        return false;
+
+    std::shared_ptr<MountPoint> mount = *it;
+    _mounts.erase(it);
+
+    if (!mount->pack)
+    {
+        // files which were hidden by the manifest may exist on disk
+        _fullPathCache.clear();
+        _fullPathCacheDir.clear();
+        return true;
+    }
+
+    // only paths below the pack may have been resolved to it, the other cached paths stay valid
+    const std::string& root = mount->root;
+    auto isBelowRoot = [&root](const std::string& fullPath) {
+        return fullPath.compare(0, root.length(), root) == 0;
+    };
+    for (auto iter = _fullPathCache.begin(); iter != _fullPathCache.end();)
+    {
+        if (isBelowRoot(iter->second))
+            iter = _fullPathCache.erase(iter);
+        else
+            ++iter;
+    }
+    for (auto iter = _fullPathCacheDir.begin(); iter != _fullPathCacheDir.end();)
+    {
+        if (isBelowRoot(iter->second))
+            iter = _fullPathCacheDir.erase(iter);
+        else
+            ++iter;
+    }
+    return true;
+}
+
+std::shared_ptr<FileUtils::MountPoint> FileUtils::findMountedFile(const std::string& fullPath, bool* covered) const
+{
+    DECLARE_GUARD;
+
+    *covered = false;
+    for (const auto& mount : _mounts)
+    {
+        if (fullPath.length() <= mount->root.length() || fullPath.compare(0, mount->root.length(), mount->root) != 0)
+            continue;
+
+        if (mount->hasFile(fullPath.substr(mount->root.length())))
+            return mount;
+
+        if (!mount->pack)
+            *covered = true;
+    }
+    return nullptr;
+}
+
+bool FileUtils::isMountedDirectory(const std::string& fullPath, bool* covered) const
+{
+    DECLARE_GUARD;
+
+    *covered = false;
+    std::string dirPath = fullPath;
+    if (!dirPath.empty() && dirPath[dirPath.length() - 1] != '/')
+        dirPath += '/';
+
+    for (const auto& mount : _mounts)
+    {
+        if (dirPath.compare(0, mount->root.length(), mount->root) != 0)
+            continue;
+
+        if (dirPath.length() == mount->root.length()
+            || mount->directories.find(dirPath.substr(mount->root.length())) != mount->directories.end())
+            return true;
+
+        if (!mount->pack)
+            *covered = true;
+    }
+    return false;
+}
+
+bool FileUtils::getContentsFromPack(const std::string& fullPath, ResizableBuffer* buffer, Status* status) const
+{
+    bool covered = false;
+    std::shared_ptr<MountPoint> mount = findMountedFile(fullPath, &covered);
+    if (!mount || !mount->pack)
+        return false;
+
+    // reading needs no lock, the mount stays alive even if it is unmounted meanwhile
+    *status = mount->pack->getFileData(fullPath.substr(mount->root.length()), buffer) ? Status::OK : Status::ReadFailed;
+    return true;
+}
+
 std::string FileUtils::getStringFromFile(const std::string& filename) const
 {
     std::string s;
@@ -635,12 +866,10 @@ std::string FileUtils::getStringFromFile(const std::string& filename) const
 
 void FileUtils::getStringFromFile(const std::string &path, std::function<void (std::string)> callback) const
 {
-    // Get the full path on the main thread, to avoid the issue that FileUtil's is not
-    // thread safe, and accessing the fullPath cache and searching the search paths is not thread safe
-    auto fullPath = fullPathForFilename(path);
-    performOperationOffthread([fullPath]() -> std::string {
-        return FileUtils::getInstance()->getStringFromFile(fullPath);
-    }, std::move(callback));
+    auto contents = std::make_shared<std::string>();
+    getContentsAsync(path, contents.get(), [contents, callback](Status) {
+        callback(std::move(*contents));
+    });
 }
 
 Data FileUtils::getDataFromFile(const std::string& filename) const
@@ -652,10 +881,50 @@ Data FileUtils::getDataFromFile(const std::string& filename) const
 
 void FileUtils::getDataFromFile(const std::string& filename, std::function<void(Data)> callback) const
 {
-    auto fullPath = fullPathForFilename(filename);
-    performOperationOffthread([fullPath]() -> Data {
-        return FileUtils::getInstance()->getDataFromFile(fullPath);
-    }, std::move(callback));
+    auto data = std::make_shared<Data>();
+    getContentsAsync(filename, data.get(), [data, callback](Status) {
+        callback(std::move(*data));
+    });
+}
+
+unsigned int FileUtils::getContentsAsync(const std::string& filename, std::shared_ptr<ResizableBuffer> buffer, std::function<void(Status)> callback, int priority) const
+{
+    // Get the full path on the calling thread, the search paths may change meanwhile
+    std::string fullPath = filename.empty() ? filename : fullPathForFilename(filename);
+    if (fullPath.empty())
+    {
+        if (callback)
+        {
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread([callback]() {
+                callback(Status::NotExists);
+            });
+        }
+        return 0;
+    }
+
+    bool covered = false;
+    auto mount = findMountedFile(fullPath, &covered);
+    bool direct = !(mount && mount->pack) && canReadFileDirectly(fullPath);
+
+    AsyncFileReader* reader;
+    {
+        DECLARE_GUARD;
+        if (!_asyncFileReader)
+            _asyncFileReader.reset(new AsyncFileReader(this));
+        reader = _asyncFileReader.get();
+    }
+    return reader->read(fullPath, std::move(buffer), priority, direct, std::move(callback));
+}
+
+bool FileUtils::cancelContentsAsync(unsigned int requestId) const
+{
+    DECLARE_GUARD;
+    return _asyncFileReader && _asyncFileReader->cancel(requestId);
+}
+
+bool FileUtils::canReadFileDirectly(const std::string& /*fullPath*/) const
+{
+    return false;
 }
 
 FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableBuffer* buffer) const
@@ -669,6 +938,10 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    Status status;
+    if (fs->getContentsFromPack(fullPath, buffer, &status))
+        return status;
+
     std::string suitableFullPath = fs->getSuitableFOpen(fullPath);
 
     struct stat statBuf;
@@ -842,10 +1115,33 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
 
     std::string fullpath;
 
+    // mounted files are looked up by the same path getPathForFilename would check on disk
+    std::string fileDirectory;
+    std::string fileName = newFilename;
+    size_t pos = newFilename.find_last_of('/');
+    if (pos != std::string::npos)
+    {
+        fileDirectory = newFilename.substr(0, pos + 1);
+        fileName = newFilename.substr(pos + 1);
+    }
+
     for (const auto& searchIt : _searchPathArray)
     {
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
         {
+            if (!_mounts.empty())
+            {
+                std::string mountedPath = searchIt + fileDirectory + resolutionIt + fileName;
+                bool covered = false;
+                if (findMountedFile(mountedPath, &covered))
+                {
+                    _fullPathCache.emplace(filename, mountedPath);
+                    return mountedPath;
+                }
+                if (covered)
+                    continue;
+            }
+
             fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
 
             if (!fullpath.empty())
@@ -902,7 +1198,11 @@ std::string FileUtils::fullPathForDirectory(const std::string &dir) const
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
         {
             fullpath = this->getPathForDirectory(newdirname, resolutionIt, searchIt);
-            if (!fullpath.empty() && isDirectoryExistInternal(fullpath))
+            if (fullpath.empty())
+                continue;
+
+            bool covered = false;
+            if (isMountedDirectory(fullpath, &covered) || (!covered && isDirectoryExistInternal(fullpath)))
             {
                 // Using the filename passed in as key.
                 _fullPathCacheDir.emplace(dir, fullpath);
@@ -1132,7 +1432,10 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
-        return isFileExistInternal(filename);
+        bool covered = false;
+        if (findMountedFile(filename, &covered))
+            return true;
+        return !covered && isFileExistInternal(filename);
     }
     else
     {
@@ -1165,7 +1468,10 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
 
     if (isAbsolutePath(dirPath))
     {
-        return isDirectoryExistInternal(dirPath);
+        bool covered = false;
+        if (isMountedDirectory(dirPath, &covered))
+            return true;
+        return !covered && isDirectoryExistInternal(dirPath);
     } else {
         auto fullPath = fullPathForDirectory(dirPath);
         return !fullPath.empty();
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include <unordered_map>
 #include <type_traits>
 #include <mutex>
+#include <memory>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
@@ -42,6 +43,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class AsyncFileReader;
+
 /**
  * @addtogroup platform
  * @{
@@ -274,6 +277,44 @@ public:
     }
     virtual Status getContents(const std::string& filename, ResizableBuffer* buffer) const;
 
+    /**
+     *  Reads whole file contents like getContents, but on a background thread.
+     *
+     *  Requests with a higher priority are read first, requests with the same priority in the order they were made.
+     *  On Linux, plain files are read with io_uring if the kernel supports it.
+     *
+     *  @code
+     *  auto data = std::make_shared<Data>();
+     *  FileUtils::getInstance()->getContentsAsync("path/to/file", data.get(), [data](FileUtils::Status status) {
+     *      // use *data
+     *  });
+     *  @endcode
+     *
+     *  @param filename The resource file name which contains the path, it is resolved on the calling thread.
+     *  @param buffer The buffer where the file contents are stored to. It must not be used until the callback was called.
+     *  @param callback Called on the cocos thread with the result, see getContents.
+     *  @param priority The priority of the request.
+     *  @return An id to cancel the request with cancelContentsAsync, 0 if the file was not found.
+     */
+    template <
+        typename T,
+        typename Enable = typename std::enable_if<
+            std::is_base_of< ResizableBuffer, ResizableBufferAdapter<T> >::value
+        >::type
+    >
+    unsigned int getContentsAsync(const std::string& filename, T* buffer, std::function<void(Status)> callback, int priority = 0) const {
+        return getContentsAsync(filename, std::make_shared<ResizableBufferAdapter<T>>(buffer), std::move(callback), priority);
+    }
+    unsigned int getContentsAsync(const std::string& filename, std::shared_ptr<ResizableBuffer> buffer, std::function<void(Status)> callback, int priority = 0) const;
+
+    /**
+     *  Cancels a request of getContentsAsync which hasn't started yet, its callback won't be called.
+     *
+     *  @param requestId The id returned by getContentsAsync.
+     *  @return false if the file is being read or was read already, the callback will be called then.
+     */
+    bool cancelContentsAsync(unsigned int requestId) const;
+
     /**
      *  Gets resource file data
      *
@@ -482,6 +523,39 @@ public:
      */
     virtual const std::vector<std::string> getOriginalSearchPaths() const;
 
+    /**
+     *  Mounts a zip pack read-only at a directory, its files are found as if they were stored in that directory.
+     *
+     *  Lookups in mounted packs use the index of the pack and never touch the file system. A file in a pack
+     *  hides a file with the same full path on disk. If several mounts provide the same full path, the one
+     *  with the higher priority is used, for equal priorities the one mounted first.
+     *
+     *  @param packPath The zip file, a relative path is resolved with the search paths.
+     *  @param mountPoint The directory to mount at, a relative path is prefixed with the default resource root path.
+     *  @param priority Mounts with a higher priority are looked up first.
+     *  @return true if the pack was opened and mounted.
+     */
+    bool mountPack(const std::string& packPath, const std::string& mountPoint = "", int priority = 0);
+
+    /**
+     *  Mounts a manifest of all files in a directory, so existence checks below that directory are
+     *  answered from the manifest without touching the file system. The files are still read from disk.
+     *
+     *  @param manifestPath A text file containing one file path relative to the directory per line.
+     *  @param directory The directory described by the manifest, a relative path is prefixed with the default resource root path.
+     *  @param priority Mounts with a higher priority are looked up first.
+     *  @return true if the manifest was loaded and mounted.
+     */
+    bool mountManifest(const std::string& manifestPath, const std::string& directory = "", int priority = 0);
+
+    /**
+     *  Unmounts a pack or manifest.
+     *
+     *  @param path The path which was passed to mountPack or mountManifest.
+     *  @return true if it was mounted.
+     */
+    bool unmount(const std::string& path);
+
     /**
      *  Gets the writable path.
      *  @return  The path that can be write/read a file in
@@ -918,6 +992,35 @@ protected:
      */
     virtual std::string fullPathForDirectory(const std::string &dirname) const;
 
+    struct MountPoint;
+
+    /**
+     *  Finds the mount which provides a file, see mountPack and mountManifest.
+     *
+     *  @param fullPath The full path of the file.
+     *  @param[out] covered Set to true if a manifest describes the directory of the file,
+     *              so the file system doesn't need to be checked when no mount provides it.
+     *  @return The mount providing the file, nullptr if no mount does.
+     */
+    std::shared_ptr<MountPoint> findMountedFile(const std::string& fullPath, bool* covered) const;
+    bool isMountedDirectory(const std::string& fullPath, bool* covered) const;
+
+    /**
+     *  Reads a file from a mounted pack.
+     *
+     *  @return false if the file isn't in a mounted pack and has to be read from the file system.
+     */
+    bool getContentsFromPack(const std::string& fullPath, ResizableBuffer* buffer, Status* status) const;
+
+    /**
+     *  Checks whether getContents would read a full path as a plain file, so getContentsAsync may open it
+     *  itself instead of calling getContents. Returns false by default, as subclasses may override getContents,
+     *  for instance to decrypt resources.
+     */
+    virtual bool canReadFileDirectly(const std::string& fullPath) const;
+
+    bool addMount(std::shared_ptr<MountPoint> mount);
+
     /**
     * mutex used to protect fields. 
     */
@@ -971,6 +1074,16 @@ protected:
      */
     mutable std::unordered_map<std::string, std::string> _fullPathCacheDir;
 
+    /**
+     *  Mounted packs and manifests, ordered by priority.
+     */
+    std::vector<std::shared_ptr<MountPoint>> _mounts;
+
+    /**
+     *  Reads the files of getContentsAsync, created on the first request.
+     */
+    mutable std::unique_ptr<AsyncFileReader> _asyncFileReader;
+
     /**
      * Writable path.
      */
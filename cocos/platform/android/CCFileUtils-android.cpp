@@ -363,6 +363,10 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
     if (fullPath[0] == '/')
         return FileUtils::getContents(fullPath, buffer);
 
+    FileUtils::Status status;
+    if (getContentsFromPack(fullPath, buffer, &status))
+        return status;
+
     string relativePath = string();
     size_t position = fullPath.find(apkprefix);
     if (0 == position) {
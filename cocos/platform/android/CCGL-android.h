@@ -66,6 +66,13 @@ extern PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT;
 #define glBindVertexArrayOES glBindVertexArrayOESEXT
 #define glDeleteVertexArraysOES glDeleteVertexArraysOESEXT
 
+// instanced arrays are optional on OpenGL ES 2.0, the entry points are resolved at runtime
+extern PFNGLDRAWELEMENTSINSTANCEDEXTPROC glDrawElementsInstancedEXTEXT;
+extern PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisorEXTEXT;
+
+#define glDrawElementsInstancedEXT glDrawElementsInstancedEXTEXT
+#define glVertexAttribDivisorEXT glVertexAttribDivisorEXTEXT
+
 
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
 
@@ -41,6 +41,8 @@ THE SOFTWARE.
 PFNGLGENVERTEXARRAYSOESPROC glGenVertexArraysOESEXT = 0;
 PFNGLBINDVERTEXARRAYOESPROC glBindVertexArrayOESEXT = 0;
 PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT = 0;
+PFNGLDRAWELEMENTSINSTANCEDEXTPROC glDrawElementsInstancedEXTEXT = 0;
+PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisorEXTEXT = 0;
 
 #define DEFAULT_MARGIN_ANDROID				30.0f
 #define WIDE_SCREEN_ASPECT_RATIO_ANDROID	2.0f
@@ -49,6 +51,8 @@ void initExtensions() {
      glGenVertexArraysOESEXT = (PFNGLGENVERTEXARRAYSOESPROC)eglGetProcAddress("glGenVertexArraysOES");
      glBindVertexArrayOESEXT = (PFNGLBINDVERTEXARRAYOESPROC)eglGetProcAddress("glBindVertexArrayOES");
      glDeleteVertexArraysOESEXT = (PFNGLDELETEVERTEXARRAYSOESPROC)eglGetProcAddress("glDeleteVertexArraysOES");
+     glDrawElementsInstancedEXTEXT = (PFNGLDRAWELEMENTSINSTANCEDEXTPROC)eglGetProcAddress("glDrawElementsInstancedEXT");
+     glVertexAttribDivisorEXTEXT = (PFNGLVERTEXATTRIBDIVISOREXTPROC)eglGetProcAddress("glVertexAttribDivisorEXT");
 }
 
 NS_CC_BEGIN
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include <sys/stat.h>
 #include <stdio.h>
 #include <errno.h>
+#include <typeinfo>
 
 #ifndef CC_RESOURCE_FOLDER_LINUX
 #define CC_RESOURCE_FOLDER_LINUX ("/Resources/")
@@ -127,6 +128,12 @@ bool FileUtilsLinux::isFileExistInternal(const std::string& strFilePath) const
     return (stat(strPath.c_str(), &sts) == 0) && S_ISREG(sts.st_mode);
 }
 
+bool FileUtilsLinux::canReadFileDirectly(const std::string& fullPath) const
+{
+    // a subclass may override getContents
+    return typeid(*this) == typeid(FileUtilsLinux) && isAbsolutePath(fullPath);
+}
+
 NS_CC_END
 
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
@@ -54,6 +54,8 @@ public:
     /* override functions */
     bool init() override;
     virtual std::string getWritablePath() const override;
+protected:
+    virtual bool canReadFileDirectly(const std::string& fullPath) const override;
 private:
     virtual bool isFileExistInternal(const std::string& strFilePath) const override;
 };
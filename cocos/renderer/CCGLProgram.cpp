@@ -90,6 +90,7 @@ const char* GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP = "ShaderPositionColor_
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE = "ShaderPositionTexture";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR = "ShaderPositionTexture_uColor";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR = "ShaderPositionTextureA8Color";
+const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR_NO_MVP = "ShaderPositionTextureA8Color_noMVP";
 const char* GLProgram::SHADER_NAME_POSITION_U_COLOR = "ShaderPosition_uColor";
 const char* GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR = "ShaderPositionLengthTextureColor";
 const char* GLProgram::SHADER_NAME_POSITION_GRAYSCALE = "ShaderUIGrayScale";
@@ -110,6 +111,8 @@ const char* GLProgram::SHADER_3D_PARTICLE_COLOR = "Shader3DParticleColor";
 const char* GLProgram::SHADER_3D_PARTICLE_TEXTURE = "Shader3DParticleTexture";
 const char* GLProgram::SHADER_3D_SKYBOX = "Shader3DSkybox";
 const char* GLProgram::SHADER_3D_TERRAIN = "Shader3DTerrain";
+const char* GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED = "Shader3DPositionTextureInstanced";
+const char* GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED = "Shader3DPositionNormalTextureInstanced";
 const char* GLProgram::SHADER_CAMERA_CLEAR = "ShaderCameraClear";
 const char* GLProgram::SHADER_LAYER_RADIAL_GRADIENT = "ShaderLayerRadialGradient";
 
@@ -144,6 +147,8 @@ const char* GLProgram::ATTRIBUTE_NAME_BLEND_WEIGHT = "a_blendWeight";
 const char* GLProgram::ATTRIBUTE_NAME_BLEND_INDEX = "a_blendIndex";
 const char* GLProgram::ATTRIBUTE_NAME_TANGENT = "a_tangent";
 const char* GLProgram::ATTRIBUTE_NAME_BINORMAL = "a_binormal";
+const char* GLProgram::ATTRIBUTE_NAME_INSTANCE_MATRIX = "a_instanceMatrix";
+const char* GLProgram::ATTRIBUTE_NAME_INSTANCE_COLOR = "a_instanceColor";
 
 
 
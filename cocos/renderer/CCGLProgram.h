@@ -119,6 +119,11 @@ public:
 
         // backward compatibility
         VERTEX_ATTRIB_TEX_COORDS = VERTEX_ATTRIB_TEX_COORD,
+
+        /**Index 11 to 14 will be used as the per-instance model view matrix, only bound by the instanced 3D shaders.*/
+        VERTEX_ATTRIB_INSTANCE_MATRIX = VERTEX_ATTRIB_MAX,
+        /**Index 15 will be used as the per-instance color, only bound by the instanced 3D shaders.*/
+        VERTEX_ATTRIB_INSTANCE_COLOR = VERTEX_ATTRIB_INSTANCE_MATRIX + 4,
     };
 
     /**Preallocated uniform handle.*/
@@ -202,6 +207,8 @@ public:
     static const char* SHADER_NAME_POSITION_TEXTURE_U_COLOR;
     /**Built in shader for 2d. Support Position, Texture and Color vertex attribute. but alpha will be the multiplication of color attribute and texture.*/
     static const char* SHADER_NAME_POSITION_TEXTURE_A8_COLOR;
+    /**Built in shader for 2d. Same as SHADER_NAME_POSITION_TEXTURE_A8_COLOR, without multiply vertex by MVP matrix.*/
+    static const char* SHADER_NAME_POSITION_TEXTURE_A8_COLOR_NO_MVP;
     /**Built in shader for 2d. Support Position, with color specified by a uniform.*/
     static const char* SHADER_NAME_POSITION_U_COLOR;
     /**Built in shader for draw a sector with 90 degrees with center at bottom left point.*/
@@ -266,6 +273,16 @@ public:
      Built in shader for terrain
      */
     static const char* SHADER_3D_TERRAIN;
+
+    /**
+     Built in shader used for instanced 3D, support Position, Texture vertex attribute, with per-instance model view matrix and color.
+     */
+    static const char* SHADER_3D_POSITION_TEXTURE_INSTANCED;
+
+    /**
+     Built in shader used for instanced 3D, support Position, Normal, Texture vertex attribute, used in lighting. with per-instance model view matrix and color.
+     */
+    static const char* SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED;
     
     /**
      Built in shader for LayerRadialGradient
@@ -348,6 +365,10 @@ public:
     static const char* ATTRIBUTE_NAME_TANGENT;
     /**Attribute blend binormal.*/
     static const char* ATTRIBUTE_NAME_BINORMAL;
+    /**Attribute per-instance model view matrix.*/
+    static const char* ATTRIBUTE_NAME_INSTANCE_MATRIX;
+    /**Attribute per-instance color.*/
+    static const char* ATTRIBUTE_NAME_INSTANCE_COLOR;
     /**
     end of Built Attribute names
     @}
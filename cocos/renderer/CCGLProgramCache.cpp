@@ -50,6 +50,7 @@ enum {
     kShaderType_PositionTexture,
     kShaderType_PositionTexture_uColor,
     kShaderType_PositionTextureA8Color,
+    kShaderType_PositionTextureA8Color_noMVP,
     kShaderType_Position_uColor,
     kShaderType_PositionLengthTextureColor,
     kShaderType_LabelDistanceFieldNormal,
@@ -69,6 +70,8 @@ enum {
     kShaderType_3DParticleColor,
     kShaderType_3DSkyBox,
     kShaderType_3DTerrain,
+    kShaderType_3DPositionTexInstanced,
+    kShaderType_3DPositionNormalTexInstanced,
     kShaderType_CameraClear,
     // ETC1 ALPHA supports.
     kShaderType_ETC1ASPositionTextureColor,
@@ -205,6 +208,13 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
     _programs.emplace(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR, p);
 
+    //
+    // Position Texture A8 Color shader without MVP
+    //
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color_noMVP);
+    _programs.emplace(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR_NO_MVP, p);
+
     //
     // Position and 1 color passed as a uniform (to simulate glColor4ub )
     //
@@ -286,6 +296,14 @@ void GLProgramCache::loadDefaultGLPrograms()
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_3DTerrain);
     _programs.emplace(GLProgram::SHADER_3D_TERRAIN, p);
+
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_3DPositionTexInstanced);
+    _programs.emplace(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED, p);
+
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_3DPositionNormalTexInstanced);
+    _programs.emplace(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED, p);
     
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_CameraClear);
@@ -376,6 +394,13 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
 
+    //
+    // Position Texture A8 Color shader without MVP
+    //
+    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color_noMVP);
+
     //
     // Position and 1 color passed as a uniform (to simulate glColor4ub )
     //
@@ -457,6 +482,14 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p = getGLProgram(GLProgram::SHADER_3D_TERRAIN);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DTerrain);
+
+    p = getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_3DPositionTexInstanced);
+
+    p = getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_3DPositionNormalTexInstanced);
     
     p = getGLProgram(GLProgram::SHADER_CAMERA_CLEAR);
     p->reset();
@@ -506,6 +539,10 @@ void GLProgramCache::reloadDefaultGLProgramsRelativeToLights()
     p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_BUMPEDNORMAL_TEXTURE);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DSkinPositionBumpedNormalTex);
+
+    p = getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_3DPositionNormalTexInstanced);
 }
 
 void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
@@ -541,6 +578,9 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_PositionTextureA8Color:
             p->initWithByteArrays(ccPositionTextureA8Color_vert, ccPositionTextureA8Color_frag);
             break;
+        case kShaderType_PositionTextureA8Color_noMVP:
+            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureA8Color_frag);
+            break;
         case kShaderType_Position_uColor:
             p->initWithByteArrays(ccPosition_uColor_vert, ccPosition_uColor_frag);
             p->bindAttribLocation("aVertex", GLProgram::VERTEX_ATTRIB_POSITION);
@@ -619,6 +659,23 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_3DTerrain:
             p->initWithByteArrays(cc3D_Terrain_vert, cc3D_Terrain_frag);
             break;
+        case kShaderType_3DPositionTexInstanced:
+            {
+                std::string instancingDef = "\n#define CC_INSTANCING 1 \n";
+                p->initWithByteArrays((instancingDef + std::string(cc3D_PositionTex_vert)).c_str(), (instancingDef + std::string(cc3D_ColorTex_frag)).c_str());
+                p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_INSTANCE_MATRIX, GLProgram::VERTEX_ATTRIB_INSTANCE_MATRIX);
+                p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_INSTANCE_COLOR, GLProgram::VERTEX_ATTRIB_INSTANCE_COLOR);
+            }
+            break;
+        case kShaderType_3DPositionNormalTexInstanced:
+            {
+                std::string def = getShaderMacrosForLight();
+                std::string instancingDef = "\n#define CC_INSTANCING 1 \n";
+                p->initWithByteArrays((def + instancingDef + std::string(cc3D_PositionNormalTex_vert)).c_str(), (def + instancingDef + std::string(cc3D_ColorNormalTex_frag)).c_str());
+                p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_INSTANCE_MATRIX, GLProgram::VERTEX_ATTRIB_INSTANCE_MATRIX);
+                p->bindAttribLocation(GLProgram::ATTRIBUTE_NAME_INSTANCE_COLOR, GLProgram::VERTEX_ATTRIB_INSTANCE_COLOR);
+            }
+            break;
         case kShaderType_CameraClear:
             p->initWithByteArrays(ccCameraClearVert, ccCameraClearFrag);
             break;
@@ -40,6 +40,7 @@
 #include "renderer/CCTechnique.h"
 #include "renderer/CCMaterial.h"
 #include "renderer/CCPass.h"
+#include "renderer/CCVertexAttribBinding.h"
 #include "xxhash.h"
 
 NS_CC_BEGIN
@@ -55,6 +56,9 @@ MeshCommand::MeshCommand()
 , _glProgramState(nullptr)
 , _stateBlock(nullptr)
 , _textureID(0)
+, _instancingMaterial(nullptr)
+, _instancingID(0)
+, _instanceColor(1.0f, 1.0f, 1.0f, 1.0f)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 , _rendererRecreatedListener(nullptr)
 #endif
@@ -189,6 +193,25 @@ uint32_t MeshCommand::getMaterialID() const
     return _materialID;
 }
 
+void MeshCommand::setInstancing(Material* instancingMaterial, uint32_t instancingID, const Vec4& instanceColor)
+{
+    _instancingMaterial = instancingMaterial;
+    _instancingID = instancingID;
+    _instanceColor = instanceColor;
+}
+
+void MeshCommand::genInstancingID(GLuint glProgram, GLuint texID, GLuint vertexBuffer, GLuint indexBuffer, unsigned int lightMask)
+{
+    unsigned int intArray[6] = {0};
+    intArray[0] = glProgram;
+    intArray[1] = texID;
+    intArray[2] = vertexBuffer;
+    intArray[3] = indexBuffer;
+    intArray[4] = lightMask;
+    intArray[5] = (unsigned int)_primitive;
+    _instancingID = XXH32((const void*)intArray, sizeof(intArray), 0);
+}
+
 void MeshCommand::preBatchDraw()
 {
     // Do nothing if using material since each pass needs to bind its own VAO
@@ -296,6 +319,51 @@ void MeshCommand::execute()
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+void MeshCommand::drawInstanced(GLuint instanceBuffer, ssize_t instanceCount)
+{
+    CCASSERT(_instancingMaterial, "drawInstanced() needs an instancing material");
+
+    // without VAO the attribs are enabled through the state cache, otherwise they are part of the VAO state
+    bool useVAO = Configuration::getInstance()->supportsShareableVAO();
+    const uint32_t instanceAttribsFlags = (0x0F << GLProgram::VERTEX_ATTRIB_INSTANCE_MATRIX) | (1 << GLProgram::VERTEX_ATTRIB_INSTANCE_COLOR);
+
+    for(const auto& pass: _instancingMaterial->_currentTechnique->_passes)
+    {
+        pass->bind(_mv);
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        if (!useVAO)
+            GL::enableVertexAttribs(pass->getVertexAttributeBinding()->getVertexAttribsFlags() | instanceAttribsFlags);
+
+        for (GLuint i = 0; i < 4; ++i)
+        {
+            GLuint index = GLProgram::VERTEX_ATTRIB_INSTANCE_MATRIX + i;
+            if (useVAO)
+                glEnableVertexAttribArray(index);
+            glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, sizeof(MeshInstanceData), (GLvoid*)(offsetof(MeshInstanceData, modelView) + sizeof(Vec4) * i));
+            GL::vertexAttribDivisor(index, 1);
+        }
+        if (useVAO)
+            glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_INSTANCE_COLOR);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_INSTANCE_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(MeshInstanceData), (GLvoid*)offsetof(MeshInstanceData, color));
+        GL::vertexAttribDivisor(GLProgram::VERTEX_ATTRIB_INSTANCE_COLOR, 1);
+
+        GL::drawElementsInstanced(_primitive, (GLsizei)_indexCount, _indexFormat, 0, (GLsizei)instanceCount);
+        CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount * instanceCount);
+
+        // divisors are not restored by the state cache, reset them so that regular draws are not affected
+        for (GLuint index = GLProgram::VERTEX_ATTRIB_INSTANCE_MATRIX; index <= GLProgram::VERTEX_ATTRIB_INSTANCE_COLOR; ++index)
+        {
+            GL::vertexAttribDivisor(index, 0);
+            if (useVAO)
+                glDisableVertexAttribArray(index);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        pass->unbind();
+    }
+}
+
 void MeshCommand::buildVAO()
 {
     // FIXME: Assumes that all the passes in the Material share the same Vertex Attribs
@@ -39,6 +39,13 @@ class EventListenerCustom;
 class EventCustom;
 class Material;
 
+/** Per-instance data of an instanced MeshCommand, laid out as it is uploaded to the instance buffer. */
+struct CC_DLL MeshInstanceData
+{
+    Mat4 modelView;
+    Vec4 color;
+};
+
 //it is a common mesh
 class CC_DLL MeshCommand : public RenderCommand
 {
@@ -66,6 +73,23 @@ public:
     void genMaterialID(GLuint texID, void* glProgramState, GLuint vertexBuffer, GLuint indexBuffer, BlendFunc blend);
     
     uint32_t getMaterialID() const;
+
+    /**
+     * Marks the command as one instance of an instanced draw.
+     * Commands sharing the same instancing ID are merged by the renderer into a single instanced draw call
+     * that uses the instancing material of the first command, with per-instance transform and color.
+     * Pass nullptr as material to draw the command on its own.
+     */
+    void setInstancing(Material* instancingMaterial, uint32_t instancingID, const Vec4& instanceColor);
+    bool isInstanced() const { return _instancingMaterial != nullptr; }
+    uint32_t getInstancingID() const { return _instancingID; }
+    const Vec4& getInstanceColor() const { return _instanceColor; }
+    const Mat4& getModelView() const { return _mv; }
+
+    void genInstancingID(GLuint glProgram, GLuint texID, GLuint vertexBuffer, GLuint indexBuffer, unsigned int lightMask);
+
+    // draws instanceCount instances, whose MeshInstanceData is stored in instanceBuffer
+    void drawInstanced(GLuint instanceBuffer, ssize_t instanceCount);
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     void listenRendererRecreated(EventCustom* event);
@@ -112,6 +136,12 @@ protected:
     RenderState::StateBlock* _stateBlock;
     GLuint _textureID;
 
+    // Instancing
+    // weak ref
+    Material* _instancingMaterial;
+    uint32_t _instancingID;
+    Vec4 _instanceColor;
+
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _rendererRecreatedListener;
@@ -198,7 +198,10 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 // constructors, destructor, init
 //
 Renderer::Renderer()
-:_lastBatchedMeshCommand(nullptr)
+:_queueStamp(0)
+,_lastBatchedMeshCommand(nullptr)
+,_queuedInstancedMeshGroupCount(0)
+,_buffersInstanceVBO(0)
 ,_triBatchesToDrawCapacity(-1)
 ,_triBatchesToDraw(nullptr)
 ,_filledVertex(0)
@@ -232,6 +235,8 @@ Renderer::~Renderer()
     _groupCommandManager->release();
     
     glDeleteBuffers(2, _buffersVBO);
+    if (_buffersInstanceVBO)
+        glDeleteBuffers(1, &_buffersInstanceVBO);
 
     free(_triBatchesToDraw);
 
@@ -263,6 +268,9 @@ void Renderer::initGLView()
 
 void Renderer::setupBuffer()
 {
+    // created on demand by the first instanced draw
+    _buffersInstanceVBO = 0;
+
     if(Configuration::getInstance()->supportsShareableVAO())
     {
         setupVBOAndVAO();
@@ -359,18 +367,21 @@ void Renderer::addCommand(RenderCommand* command, int renderQueueID)
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
     _renderGroups[renderQueueID].push_back(command);
+    ++_queueStamp;
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
     _commandGroupStack.push(renderQueueID);
+    ++_queueStamp;
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
     _commandGroupStack.pop();
+    ++_queueStamp;
 }
 
 int Renderer::createRenderQueue()
@@ -408,7 +419,11 @@ void Renderer::processRenderCommand(RenderCommand* command)
         flush2D();
         auto cmd = static_cast<MeshCommand*>(command);
         
-        if (cmd->isSkipBatching() || _lastBatchedMeshCommand == nullptr || _lastBatchedMeshCommand->getMaterialID() != cmd->getMaterialID())
+        if (cmd->isInstanced() && !cmd->isSkipBatching())
+        {
+            queueInstancedMesh(cmd);
+        }
+        else if (cmd->isSkipBatching() || _lastBatchedMeshCommand == nullptr || _lastBatchedMeshCommand->getMaterialID() != cmd->getMaterialID())
         {
             flush3D();
 
@@ -653,6 +668,8 @@ void Renderer::render()
 
 void Renderer::clean()
 {
+    ++_queueStamp;
+
     // Clear render group
     for (size_t j = 0, size = _renderGroups.size() ; j < size; j++)
     {
@@ -669,6 +686,9 @@ void Renderer::clean()
     _filledVertex = 0;
     _filledIndex = 0;
     _lastBatchedMeshCommand = nullptr;
+    for (auto& group : _queuedInstancedMeshGroups)
+        group.clear();
+    _queuedInstancedMeshGroupCount = 0;
 }
 
 void Renderer::clear()
@@ -888,6 +908,56 @@ void Renderer::flush3D()
         _lastBatchedMeshCommand->postBatchDraw();
         _lastBatchedMeshCommand = nullptr;
     }
+
+    flushInstancedMeshes();
+}
+
+void Renderer::queueInstancedMesh(MeshCommand* command)
+{
+    // opaque meshes are depth tested, so instances of different groups can be drawn out of order
+    for (size_t i = 0; i < _queuedInstancedMeshGroupCount; ++i)
+    {
+        auto& group = _queuedInstancedMeshGroups[i];
+        if (group.front()->getInstancingID() == command->getInstancingID())
+        {
+            group.push_back(command);
+            return;
+        }
+    }
+
+    if (_queuedInstancedMeshGroupCount == _queuedInstancedMeshGroups.size())
+        _queuedInstancedMeshGroups.emplace_back();
+    _queuedInstancedMeshGroups[_queuedInstancedMeshGroupCount++].push_back(command);
+}
+
+void Renderer::flushInstancedMeshes()
+{
+    if (_queuedInstancedMeshGroupCount == 0)
+        return;
+
+    if (_buffersInstanceVBO == 0)
+        glGenBuffers(1, &_buffersInstanceVBO);
+
+    for (size_t i = 0; i < _queuedInstancedMeshGroupCount; ++i)
+    {
+        auto& group = _queuedInstancedMeshGroups[i];
+        CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_INSTANCED_MESH_COMMAND");
+
+        _instanceData.resize(group.size());
+        for (size_t j = 0, size = group.size(); j < size; ++j)
+        {
+            _instanceData[j].modelView = group[j]->getModelView();
+            _instanceData[j].color = group[j]->getInstanceColor();
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, _buffersInstanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_instanceData[0]) * _instanceData.size(), _instanceData.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        group.front()->drawInstanced(_buffersInstanceVBO, group.size());
+        group.clear();
+    }
+    _queuedInstancedMeshGroupCount = 0;
 }
 
 void Renderer::flushTriangles()
@@ -33,6 +33,7 @@
 #include "platform/CCPlatformMacros.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgram.h"
+#include "renderer/CCMeshCommand.h"
 #include "platform/CCGL.h"
 
 #if !defined(NDEBUG) && CC_TARGET_PLATFORM == CC_PLATFORM_IOS
@@ -195,6 +196,9 @@ public:
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
     /* clear draw stats */
     void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    /* returns a counter that changes whenever a command is added, a group is pushed or popped or the queues are cleaned.
+     * Lets code that keeps appending triangles to its last command check that nothing was queued after it. */
+    unsigned int getQueueStamp() const { return _queueStamp; }
 
     /**
      * Enable/Disable depth test
@@ -227,6 +231,9 @@ protected:
 
     void flushTriangles();
 
+    void flushInstancedMeshes();
+    void queueInstancedMesh(MeshCommand* command);
+
     void processRenderCommand(RenderCommand* command);
     void visitRenderQueue(RenderQueue& queue);
 
@@ -240,9 +247,17 @@ protected:
     
     std::vector<RenderQueue> _renderGroups;
 
+    unsigned int _queueStamp;
+
     MeshCommand* _lastBatchedMeshCommand;
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
+    //for instanced MeshCommand, queued by instancing ID until the next flush
+    std::vector<std::vector<MeshCommand*>> _queuedInstancedMeshGroups;
+    size_t _queuedInstancedMeshGroupCount;
+    std::vector<MeshInstanceData> _instanceData;
+    GLuint _buffersInstanceVBO;
+
     //for TrianglesCommand
     V3F_C4B_T2F _verts[VBO_SIZE];
     GLushort _indices[INDEX_VBO_SIZE];
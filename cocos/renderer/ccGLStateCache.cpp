@@ -268,6 +268,24 @@ void enableVertexAttribs(uint32_t flags)
     s_attributeFlags = flags;
 }
 
+void vertexAttribDivisor(GLuint index, GLuint divisor)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+    glVertexAttribDivisorEXT(index, divisor);
+#else
+    glVertexAttribDivisorARB(index, divisor);
+#endif
+}
+
+void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei primcount)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+    glDrawElementsInstancedEXT(mode, count, type, indices, primcount);
+#else
+    glDrawElementsInstancedARB(mode, count, type, indices, primcount);
+#endif
+}
+
 // GL Uniforms functions
 
 void setProjectionMatrixDirty()
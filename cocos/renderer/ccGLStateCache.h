@@ -119,6 +119,21 @@ void CC_DLL setProjectionMatrixDirty();
  */
 void CC_DLL enableVertexAttribs(uint32_t flags);
 
+/**
+ * Sets the rate at which a generic vertex attribute advances during instanced rendering.
+ * A divisor of 0 restores the regular per-vertex behaviour.
+ *
+ * It must only be called when Configuration::supportsInstancing() returns true.
+ */
+void CC_DLL vertexAttribDivisor(GLuint index, GLuint divisor);
+
+/**
+ * Draws `primcount` instances of the indexed geometry that is currently bound.
+ *
+ * It must only be called when Configuration::supportsInstancing() returns true.
+ */
+void CC_DLL drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei primcount);
+
 /** 
  * If the texture is not already bound to texture unit 0, it binds it.
  *
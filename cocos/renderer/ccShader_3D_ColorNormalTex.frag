@@ -69,7 +69,12 @@ varying vec3 v_normal;
 
 #endif
 
+#ifdef CC_INSTANCING
+varying vec4 v_instanceColor;
+#define u_color v_instanceColor
+#else
 uniform vec4 u_color;
+#endif
 #ifdef USE_NORMAL_MAPPING
 uniform sampler2D u_normalTex;
 #endif
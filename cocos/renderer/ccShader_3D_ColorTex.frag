@@ -6,7 +6,12 @@ varying mediump vec2 TextureCoordOut;
 #else
 varying vec2 TextureCoordOut;
 #endif
+#ifdef CC_INSTANCING
+varying vec4 v_instanceColor;
+#define u_color v_instanceColor
+#else
 uniform vec4 u_color;
+#endif
 
 void main(void)
 {
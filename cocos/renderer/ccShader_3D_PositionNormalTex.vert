@@ -23,6 +23,11 @@ attribute vec3 a_normal;
 attribute vec3 a_tangent;
 attribute vec3 a_binormal;
 #endif
+#ifdef CC_INSTANCING
+attribute mat4 a_instanceMatrix;
+attribute vec4 a_instanceColor;
+varying vec4 v_instanceColor;
+#endif
 varying vec2 TextureCoordOut;
 
 #ifdef USE_NORMAL_MAPPING
@@ -48,12 +53,25 @@ varying vec3 v_normal;
 
 void main(void)
 {
-    vec4 ePosition = CC_MVMatrix * a_position;
+#ifdef CC_INSTANCING
+    mat4 modelViewMatrix = a_instanceMatrix;
+    // inverse-transpose of the upper 3x3 like CC_NormalMatrix, built from the cofactors since GLSL ES has no inverse()
+    vec3 c0 = modelViewMatrix[0].xyz;
+    vec3 c1 = modelViewMatrix[1].xyz;
+    vec3 c2 = modelViewMatrix[2].xyz;
+    vec3 r0 = cross(c1, c2);
+    mat3 normalMatrix = mat3(r0, cross(c2, c0), cross(c0, c1)) / dot(c0, r0);
+    v_instanceColor = a_instanceColor;
+#else
+    mat4 modelViewMatrix = CC_MVMatrix;
+    mat3 normalMatrix = CC_NormalMatrix;
+#endif
+    vec4 ePosition = modelViewMatrix * a_position;
 #ifdef USE_NORMAL_MAPPING
     #if ((MAX_DIRECTIONAL_LIGHT_NUM > 0) || (MAX_POINT_LIGHT_NUM > 0) || (MAX_SPOT_LIGHT_NUM > 0))
-        vec3 eTangent = normalize(CC_NormalMatrix * a_tangent);
-        vec3 eBinormal = normalize(CC_NormalMatrix * a_binormal);
-        vec3 eNormal = normalize(CC_NormalMatrix * a_normal);
+        vec3 eTangent = normalize(normalMatrix * a_tangent);
+        vec3 eBinormal = normalize(normalMatrix * a_binormal);
+        vec3 eNormal = normalize(normalMatrix * a_normal);
     #endif
     #if (MAX_DIRECTIONAL_LIGHT_NUM > 0)
         for (int i = 0; i < MAX_DIRECTIONAL_LIGHT_NUM; ++i)
@@ -103,7 +121,7 @@ void main(void)
     #endif
 
     #if ((MAX_DIRECTIONAL_LIGHT_NUM > 0) || (MAX_POINT_LIGHT_NUM > 0) || (MAX_SPOT_LIGHT_NUM > 0))
-        v_normal = CC_NormalMatrix * a_normal;
+        v_normal = normalMatrix * a_normal;
     #endif
 #endif
 
@@ -3,12 +3,22 @@ const char* cc3D_PositionTex_vert = R"(
 
 attribute vec4 a_position;
 attribute vec2 a_texCoord;
+#ifdef CC_INSTANCING
+attribute mat4 a_instanceMatrix;
+attribute vec4 a_instanceColor;
+varying vec4 v_instanceColor;
+#endif
 
 varying vec2 TextureCoordOut;
 
 void main(void)
 {
+#ifdef CC_INSTANCING
+    gl_Position = CC_PMatrix * a_instanceMatrix * a_position;
+    v_instanceColor = a_instanceColor;
+#else
     gl_Position = CC_MVPMatrix * a_position;
+#endif
     TextureCoordOut = a_texCoord;
     TextureCoordOut.y = 1.0 - TextureCoordOut.y;
 }
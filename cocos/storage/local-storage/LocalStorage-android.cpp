@@ -131,4 +131,25 @@ void localStorageClear()
     JniHelper::callStaticVoidMethod(className, "clear");
 }
 
+/** the Java side commits each call on its own */
+void localStorageSetItems( const std::vector<std::pair<std::string, std::string>>& items )
+{
+    for (const auto& item : items)
+        localStorageSetItem(item.first, item.second);
+}
+
+void localStorageRemoveItems( const std::vector<std::string>& keys )
+{
+    for (const auto& key : keys)
+        localStorageRemoveItem(key);
+}
+
+void localStorageSetWriteBehind( bool /*enabled*/ )
+{
+}
+
+void localStorageFlush()
+{
+}
+
 #endif // #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
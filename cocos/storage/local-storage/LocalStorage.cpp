@@ -37,6 +37,16 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <sqlite3.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// queued writes are committed this long after the first one, so that bursts end up in one transaction
+#define WRITE_BEHIND_DELAY_MS 200
+// the read cache is dropped when it grows past this many keys
+#define READ_CACHE_LIMIT 4096
 
 static int _initialized = 0;
 static sqlite3 *_db;
@@ -44,6 +54,27 @@ static sqlite3_stmt *_stmt_select;
 static sqlite3_stmt *_stmt_remove;
 static sqlite3_stmt *_stmt_update;
 static sqlite3_stmt *_stmt_clear;
+static sqlite3_stmt *_stmt_begin;
+static sqlite3_stmt *_stmt_commit;
+
+// a cached or queued item, removed items are kept so that they hide the value still in the DB
+struct Item
+{
+    bool removed;
+    std::string value;
+};
+
+static std::mutex _dbMutex;     // _db and the statements
+static std::mutex _commitMutex; // keeps the queued writes reaching the DB in order
+static std::mutex _dataMutex;   // everything below
+static std::unordered_map<std::string, Item> _cache;
+static std::unordered_map<std::string, Item> _pending;
+static std::unordered_map<std::string, Item> _committing; // taken from _pending by the commit in progress
+static unsigned int _generation = 0; // bumped by every write, a read only fills the cache if nothing was written meanwhile
+static bool _writeBehind = false;
+static bool _quit = false;
+static std::condition_variable _pendingCondition;
+static std::thread _writer;
 
 
 static void localStorageCreateTable()
@@ -58,6 +89,135 @@ static void localStorageCreateTable()
         printf("Error in CREATE TABLE\n");
 }
 
+static void localStorageExec(sqlite3_stmt *stmt)
+{
+    int ok = sqlite3_step(stmt);
+    ok |= sqlite3_reset(stmt);
+
+    if (ok != SQLITE_OK && ok != SQLITE_DONE)
+        printf("Error in localStorage: %s\n", sqlite3_errmsg(_db));
+}
+
+// must be called with _dbMutex locked
+static void localStorageWriteItem(const std::string& key, const Item& item)
+{
+    sqlite3_stmt *stmt = item.removed ? _stmt_remove : _stmt_update;
+    int ok = sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    if (!item.removed)
+        ok |= sqlite3_bind_text(stmt, 2, item.value.c_str(), -1, SQLITE_TRANSIENT);
+
+    ok |= sqlite3_step(stmt);
+
+    ok |= sqlite3_reset(stmt);
+
+    if (ok != SQLITE_OK && ok != SQLITE_DONE)
+        printf(item.removed ? "Error in localStorage.removeItem()\n" : "Error in localStorage.setItem()\n");
+}
+
+// write the items, in one transaction when there are several of them
+template <typename Items>
+static void localStorageWriteItems(const Items& items)
+{
+    std::lock_guard<std::mutex> lock(_dbMutex);
+    if (items.size() > 1)
+        localStorageExec(_stmt_begin);
+    for (const auto& item : items)
+        localStorageWriteItem(item.first, item.second);
+    if (items.size() > 1)
+        localStorageExec(_stmt_commit);
+}
+
+static void localStorageCommitPending(bool stopWriteBehind = false)
+{
+    std::lock_guard<std::mutex> commitLock(_commitMutex);
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        if (stopWriteBehind)
+            _writeBehind = false;
+        _committing.swap(_pending);
+    }
+    if (_committing.empty())
+        return;
+
+    // reads keep finding the items in _committing until they are in the DB
+    localStorageWriteItems(_committing);
+
+    std::lock_guard<std::mutex> lock(_dataMutex);
+    _committing.clear();
+}
+
+static void localStorageWriterLoop()
+{
+    std::unique_lock<std::mutex> lock(_dataMutex);
+    while (!_quit)
+    {
+        _pendingCondition.wait(lock, []() { return _quit || !_pending.empty(); });
+        if (_quit)
+            break;
+
+        _pendingCondition.wait_for(lock, std::chrono::milliseconds(WRITE_BEHIND_DELAY_MS), []() { return _quit; });
+
+        lock.unlock();
+        localStorageCommitPending();
+        lock.lock();
+    }
+}
+
+static void localStorageStopWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        _quit = true;
+    }
+    _pendingCondition.notify_one();
+    if (_writer.joinable())
+        _writer.join();
+    _quit = false;
+
+    // writes issued after this go straight to the DB, behind the queued ones
+    localStorageCommitPending(true);
+}
+
+// must be called with _dataMutex locked
+static void localStorageCacheItem(const std::string& key, const Item& item)
+{
+    if (_cache.size() >= READ_CACHE_LIMIT && _cache.find(key) == _cache.end())
+        _cache.clear();
+    _cache[key] = item;
+}
+
+// update the cache and queue the items or write them now
+template <typename Items>
+static void localStorageStoreItems(const Items& items)
+{
+    assert( _initialized );
+
+    bool queued;
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        ++_generation;
+        for (const auto& item : items)
+            localStorageCacheItem(item.first, item.second);
+
+        queued = _writeBehind;
+        if (queued)
+        {
+            for (const auto& item : items)
+                _pending[item.first] = item.second;
+        }
+    }
+
+    if (queued)
+    {
+        _pendingCondition.notify_one();
+    }
+    else
+    {
+        std::lock_guard<std::mutex> commitLock(_commitMutex);
+        localStorageWriteItems(items);
+    }
+}
+
 void localStorageInit( const std::string& fullpath/* = "" */)
 {
     if (!_initialized) {
@@ -67,8 +227,14 @@ void localStorageInit( const std::string& fullpath/* = "" */)
         if (fullpath.empty())
             ret = sqlite3_open(":memory:", &_db);
         else
+        {
             ret = sqlite3_open(fullpath.c_str(), &_db);
 
+            // readers don't block the writer and a commit appends to the log instead of syncing the whole DB
+            sqlite3_exec(_db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+            sqlite3_exec(_db, "PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+        }
+
         localStorageCreateTable();
 
         // SELECT
@@ -87,6 +253,10 @@ void localStorageInit( const std::string& fullpath/* = "" */)
         const char *sql_clear = "DELETE FROM data;";
         ret |= sqlite3_prepare_v2(_db, sql_clear, -1, &_stmt_clear, nullptr);
 
+        // Transactions
+        ret |= sqlite3_prepare_v2(_db, "BEGIN;", -1, &_stmt_begin, nullptr);
+        ret |= sqlite3_prepare_v2(_db, "COMMIT;", -1, &_stmt_commit, nullptr);
+
         if (ret != SQLITE_OK) {
             printf("Error initializing DB\n");
             // report error
@@ -99,9 +269,20 @@ void localStorageInit( const std::string& fullpath/* = "" */)
 void localStorageFree()
 {
     if (_initialized) {
+        localStorageStopWriter();
+
+        {
+            std::lock_guard<std::mutex> lock(_dataMutex);
+            _cache.clear();
+            ++_generation;
+        }
+
         sqlite3_finalize(_stmt_select);
         sqlite3_finalize(_stmt_remove);
         sqlite3_finalize(_stmt_update);
+        sqlite3_finalize(_stmt_clear);
+        sqlite3_finalize(_stmt_begin);
+        sqlite3_finalize(_stmt_commit);
 
         sqlite3_close(_db);
 		
@@ -112,17 +293,17 @@ void localStorageFree()
 /** sets an item in the LS */
 void localStorageSetItem( const std::string& key, const std::string& value)
 {
-    assert( _initialized );
-	
-    int ok = sqlite3_bind_text(_stmt_update, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-    ok |= sqlite3_bind_text(_stmt_update, 2, value.c_str(), -1, SQLITE_TRANSIENT);
+    std::pair<std::string, Item> item(key, Item{ false, value });
+    localStorageStoreItems(std::vector<std::pair<std::string, Item>>{ item });
+}
 
-    ok |= sqlite3_step(_stmt_update);
-	
-    ok |= sqlite3_reset(_stmt_update);
-	
-    if (ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.setItem()\n");
+void localStorageSetItems( const std::vector<std::pair<std::string, std::string>>& items )
+{
+    std::vector<std::pair<std::string, Item>> storeItems;
+    storeItems.reserve(items.size());
+    for (const auto& item : items)
+        storeItems.emplace_back(item.first, Item{ false, item.second });
+    localStorageStoreItems(storeItems);
 }
 
 /** gets an item from the LS */
@@ -130,52 +311,131 @@ bool localStorageGetItem( const std::string& key, std::string *outItem )
 {
     assert( _initialized );
 
-    int ok = sqlite3_reset(_stmt_select);
-
-    ok |= sqlite3_bind_text(_stmt_select, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-    ok |= sqlite3_step(_stmt_select);
-    const unsigned char *text = sqlite3_column_text(_stmt_select, 0);
-
-    if (ok != SQLITE_OK && ok != SQLITE_DONE && ok != SQLITE_ROW)
+    unsigned int generation;
     {
-        printf("Error in localStorage.getItem()\n");
-        return false;
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        const Item* found = nullptr;
+        auto pendingIter = _pending.find(key);
+        auto committingIter = _committing.find(key);
+        if (pendingIter != _pending.end())
+        {
+            found = &pendingIter->second;
+        }
+        else if (committingIter != _committing.end())
+        {
+            found = &committingIter->second;
+        }
+        else
+        {
+            auto cacheIter = _cache.find(key);
+            if (cacheIter != _cache.end())
+                found = &cacheIter->second;
+        }
+
+        if (found)
+        {
+            if (found->removed)
+                return false;
+            outItem->assign(found->value);
+            return true;
+        }
+        generation = _generation;
     }
-    else if (!text)
+
+    Item item{ true, "" };
     {
-        return false;
+        std::lock_guard<std::mutex> lock(_dbMutex);
+
+        int ok = sqlite3_reset(_stmt_select);
+
+        ok |= sqlite3_bind_text(_stmt_select, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        ok |= sqlite3_step(_stmt_select);
+        const unsigned char *text = sqlite3_column_text(_stmt_select, 0);
+
+        if (ok != SQLITE_OK && ok != SQLITE_DONE && ok != SQLITE_ROW)
+        {
+            printf("Error in localStorage.getItem()\n");
+            return false;
+        }
+        else if (text)
+        {
+            item.removed = false;
+            item.value.assign((const char*)text);
+        }
     }
-    else
+
     {
-        outItem->assign((const char*)text);
-        return true;
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        if (generation == _generation)
+            localStorageCacheItem(key, item);
     }
+
+    if (item.removed)
+        return false;
+    outItem->swap(item.value);
+    return true;
 }
 
 /** removes an item from the LS */
 void localStorageRemoveItem( const std::string& key )
 {
-    assert( _initialized );
-
-    int ok = sqlite3_bind_text(_stmt_remove, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-	
-    ok |= sqlite3_step(_stmt_remove);
-	
-    ok |= sqlite3_reset(_stmt_remove);
+    std::pair<std::string, Item> item(key, Item{ true, "" });
+    localStorageStoreItems(std::vector<std::pair<std::string, Item>>{ item });
+}
 
-    if (ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.removeItem()\n");
+void localStorageRemoveItems( const std::vector<std::string>& keys )
+{
+    std::vector<std::pair<std::string, Item>> storeItems;
+    storeItems.reserve(keys.size());
+    for (const auto& key : keys)
+        storeItems.emplace_back(key, Item{ true, "" });
+    localStorageStoreItems(storeItems);
 }
 
 /** removes all items from the LS */
 void localStorageClear()
 {
     assert( _initialized );
-    
+
+    // wait for a commit in progress, otherwise its items would be written after the DELETE
+    std::lock_guard<std::mutex> commitLock(_commitMutex);
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        _pending.clear();
+        _cache.clear();
+        ++_generation;
+    }
+
+    std::lock_guard<std::mutex> lock(_dbMutex);
     int ok = sqlite3_step(_stmt_clear);
+    ok |= sqlite3_reset(_stmt_clear);
     
     if( ok != SQLITE_OK && ok != SQLITE_DONE)
         printf("Error in localStorage.clear()\n");
 }
 
+void localStorageSetWriteBehind( bool enabled )
+{
+    assert( _initialized );
+
+    if (enabled)
+    {
+        std::lock_guard<std::mutex> lock(_dataMutex);
+        _writeBehind = true;
+        if (!_writer.joinable())
+            _writer = std::thread(localStorageWriterLoop);
+    }
+    else
+    {
+        localStorageStopWriter();
+    }
+}
+
+void localStorageFlush()
+{
+    assert( _initialized );
+
+    localStorageCommitPending();
+}
+
 #endif // #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
@@ -28,6 +28,8 @@ THE SOFTWARE.
 #define __JSB_LOCALSTORAGE_H
 
 #include <string>
+#include <utility>
+#include <vector>
 #include "platform/CCPlatformMacros.h"
 
 /**
@@ -55,6 +57,20 @@ void CC_DLL localStorageRemoveItem( const std::string& key );
 /** Removes all items from the JS. */
 void CC_DLL localStorageClear();
 
+/** Sets many items in the JS, in a single transaction. */
+void CC_DLL localStorageSetItems( const std::vector<std::pair<std::string, std::string>>& items );
+
+/** Removes many items from the JS, in a single transaction. */
+void CC_DLL localStorageRemoveItems( const std::vector<std::string>& keys );
+
+/** Queues the writes and commits them from a background thread shortly after, several writes to the same key are coalesced.
+ * Reads still see the queued values. Disabled by default.
+ */
+void CC_DLL localStorageSetWriteBehind( bool enabled );
+
+/** Commits the queued writes now. */
+void CC_DLL localStorageFlush();
+
 // end group
 /// @}
 
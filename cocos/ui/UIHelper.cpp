@@ -29,12 +29,19 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 
+#include <chrono>
+
 NS_CC_BEGIN
 
 namespace ui {
 
 static bool _activeLayout = true;
 
+static bool s_layoutStatsEnabled = false;
+static Helper::LayoutStats s_layoutStats = { 0, 0, 0, 0, 0.0 };
+static int s_layoutStatsDepth = 0;
+static std::chrono::steady_clock::time_point s_layoutStatsStart;
+
 Widget* Helper::seekWidgetByTag(Widget* root, int tag)
 {
     if (!root)
@@ -145,6 +152,8 @@ void Helper::doLayout(cocos2d::Node *rootNode)
         return;
     }
 
+    LayoutStatsScope statsScope;
+
     for(auto& node : rootNode->getChildren())
     {
         auto com = node->getComponent(__LAYOUT_COMPONENT_NAME);
@@ -157,6 +166,68 @@ void Helper::doLayout(cocos2d::Node *rootNode)
     }
 }
     
+Helper::LayoutStatsScope::LayoutStatsScope()
+: _enabled(s_layoutStatsEnabled)
+{
+    if (_enabled && s_layoutStatsDepth++ == 0)
+    {
+        s_layoutStatsStart = std::chrono::steady_clock::now();
+    }
+}
+
+Helper::LayoutStatsScope::~LayoutStatsScope()
+{
+    if (_enabled && --s_layoutStatsDepth == 0)
+    {
+        s_layoutStats.layoutTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_layoutStatsStart).count();
+    }
+}
+
+void Helper::LayoutStatsScope::addLayoutPass(ssize_t childrenCount)
+{
+    if (_enabled)
+    {
+        ++s_layoutStats.layoutPasses;
+        s_layoutStats.arrangedChildren += static_cast<unsigned int>(childrenCount);
+    }
+}
+
+void Helper::LayoutStatsScope::addComponentRefresh()
+{
+    if (_enabled)
+    {
+        ++s_layoutStats.componentRefreshes;
+    }
+}
+
+void Helper::LayoutStatsScope::addSkippedSubtree()
+{
+    if (_enabled)
+    {
+        ++s_layoutStats.skippedSubtrees;
+    }
+}
+
+void Helper::setLayoutStatsEnabled(bool enabled)
+{
+    s_layoutStatsEnabled = enabled;
+}
+
+bool Helper::isLayoutStatsEnabled()
+{
+    return s_layoutStatsEnabled;
+}
+
+const Helper::LayoutStats& Helper::getLayoutStats()
+{
+    return s_layoutStats;
+}
+
+void Helper::resetLayoutStats()
+{
+    s_layoutStats = { 0, 0, 0, 0, 0.0 };
+}
+
 Rect Helper::restrictCapInsetRect(const cocos2d::Rect &capInsets, const Size& textureSize )
 {
     float x = capInsets.origin.x;
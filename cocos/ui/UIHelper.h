@@ -103,6 +103,64 @@ public:
      *@param active A boolean value.
      */
     static void changeLayoutSystemActiveState(bool active);
+
+    /**
+     * Counters of the layout work done since the last call of `resetLayoutStats`.
+     */
+    struct LayoutStats
+    {
+        /** Number of `Layout::doLayout` calls which arranged children with a layout manager. */
+        unsigned int layoutPasses;
+        /** Number of children handled by those layout passes. */
+        unsigned int arrangedChildren;
+        /** Number of `LayoutComponent::refreshLayout` calls. */
+        unsigned int componentRefreshes;
+        /** Number of `LayoutComponent` subtrees skipped because their parent size didn't change. */
+        unsigned int skippedSubtrees;
+        /** Time spent laying out in milliseconds, nested layout calls are only timed once. */
+        double layoutTime;
+    };
+
+    /**
+     * Records layout work into the layout stats while it's alive.
+     * @js NA
+     * @lua NA
+     */
+    class CC_GUI_DLL LayoutStatsScope
+    {
+    public:
+        LayoutStatsScope();
+        ~LayoutStatsScope();
+
+        void addLayoutPass(ssize_t childrenCount);
+        void addComponentRefresh();
+        void addSkippedSubtree();
+
+    private:
+        bool _enabled;
+    };
+
+    /**
+     * Enable or disable collecting layout stats, it's disabled by default.
+     *@param enabled True to collect layout stats.
+     */
+    static void setLayoutStatsEnabled(bool enabled);
+
+    /**
+     * Query whether layout stats are collected.
+     */
+    static bool isLayoutStatsEnabled();
+
+    /**
+     * Get the layout stats collected since the last reset.
+     * Reset them at the start of a frame and read them at its end to get the layout cost per frame.
+     */
+    static const LayoutStats& getLayoutStats();
+
+    /**
+     * Clear the collected layout stats.
+     */
+    static void resetLayoutStats();
     
     /**
      *@brief  restrict capInsetSize, when the capInsets's width is larger than the textureSize, it will restrict to 0,
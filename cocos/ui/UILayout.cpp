@@ -899,6 +899,10 @@ const Size& Layout::getBackGroundImageTextureSize() const
 
 void Layout::setLayoutType(Type type)
 {
+    if (_layoutType == type)
+    {
+        return;
+    }
     _layoutType = type;
    
     for (auto& child : _children)
@@ -969,6 +973,7 @@ void Layout::doLayout()
         return;
     }
     
+    Helper::LayoutStatsScope statsScope;
     sortAllChildren();
 
     LayoutManager* executant = this->createLayoutManager();
@@ -976,6 +981,7 @@ void Layout::doLayout()
     if (executant)
     {
         executant->doLayout(this);
+        statsScope.addLayoutPass(_children.size());
     }
     
     _doLayoutDirty = false;
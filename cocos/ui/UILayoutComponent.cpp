@@ -50,6 +50,8 @@ namespace ui {
         , _usingPercentHeight(false)
         , _actived(true)
         , _isPercentOnly(false)
+        , _childrenLayoutDirty(true)
+        , _refreshing(false)
     {
         _name = __LAYOUT_COMPONENT_NAME;
     }
@@ -127,9 +129,36 @@ namespace ui {
         _topMargin = parentSize.height - (ownerPoint.y + (1 - ownerAnchor.y) * ownerSize.height);
     }
 
+    void LayoutComponent::markLayoutDirty()
+    {
+        Node* parent = (_owner != nullptr) ? _owner->getParent() : nullptr;
+        while (parent != nullptr)
+        {
+            // Helper::doLayout doesn't go through nodes without a LayoutComponent, so there is no need to go further.
+            LayoutComponent* component = static_cast<LayoutComponent*>(parent->getComponent(__LAYOUT_COMPONENT_NAME));
+            if (component == nullptr || component->_childrenLayoutDirty)
+                break;
+            component->_childrenLayoutDirty = true;
+            parent = parent->getParent();
+        }
+    }
+
+    void LayoutComponent::onEnter()
+    {
+        Component::onEnter();
+        this->markLayoutDirty();
+    }
+
+    void LayoutComponent::onOwnerGeometryChanged()
+    {
+        if (!_refreshing)
+            this->markLayoutDirty();
+    }
+
     //OldVersion
     void LayoutComponent::setUsingPercentContentSize(bool isUsed)
     {
+        this->markLayoutDirty();
         _usingPercentWidth = _usingPercentHeight = isUsed;
     }
     bool LayoutComponent::getUsingPercentContentSize()const
@@ -174,6 +203,7 @@ namespace ui {
     }
     void LayoutComponent::setPosition(const Point& position)
     {
+        this->markLayoutDirty();
         Node* parent = this->getOwnerParent();
         if (parent != nullptr)
         {
@@ -213,6 +243,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentXEnabled(bool isUsed)
     {
+        this->markLayoutDirty();
         _usingPositionPercentX = isUsed;
         if (_usingPositionPercentX)
         {
@@ -226,6 +257,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentX(float percentMargin)
     {
+        this->markLayoutDirty();
         _positionPercentX = percentMargin;
 
         if (_usingPositionPercentX || _horizontalEdge == HorizontalEdge::Center)
@@ -245,6 +277,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentYEnabled(bool isUsed)
     {
+        this->markLayoutDirty();
         _usingPositionPercentY = isUsed;
         if (_usingPositionPercentY)
         {
@@ -258,6 +291,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentY(float percentMargin)
     {
+        this->markLayoutDirty();
         _positionPercentY = percentMargin;
 
         if (_usingPositionPercentY || _verticalEdge == VerticalEdge::Center)
@@ -277,6 +311,7 @@ namespace ui {
     }
     void LayoutComponent::setHorizontalEdge(HorizontalEdge hEage)
     {
+        this->markLayoutDirty();
         _horizontalEdge = hEage;
         if (_horizontalEdge != HorizontalEdge::None)
         {
@@ -290,6 +325,7 @@ namespace ui {
     }
     void LayoutComponent::setVerticalEdge(VerticalEdge vEage)
     {
+        this->markLayoutDirty();
         _verticalEdge = vEage;
         if (_verticalEdge != VerticalEdge::None)
         {
@@ -303,6 +339,7 @@ namespace ui {
     }
     void LayoutComponent::setLeftMargin(float margin)
     {
+        this->markLayoutDirty();
         _leftMargin = margin;
     }
 
@@ -312,6 +349,7 @@ namespace ui {
     }
     void LayoutComponent::setRightMargin(float margin)
     {
+        this->markLayoutDirty();
         _rightMargin = margin;
     }
 
@@ -321,6 +359,7 @@ namespace ui {
     }
     void LayoutComponent::setTopMargin(float margin)
     {
+        this->markLayoutDirty();
         _topMargin = margin;
     }
 
@@ -330,6 +369,7 @@ namespace ui {
     }
     void LayoutComponent::setBottomMargin(float margin)
     {
+        this->markLayoutDirty();
         _bottomMargin = margin;
     }
 
@@ -340,6 +380,7 @@ namespace ui {
     }
     void LayoutComponent::setSize(const Size& size)
     {
+        this->markLayoutDirty();
         Node* parent = this->getOwnerParent();
         if (parent != nullptr)
         {
@@ -379,6 +420,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentWidthEnabled(bool isUsed)
     {
+        this->markLayoutDirty();
         _usingPercentWidth = isUsed;
         if (_usingPercentWidth)
         {
@@ -392,6 +434,7 @@ namespace ui {
     }
     void LayoutComponent::setSizeWidth(float width)
     {
+        this->markLayoutDirty();
         Size ownerSize = _owner->getContentSize();
         ownerSize.width = width;
 
@@ -420,6 +463,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentWidth(float percentWidth)
     {
+        this->markLayoutDirty();
         _percentWidth = percentWidth;
 
         if (_usingPercentWidth)
@@ -442,6 +486,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentHeightEnabled(bool isUsed)
     {
+        this->markLayoutDirty();
         _usingPercentHeight = isUsed;
         if (_usingPercentHeight)
         {
@@ -455,6 +500,7 @@ namespace ui {
     }
     void LayoutComponent::setSizeHeight(float height)
     {
+        this->markLayoutDirty();
         Size ownerSize = _owner->getContentSize();
         ownerSize.height = height;
 
@@ -483,6 +529,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentHeight(float percentHeight)
     {
+        this->markLayoutDirty();
         _percentHeight = percentHeight;
 
         if (_usingPercentHeight)
@@ -505,6 +552,7 @@ namespace ui {
     }
     void LayoutComponent::setStretchWidthEnabled(bool isUsed)
     {
+        this->markLayoutDirty();
         _usingStretchWidth = isUsed;
         if (_usingStretchWidth)
         {
@@ -518,6 +566,7 @@ namespace ui {
     }
     void LayoutComponent::setStretchHeightEnabled(bool isUsed)
     {
+        this->markLayoutDirty();
         _usingStretchHeight = isUsed;
         if (_usingStretchHeight)
         {
@@ -534,6 +583,9 @@ namespace ui {
         if (parent == nullptr)
             return;
 
+        Helper::LayoutStatsScope statsScope;
+        statsScope.addComponentRefresh();
+
         const Size& parentSize = parent->getContentSize();
         const Point& ownerAnchor = _owner->getAnchorPoint();
         Size ownerSize = _owner->getContentSize();
@@ -641,8 +693,19 @@ namespace ui {
             break;
         }
 
+        _refreshing = true;
         _owner->setPosition(ownerPosition);
         _owner->setContentSize(ownerSize);
+        _refreshing = false;
+
+        // The layout of the children only depends on the size of the owner and their own settings.
+        const Size& contentSize = _owner->getContentSize();
+        if (!_childrenLayoutDirty && contentSize.equals(_childrenLayoutSize))
+        {
+            statsScope.addSkippedSubtree();
+            return;
+        }
+        _childrenLayoutSize = contentSize;
 
         if (typeid(*_owner) == typeid(PageView))
         {
@@ -659,15 +722,19 @@ namespace ui {
         {
             ui::Helper::doLayout(_owner);
         }
+        // Cleared afterwards, so that changes made while the children are laid out don't leave it dirty.
+        _childrenLayoutDirty = false;
     }
 
     void LayoutComponent::setActiveEnabled(bool enable)
     {
+        this->markLayoutDirty();
         _actived = enable;
     }
 
     void LayoutComponent::setPercentOnlyEnabled(bool enable)
     {
+        this->markLayoutDirty();
         _isPercentOnly = enable;
     }
 }
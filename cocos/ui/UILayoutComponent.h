@@ -388,13 +388,20 @@ namespace ui {
 
         /**
          * Refresh layout of the owner.
+         * The children of the owner are only refreshed when its size changed or one of them has been modified since the last refresh.
          */
         void refreshLayout();
 
+        virtual void onEnter() override;
+        /** A size or anchor point set outside of a refresh, e.g. by a Label or a Sprite frame, moves the owner. */
+        virtual void onOwnerGeometryChanged() override;
+
     protected:
         Node* getOwnerParent();
         void refreshHorizontalMargin();
         void refreshVerticalMargin();
+        // Flags the ancestors, so that refreshing any of them reaches this component.
+        void markLayoutDirty();
     protected:
         HorizontalEdge  _horizontalEdge;
         VerticalEdge    _verticalEdge;
@@ -420,6 +427,12 @@ namespace ui {
 
         bool            _actived;
         bool            _isPercentOnly;
+
+        // the owner size its children were laid out for
+        Size            _childrenLayoutSize;
+        bool            _childrenLayoutDirty;
+        // set while refreshLayout moves the owner, the parent is being laid out already
+        bool            _refreshing;
     };
 }
 
@@ -25,6 +25,7 @@ THE SOFTWARE.
 
 #include "ui/UIListView.h"
 #include "ui/UIHelper.h"
+#include <algorithm>
 
 NS_CC_BEGIN
 
@@ -49,7 +50,13 @@ _curSelectedIndex(-1),
 _innerContainerDoLayoutDirty(true),
 _listViewEventListener(nullptr),
 _listViewEventSelector(nullptr),
-_eventCallback(nullptr)
+_eventCallback(nullptr),
+_itemCountCallback(nullptr),
+_itemSizeCallback(nullptr),
+_itemBindCallback(nullptr),
+_virtualFirstIndex(0),
+_virtualBufferSize(2),
+_virtualItemsDirty(true)
 {
     this->setTouchEnabled(true);
 }
@@ -59,6 +66,8 @@ ListView::~ListView()
     _listViewEventListener = nullptr;
     _listViewEventSelector = nullptr;
     _items.clear();
+    _virtualItems.clear();
+    _virtualItemPool.clear();
     CC_SAFE_RELEASE(_model);
 }
 
@@ -123,6 +132,10 @@ void ListView::updateInnerContainerSize()
             {
                 totalHeight += item->getContentSize().height;
             }
+            if (isVirtualized() && _virtualItemOffsets.size() > 1)
+            {
+                totalHeight = _virtualItemOffsets.back() - _itemsMargin + _bottomPadding;
+            }
             float finalWidth = _contentSize.width;
             float finalHeight = totalHeight;
             setInnerContainerSize(Size(finalWidth, finalHeight));
@@ -136,6 +149,10 @@ void ListView::updateInnerContainerSize()
             {
                 totalWidth += item->getContentSize().width;
             }
+            if (isVirtualized() && _virtualItemOffsets.size() > 1)
+            {
+                totalWidth = _virtualItemOffsets.back() - _itemsMargin + _rightPadding;
+            }
             float finalWidth = totalWidth;
             float finalHeight = _contentSize.height;
             setInnerContainerSize(Size(finalWidth, finalHeight));
@@ -343,6 +360,9 @@ void ListView::removeAllChildrenWithCleanup(bool cleanup)
     ScrollView::removeAllChildrenWithCleanup(cleanup);
     _curSelectedIndex = -1;
     _items.clear();
+    _virtualItems.clear();
+    _virtualItemPool.clear();
+    _virtualItemsDirty = true;
     onItemListChanged();
 }
 
@@ -386,6 +406,14 @@ void ListView::removeAllItems()
 
 Widget* ListView::getItem(ssize_t index) const
 {
+    if (isVirtualized())
+    {
+        if (index < _virtualFirstIndex || index >= _virtualFirstIndex + _virtualItems.size())
+        {
+            return nullptr;
+        }
+        return _virtualItems.at(index - _virtualFirstIndex);
+    }
     if (index < 0 || index >= _items.size())
     {
         return nullptr;
@@ -404,6 +432,11 @@ ssize_t ListView::getIndex(Widget *item) const
     {
         return -1;
     }
+    if (isVirtualized())
+    {
+        ssize_t index = _virtualItems.getIndex(item);
+        return (index == -1) ? -1 : _virtualFirstIndex + index;
+    }
     return _items.getIndex(item);
 }
 
@@ -538,6 +571,243 @@ float ListView::getScrollDuration() const
     return _scrollTime;
 }
 
+void ListView::setItemDataSource(const ccItemCountCallback& countCallback, const ccItemSizeCallback& sizeCallback, const ccItemBindCallback& bindCallback)
+{
+    bool virtualized = (countCallback && sizeCallback && bindCallback);
+    if (virtualized && !_items.empty())
+    {
+        CCLOG("Items of ListView are removed when it is virtualized!");
+        removeAllItems();
+    }
+    removeVirtualItems();
+
+    _itemCountCallback = virtualized ? countCallback : nullptr;
+    _itemSizeCallback = virtualized ? sizeCallback : nullptr;
+    _itemBindCallback = virtualized ? bindCallback : nullptr;
+    _virtualItemOffsets.clear();
+
+    // Virtual items are positioned by ListView itself, so the inner container must not lay them out.
+    if (virtualized)
+    {
+        setLayoutType(Type::ABSOLUTE);
+    }
+    else if (_direction == Direction::HORIZONTAL)
+    {
+        setLayoutType(Type::HORIZONTAL);
+    }
+    else if (_direction == Direction::VERTICAL)
+    {
+        setLayoutType(Type::VERTICAL);
+    }
+    _outOfBoundaryAmountDirty = true;
+    requestDoLayout();
+}
+
+bool ListView::isVirtualized() const
+{
+    return _itemBindCallback != nullptr;
+}
+
+void ListView::reloadData()
+{
+    _virtualItemsDirty = true;
+    requestDoLayout();
+}
+
+ssize_t ListView::getItemCount() const
+{
+    if (isVirtualized())
+    {
+        return _virtualItemOffsets.empty() ? _itemCountCallback(const_cast<ListView*>(this)) : _virtualItemOffsets.size() - 1;
+    }
+    return _items.size();
+}
+
+void ListView::setVirtualBufferSize(int count)
+{
+    _virtualBufferSize = MAX(count, 0);
+}
+
+int ListView::getVirtualBufferSize() const
+{
+    return _virtualBufferSize;
+}
+
+void ListView::updateVirtualItemOffsets()
+{
+    ssize_t count = MAX(_itemCountCallback(this), 0);
+    _virtualItemOffsets.resize(count + 1);
+
+    bool vertical = (_direction != Direction::HORIZONTAL);
+    float offset = vertical ? _topPadding : _leftPadding;
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        _virtualItemOffsets[i] = offset;
+        Size size = _itemSizeCallback(this, i);
+        offset += (vertical ? size.height : size.width) + _itemsMargin;
+    }
+    _virtualItemOffsets[count] = offset;
+}
+
+Rect ListView::getVirtualItemBoundingBox(ssize_t index) const
+{
+    Size size = _itemSizeCallback(const_cast<ListView*>(this), index);
+    const Size& innerSize = _innerContainer->getContentSize();
+    Rect rect(Vec2::ZERO, size);
+    if (_direction == Direction::HORIZONTAL)
+    {
+        rect.origin.x = _virtualItemOffsets[index];
+        switch (_gravity)
+        {
+            case Gravity::TOP:
+                rect.origin.y = innerSize.height - _topPadding - size.height;
+                break;
+            case Gravity::BOTTOM:
+                rect.origin.y = _bottomPadding;
+                break;
+            default:
+                rect.origin.y = (innerSize.height + _bottomPadding - _topPadding - size.height) / 2;
+                break;
+        }
+    }
+    else
+    {
+        rect.origin.y = innerSize.height - _virtualItemOffsets[index] - size.height;
+        switch (_gravity)
+        {
+            case Gravity::RIGHT:
+                rect.origin.x = innerSize.width - _rightPadding - size.width;
+                break;
+            case Gravity::CENTER_HORIZONTAL:
+                rect.origin.x = (innerSize.width + _leftPadding - _rightPadding - size.width) / 2;
+                break;
+            default:
+                rect.origin.x = _leftPadding;
+                break;
+        }
+    }
+    return rect;
+}
+
+void ListView::positionVirtualItem(Widget* item, ssize_t index)
+{
+    Rect rect = getVirtualItemBoundingBox(index);
+    const Vec2& anchorPoint = item->getAnchorPoint();
+    item->setPosition(rect.origin + Vec2(rect.size.width * anchorPoint.x, rect.size.height * anchorPoint.y));
+}
+
+Widget* ListView::bindVirtualItem(ssize_t index)
+{
+    Widget* recycled = nullptr;
+    if (!_virtualItemPool.empty())
+    {
+        recycled = _virtualItemPool.back();
+        recycled->retain();
+        _virtualItemPool.popBack();
+        recycled->autorelease();
+    }
+    else if (_model)
+    {
+        recycled = _model->clone();
+    }
+
+    Widget* item = _itemBindCallback(this, index, recycled);
+    CCASSERT(nullptr != item, "The bind callback of ListView must return an item!");
+    if (recycled && recycled != item && recycled->getParent() == _innerContainer)
+    {
+        _virtualItemPool.pushBack(recycled);
+    }
+    if (item->getParent() != _innerContainer)
+    {
+        ScrollView::addChild(item, item->getLocalZOrder(), item->getName());
+    }
+    item->setVisible(true);
+    positionVirtualItem(item, index);
+    return item;
+}
+
+void ListView::recycleVirtualItem(Widget* item)
+{
+    item->setVisible(false);
+    _virtualItemPool.pushBack(item);
+}
+
+void ListView::removeVirtualItems()
+{
+    for (auto& item : _virtualItems)
+    {
+        _innerContainer->removeChild(item, true);
+    }
+    for (auto& item : _virtualItemPool)
+    {
+        _innerContainer->removeChild(item, true);
+    }
+    _virtualItems.clear();
+    _virtualItemPool.clear();
+    _virtualFirstIndex = 0;
+    _virtualItemsDirty = true;
+}
+
+void ListView::updateVirtualItems()
+{
+    ssize_t count = _virtualItemOffsets.size() - 1;
+    ssize_t first = 0;
+    ssize_t last = 0;
+    if (count > 0)
+    {
+        // The visible range along the scroll direction, measured like _virtualItemOffsets.
+        float start, end;
+        if (_direction == Direction::HORIZONTAL)
+        {
+            start = -_innerContainer->getLeftBoundary();
+            end = start + _contentSize.width;
+        }
+        else
+        {
+            end = _innerContainer->getContentSize().height + _innerContainer->getBottomBoundary();
+            start = end - _contentSize.height;
+        }
+        auto begin = _virtualItemOffsets.begin();
+        first = std::upper_bound(begin, begin + count, start) - begin - 1;
+        last = std::lower_bound(begin, begin + count, end) - begin;
+        first = MAX(first - _virtualBufferSize, 0);
+        last = MIN(last + _virtualBufferSize, count);
+        last = MAX(first, last);
+    }
+
+    ssize_t oldFirst = _virtualFirstIndex;
+    ssize_t oldLast = _virtualFirstIndex + _virtualItems.size();
+    if (!_virtualItemsDirty && first == oldFirst && last == oldLast)
+    {
+        return;
+    }
+
+    // Recycle the items which left the range first, so that they can be bound to the ones which entered it.
+    for (ssize_t i = oldFirst; i < oldLast; ++i)
+    {
+        if (_virtualItemsDirty || i < first || i >= last)
+        {
+            recycleVirtualItem(_virtualItems.at(i - oldFirst));
+        }
+    }
+
+    Vector<Widget*> items(last - first);
+    for (ssize_t i = first; i < last; ++i)
+    {
+        if (!_virtualItemsDirty && i >= oldFirst && i < oldLast)
+        {
+            items.pushBack(_virtualItems.at(i - oldFirst));
+        }
+        else
+        {
+            items.pushBack(bindVirtualItem(i));
+        }
+    }
+    _virtualItems = std::move(items);
+    _virtualFirstIndex = first;
+    _virtualItemsDirty = false;
+}
+
 void ListView::setDirection(Direction dir)
 {
     switch (dir)
@@ -546,16 +816,26 @@ void ListView::setDirection(Direction dir)
         case Direction::BOTH:
             break;
         case Direction::VERTICAL:
-            setLayoutType(Type::VERTICAL);
+            if (!isVirtualized())
+            {
+                setLayoutType(Type::VERTICAL);
+            }
             break;
         case Direction::HORIZONTAL:
-            setLayoutType(Type::HORIZONTAL);
+            if (!isVirtualized())
+            {
+                setLayoutType(Type::HORIZONTAL);
+            }
             break;
         default:
             return;
             break;
     }
     ScrollView::setDirection(dir);
+    if (isVirtualized())
+    {
+        requestDoLayout();
+    }
 }
     
 void ListView::refreshView()
@@ -570,6 +850,32 @@ void ListView::requestDoLayout()
 
 void ListView::doLayout()
 {
+    if (isVirtualized())
+    {
+        // Called on every visit, so the alive items follow the inner container while scrolling.
+        if (_innerContainerDoLayoutDirty)
+        {
+            updateVirtualItemOffsets();
+            updateInnerContainerSize();
+            _innerContainerDoLayoutDirty = false;
+
+            ssize_t count = _virtualItemOffsets.size() - 1;
+            if (_virtualFirstIndex + _virtualItems.size() > count)
+            {
+                _virtualItemsDirty = true;
+            }
+            else
+            {
+                for (ssize_t i = 0; i < _virtualItems.size(); ++i)
+                {
+                    positionVirtualItem(_virtualItems.at(i), _virtualFirstIndex + i);
+                }
+            }
+        }
+        updateVirtualItems();
+        return;
+    }
+
     if(!_innerContainerDoLayoutDirty)
     {
         return;
@@ -852,16 +1158,35 @@ Vec2 ListView::calculateItemDestination(const Vec2& positionRatioInView, Widget*
     return -(itemPosition - positionInView);
 }
 
+static Vec2 calculateVirtualItemDestination(const Size& contentSize, const Vec2& positionRatioInView, const Rect& itemBoundingBox, const Vec2& itemAnchorPoint)
+{
+    Vec2 positionInView(contentSize.width * positionRatioInView.x, contentSize.height * positionRatioInView.y);
+    Vec2 itemPosition = itemBoundingBox.origin + Vec2(itemBoundingBox.size.width * itemAnchorPoint.x, itemBoundingBox.size.height * itemAnchorPoint.y);
+    return -(itemPosition - positionInView);
+}
+
 void ListView::jumpToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint)
 {
-    Widget* item = getItem(itemIndex);
-    if (item == nullptr)
+    Vec2 destination;
+    if (isVirtualized())
     {
-        return;
+        doLayout();
+        if (itemIndex < 0 || itemIndex >= getItemCount())
+        {
+            return;
+        }
+        destination = calculateVirtualItemDestination(getContentSize(), positionRatioInView, getVirtualItemBoundingBox(itemIndex), itemAnchorPoint);
+    }
+    else
+    {
+        Widget* item = getItem(itemIndex);
+        if (item == nullptr)
+        {
+            return;
+        }
+        doLayout();
+        destination = calculateItemDestination(positionRatioInView, item, itemAnchorPoint);
     }
-    doLayout();
-
-    Vec2 destination = calculateItemDestination(positionRatioInView, item, itemAnchorPoint);
     if(!_bounceEnabled)
     {
         Vec2 delta = destination - getInnerContainerPosition();
@@ -878,6 +1203,17 @@ void ListView::scrollToItem(ssize_t itemIndex, const Vec2& positionRatioInView,
 
 void ListView::scrollToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint, float timeInSec)
 {
+    if (isVirtualized())
+    {
+        doLayout();
+        if (itemIndex < 0 || itemIndex >= getItemCount())
+        {
+            return;
+        }
+        Vec2 destination = calculateVirtualItemDestination(getContentSize(), positionRatioInView, getVirtualItemBoundingBox(itemIndex), itemAnchorPoint);
+        startAutoScrollToDestination(destination, timeInSec, true);
+        return;
+    }
     Widget* item = getItem(itemIndex);
     if (item == nullptr)
     {
@@ -894,8 +1230,7 @@ ssize_t ListView::getCurSelectedIndex() const
 
 void ListView::setCurSelectedIndex(int itemIndex)
 {
-    Widget* item = getItem(itemIndex);
-    if (item == nullptr)
+    if (itemIndex < 0 || itemIndex >= getItemCount())
     {
         return;
     }
@@ -940,6 +1275,10 @@ void ListView::copySpecialProperties(Widget *widget)
         _listViewEventListener = listViewEx->_listViewEventListener;
         _listViewEventSelector = listViewEx->_listViewEventSelector;
         _eventCallback = listViewEx->_eventCallback;
+        if (listViewEx->isVirtualized())
+        {
+            setItemDataSource(listViewEx->_itemCountCallback, listViewEx->_itemSizeCallback, listViewEx->_itemBindCallback);
+        }
     }
 }
 
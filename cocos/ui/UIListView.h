@@ -57,7 +57,7 @@ typedef void (Ref::*SEL_ListViewEvent)(Ref*,ListViewEventType);
 /**
  *@brief ListView is a view group that displays a list of scrollable items.
  *The list items are inserted to the list by using `addChild` or  `insertDefaultItem`.
- * @warning The list item in ListView doesn't support cell reuse at the moment, if you have a large amount of data need to be displayed, use  `TableView` instead.
+ * @warning Items added with `pushBackCustomItem` or `insertCustomItem` are all kept alive, if you have a large amount of data need to be displayed, use `setItemDataSource` to virtualize the list.
  * ListView is a subclass of  `ScrollView`, so it shares many features of ScrollView.
  */
 class CC_GUI_DLL ListView : public ScrollView
@@ -107,6 +107,23 @@ public:
      * ListView item click callback.
      */
     typedef std::function<void(Ref*, EventType)> ccListViewCallback;
+
+    /**
+     * Returns the number of items of a virtualized ListView.
+     */
+    typedef std::function<ssize_t(ListView*)> ccItemCountCallback;
+
+    /**
+     * Returns the size of the item at a given index of a virtualized ListView.
+     */
+    typedef std::function<Size(ListView*, ssize_t)> ccItemSizeCallback;
+
+    /**
+     * Binds the data at a given index to an item widget of a virtualized ListView.
+     * The widget passed in is a recycled item, a clone of the item model, or nullptr if neither is available.
+     * Returns the widget to display, which is usually the one passed in.
+     */
+    typedef std::function<Widget*(ListView*, ssize_t, Widget*)> ccItemBindCallback;
     
     /**
      * Default constructor
@@ -316,6 +333,48 @@ public:
      * @see setScrollDuration(float)
      */
     float getScrollDuration() const;
+
+    /**
+     * @brief Virtualize ListView with a data source.
+     *
+     * A virtualized ListView only keeps the visible items and a few buffered ones alive, and recycles them while scrolling,
+     * so it can show a huge number of items. Items may have different sizes along the scroll direction.
+     * Items added with `pushBackCustomItem` and the like are removed, `getItems` stays empty and magnetic scroll is disabled.
+     * Passing nullptr callbacks turns virtualization off.
+     *
+     * @param countCallback Returns the number of items.
+     * @param sizeCallback Returns the size of an item.
+     * @param bindCallback Fills an item widget with the data of an index.
+     */
+    void setItemDataSource(const ccItemCountCallback& countCallback, const ccItemSizeCallback& sizeCallback, const ccItemBindCallback& bindCallback);
+
+    /**
+     * Query whether ListView is virtualized by a data source.
+     * @see setItemDataSource
+     */
+    bool isVirtualized() const;
+
+    /**
+     * @brief Query the item count and sizes again and rebind all visible items.
+     * Call it when the data behind a virtualized ListView changes.
+     */
+    void reloadData();
+
+    /**
+     * Get the number of items, including the ones which aren't alive in a virtualized ListView.
+     */
+    ssize_t getItemCount() const;
+
+    /**
+     * Set how many items before and after the visible ones are kept alive in a virtualized ListView, default is 2.
+     * @param count The number of buffered items on each side.
+     */
+    void setVirtualBufferSize(int count);
+
+    /**
+     * Get how many items before and after the visible ones are kept alive in a virtualized ListView.
+     */
+    int getVirtualBufferSize() const;
     
     //override methods
     virtual void doLayout() override;
@@ -487,6 +546,14 @@ protected:
     
     void startMagneticScroll();
     Vec2 calculateItemDestination(const Vec2& positionRatioInView, Widget* item, const Vec2& itemAnchorPoint);
+
+    void updateVirtualItemOffsets();
+    void updateVirtualItems();
+    Widget* bindVirtualItem(ssize_t index);
+    void recycleVirtualItem(Widget* item);
+    void removeVirtualItems();
+    void positionVirtualItem(Widget* item, ssize_t index);
+    Rect getVirtualItemBoundingBox(ssize_t index) const;
     
 protected:
     Widget* _model;
@@ -525,6 +592,20 @@ protected:
 #pragma warning (pop)
 #endif
     ccListViewCallback _eventCallback;
+
+    ccItemCountCallback _itemCountCallback;
+    ccItemSizeCallback _itemSizeCallback;
+    ccItemBindCallback _itemBindCallback;
+    // start of each item along the scroll direction, measured from the top or left of the inner container,
+    // the last element is where the item after the last one would start
+    std::vector<float> _virtualItemOffsets;
+    // alive items of [_virtualFirstIndex, _virtualFirstIndex + _virtualItems.size())
+    Vector<Widget*> _virtualItems;
+    // hidden items waiting to be bound again
+    Vector<Widget*> _virtualItemPool;
+    ssize_t _virtualFirstIndex;
+    int _virtualBufferSize;
+    bool _virtualItemsDirty;
 };
 
 }
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <locale>
+#include <memory>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -38,6 +39,16 @@
 #include "base/CCDirector.h"
 #include "2d/CCLabel.h"
 #include "2d/CCSprite.h"
+#include "2d/CCCamera.h"
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontAtlasCache.h"
+#include "2d/CCFont.h"
+#include "base/CCEventCustom.h"
+#include "base/CCEventListenerCustom.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/CCQuadCommand.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCTexture2D.h"
 #include "base/ccUTF8.h"
 #include "ui/UIHelper.h"
 
@@ -106,6 +117,209 @@ private:
 };
 const std::string ListenerComponent::COMPONENT_NAME("cocos2d_ui_UIRichText_ListenerComponent");
 
+// Draws one line of plain TTF text straight from its font atlas, without the Label machinery.
+// All glyph runs share one program state, so the renderer merges consecutive runs
+// that use the same atlas texture into a single draw call.
+class GlyphRunRenderer : public Node
+{
+public:
+    static GlyphRunRenderer* create(FontAtlas* fontAtlas, const std::u32string& text, const float* offsets, const float* kernings, float lineHeight)
+    {
+        auto renderer = new (std::nothrow) GlyphRunRenderer(fontAtlas, text, offsets, kernings, lineHeight);
+        renderer->autorelease();
+        return renderer;
+    }
+
+    GlyphRunRenderer(FontAtlas* fontAtlas, const std::u32string& text, const float* offsets, const float* kernings, float lineHeight)
+    : _fontAtlas(fontAtlas)
+    , _text(text)
+    , _offsets(offsets, offsets + text.length() + 1)
+    , _kernings(kernings, kernings + text.length())
+    , _textColor(Color3B::WHITE)
+    , _blendFunc(BlendFunc::ALPHA_NON_PREMULTIPLIED)
+    , _quadsDirty(true)
+    {
+        // the run may start in the middle of a shaped line
+        const float origin = _offsets.front();
+        for (auto& offset : _offsets)
+            offset -= origin;
+
+        _fontAtlas->retain();
+        setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR_NO_MVP));
+        setContentSize(Size(getTextWidth(_text.length()), lineHeight));
+    }
+
+    virtual ~GlyphRunRenderer()
+    {
+        FontAtlasCache::releaseFontAtlas(_fontAtlas);
+    }
+
+    FontAtlas* getFontAtlas() const { return _fontAtlas; }
+
+    void setTextColor(const Color3B& color)
+    {
+        _textColor = color;
+        updateColor();
+    }
+
+    // the atlas textures were recreated, rebuild the quads on the next draw
+    void setQuadsDirty()
+    {
+        _quadsDirty = true;
+        _batches.clear();
+    }
+
+    // returns the width change, like RichText::stripTrailingWhitespace does for labels
+    float trimTrailingWhitespace()
+    {
+        auto length = _text.length();
+        while (length > 0 && StringUtils::isUnicodeSpace(_text[length - 1]))
+            --length;
+        if (length == _text.length())
+            return 0.0f;
+
+        const float width = _contentSize.width;
+        _text.resize(length);
+        _offsets.resize(length + 1);
+        _kernings.resize(length);
+        setContentSize(Size(getTextWidth(length), _contentSize.height));
+        setQuadsDirty();
+        return _contentSize.width - width;
+    }
+
+    virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override
+    {
+#if CC_USE_CULLING
+        auto visitingCamera = Camera::getVisitingCamera();
+        auto defaultCamera = Camera::getDefaultCamera();
+        if (visitingCamera == defaultCamera)
+        {
+            _insideBounds = ((flags & FLAGS_TRANSFORM_DIRTY) || visitingCamera->isViewProjectionUpdated()) ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
+        }
+        else
+        {
+            _insideBounds = renderer->checkVisibility(transform, _contentSize);
+        }
+        if (!_insideBounds)
+            return;
+#endif
+        if (_quadsDirty)
+            updateQuads();
+
+        for (size_t i = 0, size = _batches.size(); i < size; ++i)
+        {
+            auto& batch = _batches[i];
+            batch.command->init(_globalZOrder, batch.texture, getGLProgramState(), _blendFunc,
+                                batch.quads.data(), batch.quads.size(), transform, flags);
+            renderer->addCommand(batch.command.get());
+        }
+    }
+
+protected:
+    virtual void updateColor() override
+    {
+        Color4B color4(_displayedColor.r * _textColor.r / 255,
+                       _displayedColor.g * _textColor.g / 255,
+                       _displayedColor.b * _textColor.b / 255,
+                       _displayedOpacity);
+        for (auto& batch : _batches)
+        {
+            for (auto& quad : batch.quads)
+            {
+                quad.bl.colors = color4;
+                quad.br.colors = color4;
+                quad.tl.colors = color4;
+                quad.tr.colors = color4;
+            }
+        }
+    }
+
+    float getTextWidth(size_t length) const
+    {
+        return length > 0 ? _offsets[length] - _kernings[length - 1] : 0.0f;
+    }
+
+    void updateQuads()
+    {
+        _batches.clear();
+        _fontAtlas->prepareLetterDefinitions(_text);
+
+        const auto& textures = _fontAtlas->getTextures();
+        const float contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+        FontLetterDefinition letterDef;
+        for (size_t i = 0, length = _text.length(); i < length; ++i)
+        {
+            if (!_fontAtlas->getLetterDefinitionForChar(_text[i], letterDef) || letterDef.width <= 0.0f || letterDef.height <= 0.0f)
+                continue;
+
+            auto textureIt = textures.find(letterDef.textureID);
+            if (textureIt == textures.end())
+                continue;
+            Texture2D* texture = textureIt->second;
+
+            auto batchIt = std::find_if(_batches.begin(), _batches.end(), [texture](const Batch& batch) {
+                return batch.texture == texture;
+            });
+            if (batchIt == _batches.end())
+            {
+                _batches.emplace_back();
+                batchIt = _batches.end() - 1;
+                batchIt->texture = texture;
+                batchIt->command.reset(new (std::nothrow) QuadCommand());
+                batchIt->quads.reserve(length);
+                _blendFunc = texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
+            }
+
+            // same placement as Label gives a single line of TTF text: top-left anchored at the baseline offset
+            const float left = _offsets[i] + letterDef.offsetX / contentScaleFactor;
+            const float top = _contentSize.height - letterDef.offsetY / contentScaleFactor;
+            const float right = left + letterDef.width;
+            const float bottom = top - letterDef.height;
+
+            const float pixelsWide = static_cast<float>(texture->getPixelsWide());
+            const float pixelsHigh = static_cast<float>(texture->getPixelsHigh());
+            const float texLeft = letterDef.U * contentScaleFactor / pixelsWide;
+            const float texRight = (letterDef.U + letterDef.width) * contentScaleFactor / pixelsWide;
+            const float texTop = letterDef.V * contentScaleFactor / pixelsHigh;
+            const float texBottom = (letterDef.V + letterDef.height) * contentScaleFactor / pixelsHigh;
+
+            V3F_C4B_T2F_Quad quad;
+            quad.tl.vertices.set(left, top, 0.0f);
+            quad.tr.vertices.set(right, top, 0.0f);
+            quad.bl.vertices.set(left, bottom, 0.0f);
+            quad.br.vertices.set(right, bottom, 0.0f);
+            quad.tl.texCoords = Tex2F(texLeft, texTop);
+            quad.tr.texCoords = Tex2F(texRight, texTop);
+            quad.bl.texCoords = Tex2F(texLeft, texBottom);
+            quad.br.texCoords = Tex2F(texRight, texBottom);
+            batchIt->quads.push_back(quad);
+        }
+
+        _quadsDirty = false;
+        updateColor();
+    }
+
+private:
+    struct Batch
+    {
+        Texture2D* texture;     // weak ref, owned by the font atlas
+        std::vector<V3F_C4B_T2F_Quad> quads;
+        std::unique_ptr<QuadCommand> command;
+    };
+
+    FontAtlas* _fontAtlas;      // strong ref.
+    std::u32string _text;
+    std::vector<float> _offsets;
+    std::vector<float> _kernings;
+    Color3B _textColor;
+    BlendFunc _blendFunc;
+    std::vector<Batch> _batches;
+    bool _quadsDirty;
+#if CC_USE_CULLING
+    bool _insideBounds = true;
+#endif
+};
+
 bool RichElement::init(int tag, const Color3B &color, GLubyte opacity)
 {
     _tag = tag;
@@ -885,6 +1099,8 @@ const std::string RichText::KEY_ANCHOR_TEXT_GLOW_COLOR("KEY_ANCHOR_TEXT_GLOW_COL
 RichText::RichText()
     : _formatTextDirty(true)
     , _leftSpaceWidth(0.0f)
+    , _formatGeneration(0)
+    , _fontAtlasResetListener(nullptr)
 {
     _defaults[KEY_VERTICAL_SPACE] = 0.0f;
     _defaults[KEY_WRAP_MODE] = static_cast<int>(WrapMode::WRAP_PER_WORD);
@@ -902,6 +1118,12 @@ RichText::RichText()
 RichText::~RichText()
 {
     _richElements.clear();
+    purgeShapedRuns(false);
+    if (_fontAtlasResetListener)
+    {
+        Director::getInstance()->getEventDispatcher()->removeEventListener(_fontAtlasResetListener);
+        _fontAtlasResetListener->release();
+    }
 }
     
 RichText* RichText::create()
@@ -1358,6 +1580,7 @@ void RichText::formatText()
         this->removeAllProtectedChildren();
         _elementRenders.clear();
         _lineHeights.clear();
+        ++_formatGeneration;
         if (_ignoreSize)
         {
             addNewLine();
@@ -1370,6 +1593,19 @@ void RichText::formatText()
                     case RichElement::Type::TEXT:
                     {
                         RichElementText* elmtText = static_cast<RichElementText*>(element);
+                        // plain single line text in a TTF font is drawn from the font atlas without a Label
+                        if ((elmtText->_flags & ~RichElementText::URL_FLAG) == 0 && !elmtText->_text.empty()
+                            && elmtText->_text.find('\n') == std::string::npos
+                            && FileUtils::getInstance()->isFileExist(elmtText->_fontName))
+                        {
+                            ShapedRun* shapedRun = shapeTextRun(elmtText->_text, elmtText->_fontName, elmtText->_fontSize, elmtText->_flags);
+                            if (shapedRun)
+                            {
+                                elementRenderer = createGlyphRunRenderer(*shapedRun, 0, static_cast<int>(shapedRun->utf32Text.length()),
+                                                                         elmtText->_color, elmtText->_flags, elmtText->_url);
+                                break;
+                            }
+                        }
                         Label* label;
                         if (FileUtils::getInstance()->isFileExist(elmtText->_fontName))
                         {
@@ -1493,6 +1729,7 @@ void RichText::formatText()
             }
         }
         formatRenderers();
+        purgeShapedRuns(true);
         _formatTextDirty = false;
     }
 }
@@ -1532,7 +1769,7 @@ namespace {
         return std::any_of(str.begin(), str.end(), isUTF8CharWrappable);
     }
 
-    int findSplitPositionForWord(Label* label, const StringUtils::StringUTF8& text, int estimatedIdx, float originalLeftSpaceWidth, float newLineWidth)
+    int findSplitPositionForWord(const std::function<float(int)>& measureText, const StringUtils::StringUTF8& text, int estimatedIdx, float originalLeftSpaceWidth, float newLineWidth)
     {
         bool startingNewLine = (newLineWidth == originalLeftSpaceWidth);
         if (!isWrappable(text))
@@ -1540,9 +1777,7 @@ namespace {
 
         // The adjustment of the new line position
         int idx = getNextWordPos(text, estimatedIdx);
-        std::string leftStr = text.getAsCharSequence(0, idx);
-        label->setString(leftStr);
-        float textRendererWidth = label->getContentSize().width;
+        float textRendererWidth = measureText(idx);
         if (originalLeftSpaceWidth < textRendererWidth)  // Have protruding
         {
             while (1)
@@ -1551,9 +1786,7 @@ namespace {
                 int newidx = getPrevWordPos(text, idx);
                 if (newidx >= 0)
                 {
-                    leftStr = text.getAsCharSequence(0, newidx);
-                    label->setString(leftStr);
-                    textRendererWidth = label->getContentSize().width;
+                    textRendererWidth = measureText(newidx);
                     if (textRendererWidth <= originalLeftSpaceWidth)  // is fitted
                         return newidx;
                     idx = newidx;
@@ -1569,9 +1802,7 @@ namespace {
             {
                 // try to append a word
                 int newidx = getNextWordPos(text, idx);
-                leftStr = text.getAsCharSequence(0, newidx);
-                label->setString(leftStr);
-                textRendererWidth = label->getContentSize().width;
+                textRendererWidth = measureText(newidx);
                 if (textRendererWidth < originalLeftSpaceWidth)
                 {
                     // the whole string is tested
@@ -1588,7 +1819,7 @@ namespace {
         return idx;
     }
 
-    int findSplitPositionForChar(Label* label, const StringUtils::StringUTF8& text, int estimatedIdx, float originalLeftSpaceWidth, float newLineWidth)
+    int findSplitPositionForChar(const std::function<float(int)>& measureText, const StringUtils::StringUTF8& text, int estimatedIdx, float originalLeftSpaceWidth, float newLineWidth)
     {
         bool startingNewLine = (newLineWidth == originalLeftSpaceWidth);
 
@@ -1596,18 +1827,13 @@ namespace {
         int leftLength = estimatedIdx;
 
         // The adjustment of the new line position
-        std::string leftStr = text.getAsCharSequence(0, leftLength);
-        label->setString(leftStr);
-        float textRendererWidth = label->getContentSize().width;
+        float textRendererWidth = measureText(leftLength);
         if (originalLeftSpaceWidth < textRendererWidth)  // Have protruding
         {
             while (leftLength-- > 0)
             {
                 // try to erase a char
-                auto& ch = text.getString().at(leftLength);
-                leftStr.erase(leftStr.end() - ch._char.length(), leftStr.end());
-                label->setString(leftStr);
-                textRendererWidth = label->getContentSize().width;
+                textRendererWidth = measureText(leftLength);
                 if (textRendererWidth <= originalLeftSpaceWidth)  // is fitted
                     break;
             }
@@ -1617,11 +1843,8 @@ namespace {
             while (leftLength < stringLength)
             {
                 // try to append a char
-                auto& ch = text.getString().at(leftLength);
                 ++leftLength;
-                leftStr.append(ch._char);
-                label->setString(leftStr);
-                textRendererWidth = label->getContentSize().width;
+                textRendererWidth = measureText(leftLength);
                 if (originalLeftSpaceWidth < textRendererWidth)  // protruded, undo add
                 {
                     --leftLength;
@@ -1640,6 +1863,125 @@ namespace {
     }
 }
 
+float RichText::ShapedRun::getWidth(int start, int end) const
+{
+    if (end <= start)
+        return 0.0f;
+    // like Label, the kerning after the last char doesn't count
+    return offsets[end] - offsets[start] - kernings[end - 1];
+}
+
+RichText::ShapedRun* RichText::shapeTextRun(const std::string& text, const std::string& fontName, float fontSize, uint32_t flags)
+{
+    // outline and glow switch the label to another atlas with different metrics
+    if (flags & (RichElementText::OUTLINE_FLAG | RichElementText::GLOW_FLAG))
+        return nullptr;
+
+    const bool bold = (flags & RichElementText::BOLD_FLAG) != 0;
+    std::string key = StringUtils::format("%.2f %d ", fontSize, bold ? 1 : 0);
+    key += fontName;
+    key += '\n';
+    key += text;
+
+    auto it = _shapedRuns.find(key);
+    if (it != _shapedRuns.end())
+    {
+        it->second.generation = _formatGeneration;
+        return &it->second;
+    }
+
+    TTFConfig ttfConfig(fontName, fontSize, GlyphCollection::DYNAMIC);
+    FontAtlas* fontAtlas = FontAtlasCache::getFontAtlasTTF(&ttfConfig);
+    if (!fontAtlas)
+        return nullptr;
+
+    if (!_fontAtlasResetListener)
+    {
+        // the atlas textures are rebuilt when the GL context is recreated, the glyph runs have to follow
+        _fontAtlasResetListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(FontAtlas::CMD_RESET_FONTATLAS, [this](EventCustom* event) {
+            onFontAtlasReset(static_cast<FontAtlas*>(event->getUserData()));
+        });
+        _fontAtlasResetListener->retain();
+    }
+
+    ShapedRun& run = _shapedRuns[key];
+    // getFontAtlasTTF does not retain a cached atlas, purgeShapedRuns releases this reference
+    fontAtlas->retain();
+    run.fontAtlas = fontAtlas;
+    run.generation = _formatGeneration;
+    run.lineHeight = fontAtlas->getLineHeight() / CC_CONTENT_SCALE_FACTOR();
+    StringUtils::UTF8ToUTF32(text, run.utf32Text);
+    // some fonts have no letter definition for the no-break space, Label draws a regular space instead
+    std::replace(run.utf32Text.begin(), run.utf32Text.end(),
+                 static_cast<char32_t>(StringUtils::UnicodeCharacters::NoBreakSpace),
+                 static_cast<char32_t>(StringUtils::UnicodeCharacters::Space));
+
+    // same advances as Label::multilineTextWrap, so the measured width matches the label that would draw the text
+    fontAtlas->prepareLetterDefinitions(run.utf32Text);
+    int letterCount = 0;
+    int* horizontalKernings = fontAtlas->getFont()->getHorizontalKerningForTextUTF32(run.utf32Text, letterCount);
+    const float contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+    const float additionalKerning = bold ? 1.0f : 0.0f;  // Label::enableBold
+    const size_t length = run.utf32Text.length();
+    run.offsets.resize(length + 1);
+    run.kernings.assign(length, 0.0f);
+
+    float nextLetterX = 0.0f;
+    FontLetterDefinition letterDef;
+    for (size_t i = 0; i < length; ++i)
+    {
+        run.offsets[i] = nextLetterX / contentScaleFactor;
+        if (fontAtlas->getLetterDefinitionForChar(run.utf32Text[i], letterDef))
+        {
+            float kerning = (horizontalKernings && i + 1 < length) ? horizontalKernings[i + 1] : 0.0f;
+            run.kernings[i] = kerning / contentScaleFactor;
+            nextLetterX += kerning + letterDef.xAdvance + additionalKerning;
+        }
+    }
+    run.offsets[length] = nextLetterX / contentScaleFactor;
+    delete [] horizontalKernings;
+
+    return &run;
+}
+
+Node* RichText::createGlyphRunRenderer(const ShapedRun& run, int start, int length, const Color3B& color, uint32_t flags, const std::string& url)
+{
+    auto glyphRun = GlyphRunRenderer::create(run.fontAtlas, run.utf32Text.substr(start, length),
+                                             run.offsets.data() + start, run.kernings.data() + start, run.lineHeight);
+    glyphRun->setTextColor(color);
+    if (flags & RichElementText::URL_FLAG)
+        glyphRun->addComponent(ListenerComponent::create(glyphRun,
+                                                         url,
+                                                         std::bind(&RichText::openUrl, this, std::placeholders::_1)));
+    return glyphRun;
+}
+
+void RichText::purgeShapedRuns(bool unusedOnly)
+{
+    for (auto it = _shapedRuns.begin(); it != _shapedRuns.end(); )
+    {
+        if (!unusedOnly || it->second.generation != _formatGeneration)
+        {
+            FontAtlasCache::releaseFontAtlas(it->second.fontAtlas);
+            it = _shapedRuns.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void RichText::onFontAtlasReset(FontAtlas* fontAtlas)
+{
+    for (auto& child : _protectedChildren)
+    {
+        auto glyphRun = dynamic_cast<GlyphRunRenderer*>(child);
+        if (glyphRun && glyphRun->getFontAtlas() == fontAtlas)
+            glyphRun->setQuadsDirty();
+    }
+}
+
 void RichText::handleTextRenderer(const std::string& text, const std::string& fontName, float fontSize, const Color3B &color,
                                   GLubyte opacity, uint32_t flags, const std::string& url,
                                   const Color3B& outlineColor, int outlineSize ,
@@ -1649,6 +1991,43 @@ void RichText::handleTextRenderer(const std::string& text, const std::string& fo
     bool fileExist = FileUtils::getInstance()->isFileExist(fontName);
     RichText::WrapMode wrapMode = static_cast<RichText::WrapMode>(_defaults.at(KEY_WRAP_MODE).asInt());
 
+    auto createLabel = [&](const std::string& str) {
+        Label* textRenderer = fileExist ? Label::createWithTTF(str, fontName, fontSize)
+            : Label::createWithSystemFont(str, fontName, fontSize);
+
+        if (flags & RichElementText::ITALICS_FLAG)
+            textRenderer->enableItalics();
+        if (flags & RichElementText::BOLD_FLAG)
+            textRenderer->enableBold();
+        if (flags & RichElementText::UNDERLINE_FLAG)
+            textRenderer->enableUnderline();
+        if (flags & RichElementText::STRIKETHROUGH_FLAG)
+            textRenderer->enableStrikethrough();
+        if (flags & RichElementText::URL_FLAG)
+            textRenderer->addComponent(ListenerComponent::create(textRenderer,
+                                                                 url,
+                                                                 std::bind(&RichText::openUrl, this, std::placeholders::_1)));
+        if (flags & RichElementText::OUTLINE_FLAG)
+            textRenderer->enableOutline(Color4B(outlineColor), outlineSize);
+        if (flags & RichElementText::SHADOW_FLAG)
+            textRenderer->enableShadow(Color4B(shadowColor), shadowOffset, shadowBlurRadius);
+        if (flags & RichElementText::GLOW_FLAG)
+            textRenderer->enableGlow(Color4B(glowColor));
+
+        textRenderer->setTextColor(Color4B(color));
+        textRenderer->setOpacity(opacity);
+        return textRenderer;
+    };
+
+    // plain text is drawn by a glyph run, styled text still needs a Label even when it was measured without one
+    auto createShapedRenderer = [&](const ShapedRun& run, int start, int length, const std::string& str) -> Node* {
+        if ((flags & ~RichElementText::URL_FLAG) != 0)
+            return createLabel(str);
+        Node* glyphRun = createGlyphRunRenderer(run, start, length, color, flags, url);
+        glyphRun->setOpacity(opacity);
+        return glyphRun;
+    };
+
     // split text by \n
     std::stringstream ss(text);
     std::string currentText;
@@ -1662,6 +2041,10 @@ void RichText::handleTextRenderer(const std::string& text, const std::string& fo
         }
         ++realLines;
 
+        // TTF text is measured against the font atlas, other fonts with the label that ends up showing the text
+        ShapedRun* shapedRun = (fileExist && !currentText.empty()) ? shapeTextRun(currentText, fontName, fontSize, flags) : nullptr;
+        int shapedOffset = 0;
+
         size_t splitParts = 0;
         StringUtils::StringUTF8 utf8Text(currentText);
         while (!currentText.empty())
@@ -1673,40 +2056,34 @@ void RichText::handleTextRenderer(const std::string& text, const std::string& fo
             }
             ++splitParts;
 
-            Label* textRenderer = fileExist ? Label::createWithTTF(currentText, fontName, fontSize)
-                : Label::createWithSystemFont(currentText, fontName, fontSize);
-
-            if (flags & RichElementText::ITALICS_FLAG)
-                textRenderer->enableItalics();
-            if (flags & RichElementText::BOLD_FLAG)
-                textRenderer->enableBold();
-            if (flags & RichElementText::UNDERLINE_FLAG)
-                textRenderer->enableUnderline();
-            if (flags & RichElementText::STRIKETHROUGH_FLAG)
-                textRenderer->enableStrikethrough();
-            if (flags & RichElementText::URL_FLAG)
-                textRenderer->addComponent(ListenerComponent::create(textRenderer,
-                                                                     url,
-                                                                     std::bind(&RichText::openUrl, this, std::placeholders::_1)));
-            if (flags & RichElementText::OUTLINE_FLAG)
-                textRenderer->enableOutline(Color4B(outlineColor), outlineSize);
-            if (flags & RichElementText::SHADOW_FLAG)
-                textRenderer->enableShadow(Color4B(shadowColor), shadowOffset, shadowBlurRadius);
-            if (flags & RichElementText::GLOW_FLAG)
-                textRenderer->enableGlow(Color4B(glowColor));
-
-            textRenderer->setTextColor(Color4B(color));
-            textRenderer->setOpacity(opacity);
-
-            // textRendererWidth will get 0.0f, when we've got glError: 0x0501 in Label::getContentSize
-            // It happens when currentText is very very long so that can't generate a texture
-            float textRendererWidth = textRenderer->getContentSize().width;
+            const int textLength = static_cast<int>(utf8Text.length());
+            Label* textRenderer = nullptr;
+            std::function<float(int)> measureText;
+            float textRendererWidth = 0.0f;
+            if (shapedRun)
+            {
+                measureText = [shapedRun, shapedOffset, textLength](int length) {
+                    return shapedRun->getWidth(shapedOffset, shapedOffset + std::min(length, textLength));
+                };
+                textRendererWidth = measureText(textLength);
+            }
+            else
+            {
+                textRenderer = createLabel(currentText);
+                measureText = [textRenderer, &utf8Text](int length) {
+                    textRenderer->setString(utf8Text.getAsCharSequence(0, length));
+                    return textRenderer->getContentSize().width;
+                };
+                // textRendererWidth will get 0.0f, when we've got glError: 0x0501 in Label::getContentSize
+                // It happens when currentText is very very long so that can't generate a texture
+                textRendererWidth = textRenderer->getContentSize().width;
+            }
 
             // no splitting
             if (textRendererWidth > 0.0f && _leftSpaceWidth >= textRendererWidth)
             {
                 _leftSpaceWidth -= textRendererWidth;
-                pushToContainer(textRenderer);
+                pushToContainer(shapedRun ? createShapedRenderer(*shapedRun, shapedOffset, textLength, currentText) : textRenderer);
                 break;
             }
 
@@ -1715,21 +2092,29 @@ void RichText::handleTextRenderer(const std::string& text, const std::string& fo
             //  (_leftSpaceWidth / fontSize) means how many chars can be aligned in leftSpaceWidth.
             int estimatedIdx = 0;
             if (textRendererWidth > 0.0f)
-                estimatedIdx = static_cast<int>(_leftSpaceWidth / textRendererWidth * utf8Text.length());
+                estimatedIdx = static_cast<int>(_leftSpaceWidth / textRendererWidth * textLength);
             else
                 estimatedIdx = static_cast<int>(_leftSpaceWidth / fontSize);
 
             int leftLength = 0;
             if (wrapMode == WRAP_PER_WORD)
-                leftLength = findSplitPositionForWord(textRenderer, utf8Text, estimatedIdx, _leftSpaceWidth, _customSize.width);
+                leftLength = findSplitPositionForWord(measureText, utf8Text, estimatedIdx, _leftSpaceWidth, _customSize.width);
             else
-                leftLength = findSplitPositionForChar(textRenderer, utf8Text, estimatedIdx, _leftSpaceWidth, _customSize.width);
+                leftLength = findSplitPositionForChar(measureText, utf8Text, estimatedIdx, _leftSpaceWidth, _customSize.width);
 
             // split string
             if (leftLength > 0)
             {
-                textRenderer->setString(utf8Text.getAsCharSequence(0, leftLength));
-                pushToContainer(textRenderer);
+                std::string leftStr = utf8Text.getAsCharSequence(0, leftLength);
+                if (shapedRun)
+                {
+                    pushToContainer(createShapedRenderer(*shapedRun, shapedOffset, leftLength, leftStr));
+                }
+                else
+                {
+                    textRenderer->setString(leftStr);
+                    pushToContainer(textRenderer);
+                }
             }
 
             StringUtils::StringUTF8::CharUTF8Store& str = utf8Text.getString();
@@ -1737,6 +2122,7 @@ void RichText::handleTextRenderer(const std::string& text, const std::string& fo
             // erase the chars which are processed
             str.erase(str.begin(), str.begin() + leftLength);
             currentText = utf8Text.getAsCharSequence();
+            shapedOffset += leftLength;
         }
     }
 }
@@ -1794,6 +2180,16 @@ void RichText::formatRenderers()
     float verticalSpace = _defaults[KEY_VERTICAL_SPACE].asFloat();
     float fontSize = _defaults[KEY_FONT_SIZE].asFloat();
 
+    // glyph runs are added after the other renderers and grouped by font atlas,
+    // so that the runs sharing a texture are merged into one draw call
+    std::vector<GlyphRunRenderer*> glyphRuns;
+    auto addRenderer = [this, &glyphRuns](Node* renderer) {
+        if (auto glyphRun = dynamic_cast<GlyphRunRenderer*>(renderer))
+            glyphRuns.push_back(glyphRun);
+        else
+            this->addProtectedChild(renderer, 1);
+    };
+
     if (_ignoreSize)
     {
         float newContentSizeWidth = 0.0f;
@@ -1808,7 +2204,7 @@ void RichText::formatRenderers()
             {
                 iter->setAnchorPoint(Vec2::ZERO);
                 iter->setPosition(nextPosX, nextPosY);
-                this->addProtectedChild(iter, 1);
+                addRenderer(iter);
                 Size iSize = iter->getContentSize();
                 newContentSizeWidth += iSize.width;
                 nextPosX += iSize.width;
@@ -1859,13 +2255,19 @@ void RichText::formatRenderers()
             {
                 iter->setAnchorPoint(Vec2::ZERO);
                 iter->setPosition(nextPosX, nextPosY);
-                this->addProtectedChild(iter, 1);
+                addRenderer(iter);
                 nextPosX += iter->getContentSize().width;
             }
             
             doHorizontalAlignment(row, nextPosX);
         }
     }
+
+    std::stable_sort(glyphRuns.begin(), glyphRuns.end(), [](GlyphRunRenderer* a, GlyphRunRenderer* b) {
+        return std::less<FontAtlas*>()(a->getFontAtlas(), b->getFontAtlas());
+    });
+    for (auto glyphRun : glyphRuns)
+        this->addProtectedChild(glyphRun, 1);
     
     _elementRenders.clear();
     _lineHeights.clear();
@@ -1924,6 +2326,9 @@ namespace {
 
 float RichText::stripTrailingWhitespace(const Vector<cocos2d::Node*>& row) {
     if ( !row.empty() ) {
+        if ( auto glyphRun = dynamic_cast<GlyphRunRenderer*>(row.back()) ) {
+            return glyphRun->trimTrailingWhitespace();
+        }
         if ( auto label = dynamic_cast<Label*>(row.back()) ) {
             const auto width = label->getContentSize().width;
             const auto trimmedString = rtrim(label->getString());
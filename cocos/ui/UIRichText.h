@@ -30,6 +30,8 @@
 #include "ui/GUIExport.h"
 #include "base/CCValue.h"
 
+#include <unordered_map>
+
 NS_CC_BEGIN
 /**
  * @addtogroup ui
@@ -37,6 +39,8 @@ NS_CC_BEGIN
  */
 
 class Label;
+class FontAtlas;
+class EventListenerCustom;
 
 namespace ui {
 
@@ -556,6 +560,23 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithXML(const std::string& xml, const ValueMap& defaults = ValueMap(), const OpenUrlHandler& handleOpenUrl = nullptr);
 
 protected:
+    /**
+     * Glyph advances of one line of TTF text, measured straight from the font atlas.
+     * Shaped runs are kept across re-layouts and dropped once a layout pass no longer uses them.
+     */
+    struct ShapedRun
+    {
+        FontAtlas* fontAtlas;           /*!< strong ref */
+        std::u32string utf32Text;
+        std::vector<float> offsets;     /*!< pen position before each char, the last entry is the pen position after the run */
+        std::vector<float> kernings;    /*!< kerning between each char and the next one */
+        float lineHeight;
+        unsigned int generation;        /*!< the last layout pass that used this run */
+
+        /** Width of the chars [start, end), the same as a Label showing only that part of the text. */
+        float getWidth(int start, int end) const;
+    };
+
     virtual void adaptRenderers() override;
 
     virtual void initRenderer() override;
@@ -571,12 +592,19 @@ protected:
     void addNewLine();
 	void doHorizontalAlignment(const Vector<Node*>& row, float rowWidth);
 	float stripTrailingWhitespace(const Vector<Node*>& row);
+    ShapedRun* shapeTextRun(const std::string& text, const std::string& fontName, float fontSize, uint32_t flags);
+    Node* createGlyphRunRenderer(const ShapedRun& run, int start, int length, const Color3B& color, uint32_t flags, const std::string& url);
+    void purgeShapedRuns(bool unusedOnly);
+    void onFontAtlasReset(FontAtlas* fontAtlas);
 
     bool _formatTextDirty;
     Vector<RichElement*> _richElements;
     std::vector<Vector<Node*>> _elementRenders;
     std::vector<float> _lineHeights;
     float _leftSpaceWidth;
+    std::unordered_map<std::string, ShapedRun> _shapedRuns;
+    unsigned int _formatGeneration;
+    EventListenerCustom* _fontAtlasResetListener;   /*!< strong ref */
 
     ValueMap _defaults;             /*!< default values */
     OpenUrlHandler _handleOpenUrl;  /*!< the callback for open URL */
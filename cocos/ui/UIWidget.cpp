@@ -290,6 +290,16 @@ LayoutComponent* Widget::getOrCreateLayoutComponent()
     return (LayoutComponent*)layoutComponent;
 }
 
+// Layouts arrange their children by size and layout parameter, so a change of either has to lay them out again.
+static void requestParentDoLayout(Node* parent)
+{
+    Layout* layout = dynamic_cast<Layout*>(parent);
+    if (layout && layout->getLayoutType() != Layout::Type::ABSOLUTE)
+    {
+        layout->requestDoLayout();
+    }
+}
+
 void Widget::setContentSize(const cocos2d::Size &contentSize)
 {
     Size previousSize = ProtectedNode::getContentSize();
@@ -333,6 +343,7 @@ void Widget::setContentSize(const cocos2d::Size &contentSize)
         _sizePercent.set(spx, spy);
     }
     onSizeChanged();
+    requestParentDoLayout(_parent);
 }
 
 void Widget::setSize(const Size &size)
@@ -1167,6 +1178,7 @@ void Widget::setLayoutParameter(LayoutParameter *parameter)
     }
     _layoutParameterDictionary.insert((int)parameter->getLayoutType(), parameter);
     _layoutParameterType = parameter->getLayoutType();
+    requestParentDoLayout(_parent);
 }
 
 LayoutParameter* Widget::getLayoutParameter()const
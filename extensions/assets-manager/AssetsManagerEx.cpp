@@ -28,13 +28,17 @@
 #include "base/CCDirector.h"
 
 #include <stdio.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 #ifdef MINIZIP_FROM_SYSTEM
 #include <minizip/unzip.h>
 #else // from our embedded sources
 #include "unzip.h"
 #endif
-#include "base/CCAsyncTaskPool.h"
 
 NS_CC_EXT_BEGIN
 
@@ -47,12 +51,82 @@ NS_CC_EXT_BEGIN
 #define MAX_FILENAME   512
 
 #define DEFAULT_CONNECTION_TIMEOUT 45
+#define DEFAULT_CHUNKS_PER_TASK 4
+#define MAX_DEFAULT_PROCESS_TASK 4
 
 #define SAVE_POINT_INTERVAL 0.1
 
 const std::string AssetsManagerEx::VERSION_ID = "@version";
 const std::string AssetsManagerEx::MANIFEST_ID = "@manifest";
 
+// Fixed set of threads running verification and decompression jobs in the order they were queued
+class AssetsManagerEx::WorkerPool
+{
+public:
+    explicit WorkerPool(int threadCount)
+    : _stop(false)
+    {
+        for (int i = 0; i < threadCount; ++i)
+        {
+            _threads.push_back(std::thread(&WorkerPool::threadLoop, this));
+        }
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+            _jobs.clear();
+        }
+        _condition.notify_all();
+        for (auto& thread : _threads)
+        {
+            thread.join();
+        }
+    }
+
+    void enqueue(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.push_back(std::move(job));
+        }
+        _condition.notify_one();
+    }
+
+private:
+    void threadLoop()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this] { return _stop || !_jobs.empty(); });
+                if (_stop)
+                    return;
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread> _threads;
+    std::deque<std::function<void()>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stop;
+};
+
+static int getDefaultProcessTaskCount()
+{
+    // Leave a core to the cocos thread, hardware_concurrency may also report 0 if it's unknown
+    int cores = (int)std::thread::hardware_concurrency();
+    return std::max(1, std::min(MAX_DEFAULT_PROCESS_TASK, cores - 1));
+}
+
 // Implementation of AssetsManagerEx
 
 AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::string& storagePath)
@@ -74,8 +148,10 @@ AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::stri
 , _nextSavePoint(0.0)
 , _maxConcurrentTask(32)
 , _currConcurrentTask(0)
+, _maxConcurrentProcessTask(getDefaultProcessTaskCount())
 , _versionCompareHandle(nullptr)
 , _verifyCallback(nullptr)
+, _verifyCallbackThreadSafe(false)
 , _inited(false)
 {
     // Init variables
@@ -88,7 +164,8 @@ AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::stri
     {
         static_cast<uint32_t>(_maxConcurrentTask),
         DEFAULT_CONNECTION_TIMEOUT,
-        ".tmp"
+        ".tmp",
+        DEFAULT_CHUNKS_PER_TASK
     };
     _downloader = std::shared_ptr<network::Downloader>(new network::Downloader(hints));
     _downloader->onTaskError = std::bind(&AssetsManagerEx::onError, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
@@ -116,6 +193,8 @@ AssetsManagerEx::~AssetsManagerEx()
     _downloader->onTaskError = (nullptr);
     _downloader->onFileTaskSuccess = (nullptr);
     _downloader->onTaskProgress = (nullptr);
+    // Pending jobs hold a reference to this manager, so the workers are idle by now
+    _workerPool.reset();
     CC_SAFE_RELEASE(_localManifest);
     // _tempManifest could share a ptr with _remoteManifest or _localManifest
     if (_tempManifest != _localManifest && _tempManifest != _remoteManifest)
@@ -445,10 +524,16 @@ bool AssetsManagerEx::decompress(const std::string &zip)
             } while(error > 0);
             
             fclose(out);
+            
+            // minizip checks the CRC of the entry once it has been read completely
+            if (unzCloseCurrentFile(zipfile) == UNZ_CRCERROR)
+            {
+                CCLOG("AssetsManagerEx : CRC mismatch in zip file %s\n", fileName);
+                unzClose(zipfile);
+                return false;
+            }
         }
         
-        unzCloseCurrentFile(zipfile);
-        
         // Goto next entry listed in the zip file.
         if ((i+1) < global_info.number_entry)
         {
@@ -467,41 +552,48 @@ bool AssetsManagerEx::decompress(const std::string &zip)
 
 void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const std::string &storagePath)
 {
-    struct AsyncData
+    processDownloadedAsset(customId, storagePath, Manifest::Asset(), false, true);
+}
+
+void AssetsManagerEx::processDownloadedAsset(const std::string &customId, const std::string &storagePath, const Manifest::Asset &asset, bool verify, bool compressed)
+{
+    if (!_workerPool)
     {
-        std::string customId;
-        std::string zipFile;
-        bool succeed;
-    };
+        _workerPool.reset(new (std::nothrow) WorkerPool(std::max(1, _maxConcurrentProcessTask)));
+    }
     
-    AsyncData* asyncData = new AsyncData;
-    asyncData->customId = customId;
-    asyncData->zipFile = storagePath;
-    asyncData->succeed = false;
+    // Released once the result has been reported on the cocos thread
+    retain();
     
-    std::function<void(void*)> decompressFinished = [this](void* param) {
-        auto dataInner = reinterpret_cast<AsyncData*>(param);
-        if (dataInner->succeed)
+    auto verifyCallback = _verifyCallback;
+    _workerPool->enqueue([this, customId, storagePath, asset, verify, compressed, verifyCallback]() {
+        bool verified = !verify || verifyCallback(storagePath, asset);
+        bool decompressed = true;
+        if (verified && compressed)
         {
-            fileSuccess(dataInner->customId, dataInner->zipFile);
+            decompressed = decompress(storagePath);
+            _fileUtils->removeFile(storagePath);
         }
-        else
-        {
-            std::string errorMsg = "Unable to decompress file " + dataInner->zipFile;
-            // Ensure zip file deletion (if decompress failure cause task thread exit anormally)
-            _fileUtils->removeFile(dataInner->zipFile);
-            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", errorMsg);
-            fileError(dataInner->customId, errorMsg);
-        }
-        delete dataInner;
-    };
-    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, std::move(decompressFinished), (void*)asyncData, [this, asyncData]() {
-        // Decompress all compressed files
-        if (decompress(asyncData->zipFile))
-        {
-            asyncData->succeed = true;
-        }
-        _fileUtils->removeFile(asyncData->zipFile);
+        
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, customId, storagePath, verified, decompressed]() {
+            if (!verified)
+            {
+                fileError(customId, "Asset file verification failed after downloaded");
+            }
+            else if (!decompressed)
+            {
+                std::string errorMsg = "Unable to decompress file " + storagePath;
+                // Ensure zip file deletion (if decompress failure cause task thread exit anormally)
+                _fileUtils->removeFile(storagePath);
+                dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", errorMsg);
+                fileError(customId, errorMsg);
+            }
+            else
+            {
+                fileSuccess(customId, storagePath);
+            }
+            release();
+        });
     });
 }
 
@@ -1094,33 +1186,35 @@ void AssetsManagerEx::onSuccess(const std::string &/*srcUrl*/, const std::string
     }
     else
     {
-        bool ok = true;
         auto &assets = _remoteManifest->getAssets();
         auto assetIt = assets.find(customId);
-        if (assetIt != assets.end())
+        if (assetIt == assets.end())
         {
-            Manifest::Asset asset = assetIt->second;
-            if (_verifyCallback != nullptr)
-            {
-                ok = _verifyCallback(storagePath, asset);
-            }
+            fileSuccess(customId, storagePath);
+            return;
         }
         
-        if (ok)
+        const Manifest::Asset& asset = assetIt->second;
+        bool verify = _verifyCallback != nullptr;
+        if (verify && !_verifyCallbackThreadSafe)
         {
-            bool compressed = assetIt != assets.end() ? assetIt->second.compressed : false;
-            if (compressed)
-            {
-                decompressDownloadedZip(customId, storagePath);
-            }
-            else
+            // Script callbacks can only be invoked on the cocos thread
+            if (!_verifyCallback(storagePath, asset))
             {
-                fileSuccess(customId, storagePath);
+                fileError(customId, "Asset file verification failed after downloaded");
+                return;
             }
+            verify = false;
+        }
+        
+        if (verify || asset.compressed)
+        {
+            // Processed while the remaining assets keep downloading
+            processDownloadedAsset(customId, storagePath, asset, verify, asset.compressed);
         }
         else
         {
-            fileError(customId, "Asset file verification failed after downloaded");
+            fileSuccess(customId, storagePath);
         }
     }
 }
@@ -27,6 +27,7 @@
 #define __AssetsManagerEx__
 
 #include <string>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -117,6 +118,15 @@ public:
      */
     void setMaxConcurrentTask(const int max) {_maxConcurrentTask = max;};
     
+    /** @brief Function for retrieving the number of worker threads verifying and decompressing downloaded assets
+     */
+    int getMaxConcurrentProcessTask() const {return _maxConcurrentProcessTask;};
+    
+    /** @brief Function for setting the number of worker threads verifying and decompressing downloaded assets,
+     *         it needs to be set before the first downloaded asset gets processed
+     */
+    void setMaxConcurrentProcessTask(const int max) {_maxConcurrentProcessTask = max;};
+    
     /** @brief Set the handle function for comparing manifests versions
      * @param handle    The compare function
      */
@@ -125,7 +135,14 @@ public:
     /** @brief Set the verification function for checking whether downloaded asset is correct, e.g. using md5 verification
      * @param callback  The verify callback function
      */
-    void setVerifyCallback(const std::function<bool(const std::string& path, Manifest::Asset asset)>& callback) {_verifyCallback = callback;};
+    void setVerifyCallback(const std::function<bool(const std::string& path, Manifest::Asset asset)>& callback) {_verifyCallback = callback; _verifyCallbackThreadSafe = false;};
+    
+    /** @brief Set the verification function for checking whether downloaded asset is correct
+     * @param callback      The verify callback function
+     * @param threadSafe    Whether the callback can be invoked from worker threads. If so, assets are verified
+     *                      on the worker threads that decompress them, otherwise on the cocos thread.
+     */
+    void setVerifyCallback(const std::function<bool(const std::string& path, Manifest::Asset asset)>& callback, bool threadSafe) {_verifyCallback = callback; _verifyCallbackThreadSafe = threadSafe;};
     
 CC_CONSTRUCTOR_ACCESS:
     
@@ -160,6 +177,10 @@ protected:
     bool decompress(const std::string &filename);
     void decompressDownloadedZip(const std::string &customId, const std::string &storagePath);
     
+    /** @brief Verify and/or decompress a downloaded asset on the worker threads, the result is reported on the cocos thread
+     */
+    void processDownloadedAsset(const std::string &customId, const std::string &storagePath, const Manifest::Asset &asset, bool verify, bool compressed);
+    
     /** @brief Update a list of assets under the current AssetsManagerEx context
      */
     void updateAssets(const DownloadUnits& assets);
@@ -215,6 +236,8 @@ protected:
     virtual void onSuccess(const std::string &srcUrl, const std::string &storagePath, const std::string &customId);
     
 private:
+    class WorkerPool;
+    
     void batchDownload();
 
     // Called when one DownloadUnits finished
@@ -286,9 +309,15 @@ private:
     //! Max concurrent task count for downloading
     int _maxConcurrentTask;
     
-    //! Current concurrent task count
+    //! Current concurrent task count, an asset keeps its slot until it has been verified and decompressed
     int _currConcurrentTask;
     
+    //! Worker thread count for verifying and decompressing
+    int _maxConcurrentProcessTask;
+    
+    //! Worker threads for verifying and decompressing, created when the first asset needs them
+    std::unique_ptr<WorkerPool> _workerPool;
+    
     //! Download percent
     float _percent;
     
@@ -320,6 +349,9 @@ private:
     //! Callback function to verify the downloaded assets
     std::function<bool(const std::string& path, Manifest::Asset asset)> _verifyCallback;
     
+    //! Whether the verify callback can run on worker threads
+    bool _verifyCallbackThreadSafe;
+    
     //! Marker for whether the assets manager is inited
     bool _inited;
 };
@@ -485,3 +485,111 @@ void TestCase::onBackCallback(Ref* sender)
         _testSuite->backsUpOneLevel();
     }
 }
+
+//FrameTimer
+FrameTimer::FrameTimer()
+: _framesPerReport(60)
+, _frames(0)
+, _nextEvent(0)
+{
+}
+
+FrameTimer::~FrameTimer()
+{
+    stop();
+}
+
+void FrameTimer::start(const std::vector<std::string>& events, const std::function<void()>& onReport, int framesPerReport)
+{
+    CCASSERT(events.size() >= 2, "FrameTimer needs the events at the start and at the end of a span");
+    stop();
+
+    _onReport = onReport;
+    _framesPerReport = framesPerReport;
+    _totalTimes.assign(events.size() - 1, 0.0);
+    _maxTimes.assign(events.size() - 1, 0.0);
+    _nextEvent = 0;
+    reset();
+
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    for (int i = 0; i < (int)events.size(); ++i)
+    {
+        _listeners.push_back(dispatcher->addCustomEventListener(events[i], [this, i](EventCustom*) {
+            onEvent(i);
+        }));
+    }
+}
+
+void FrameTimer::stop()
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    for (auto listener : _listeners)
+    {
+        dispatcher->removeEventListener(listener);
+    }
+    _listeners.clear();
+}
+
+void FrameTimer::reset()
+{
+    std::fill(_totalTimes.begin(), _totalTimes.end(), 0.0);
+    std::fill(_maxTimes.begin(), _maxTimes.end(), 0.0);
+    _frames = 0;
+}
+
+void FrameTimer::setFrameCallbacks(const std::function<void()>& onFrameBegin, const std::function<void()>& onFrameEnd)
+{
+    _onFrameBegin = onFrameBegin;
+    _onFrameEnd = onFrameEnd;
+}
+
+double FrameTimer::getAverageTime(int span) const
+{
+    return _frames > 0 ? _totalTimes[span] / _frames : 0.0;
+}
+
+double FrameTimer::getMaxTime(int span) const
+{
+    return _maxTimes[span];
+}
+
+void FrameTimer::onEvent(int index)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (index == 0)
+    {
+        if (_onFrameBegin)
+        {
+            _onFrameBegin();
+        }
+    }
+    else if (index == _nextEvent)
+    {
+        double time = std::chrono::duration<double, std::milli>(now - _lastEventTime).count();
+        _totalTimes[index - 1] += time;
+        _maxTimes[index - 1] = std::max(_maxTimes[index - 1], time);
+    }
+    else
+    {
+        return;
+    }
+    _lastEventTime = now;
+    _nextEvent = index + 1;
+
+    if (_nextEvent == (int)_listeners.size())
+    {
+        _nextEvent = 0;
+        if (_onFrameEnd)
+        {
+            _onFrameEnd();
+        }
+        if (++_frames == _framesPerReport)
+        {
+            if (_onReport)
+            {
+                _onReport();
+            }
+            reset();
+        }
+    }
+}
@@ -26,6 +26,7 @@
 #ifndef _CPPTESTS_BASETEST_H__
 #define _CPPTESTS_BASETEST_H__
 
+#include <chrono>
 #include "cocos2d.h"
 #include "extensions/cocos-ext.h"
 #include "VisibleRect.h"
@@ -202,6 +203,49 @@ private:
     friend class TestController;
 };
 
+/**
+ * Measures parts of every frame for the performance test cases.
+ * The time between two consecutive events passed to start() is one span. Every framesPerReport frames
+ * the report callback runs, it can read the average and maximum time of each span before they are reset.
+ */
+class FrameTimer
+{
+public:
+    FrameTimer();
+    ~FrameTimer();
+
+    /**
+     * Starts listening to the director events, e.g. { Director::EVENT_BEFORE_UPDATE, Director::EVENT_AFTER_UPDATE }.
+     * @param onReport Called every framesPerReport frames.
+     */
+    void start(const std::vector<std::string>& events, const std::function<void()>& onReport, int framesPerReport = 60);
+    /** Removes the listeners, call it from onExit. */
+    void stop();
+    /** Drops the frames measured since the last report, e.g. after a setting of the test changed. */
+    void reset();
+
+    /** Extra work done with the first and the last event of every frame, e.g. to collect stats of the frame. */
+    void setFrameCallbacks(const std::function<void()>& onFrameBegin, const std::function<void()>& onFrameEnd);
+
+    int getFrames() const { return _frames; }
+    /** Average and maximum time of a span in milliseconds. */
+    double getAverageTime(int span = 0) const;
+    double getMaxTime(int span = 0) const;
+
+private:
+    void onEvent(int index);
+
+    std::vector<cocos2d::EventListenerCustom*> _listeners;
+    std::chrono::steady_clock::time_point _lastEventTime;
+    std::vector<double> _totalTimes;
+    std::vector<double> _maxTimes;
+    std::function<void()> _onFrameBegin;
+    std::function<void()> _onFrameEnd;
+    std::function<void()> _onReport;
+    int _framesPerReport;
+    int _frames;
+    int _nextEvent; // events seen out of order, e.g. when started in the middle of a frame, are ignored
+};
 
 #define ADD_TEST(__className__) addTest( #__className__, [](){ return new (std::nothrow) __className__;} );
 
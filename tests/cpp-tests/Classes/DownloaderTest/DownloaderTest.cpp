@@ -32,6 +32,20 @@
 #include "ui/UIButton.h"
 #include "network/CCDownloader.h"
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
 USING_NS_CC;
 
 static const char* sURLList[] =
@@ -365,8 +379,365 @@ struct DownloaderMultiTask : public TestCase
     }
 };
 
+// Minimal HTTP/1.1 server on 127.0.0.1 serving a generated file with range support,
+// it can drop the first connections in the middle of the body to interrupt a download
+class LocalRangeServer
+{
+public:
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    typedef SOCKET Socket;
+#else
+    typedef int Socket;
+    static const Socket INVALID_SOCKET = -1;
+#endif
+
+    static const int64_t FILE_SIZE = 24 * 1024 * 1024;
+
+    static unsigned char byteAt(int64_t offset)
+    {
+        return (unsigned char)((offset * 7) ^ (offset >> 12));
+    }
+
+    LocalRangeServer()
+    : _listenSocket(INVALID_SOCKET)
+    , _port(0)
+    , _bytesSent(0)
+    , _requestCount(0)
+    , _dropAfter(0)
+    , _dropCount(0)
+    {
+    }
+
+    ~LocalRangeServer()
+    {
+        stop();
+    }
+
+    bool start()
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        WSADATA wsaData;
+        WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+        _listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (_listenSocket == INVALID_SOCKET)
+        {
+            return false;
+        }
+
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (bind(_listenSocket, (sockaddr*)&address, sizeof(address)) != 0
+            || listen(_listenSocket, 16) != 0
+            || getsockname(_listenSocket, (sockaddr*)&address, &length) != 0)
+        {
+            closeSocket(_listenSocket);
+            _listenSocket = INVALID_SOCKET;
+            return false;
+        }
+        _port = ntohs(address.sin_port);
+
+        _acceptThread = std::thread(&LocalRangeServer::acceptLoop, this);
+        return true;
+    }
+
+    void stop()
+    {
+        if (_listenSocket == INVALID_SOCKET)
+        {
+            return;
+        }
+
+        shutdown(_listenSocket, 2);
+        closeSocket(_listenSocket);
+        _listenSocket = INVALID_SOCKET;
+        _acceptThread.join();
+
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto client : _clientSockets)
+            {
+                shutdown(client, 2);
+            }
+            threads.swap(_clientThreads);
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        WSACleanup();
+#endif
+    }
+
+    // the next count GET responses are cut after bytes bytes of body
+    void dropConnections(int count, int64_t bytes)
+    {
+        _dropAfter = bytes;
+        _dropCount = count;
+    }
+
+    void resetStats()
+    {
+        _bytesSent = 0;
+        _requestCount = 0;
+    }
+
+    int getPort() const { return _port; }
+    int64_t getBytesSent() const { return _bytesSent; }
+    int getRequestCount() const { return _requestCount; }
+
+private:
+    static void closeSocket(Socket s)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        closesocket(s);
+#else
+        close(s);
+#endif
+    }
+
+    void acceptLoop()
+    {
+        while (true)
+        {
+            Socket client = accept(_listenSocket, nullptr, nullptr);
+            if (client == INVALID_SOCKET)
+            {
+                break;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _clientSockets.push_back(client);
+            _clientThreads.push_back(std::thread(&LocalRangeServer::serveConnection, this, client));
+        }
+    }
+
+    static std::string getHeaderValue(const std::string& header, const char* name)
+    {
+        size_t field = header.find(name);
+        if (field == std::string::npos)
+        {
+            return "";
+        }
+        size_t begin = field + strlen(name);
+        return header.substr(begin, header.find("\r\n", begin) - begin);
+    }
+
+    bool sendBody(Socket client, int64_t first, int64_t last)
+    {
+        char data[16 * 1024];
+        int64_t limit = last + 1;
+        if (_dropCount > 0)
+        {
+            --_dropCount;
+            limit = std::min(limit, first + (int64_t)_dropAfter);
+        }
+
+        for (int64_t offset = first; offset < limit;)
+        {
+            int size = (int)std::min((int64_t)sizeof(data), limit - offset);
+            for (int i = 0; i < size; ++i)
+            {
+                data[i] = (char)byteAt(offset + i);
+            }
+            int sent = (int)send(client, data, size, 0);
+            if (sent <= 0)
+            {
+                return false;
+            }
+            offset += sent;
+            _bytesSent += sent;
+        }
+        return limit == last + 1;
+    }
+
+    void serveConnection(Socket client)
+    {
+        static const char ETAG[] = "\"range-test-v1\"";
+        std::string buffer;
+        char data[4096];
+
+        while (true)
+        {
+            size_t headerEnd = buffer.find("\r\n\r\n");
+            if (headerEnd == std::string::npos)
+            {
+                int received = (int)recv(client, data, sizeof(data), 0);
+                if (received <= 0)
+                {
+                    break;
+                }
+                buffer.append(data, received);
+                continue;
+            }
+            std::string header = buffer.substr(0, headerEnd + 2);
+            buffer.erase(0, headerEnd + 4);
+
+            bool isHead = header.compare(0, 5, "HEAD ") == 0;
+            int64_t first = 0;
+            int64_t last = FILE_SIZE - 1;
+            std::string range = getHeaderValue(header, "\r\nRange: bytes=");
+            std::string ifRange = getHeaderValue(header, "\r\nIf-Range: ");
+            bool partial = !range.empty() && (ifRange.empty() || ifRange == ETAG);
+            if (partial)
+            {
+                first = atoll(range.c_str());
+                size_t dash = range.find('-');
+                if (dash + 1 < range.size())
+                {
+                    last = std::min(last, (int64_t)atoll(range.c_str() + dash + 1));
+                }
+            }
+
+            std::string response = StringUtils::format("HTTP/1.1 %s\r\nAccept-Ranges: bytes\r\nETag: %s\r\nContent-Length: %lld\r\n",
+                                                       partial ? "206 Partial Content" : "200 OK", ETAG, (long long)(last - first + 1));
+            if (partial)
+            {
+                response += StringUtils::format("Content-Range: bytes %lld-%lld/%lld\r\n", (long long)first, (long long)last, (long long)FILE_SIZE);
+            }
+            response += "\r\n";
+            if (send(client, response.data(), (int)response.size(), 0) <= 0)
+            {
+                break;
+            }
+            if (!isHead)
+            {
+                ++_requestCount;
+                if (!sendBody(client, first, last))
+                {
+                    break;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _clientSockets.erase(std::find(_clientSockets.begin(), _clientSockets.end(), client));
+        closeSocket(client);
+    }
+
+    Socket _listenSocket;
+    int _port;
+    std::atomic<int64_t> _bytesSent;
+    std::atomic<int> _requestCount;
+    std::atomic<int64_t> _dropAfter;
+    std::atomic<int> _dropCount;
+    std::thread _acceptThread;
+    std::mutex _mutex;
+    std::vector<Socket> _clientSockets;
+    std::vector<std::thread> _clientThreads;
+};
+
+struct DownloaderChunkedTask : public TestCase
+{
+    CREATE_FUNC(DownloaderChunkedTask);
+
+    virtual std::string title() const override { return "Downloader Chunked Task"; }
+    virtual std::string subtitle() const override { return "24 MB file over 4 connections, interrupted then resumed"; }
+
+    std::unique_ptr<network::Downloader> downloader;
+    LocalRangeServer server;
+    Label* label;
+    std::string path;
+    int attempts;
+
+    DownloaderChunkedTask()
+    : label(nullptr)
+    , attempts(0)
+    {
+        network::DownloaderHints hints = {6, 60, ".tmp", 4};
+        downloader.reset(new network::Downloader(hints));
+        path = FileUtils::getInstance()->getWritablePath() + "CppTests/DownloaderTest/chunked.bin";
+    }
+
+    virtual ~DownloaderChunkedTask()
+    {
+        downloader.reset();
+        server.stop();
+    }
+
+    void download()
+    {
+        ++attempts;
+        downloader->createDownloadFileTask(StringUtils::format("http://127.0.0.1:%d/chunked.bin", server.getPort()), path, "chunked");
+    }
+
+    bool verify()
+    {
+        Data data = FileUtils::getInstance()->getDataFromFile(path);
+        if (data.getSize() != LocalRangeServer::FILE_SIZE)
+        {
+            return false;
+        }
+        for (ssize_t i = 0; i < data.getSize(); ++i)
+        {
+            if (data.getBytes()[i] != LocalRangeServer::byteAt(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    virtual void onEnter() override
+    {
+        TestCase::onEnter();
+
+        auto winSize = Director::getInstance()->getWinSize();
+        label = Label::createWithTTF("", "fonts/arial.ttf", 18);
+        label->setPosition(winSize.width / 2, winSize.height / 2);
+        addChild(label);
+
+        if (!server.start())
+        {
+            label->setString("Failed to start the local server");
+            return;
+        }
+
+        // every connection is cut after 2 MB on the first try, the second try only downloads the missing bytes
+        FileUtils::getInstance()->removeFile(path);
+        server.dropConnections(4, 2 * 1024 * 1024);
+        download();
+
+        downloader->onTaskProgress = [this](const network::DownloadTask& task,
+                                            int64_t bytesReceived,
+                                            int64_t totalBytesReceived,
+                                            int64_t totalBytesExpected)
+        {
+            label->setString(StringUtils::format("try %d: %lld of %lld bytes", attempts, (long long)totalBytesReceived, (long long)totalBytesExpected));
+        };
+
+        downloader->onFileTaskSuccess = [this](const network::DownloadTask& task)
+        {
+            label->setString(StringUtils::format("%s after %d tries\n%lld bytes sent by the server in %d requests for a %lld bytes file",
+                                                 verify() ? "Downloaded" : "Corrupted file", attempts,
+                                                 (long long)server.getBytesSent(), server.getRequestCount(), (long long)LocalRangeServer::FILE_SIZE));
+        };
+
+        downloader->onTaskError = [this](const network::DownloadTask& task, int errorCode, int errorCodeInternal, const std::string& errorStr)
+        {
+            log("downloader chunked task interrupted: %s", errorStr.c_str());
+            if (attempts < 3)
+            {
+                // the failed task still holds the temp file until this callback returns
+                scheduleOnce([this](float) { download(); }, 0.5f, "retry");
+            }
+            else
+            {
+                label->setString(StringUtils::format("Failed: %s", errorStr.c_str()));
+            }
+        };
+    }
+};
+
 DownloaderTests::DownloaderTests()
 {
     ADD_TEST_CASE(DownloaderTest);
     ADD_TEST_CASE(DownloaderMultiTask);
+    ADD_TEST_CASE(DownloaderChunkedTask);
 }
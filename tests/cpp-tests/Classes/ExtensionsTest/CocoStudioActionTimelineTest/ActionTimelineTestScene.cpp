@@ -0,0 +1,415 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ActionTimelineTestScene.h"
+#include <chrono>
+#include "editor-support/cocostudio/ActionTimeline/CSLoader.h"
+#include "editor-support/cocostudio/ActionTimeline/CCActionTimeline.h"
+#include "editor-support/cocostudio/CCComExtensionData.h"
+#include "editor-support/cocostudio/FlatBuffersSerialize.h"
+
+USING_NS_CC;
+using namespace cocostudio;
+using namespace cocostudio::timeline;
+
+static const int POPUP_ROW_COUNT = 41;
+static const int CREATE_REPEAT = 20;
+static const float POPUP_WIDTH = 420;
+static const float POPUP_HEIGHT = 560;
+static const int WIDGET_COUNT = 300;
+static const int WIDGET_ACTION_TAG = 1000;
+
+CocoStudioActionTimelineTests::CocoStudioActionTimelineTests()
+{
+    ADD_TEST_CASE(TestCSLoaderCache);
+    ADD_TEST_CASE(TestTimelineChannels);
+}
+
+static std::string csdHeader(const char* type, const char* name)
+{
+    std::string xml = "<GameProjectFile>\n";
+    xml += StringUtils::format("  <PropertyGroup Type=\"%s\" Name=\"%s\" Version=\"3.10.0.0\" />\n", type, name);
+    xml += "  <Content ctype=\"GameProjectContent\">\n    <Content>\n";
+    xml += "      <Animation Duration=\"0\" Speed=\"1.0000\" />\n";
+    return xml;
+}
+
+static std::string csdFooter()
+{
+    return "    </Content>\n  </Content>\n</GameProjectFile>\n";
+}
+
+static std::string csdNode(const char* ctype, const std::string& name, float x, float y, const std::string& attributes, const std::string& elements)
+{
+    std::string xml = StringUtils::format("<AbstractNodeData Name=\"%s\" %s ctype=\"%s\">", name.c_str(), attributes.c_str(), ctype);
+    xml += StringUtils::format("<Position X=\"%.1f\" Y=\"%.1f\" /><Scale ScaleX=\"1.0000\" ScaleY=\"1.0000\" /><CColor A=\"255\" R=\"255\" G=\"255\" B=\"255\" />", x, y);
+    xml += elements;
+    return xml;
+}
+
+// One list row of a popup: a panel holding images, sprites, texts and a button, 12 nodes in total
+// counting the project node which nests it.
+static std::string generateRowCsd()
+{
+    std::string xml = csdHeader("Node", "Row");
+    xml += "      <ObjectData Name=\"Row\" Tag=\"1\" ctype=\"GameNodeObjectData\"><Size X=\"0.0000\" Y=\"0.0000\" /><Children>";
+    xml += csdNode("PanelObjectData", "Panel", 0, 0, "TouchEnable=\"True\" BackColorAlpha=\"40\" ComboBoxIndex=\"1\"",
+                   "<Size X=\"400.0000\" Y=\"12.0000\" /><SingleColor A=\"255\" R=\"150\" G=\"200\" B=\"255\" /><Children>");
+    xml += csdNode("ImageViewObjectData", "Icon", 6, 6, "", "<Size X=\"10.0000\" Y=\"10.0000\" /><FileData Type=\"Normal\" Path=\"Images/r1.png\" /></AbstractNodeData>");
+    xml += csdNode("SpriteObjectData", "Avatar", 20, 6, "", "<FileData Type=\"Normal\" Path=\"Images/grossini.png\" /></AbstractNodeData>");
+    xml += csdNode("TextObjectData", "Name", 80, 6, "FontSize=\"10\" LabelText=\"Player name\"", "<Size X=\"60.0000\" Y=\"12.0000\" /></AbstractNodeData>");
+    xml += csdNode("TextObjectData", "Level", 150, 6, "FontSize=\"10\" LabelText=\"Lv. 12\"", "<Size X=\"30.0000\" Y=\"12.0000\" /></AbstractNodeData>");
+    xml += csdNode("TextObjectData", "Score", 210, 6, "FontSize=\"10\" LabelText=\"123456\"", "<Size X=\"40.0000\" Y=\"12.0000\" /></AbstractNodeData>");
+    xml += csdNode("SpriteObjectData", "Badge1", 260, 6, "", "<FileData Type=\"Normal\" Path=\"Images/blocks.png\" /></AbstractNodeData>");
+    xml += csdNode("SpriteObjectData", "Badge2", 280, 6, "", "<FileData Type=\"Normal\" Path=\"Images/blocks.png\" /></AbstractNodeData>");
+    xml += csdNode("ImageViewObjectData", "Flag", 300, 6, "", "<Size X=\"10.0000\" Y=\"10.0000\" /><FileData Type=\"Normal\" Path=\"Images/r1.png\" /></AbstractNodeData>");
+    xml += csdNode("ButtonObjectData", "Invite", 360, 6, "TouchEnable=\"True\" FontSize=\"10\" ButtonText=\"Invite\"",
+                   "<Size X=\"40.0000\" Y=\"12.0000\" /><NormalFileData Type=\"Normal\" Path=\"Images/btn-play-normal.png\" /></AbstractNodeData>");
+    xml += "</Children></AbstractNodeData></Children></ObjectData>\n";
+    xml += csdFooter();
+    return xml;
+}
+
+static std::string generatePopupCsd(const std::string& rowCsdPath)
+{
+    std::string xml = csdHeader("Layer", "Popup");
+    std::string size = StringUtils::format("<Size X=\"%.4f\" Y=\"%.4f\" />", POPUP_WIDTH, POPUP_HEIGHT);
+    xml += "      <ObjectData Name=\"Popup\" Tag=\"1\" ctype=\"GameLayerObjectData\">" + size + "<Children>";
+    xml += csdNode("PanelObjectData", "Background", 0, 0, "BackColorAlpha=\"160\" ComboBoxIndex=\"1\"",
+                   size + "<SingleColor A=\"255\" R=\"20\" G=\"20\" B=\"60\" /></AbstractNodeData>");
+    xml += csdNode("TextObjectData", "Title", POPUP_WIDTH / 2, POPUP_HEIGHT - 15, "FontSize=\"14\" LabelText=\"Friends\"", "<Size X=\"80.0000\" Y=\"16.0000\" /></AbstractNodeData>");
+    for (int i = 0; i < POPUP_ROW_COUNT; ++i)
+    {
+        xml += csdNode("ProjectNodeObjectData", StringUtils::format("Row%d", i), 10, POPUP_HEIGHT - 30 - i * 13, "InnerActionSpeed=\"1.0000\"",
+                       "<FileData Type=\"Normal\" Path=\"" + rowCsdPath + "\" /></AbstractNodeData>");
+    }
+    xml += "</Children></ObjectData>\n";
+    xml += csdFooter();
+    return xml;
+}
+
+static int countNodes(Node* node)
+{
+    int count = 1;
+    for (auto child : node->getChildren())
+    {
+        count += countNodes(child);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------
+//
+// TestCSLoaderCache
+//
+//------------------------------------------------------------------
+TestCSLoaderCache::TestCSLoaderCache()
+: _popup(nullptr)
+, _resultLabel(nullptr)
+, _countLabel(nullptr)
+{
+}
+
+bool TestCSLoaderCache::init()
+{
+    if (!TestCase::init())
+    {
+        return false;
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _resultLabel->setPosition(Vec2(s.width / 2, s.height - 80));
+    addChild(_resultLabel, 1);
+
+    _countLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _countLabel->setPosition(Vec2(s.width / 2, s.height - 100));
+    addChild(_countLabel, 1);
+
+    MenuItemFont::setFontSize(16);
+    auto item = MenuItemFont::create("Run again", CC_CALLBACK_1(TestCSLoaderCache::runBenchmark, this));
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height - 125));
+    addChild(menu, 1);
+
+    return true;
+}
+
+void TestCSLoaderCache::onEnter()
+{
+    TestCase::onEnter();
+
+    if (!prepareFiles())
+    {
+        _resultLabel->setString("Can't write the layout files to the writable path");
+        return;
+    }
+    runBenchmark(nullptr);
+}
+
+void TestCSLoaderCache::onExit()
+{
+    auto loader = CSLoader::getInstance();
+    loader->removeFlatBuffersCache(_rowPath);
+    loader->removeFlatBuffersCache(_popupPath);
+    loader->setFlatBuffersCacheEnabled(true);
+
+    TestCase::onExit();
+}
+
+std::string TestCSLoaderCache::title() const
+{
+    return "CSLoader Cache";
+}
+
+std::string TestCSLoaderCache::subtitle() const
+{
+    return "Creating a popup of about 500 nodes with and without the .csb cache";
+}
+
+bool TestCSLoaderCache::prepareFiles()
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string rowCsd = fileUtils->getWritablePath() + "CSLoaderCacheRow.csd";
+    std::string popupCsd = fileUtils->getWritablePath() + "CSLoaderCachePopup.csd";
+    _rowPath = fileUtils->getWritablePath() + "CSLoaderCacheRow.csb";
+    _popupPath = fileUtils->getWritablePath() + "CSLoaderCachePopup.csb";
+
+    if (!fileUtils->writeStringToFile(generateRowCsd(), rowCsd)
+        || !fileUtils->writeStringToFile(generatePopupCsd(rowCsd), popupCsd))
+    {
+        return false;
+    }
+
+    // serializeFlatBuffersWithXMLFile returns an error message, empty on success
+    auto serializer = FlatBuffersSerialize::getInstance();
+    return serializer->serializeFlatBuffersWithXMLFile(rowCsd, _rowPath).empty()
+        && serializer->serializeFlatBuffersWithXMLFile(popupCsd, _popupPath).empty();
+}
+
+void TestCSLoaderCache::runBenchmark(Ref* sender)
+{
+    using namespace std::chrono;
+    auto loader = CSLoader::getInstance();
+
+    // the first load also creates the textures, keep it out of the measurements
+    CSLoader::createNode(_popupPath);
+
+    auto measure = [this](int repeat) {
+        double total = 0;
+        for (int i = 0; i < repeat; ++i)
+        {
+            auto start = steady_clock::now();
+            CSLoader::createNode(_popupPath);
+            total += duration<double, std::milli>(steady_clock::now() - start).count();
+        }
+        return total / repeat;
+    };
+
+    loader->setFlatBuffersCacheEnabled(false);
+    double uncachedTime = measure(CREATE_REPEAT);
+
+    loader->setFlatBuffersCacheEnabled(true);
+    double firstTime = measure(1);
+    double cachedTime = measure(CREATE_REPEAT);
+
+    char text[160];
+    snprintf(text, sizeof(text), "Cache off: %.2f ms, cache on: first %.2f ms, then %.2f ms per popup",
+             uncachedTime, firstTime, cachedTime);
+    _resultLabel->setString(text);
+    CCLOG("TestCSLoaderCache: %s", text);
+
+    if (_popup)
+    {
+        _popup->removeFromParent();
+    }
+    _popup = CSLoader::createNode(_popupPath);
+    if (_popup)
+    {
+        auto s = Director::getInstance()->getWinSize();
+        _popup->setScale(std::min(1.0f, (s.height - 150) / POPUP_HEIGHT));
+        _popup->setPosition(Vec2((s.width - POPUP_WIDTH * _popup->getScale()) / 2, 10));
+        addChild(_popup);
+        _countLabel->setString(StringUtils::format("%d nodes per popup", countNodes(_popup)));
+    }
+}
+
+//------------------------------------------------------------------
+//
+// TestTimelineChannels
+//
+//------------------------------------------------------------------
+
+// The kind of action a HUD widget runs: a bounce with easings, a pulse, a wobble, a fade,
+// a color that stays the same and a visibility key.
+static ActionTimeline* createWidgetAction()
+{
+    const int duration = 60;
+    auto action = ActionTimeline::create();
+    action->setDuration(duration);
+
+    auto position = Timeline::create();
+    const float heights[] = { 0, 12, 4, 0 };
+    for (int i = 0; i < 4; ++i)
+    {
+        auto frame = PositionFrame::create();
+        frame->setFrameIndex(i * duration / 3);
+        frame->setPosition(Vec2(0, heights[i]));
+        frame->setTweenType(i % 2 ? tweenfunc::Bounce_EaseOut : tweenfunc::Sine_EaseInOut);
+        position->addFrame(frame);
+    }
+
+    auto scale = Timeline::create();
+    auto rotation = Timeline::create();
+    auto alpha = Timeline::create();
+    for (int i = 0; i <= 2; ++i)
+    {
+        auto scaleFrame = ScaleFrame::create();
+        scaleFrame->setFrameIndex(i * duration / 2);
+        scaleFrame->setScale(i == 1 ? 0.6f : 0.5f);
+        scale->addFrame(scaleFrame);
+
+        auto rotationFrame = RotationSkewFrame::create();
+        rotationFrame->setFrameIndex(i * duration / 2);
+        rotationFrame->setSkewX(i == 1 ? 10 : -10);
+        rotationFrame->setSkewY(i == 1 ? 10 : -10);
+        rotationFrame->setTweenType(tweenfunc::Quad_EaseInOut);
+        rotation->addFrame(rotationFrame);
+
+        auto alphaFrame = AlphaFrame::create();
+        alphaFrame->setFrameIndex(i * duration / 2);
+        alphaFrame->setAlpha(i == 1 ? 128 : 255);
+        alpha->addFrame(alphaFrame);
+    }
+
+    auto color = Timeline::create();
+    auto visible = Timeline::create();
+    for (int i = 0; i <= 1; ++i)
+    {
+        auto colorFrame = ColorFrame::create();
+        colorFrame->setFrameIndex(i * duration);
+        colorFrame->setColor(Color3B(255, 220, 180));
+        color->addFrame(colorFrame);
+
+        auto visibleFrame = VisibleFrame::create();
+        visibleFrame->setFrameIndex(i * duration);
+        visibleFrame->setVisible(true);
+        visible->addFrame(visibleFrame);
+    }
+
+    for (auto timeline : { position, scale, rotation, alpha, color, visible })
+    {
+        timeline->setActionTag(WIDGET_ACTION_TAG);
+        action->addTimeline(timeline);
+    }
+    return action;
+}
+
+TestTimelineChannels::TestTimelineChannels()
+: _updateLabel(nullptr)
+, _channelsItem(nullptr)
+{
+}
+
+bool TestTimelineChannels::init()
+{
+    if (!TestCase::init())
+    {
+        return false;
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _updateLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _updateLabel->setPosition(Vec2(s.width / 2, s.height - 80));
+    addChild(_updateLabel, 1);
+
+    MenuItemFont::setFontSize(16);
+    _channelsItem = MenuItemFont::create("", CC_CALLBACK_1(TestTimelineChannels::switchChannelsCallback, this));
+    auto menu = Menu::create(_channelsItem, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height - 105));
+    addChild(menu, 1);
+    _channelsItem->setString(ActionTimeline::isChannelsEnabled() ? "Channels: on" : "Channels: off");
+
+    // each widget runs its own clone, like the nodes created by CSLoader
+    auto prototype = createWidgetAction();
+    const int columns = 25;
+    for (int i = 0; i < WIDGET_COUNT; ++i)
+    {
+        auto widget = Node::create();
+        widget->setPosition(Vec2(s.width * (i % columns + 0.5f) / columns, s.height * 0.08f + (i / columns) * 24));
+        addChild(widget);
+
+        auto sprite = Sprite::create("Images/r1.png");
+        auto data = ComExtensionData::create();
+        data->setActionTag(WIDGET_ACTION_TAG);
+        sprite->addComponent(data);
+        widget->addChild(sprite);
+
+        auto action = prototype->clone();
+        sprite->runAction(action);
+        action->gotoFrameAndPlay(i % action->getDuration(), true);
+    }
+
+    return true;
+}
+
+void TestTimelineChannels::onEnter()
+{
+    TestCase::onEnter();
+
+    _frameTimer.start({ Director::EVENT_BEFORE_UPDATE, Director::EVENT_AFTER_UPDATE }, [this]() {
+        char text[128];
+        snprintf(text, sizeof(text), "%d widgets: update %.3f ms per frame", WIDGET_COUNT, _frameTimer.getAverageTime());
+        _updateLabel->setString(text);
+        CCLOG("TestTimelineChannels: %s, channels %s", text, ActionTimeline::isChannelsEnabled() ? "on" : "off");
+    });
+}
+
+void TestTimelineChannels::onExit()
+{
+    _frameTimer.stop();
+
+    ActionTimeline::setChannelsEnabled(true);
+
+    TestCase::onExit();
+}
+
+std::string TestTimelineChannels::title() const
+{
+    return "ActionTimeline Channels";
+}
+
+std::string TestTimelineChannels::subtitle() const
+{
+    return "Update time of 300 widgets running timeline actions";
+}
+
+void TestTimelineChannels::switchChannelsCallback(Ref* sender)
+{
+    ActionTimeline::setChannelsEnabled(!ActionTimeline::isChannelsEnabled());
+    _channelsItem->setString(ActionTimeline::isChannelsEnabled() ? "Channels: on" : "Channels: off");
+    _frameTimer.reset();
+}
@@ -0,0 +1,270 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ArmatureScene.h"
+#include <chrono>
+#include "editor-support/cocostudio/CCArmature.h"
+#include "editor-support/cocostudio/CCArmatureDataManager.h"
+#include "editor-support/cocostudio/CCTween.h"
+
+USING_NS_CC;
+using namespace cocostudio;
+
+static const char* ARMATURE_NAME = "ArmatureBenchmark";
+static const int ARMATURE_COUNT = 100;
+static const int LOAD_REPEAT = 10;
+
+CocoStudioArmatureTests::CocoStudioArmatureTests()
+{
+    ADD_TEST_CASE(TestArmatureBinary);
+}
+
+// Builds an armature in the .ExportJson layout: a binary tree of bones, each showing a grossini frame,
+// and four looping movements with key frames using the common easings.
+static std::string generateExportJson()
+{
+    const int boneCount = 31;
+    const int duration = 60;
+    const int keyFrameInterval = 10;
+    const char* movements[] = { "walk", "run", "attack", "idle" };
+    const int easings[] = { tweenfunc::Sine_EaseInOut, tweenfunc::Elastic_EaseOut, tweenfunc::Expo_EaseOut, tweenfunc::Quad_EaseInOut, tweenfunc::Linear };
+
+    std::string json = "{\"content_scale\": 1.0, \"armature_data\": [{";
+    json += StringUtils::format("\"name\": \"%s\", \"version\": 1.6, \"bone_data\": [", ARMATURE_NAME);
+    for (int i = 0; i < boneCount; ++i)
+    {
+        json += i ? ", {" : "{";
+        json += StringUtils::format("\"name\": \"bone%d\", ", i);
+        if (i > 0)
+        {
+            json += StringUtils::format("\"parent\": \"bone%d\", ", (i - 1) / 2);
+        }
+        json += StringUtils::format("\"x\": %d, \"y\": %d, \"z\": %d, \"cX\": 1, \"cY\": 1, \"kX\": 0, \"kY\": 0, ", i ? 12 : 0, i ? 8 : 0, i);
+        json += StringUtils::format("\"display_data\": [{\"name\": \"grossini_dance_%02d.png\", \"displayType\": 0, ", i % 14 + 1);
+        json += "\"skin_data\": [{\"x\": 0, \"y\": 0, \"cX\": 0.3, \"cY\": 0.3, \"kX\": 0, \"kY\": 0}]}]}";
+    }
+    json += "]}], \"animation_data\": [{";
+    json += StringUtils::format("\"name\": \"%s\", \"mov_data\": [", ARMATURE_NAME);
+    for (int m = 0; m < 4; ++m)
+    {
+        json += m ? ", {" : "{";
+        json += StringUtils::format("\"name\": \"%s\", \"dr\": %d, \"lp\": true, \"to\": 6, \"drTW\": %d, \"twE\": 0, \"sc\": %.1f, \"mov_bone_data\": [",
+                                    movements[m], duration, duration, 1.0f + m * 0.5f);
+        for (int i = 0; i < boneCount; ++i)
+        {
+            json += i ? ", {" : "{";
+            json += StringUtils::format("\"name\": \"bone%d\", \"dl\": 0, \"frame_data\": [", i);
+            for (int frame = 0; frame <= duration; frame += keyFrameInterval)
+            {
+                // the last key frame repeats the first one so the loop is seamless
+                float phase = (frame % duration) / (float)keyFrameInterval + i + m;
+                json += frame ? ", {" : "{";
+                json += StringUtils::format("\"x\": %.2f, \"y\": %.2f, \"kX\": %.3f, \"kY\": %.3f, \"cX\": 1, \"cY\": 1, \"z\": 0, \"dI\": 0, \"fi\": %d, \"twE\": %d}",
+                                            sinf(phase) * 4, cosf(phase) * 4, sinf(phase * 0.7f) * 0.5f, sinf(phase * 0.7f) * 0.5f,
+                                            frame, easings[(i + frame / keyFrameInterval) % 5]);
+            }
+            json += "]}";
+        }
+        json += "]}";
+    }
+    json += "]}], \"texture_data\": [], \"config_file_path\": []}";
+    return json;
+}
+
+//------------------------------------------------------------------
+//
+// TestArmatureBinary
+//
+//------------------------------------------------------------------
+TestArmatureBinary::TestArmatureBinary()
+: _precompiled(true)
+, _armatures(nullptr)
+, _loadLabel(nullptr)
+, _updateLabel(nullptr)
+, _formatItem(nullptr)
+, _easingItem(nullptr)
+{
+}
+
+bool TestArmatureBinary::init()
+{
+    if (!TestCase::init())
+    {
+        return false;
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _armatures = Node::create();
+    addChild(_armatures);
+
+    _loadLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _loadLabel->setPosition(Vec2(s.width / 2, s.height - 80));
+    addChild(_loadLabel, 1);
+
+    _updateLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _updateLabel->setPosition(Vec2(s.width / 2, s.height - 100));
+    addChild(_updateLabel, 1);
+
+    MenuItemFont::setFontSize(16);
+    _formatItem = MenuItemFont::create("", CC_CALLBACK_1(TestArmatureBinary::switchFormatCallback, this));
+    _easingItem = MenuItemFont::create("", CC_CALLBACK_1(TestArmatureBinary::switchEasingTableCallback, this));
+    auto menu = Menu::create(_formatItem, _easingItem, nullptr);
+    menu->alignItemsHorizontallyWithPadding(20);
+    menu->setPosition(Vec2(s.width / 2, s.height - 125));
+    addChild(menu, 1);
+
+    _easingItem->setString(Tween::isEasingTableEnabled() ? "Easing tables: on" : "Easing tables: off");
+
+    return true;
+}
+
+void TestArmatureBinary::onEnter()
+{
+    TestCase::onEnter();
+
+    SpriteFrameCache::getInstance()->addSpriteFramesWithFile("animations/grossini.plist");
+
+    if (!prepareFiles())
+    {
+        _loadLabel->setString("Can't write the armature files to the writable path");
+        return;
+    }
+    measureLoadTime();
+    createArmatures(_precompiled);
+
+    _frameTimer.start({ Director::EVENT_BEFORE_UPDATE, Director::EVENT_AFTER_UPDATE }, [this]() {
+        char text[128];
+        snprintf(text, sizeof(text), "%d armatures: update %.3f ms per frame", ARMATURE_COUNT, _frameTimer.getAverageTime());
+        _updateLabel->setString(text);
+        CCLOG("TestArmatureBinary: %s, %s, easing tables %s", text, _precompiled ? "precompiled" : "ExportJson",
+              Tween::isEasingTableEnabled() ? "on" : "off");
+    });
+}
+
+void TestArmatureBinary::onExit()
+{
+    _frameTimer.stop();
+
+    _armatures->removeAllChildren();
+    ArmatureDataManager::getInstance()->removeArmatureFileInfo(_jsonPath);
+    ArmatureDataManager::getInstance()->removeArmatureFileInfo(_binaryPath);
+    Tween::setEasingTableEnabled(true);
+
+    TestCase::onExit();
+}
+
+std::string TestArmatureBinary::title() const
+{
+    return "Precompiled Armature";
+}
+
+std::string TestArmatureBinary::subtitle() const
+{
+    return "Load time of .ExportJson vs .csab, update time of 100 armatures";
+}
+
+bool TestArmatureBinary::prepareFiles()
+{
+    auto fileUtils = FileUtils::getInstance();
+    _jsonPath = fileUtils->getWritablePath() + ARMATURE_NAME + ".ExportJson";
+    _binaryPath = fileUtils->getWritablePath() + ARMATURE_NAME + ".csab";
+
+    if (!fileUtils->writeStringToFile(generateExportJson(), _jsonPath))
+    {
+        return false;
+    }
+
+    auto manager = ArmatureDataManager::getInstance();
+    manager->addArmatureFileInfo(_jsonPath);
+    bool saved = manager->saveArmatureFileInfoBinary(_jsonPath, _binaryPath);
+    manager->removeArmatureFileInfo(_jsonPath);
+    return saved;
+}
+
+void TestArmatureBinary::measureLoadTime()
+{
+    using namespace std::chrono;
+    auto manager = ArmatureDataManager::getInstance();
+
+    // Each load reads the file again, removeArmatureFileInfo drops the datas and the "already loaded" mark
+    auto measure = [manager](const std::string& path) {
+        double total = 0;
+        for (int i = 0; i < LOAD_REPEAT; ++i)
+        {
+            auto start = steady_clock::now();
+            manager->addArmatureFileInfo(path);
+            total += duration<double, std::milli>(steady_clock::now() - start).count();
+            manager->removeArmatureFileInfo(path);
+        }
+        return total / LOAD_REPEAT;
+    };
+
+    double jsonTime = measure(_jsonPath);
+    double binaryTime = measure(_binaryPath);
+
+    auto fileUtils = FileUtils::getInstance();
+    char text[160];
+    snprintf(text, sizeof(text), "Load: ExportJson %.2f ms (%ld bytes), precompiled %.2f ms (%ld bytes)",
+             jsonTime, fileUtils->getFileSize(_jsonPath), binaryTime, fileUtils->getFileSize(_binaryPath));
+    _loadLabel->setString(text);
+    CCLOG("TestArmatureBinary: %s", text);
+}
+
+void TestArmatureBinary::createArmatures(bool precompiled)
+{
+    _precompiled = precompiled;
+    _armatures->removeAllChildren();
+
+    auto manager = ArmatureDataManager::getInstance();
+    manager->removeArmatureFileInfo(_jsonPath);
+    manager->removeArmatureFileInfo(_binaryPath);
+    manager->addArmatureFileInfo(_precompiled ? _binaryPath : _jsonPath);
+
+    auto s = Director::getInstance()->getWinSize();
+    const int columns = 20;
+    for (int i = 0; i < ARMATURE_COUNT; ++i)
+    {
+        Armature* armature = Armature::create(ARMATURE_NAME);
+        armature->getAnimation()->playWithIndex(i % 4);
+        armature->getAnimation()->gotoAndPlay(i % 60);
+        armature->setPosition(Vec2(s.width * (i % columns + 0.5f) / columns, s.height * (0.1f + (i / columns) * 0.12f)));
+        _armatures->addChild(armature);
+    }
+
+    _formatItem->setString(_precompiled ? "Data: precompiled" : "Data: ExportJson");
+    _frameTimer.reset();
+}
+
+void TestArmatureBinary::switchFormatCallback(Ref* sender)
+{
+    createArmatures(!_precompiled);
+}
+
+void TestArmatureBinary::switchEasingTableCallback(Ref* sender)
+{
+    Tween::setEasingTableEnabled(!Tween::isEasingTableEnabled());
+    _easingItem->setString(Tween::isEasingTableEnabled() ? "Easing tables: on" : "Easing tables: off");
+    _frameTimer.reset();
+}
@@ -0,0 +1,69 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __ARMATURE_SCENE_H__
+#define __ARMATURE_SCENE_H__
+
+#include "cocos2d.h"
+#include "../../BaseTest.h"
+
+DEFINE_TEST_SUITE(CocoStudioArmatureTests);
+
+class TestArmatureBinary : public TestCase
+{
+public:
+    CREATE_FUNC(TestArmatureBinary);
+
+    TestArmatureBinary();
+
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    // writes a generated .ExportJson and converts it, returns false if the files can't be written
+    bool prepareFiles();
+    void measureLoadTime();
+    void createArmatures(bool precompiled);
+
+    void switchFormatCallback(cocos2d::Ref* sender);
+    void switchEasingTableCallback(cocos2d::Ref* sender);
+
+    std::string _jsonPath;
+    std::string _binaryPath;
+    bool _precompiled;
+
+    cocos2d::Node* _armatures;
+    cocos2d::Label* _loadLabel;
+    cocos2d::Label* _updateLabel;
+    cocos2d::MenuItemFont* _formatItem;
+    cocos2d::MenuItemFont* _easingItem;
+
+    FrameTimer _frameTimer;
+};
+
+#endif  // __ARMATURE_SCENE_H__
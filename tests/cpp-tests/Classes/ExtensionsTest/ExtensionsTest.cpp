@@ -27,6 +27,8 @@
 #include "AssetsManagerExTest/AssetsManagerExTest.h"
 #include "NetworkTest/HttpClientTest.h"
 #include "TableViewTest/TableViewTestScene.h"
+#include "CocoStudioArmatureTest/ArmatureScene.h"
+#include "CocoStudioActionTimelineTest/ActionTimelineTestScene.h"
 
 #include "NetworkTest/WebSocketTest.h"
 #include "NetworkTest/SocketIOTest.h"
@@ -34,6 +36,8 @@
 ExtensionsTests::ExtensionsTests()
 {
     addTest("AssetsManagerExTest", [](){ return new (std::nothrow) AssetsManagerExTests; });
+    addTest("CocoStudioArmatureTest", [](){ return new (std::nothrow) CocoStudioArmatureTests; });
+    addTest("CocoStudioActionTimelineTest", [](){ return new (std::nothrow) CocoStudioActionTimelineTests; });
     addTest("HttpClientTest", [](){ return new (std::nothrow) HttpClientTests; });
     addTest("WebSocketTest", [](){ return new (std::nothrow) WebSocketTests; });
     addTest("SocketIOTest", [](){ return new (std::nothrow) SocketIOTests; });
@@ -25,6 +25,20 @@
 #include "HttpClientTest.h"
 #include "../ExtensionsTest.h"
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
 
 USING_NS_CC;
 USING_NS_CC_EXT;
@@ -34,6 +48,8 @@ HttpClientTests::HttpClientTests()
 {
     ADD_TEST_CASE(HttpClientTest);
     ADD_TEST_CASE(HttpClientClearRequestsTest);
+    ADD_TEST_CASE(HttpClientThroughputTest);
+    ADD_TEST_CASE(HttpClientStreamingTest);
 }
 
 HttpClientTest::HttpClientTest() 
@@ -545,3 +561,432 @@ void HttpClientClearRequestsTest::onHttpRequestCompleted(HttpClient *sender, Htt
         log("error buffer: %s", response->getErrorBuffer());
     }
 }
+
+// Minimal HTTP/1.1 server on 127.0.0.1 answering every request with "ok" on a kept-alive connection,
+// or with LARGE_BODY_SIZE bytes of generated data for the "/large" path
+class LocalHttpServer
+{
+public:
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    typedef SOCKET Socket;
+#else
+    typedef int Socket;
+    static const Socket INVALID_SOCKET = -1;
+#endif
+
+    LocalHttpServer()
+    : _listenSocket(INVALID_SOCKET)
+    , _port(0)
+    , _connectionCount(0)
+    {
+    }
+
+    ~LocalHttpServer()
+    {
+        stop();
+    }
+
+    bool start()
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        WSADATA wsaData;
+        WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+        _listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (_listenSocket == INVALID_SOCKET)
+        {
+            return false;
+        }
+
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (bind(_listenSocket, (sockaddr*)&address, sizeof(address)) != 0
+            || listen(_listenSocket, 128) != 0
+            || getsockname(_listenSocket, (sockaddr*)&address, &length) != 0)
+        {
+            closeSocket(_listenSocket);
+            _listenSocket = INVALID_SOCKET;
+            return false;
+        }
+        _port = ntohs(address.sin_port);
+
+        _acceptThread = std::thread(&LocalHttpServer::acceptLoop, this);
+        return true;
+    }
+
+    void stop()
+    {
+        if (_listenSocket == INVALID_SOCKET)
+        {
+            return;
+        }
+
+        shutdown(_listenSocket, 2);
+        closeSocket(_listenSocket);
+        _listenSocket = INVALID_SOCKET;
+        _acceptThread.join();
+
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto client : _clientSockets)
+            {
+                shutdown(client, 2);
+            }
+            threads.swap(_clientThreads);
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        WSACleanup();
+#endif
+    }
+
+    int getPort() const { return _port; }
+    int getConnectionCount() const { return _connectionCount; }
+
+    static const size_t LARGE_BODY_SIZE = 8 * 1024 * 1024;
+
+private:
+    static void closeSocket(Socket s)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        closesocket(s);
+#else
+        close(s);
+#endif
+    }
+
+    void acceptLoop()
+    {
+        while (true)
+        {
+            Socket client = accept(_listenSocket, nullptr, nullptr);
+            if (client == INVALID_SOCKET)
+            {
+                break;
+            }
+
+            int noDelay = 1;
+            setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_connectionCount;
+            _clientSockets.push_back(client);
+            _clientThreads.push_back(std::thread(&LocalHttpServer::serveConnection, this, client));
+        }
+    }
+
+    static bool sendAll(Socket client, const char* data, size_t size)
+    {
+        while (size > 0)
+        {
+            int sent = (int)send(client, data, (int)std::min(size, (size_t)65536), 0);
+            if (sent <= 0)
+            {
+                return false;
+            }
+            data += sent;
+            size -= sent;
+        }
+        return true;
+    }
+
+    void serveConnection(Socket client)
+    {
+        static const std::string RESPONSE = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+        std::string buffer;
+        char data[4096];
+
+        while (true)
+        {
+            size_t headerEnd = buffer.find("\r\n\r\n");
+            if (headerEnd == std::string::npos)
+            {
+                int received = (int)recv(client, data, sizeof(data), 0);
+                if (received <= 0)
+                {
+                    break;
+                }
+                buffer.append(data, received);
+                continue;
+            }
+
+            size_t contentLength = 0;
+            size_t field = buffer.find("Content-Length:");
+            if (field != std::string::npos && field < headerEnd)
+            {
+                contentLength = (size_t)atoi(buffer.c_str() + field + 15);
+            }
+            if (buffer.size() < headerEnd + 4 + contentLength)
+            {
+                int received = (int)recv(client, data, sizeof(data), 0);
+                if (received <= 0)
+                {
+                    break;
+                }
+                buffer.append(data, received);
+                continue;
+            }
+            bool large = buffer.compare(0, 11, "GET /large ") == 0;
+            buffer.erase(0, headerEnd + 4 + contentLength);
+
+            const std::string& response = large ? getLargeResponse() : RESPONSE;
+            if (!sendAll(client, response.data(), response.size()))
+            {
+                break;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _clientSockets.erase(std::find(_clientSockets.begin(), _clientSockets.end(), client));
+        closeSocket(client);
+    }
+
+    const std::string& getLargeResponse()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_largeResponse.empty())
+        {
+            _largeResponse = StringUtils::format("HTTP/1.1 200 OK\r\nContent-Length: %d\r\n\r\n", (int)LARGE_BODY_SIZE);
+            size_t headerSize = _largeResponse.size();
+            _largeResponse.resize(headerSize + LARGE_BODY_SIZE);
+            for (size_t i = 0; i < LARGE_BODY_SIZE; ++i)
+            {
+                _largeResponse[headerSize + i] = (char)(i % 251);
+            }
+        }
+        return _largeResponse;
+    }
+
+    Socket _listenSocket;
+    int _port;
+    std::atomic<int> _connectionCount;
+    std::string _largeResponse;
+    std::thread _acceptThread;
+    std::mutex _mutex;
+    std::vector<Socket> _clientSockets;
+    std::vector<std::thread> _clientThreads;
+};
+
+HttpClientThroughputTest::HttpClientThroughputTest()
+: _server(new (std::nothrow) LocalHttpServer())
+, _labelResult(nullptr)
+, _totalRequests(1000)
+, _finishedRequests(0)
+, _failedRequests(0)
+, _connectionsBefore(0)
+, _running(false)
+{
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto itemSingle = MenuItemFont::create("1 connection per host", [this](Ref*) { runRequests(1); });
+    auto itemMultiple = MenuItemFont::create("6 connections per host", [this](Ref*) { runRequests(6); });
+    auto menu = Menu::create(itemSingle, itemMultiple, nullptr);
+    menu->alignItemsVerticallyWithPadding(10);
+    menu->setPosition(winSize.width / 2, winSize.height - 120);
+    addChild(menu);
+
+    _labelResult = Label::createWithTTF("", "fonts/arial.ttf", 18);
+    _labelResult->setPosition(winSize.width / 2, winSize.height / 2 - 40);
+    addChild(_labelResult);
+
+    if (!_server->start())
+    {
+        _labelResult->setString("Failed to start the local server");
+    }
+}
+
+HttpClientThroughputTest::~HttpClientThroughputTest()
+{
+    HttpClient::destroyInstance();
+    delete _server;
+}
+
+void HttpClientThroughputTest::runRequests(int maxConnectionsPerHost)
+{
+    if (_server->getPort() == 0 || _running)
+    {
+        return;
+    }
+
+    HttpClient::getInstance()->setMaxConnectionsPerHost(maxConnectionsPerHost);
+
+    _running = true;
+    _finishedRequests = 0;
+    _failedRequests = 0;
+    _connectionsBefore = _server->getConnectionCount();
+    _startTime = std::chrono::steady_clock::now();
+    _labelResult->setString("waiting...");
+
+    for (int i = 0; i < _totalRequests; ++i)
+    {
+        HttpRequest* request = new (std::nothrow) HttpRequest();
+        request->setUrl(StringUtils::format("http://127.0.0.1:%d/item?id=%d", _server->getPort(), i));
+        request->setRequestType(HttpRequest::Type::GET);
+        request->setResponseCallback([this](HttpClient* client, HttpResponse* response) {
+            if (!response->isSucceed())
+            {
+                ++_failedRequests;
+            }
+
+            if (++_finishedRequests == _totalRequests)
+            {
+                auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _startTime).count() / 1000.0f;
+                _labelResult->setString(StringUtils::format("%d requests in %.1f ms (%.0f requests/s)\n%d failed, %d connections opened",
+                                                            _totalRequests, elapsed, _totalRequests * 1000.0f / elapsed,
+                                                            _failedRequests, _server->getConnectionCount() - _connectionsBefore));
+                _running = false;
+            }
+        });
+        HttpClient::getInstance()->send(request);
+        request->release();
+    }
+}
+
+HttpClientStreamingTest::HttpClientStreamingTest()
+: _server(new (std::nothrow) LocalHttpServer())
+, _labelProgress(nullptr)
+, _labelResult(nullptr)
+, _receivedSize(0)
+, _chunkCount(0)
+, _pauseCount(0)
+, _checksumMatched(true)
+, _running(false)
+{
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto itemFile = MenuItemFont::create("Stream to a file", [this](Ref*) { streamToFile(); });
+    auto itemCallback = MenuItemFont::create("Stream to a pausing callback", [this](Ref*) { streamToCallback(); });
+    auto menu = Menu::create(itemFile, itemCallback, nullptr);
+    menu->alignItemsVerticallyWithPadding(10);
+    menu->setPosition(winSize.width / 2, winSize.height - 120);
+    addChild(menu);
+
+    _labelProgress = Label::createWithTTF("", "fonts/arial.ttf", 18);
+    _labelProgress->setPosition(winSize.width / 2, winSize.height / 2 - 20);
+    addChild(_labelProgress);
+
+    _labelResult = Label::createWithTTF("", "fonts/arial.ttf", 18);
+    _labelResult->setPosition(winSize.width / 2, winSize.height / 2 - 60);
+    addChild(_labelResult);
+
+    if (!_server->start())
+    {
+        _labelResult->setString("Failed to start the local server");
+    }
+}
+
+HttpClientStreamingTest::~HttpClientStreamingTest()
+{
+    HttpClient::destroyInstance();
+    delete _server;
+    FileUtils::getInstance()->removeFile(FileUtils::getInstance()->getWritablePath() + "HttpClientStreamingTest.bin");
+}
+
+HttpRequest* HttpClientStreamingTest::createRequest()
+{
+    if (_server->getPort() == 0 || _running)
+    {
+        return nullptr;
+    }
+
+    _running = true;
+    _labelProgress->setString("");
+    _labelResult->setString("waiting...");
+
+    HttpRequest* request = new (std::nothrow) HttpRequest();
+    request->setUrl(StringUtils::format("http://127.0.0.1:%d/large", _server->getPort()));
+    request->setRequestType(HttpRequest::Type::GET);
+    request->setProgressCallback([this](HttpRequest* request, int64_t receivedSize, int64_t totalSize) {
+        _labelProgress->setString(StringUtils::format("%lld of %lld bytes", (long long)receivedSize, (long long)totalSize));
+    });
+    return request;
+}
+
+void HttpClientStreamingTest::streamToFile()
+{
+    HttpRequest* request = createRequest();
+    if (!request)
+    {
+        return;
+    }
+
+    std::string path = FileUtils::getInstance()->getWritablePath() + "HttpClientStreamingTest.bin";
+    request->setResponseFilePath(path);
+    request->setResponseCallback([this, path](HttpClient* client, HttpResponse* response) {
+        _running = false;
+        if (!response->isSucceed())
+        {
+            _labelResult->setString(StringUtils::format("Failed: %s", response->getErrorBuffer()));
+            return;
+        }
+
+        long fileSize = FileUtils::getInstance()->getFileSize(path);
+        _labelResult->setString(StringUtils::format("Saved %ld bytes, %d bytes kept in memory\n%s",
+                                                    fileSize, (int)response->getResponseData()->size(),
+                                                    fileSize == (long)LocalHttpServer::LARGE_BODY_SIZE ? "OK" : "Size mismatch"));
+    });
+    HttpClient::getInstance()->send(request);
+    request->release();
+}
+
+void HttpClientStreamingTest::streamToCallback()
+{
+    HttpRequest* request = createRequest();
+    if (!request)
+    {
+        return;
+    }
+
+    _receivedSize = 0;
+    _chunkCount = 0;
+    _pauseCount = 0;
+    _checksumMatched = true;
+    // Invoked on the network thread, pause every 16th chunk and resume it from the cocos thread a moment later
+    request->setResponseDataCallback([this](HttpResponse* response, const char* data, size_t size) {
+        static const int PAUSE_INTERVAL = 16;
+        if (++_chunkCount % PAUSE_INTERVAL == 0)
+        {
+            ++_pauseCount;
+            response->retain();
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread([response]() {
+                HttpClient::getInstance()->resume(response);
+                response->release();
+            });
+            return false;
+        }
+
+        size_t offset = _receivedSize;
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (data[i] != (char)((offset + i) % 251))
+            {
+                _checksumMatched = false;
+                break;
+            }
+        }
+        _receivedSize += size;
+        return true;
+    });
+    request->setResponseCallback([this](HttpClient* client, HttpResponse* response) {
+        _running = false;
+        if (!response->isSucceed())
+        {
+            _labelResult->setString(StringUtils::format("Failed: %s", response->getErrorBuffer()));
+            return;
+        }
+
+        _labelResult->setString(StringUtils::format("Received %d bytes with %d pauses, %d bytes kept in memory\n%s",
+                                                    (int)_receivedSize, (int)_pauseCount, (int)response->getResponseData()->size(),
+                                                    _checksumMatched && _receivedSize == LocalHttpServer::LARGE_BODY_SIZE ? "OK" : "Data mismatch"));
+    });
+    HttpClient::getInstance()->send(request);
+    request->release();
+}
@@ -29,6 +29,8 @@
 #include "extensions/cocos-ext.h"
 #include "network/HttpClient.h"
 #include "BaseTest.h"
+#include <atomic>
+#include <chrono>
 
 DEFINE_TEST_SUITE(HttpClientTests);
 
@@ -80,4 +82,57 @@ private:
     cocos2d::Label* _labelStatusCode;
 };
 
+class LocalHttpServer;
+
+class HttpClientThroughputTest : public TestCase
+{
+public:
+    CREATE_FUNC(HttpClientThroughputTest);
+
+    HttpClientThroughputTest();
+    virtual ~HttpClientThroughputTest();
+
+    void runRequests(int maxConnectionsPerHost);
+
+    virtual std::string title() const override { return "Http Client Throughput Test"; }
+    virtual std::string subtitle() const override { return "1000 small requests to a local keep-alive server"; }
+
+private:
+    LocalHttpServer* _server;
+    cocos2d::Label* _labelResult;
+    int _totalRequests;
+    int _finishedRequests;
+    int _failedRequests;
+    int _connectionsBefore;
+    bool _running;
+    std::chrono::steady_clock::time_point _startTime;
+};
+
+class HttpClientStreamingTest : public TestCase
+{
+public:
+    CREATE_FUNC(HttpClientStreamingTest);
+
+    HttpClientStreamingTest();
+    virtual ~HttpClientStreamingTest();
+
+    void streamToFile();
+    void streamToCallback();
+
+    virtual std::string title() const override { return "Http Client Streaming Test"; }
+    virtual std::string subtitle() const override { return "8 MB body streamed without buffering it in the response"; }
+
+private:
+    cocos2d::network::HttpRequest* createRequest();
+
+    LocalHttpServer* _server;
+    cocos2d::Label* _labelProgress;
+    cocos2d::Label* _labelResult;
+    std::atomic<size_t> _receivedSize;
+    std::atomic<int> _chunkCount;
+    std::atomic<int> _pauseCount;
+    std::atomic<bool> _checksumMatched;
+    bool _running;
+};
+
 #endif //__HTTPREQUESTHTTP_H
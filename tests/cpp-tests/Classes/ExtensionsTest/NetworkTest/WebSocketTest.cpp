@@ -27,6 +27,7 @@
 #include "testResource.h"
 
 #include "WebSocketDelayTest.h"
+#include "WebSocketThroughputTest.h"
 
 USING_NS_CC;
 USING_NS_CC_EXT;
@@ -36,6 +37,7 @@ WebSocketTests::WebSocketTests()
     ADD_TEST_CASE(WebSocketTest);
     ADD_TEST_CASE(WebSocketCloseTest);
     ADD_TEST_CASE(WebSocketDelayTest);
+    ADD_TEST_CASE(WebSocketThroughputTest);
 }
 
 WebSocketTest::WebSocketTest()
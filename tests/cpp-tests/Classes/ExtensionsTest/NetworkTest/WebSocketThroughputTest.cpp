@@ -0,0 +1,535 @@
+#include "WebSocketThroughputTest.h"
+#include "../ExtensionsTest.h"
+#include "base/base64.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+USING_NS_CC;
+USING_NS_CC_EXT;
+
+#define MESSAGE_SIZE 64
+
+// SHA-1 digest, only needed for the Sec-WebSocket-Accept header of the handshake
+static void sha1(const std::string& input, unsigned char digest[20])
+{
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+    std::string message = input;
+    uint64_t bitLength = (uint64_t)input.size() * 8;
+    message.push_back((char)0x80);
+    while (message.size() % 64 != 56)
+    {
+        message.push_back(0);
+    }
+    for (int i = 7; i >= 0; --i)
+    {
+        message.push_back((char)(bitLength >> (i * 8)));
+    }
+
+    auto rotate = [](uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); };
+
+    for (size_t chunk = 0; chunk < message.size(); chunk += 64)
+    {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i)
+        {
+            const unsigned char* p = (const unsigned char*)message.data() + chunk + i * 4;
+            w[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+        }
+        for (int i = 16; i < 80; ++i)
+        {
+            w[i] = rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i)
+        {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+
+            uint32_t temp = rotate(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotate(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    for (int i = 0; i < 20; ++i)
+    {
+        digest[i] = (unsigned char)(h[i / 4] >> (24 - (i % 4) * 8));
+    }
+}
+
+// Minimal WebSocket server on 127.0.0.1 that echoes every data frame back unmasked.
+// Frames that arrive together are answered with a single send.
+class LocalEchoServer
+{
+public:
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    typedef SOCKET Socket;
+#else
+    typedef int Socket;
+    static const Socket INVALID_SOCKET = -1;
+#endif
+
+    LocalEchoServer()
+    : _listenSocket(INVALID_SOCKET)
+    , _port(0)
+    {
+    }
+
+    ~LocalEchoServer()
+    {
+        stop();
+    }
+
+    bool start()
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        WSADATA wsaData;
+        WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+        _listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (_listenSocket == INVALID_SOCKET)
+        {
+            return false;
+        }
+
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (bind(_listenSocket, (sockaddr*)&address, sizeof(address)) != 0
+            || listen(_listenSocket, 16) != 0
+            || getsockname(_listenSocket, (sockaddr*)&address, &length) != 0)
+        {
+            closeSocket(_listenSocket);
+            _listenSocket = INVALID_SOCKET;
+            return false;
+        }
+        _port = ntohs(address.sin_port);
+
+        _acceptThread = std::thread(&LocalEchoServer::acceptLoop, this);
+        return true;
+    }
+
+    void stop()
+    {
+        if (_listenSocket == INVALID_SOCKET)
+        {
+            return;
+        }
+
+        shutdown(_listenSocket, 2);
+        closeSocket(_listenSocket);
+        _listenSocket = INVALID_SOCKET;
+        _acceptThread.join();
+
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto client : _clientSockets)
+            {
+                shutdown(client, 2);
+            }
+            threads.swap(_clientThreads);
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        WSACleanup();
+#endif
+    }
+
+    int getPort() const { return _port; }
+
+private:
+    static void closeSocket(Socket s)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        closesocket(s);
+#else
+        close(s);
+#endif
+    }
+
+    void acceptLoop()
+    {
+        while (true)
+        {
+            Socket client = accept(_listenSocket, nullptr, nullptr);
+            if (client == INVALID_SOCKET)
+            {
+                break;
+            }
+
+            int noDelay = 1;
+            setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _clientSockets.push_back(client);
+            _clientThreads.push_back(std::thread(&LocalEchoServer::serveConnection, this, client));
+        }
+    }
+
+    static bool sendAll(Socket client, const char* data, size_t size)
+    {
+        while (size > 0)
+        {
+            int sent = (int)send(client, data, (int)std::min(size, (size_t)65536), 0);
+            if (sent <= 0)
+            {
+                return false;
+            }
+            data += sent;
+            size -= sent;
+        }
+        return true;
+    }
+
+    static std::string acceptKey(const std::string& request)
+    {
+        std::string lowered = request;
+        std::transform(lowered.begin(), lowered.end(), lowered.begin(), ::tolower);
+        size_t field = lowered.find("sec-websocket-key:");
+        if (field == std::string::npos)
+        {
+            return "";
+        }
+        size_t begin = request.find_first_not_of(' ', field + 18);
+        size_t end = request.find("\r\n", begin);
+        std::string key = request.substr(begin, end - begin);
+
+        unsigned char digest[20];
+        sha1(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11", digest);
+        char* encoded = nullptr;
+        base64Encode(digest, sizeof(digest), &encoded);
+        std::string result = encoded ? encoded : "";
+        free(encoded);
+        return result;
+    }
+
+    // Appends the echo of every complete frame to 'reply' and removes them from 'buffer'.
+    // Returns false once the client sent a close frame.
+    static bool echoFrames(std::string& buffer, std::string& reply)
+    {
+        while (buffer.size() >= 2)
+        {
+            const unsigned char* p = (const unsigned char*)buffer.data();
+            unsigned char opcode = p[0] & 0x0F;
+            bool masked = (p[1] & 0x80) != 0;
+            uint64_t length = p[1] & 0x7F;
+            size_t headerSize = 2;
+            if (length == 126)
+            {
+                if (buffer.size() < 4)
+                    break;
+                length = ((uint64_t)p[2] << 8) | p[3];
+                headerSize = 4;
+            }
+            else if (length == 127)
+            {
+                if (buffer.size() < 10)
+                    break;
+                length = 0;
+                for (int i = 0; i < 8; ++i)
+                {
+                    length = (length << 8) | p[2 + i];
+                }
+                headerSize = 10;
+            }
+            size_t maskOffset = headerSize;
+            if (masked)
+            {
+                headerSize += 4;
+            }
+            if (buffer.size() < headerSize + length)
+            {
+                break;
+            }
+
+            // Pings are answered with pongs, everything else keeps its FIN bit and opcode
+            unsigned char first = (opcode == 0x9) ? (unsigned char)0x8A : p[0];
+            reply.push_back((char)first);
+            if (length < 126)
+            {
+                reply.push_back((char)length);
+            }
+            else if (length <= 0xFFFF)
+            {
+                reply.push_back((char)126);
+                reply.push_back((char)(length >> 8));
+                reply.push_back((char)length);
+            }
+            else
+            {
+                reply.push_back((char)127);
+                for (int i = 7; i >= 0; --i)
+                {
+                    reply.push_back((char)(length >> (i * 8)));
+                }
+            }
+            size_t payloadStart = reply.size();
+            reply.append(buffer, headerSize, (size_t)length);
+            if (masked)
+            {
+                for (size_t i = 0; i < length; ++i)
+                {
+                    reply[payloadStart + i] ^= buffer[maskOffset + (i % 4)];
+                }
+            }
+            buffer.erase(0, headerSize + (size_t)length);
+
+            if (opcode == 0x8)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void serveConnection(Socket client)
+    {
+        std::string buffer;
+        std::string reply;
+        char data[16384];
+        bool upgraded = false;
+        bool open = true;
+
+        while (open)
+        {
+            int received = (int)recv(client, data, sizeof(data), 0);
+            if (received <= 0)
+            {
+                break;
+            }
+            buffer.append(data, received);
+
+            if (!upgraded)
+            {
+                size_t headerEnd = buffer.find("\r\n\r\n");
+                if (headerEnd == std::string::npos)
+                {
+                    continue;
+                }
+                std::string key = acceptKey(buffer.substr(0, headerEnd + 2));
+                if (key.empty())
+                {
+                    break;
+                }
+                std::string response = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                                       "Sec-WebSocket-Accept: " + key + "\r\n\r\n";
+                if (!sendAll(client, response.data(), response.size()))
+                {
+                    break;
+                }
+                buffer.erase(0, headerEnd + 4);
+                upgraded = true;
+            }
+
+            reply.clear();
+            open = echoFrames(buffer, reply);
+            if (!reply.empty() && !sendAll(client, reply.data(), reply.size()))
+            {
+                break;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _clientSockets.erase(std::find(_clientSockets.begin(), _clientSockets.end(), client));
+        closeSocket(client);
+    }
+
+    Socket _listenSocket;
+    int _port;
+    std::thread _acceptThread;
+    std::mutex _mutex;
+    std::vector<Socket> _clientSockets;
+    std::vector<std::thread> _clientThreads;
+};
+
+WebSocketThroughputTest::WebSocketThroughputTest()
+: _server(new (std::nothrow) LocalEchoServer())
+, _ws(nullptr)
+, _labelStatus(nullptr)
+, _labelResult(nullptr)
+, _startTime(0)
+, _totalMessages(0)
+, _receivedMessages(0)
+, _burst(false)
+, _running(false)
+{
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto itemBurst = MenuItemFont::create("Burst of 10000 messages", [this](Ref*) { runBenchmark(10000, true); });
+    auto itemPingPong = MenuItemFont::create("1000 round trips", [this](Ref*) { runBenchmark(1000, false); });
+    auto menu = Menu::create(itemBurst, itemPingPong, nullptr);
+    menu->alignItemsVerticallyWithPadding(10);
+    menu->setPosition(winSize.width / 2, winSize.height - 120);
+    addChild(menu);
+
+    _labelStatus = Label::createWithTTF("Connecting...", "fonts/arial.ttf", 16);
+    _labelStatus->setPosition(winSize.width / 2, winSize.height / 2);
+    addChild(_labelStatus);
+
+    _labelResult = Label::createWithTTF("", "fonts/arial.ttf", 18);
+    _labelResult->setPosition(winSize.width / 2, winSize.height / 2 - 60);
+    addChild(_labelResult);
+
+    if (!_server->start())
+    {
+        _labelStatus->setString("Failed to start the local echo server");
+        return;
+    }
+
+    _ws = new network::WebSocket();
+    if (!_ws->init(*this, StringUtils::format("ws://127.0.0.1:%d/", _server->getPort())))
+    {
+        CC_SAFE_DELETE(_ws);
+    }
+    else
+    {
+        retain(); // Released in onClose, the delegate has to outlive the connection
+    }
+}
+
+WebSocketThroughputTest::~WebSocketThroughputTest()
+{
+    delete _server;
+}
+
+void WebSocketThroughputTest::onExit()
+{
+    if (_ws)
+    {
+        _ws->closeAsync();
+    }
+
+    TestCase::onExit();
+}
+
+void WebSocketThroughputTest::runBenchmark(int count, bool burst)
+{
+    if (_ws == nullptr || _running || _ws->getReadyState() != network::WebSocket::State::OPEN)
+    {
+        return;
+    }
+
+    _running = true;
+    _burst = burst;
+    _totalMessages = count;
+    _receivedMessages = 0;
+    _sendTimes.assign(count, 0);
+    _latencies.clear();
+    _latencies.reserve(count);
+    _labelResult->setString("waiting...");
+
+    _startTime = getNowMircroSeconds();
+    if (burst)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            sendMessage(i);
+        }
+    }
+    else
+    {
+        sendMessage(0);
+    }
+}
+
+void WebSocketThroughputTest::sendMessage(int index)
+{
+    unsigned char message[MESSAGE_SIZE] = { 0 };
+    memcpy(message, &index, sizeof(index));
+    _sendTimes[index] = getNowMircroSeconds();
+    _ws->send(message, MESSAGE_SIZE);
+}
+
+void WebSocketThroughputTest::showResult()
+{
+    int64_t elapsed = getNowMircroSeconds() - _startTime;
+    std::sort(_latencies.begin(), _latencies.end());
+    auto percentile = [this](float p) {
+        size_t index = std::min(_latencies.size() - 1, (size_t)(_latencies.size() * p));
+        return _latencies[index] / 1000.0f;
+    };
+
+    _labelResult->setString(StringUtils::format("%d messages in %.1f ms (%.0f messages/s)\nlatency p50 %.2f ms, p90 %.2f ms, p99 %.2f ms",
+                                                _totalMessages, elapsed / 1000.0f, _totalMessages * 1000000.0f / elapsed,
+                                                percentile(0.5f), percentile(0.9f), percentile(0.99f)));
+    _running = false;
+}
+
+// Delegate methods
+void WebSocketThroughputTest::onOpen(network::WebSocket* ws)
+{
+    _labelStatus->setString(StringUtils::format("Connected to %s", ws->getUrl().c_str()));
+}
+
+void WebSocketThroughputTest::onMessage(network::WebSocket* ws, const network::WebSocket::Data& data)
+{
+    if (!_running || !data.isBinary || data.len != MESSAGE_SIZE)
+    {
+        return;
+    }
+
+    int index = 0;
+    memcpy(&index, data.bytes, sizeof(index));
+    if (index < 0 || index >= _totalMessages)
+    {
+        return;
+    }
+
+    _latencies.push_back(getNowMircroSeconds() - _sendTimes[index]);
+    if (++_receivedMessages == _totalMessages)
+    {
+        showResult();
+    }
+    else if (!_burst)
+    {
+        sendMessage(_receivedMessages);
+    }
+}
+
+void WebSocketThroughputTest::onClose(network::WebSocket* ws)
+{
+    log("onClose: websocket instance (%p) closed.", ws);
+    if (ws == _ws)
+    {
+        _ws = nullptr;
+        _labelStatus->setString("Connection was closed");
+    }
+    CC_SAFE_DELETE(ws);
+    release();
+}
+
+void WebSocketThroughputTest::onError(network::WebSocket* ws, const network::WebSocket::ErrorCode& error)
+{
+    _labelStatus->setString(StringUtils::format("An error was fired, code: %d", static_cast<int>(error)));
+    _running = false;
+}
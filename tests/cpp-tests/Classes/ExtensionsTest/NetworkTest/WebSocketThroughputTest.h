@@ -0,0 +1,56 @@
+#pragma once
+
+#include "cocos2d.h"
+#include "extensions/cocos-ext.h"
+#include "network/WebSocket.h"
+#include "BaseTest.h"
+
+#include <chrono>
+
+class LocalEchoServer;
+
+class WebSocketThroughputTest : public TestCase
+, public cocos2d::network::WebSocket::Delegate
+{
+public:
+    CREATE_FUNC(WebSocketThroughputTest);
+
+    WebSocketThroughputTest();
+    virtual ~WebSocketThroughputTest();
+
+    virtual void onExit() override;
+
+    virtual void onOpen(cocos2d::network::WebSocket* ws)override;
+    virtual void onMessage(cocos2d::network::WebSocket* ws, const cocos2d::network::WebSocket::Data& data)override;
+    virtual void onClose(cocos2d::network::WebSocket* ws)override;
+    virtual void onError(cocos2d::network::WebSocket* ws, const cocos2d::network::WebSocket::ErrorCode& error)override;
+
+    virtual std::string title() const override { return "WebSocket Throughput Test"; }
+    virtual std::string subtitle() const override { return "Messages/s and latency percentiles against a local echo server"; }
+
+    int64_t getNowMircroSeconds()
+    {
+        auto now = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+    }
+
+private:
+    // burst: send all messages at once, otherwise send the next message when the previous echo arrives
+    void runBenchmark(int count, bool burst);
+    void sendMessage(int index);
+    void showResult();
+
+    LocalEchoServer* _server;
+    cocos2d::network::WebSocket* _ws;
+
+    cocos2d::Label* _labelStatus;
+    cocos2d::Label* _labelResult;
+
+    std::vector<int64_t> _sendTimes;
+    std::vector<int64_t> _latencies;
+    int64_t _startTime;
+    int _totalMessages;
+    int _receivedMessages;
+    bool _burst;
+    bool _running;
+};
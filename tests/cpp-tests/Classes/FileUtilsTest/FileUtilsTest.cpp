@@ -24,6 +24,12 @@
 
 #include "FileUtilsTest.h"
 
+#include <chrono>
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 USING_NS_CC;
 
 FileUtilsTests::FileUtilsTests()
@@ -49,6 +55,9 @@ FileUtilsTests::FileUtilsTests()
     ADD_TEST_CASE(TestWriteDataAsync);
     ADD_TEST_CASE(TestListFiles);
     ADD_TEST_CASE(TestIsFileExistRejectFolder);
+    ADD_TEST_CASE(TestMountPack);
+    ADD_TEST_CASE(TestMountPerformance);
+    ADD_TEST_CASE(TestGetContentsAsync);
 }
 
 // TestResolutionDirectories
@@ -1484,3 +1493,276 @@ std::string TestIsFileExistRejectFolder::subtitle() const
 {
     return "";
 }
+
+// TestMountPack
+
+void TestMountPack::onEnter()
+{
+    FileUtilsDemo::onEnter();
+
+    auto fs = FileUtils::getInstance();
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto infoLabel = Label::createWithTTF("mount Misc/pack.zip, read its files and unmount it", "fonts/Thonburi.ttf", 18);
+    this->addChild(infoLabel);
+    infoLabel->setPosition(winSize.width / 2, winSize.height * 3 / 4);
+
+    auto resultLabel = Label::createWithTTF("", "fonts/Thonburi.ttf", 16);
+    this->addChild(resultLabel);
+    resultLabel->setPosition(winSize.width / 2, winSize.height / 3);
+
+    auto runTests = [fs]() {
+        if (fs->isFileExist("mounted/hello.txt"))
+            return std::string("failed: file exists before mounting");
+
+        if (!fs->mountPack("Misc/pack.zip"))
+            return std::string("failed: can not mount Misc/pack.zip");
+
+        std::string hello = fs->getStringFromFile("mounted/hello.txt");
+        if (hello != "Hello from pack.zip!")
+            return std::string("failed: compressed file content is '" + hello + "'");
+
+        Data stored = fs->getDataFromFile("mounted/sub/stored.txt");
+        if (stored.getSize() != 26 || memcmp(stored.getBytes(), "Stored without compression", 26) != 0)
+            return std::string("failed: stored file content");
+
+        if (!fs->isDirectoryExist("mounted/sub") || !fs->isFileExist(fs->fullPathForFilename("mounted/hello.txt")))
+            return std::string("failed: mounted file or directory is missing");
+
+        fs->unmount("Misc/pack.zip");
+        if (fs->isFileExist("mounted/hello.txt") || fs->isDirectoryExist("mounted/sub"))
+            return std::string("failed: file exists after unmounting");
+
+        return std::string("success");
+    };
+
+    resultLabel->setString(runTests());
+}
+
+void TestMountPack::onExit()
+{
+    FileUtils::getInstance()->unmount("Misc/pack.zip");
+    FileUtilsDemo::onExit();
+}
+
+std::string TestMountPack::title() const
+{
+    return "FileUtils: mountPack()";
+}
+
+std::string TestMountPack::subtitle() const
+{
+    return "";
+}
+
+// TestMountPerformance
+
+void TestMountPerformance::onEnter()
+{
+    FileUtilsDemo::onEnter();
+
+    auto fs = FileUtils::getInstance();
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto resultLabel = Label::createWithTTF("", "fonts/Thonburi.ttf", 16);
+    this->addChild(resultLabel);
+    resultLabel->setPosition(winSize.width / 2, winSize.height / 2);
+
+    const int fileCount = 50000;
+    const int searchPathCount = 8;
+    // probing the disk is slow, only a sample is resolved without the manifest
+    const int diskSampleCount = 2000;
+
+    // all files are in the last search path, so every lookup goes through 24 candidates
+    std::string root = fs->getWritablePath() + "mount-performance/";
+    std::vector<std::string> files;
+    std::string manifest;
+    files.reserve(fileCount);
+    for (int i = 0; i < fileCount; ++i)
+    {
+        files.push_back(StringUtils::format("dir%d/file%d.png", i % 100, i));
+        manifest += StringUtils::format("path%d/", searchPathCount - 1) + files.back() + "\n";
+    }
+    _manifestPath = root + "manifest.txt";
+    fs->createDirectory(root);
+    fs->writeStringToFile(manifest, _manifestPath);
+
+    _defaultSearchPathArray = fs->getOriginalSearchPaths();
+    _defaultResolutionsOrderArray = fs->getSearchResolutionsOrder();
+    std::vector<std::string> searchPaths;
+    for (int i = 0; i < searchPathCount; ++i)
+    {
+        searchPaths.push_back(StringUtils::format("%spath%d/", root.c_str(), i));
+    }
+    fs->setSearchPaths(searchPaths);
+    fs->setSearchResolutionsOrder({ "resources-hd", "resources-sd", "" });
+
+    auto resolve = [fs, &files](int count) {
+        fs->purgeCachedEntries();
+        int found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i)
+        {
+            if (!fs->fullPathForFilename(files[i]).empty())
+                ++found;
+        }
+        auto end = std::chrono::steady_clock::now();
+        float micros = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / (float)count;
+        return std::make_pair(found, micros);
+    };
+
+    bool popupNotify = fs->isPopupNotify();
+    fs->setPopupNotify(false);
+    auto disk = resolve(diskSampleCount);
+    fs->mountManifest(_manifestPath, root);
+    auto mounted = resolve(fileCount);
+    fs->setPopupNotify(popupNotify);
+
+    std::string result = StringUtils::format("disk: %.2f us/path (%d of %d found)\nmanifest: %.2f us/path (%d of %d found)\n%d paths: %.1f ms instead of %.1f ms",
+                                             disk.second, disk.first, diskSampleCount,
+                                             mounted.second, mounted.first, fileCount,
+                                             fileCount, mounted.second * fileCount / 1000, disk.second * fileCount / 1000);
+    CCLOG("%s", result.c_str());
+    resultLabel->setString(result);
+}
+
+void TestMountPerformance::onExit()
+{
+    auto fs = FileUtils::getInstance();
+    fs->unmount(_manifestPath);
+    fs->setSearchPaths(_defaultSearchPathArray);
+    fs->setSearchResolutionsOrder(_defaultResolutionsOrderArray);
+    fs->removeDirectory(fs->getWritablePath() + "mount-performance/");
+    FileUtilsDemo::onExit();
+}
+
+std::string TestMountPerformance::title() const
+{
+    return "FileUtils: resolve 50000 paths";
+}
+
+std::string TestMountPerformance::subtitle() const
+{
+    return "8 search paths and 3 resolution orders, with and without a manifest";
+}
+
+// TestGetContentsAsync
+
+void TestGetContentsAsync::onEnter()
+{
+    FileUtilsDemo::onEnter();
+
+    auto fs = FileUtils::getInstance();
+    auto winSize = Director::getInstance()->getWinSize();
+
+    _resultLabel = Label::createWithTTF("reading...", "fonts/Thonburi.ttf", 16);
+    this->addChild(_resultLabel);
+    _resultLabel->setPosition(winSize.width / 2, winSize.height / 2);
+
+    const int fileCount = 5000;
+    std::string root = fs->getWritablePath() + "contents-async/";
+    fs->createDirectory(root);
+    _files.clear();
+    for (int i = 0; i < fileCount; ++i)
+    {
+        _files.push_back(StringUtils::format("%sfile%d.txt", root.c_str(), i));
+        std::string contents(512 + (i * 37) % 3584, 'a' + i % 26);
+        fs->writeStringToFile(contents, _files.back());
+    }
+
+    auto readAllSync = [this, fs]() {
+        auto start = std::chrono::steady_clock::now();
+        Data data;
+        for (const auto& file : _files)
+        {
+            fs->getContents(file, &data);
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0f;
+    };
+
+    evictFiles();
+    float coldSync = readAllSync();
+    float warmSync = readAllSync();
+    _result = StringUtils::format("%d files, sync: cold %.1f ms, warm %.1f ms", fileCount, coldSync, warmSync);
+
+    evictFiles();
+    readAllAsync([this](float coldAsync) {
+        readAllAsync([this, coldAsync](float warmAsync) {
+            _result += StringUtils::format("\nasync: cold %.1f ms, warm %.1f ms", coldAsync, warmAsync);
+            if (_failures > 0)
+                _result += StringUtils::format("\nfailed: %d files were not read correctly", _failures);
+            CCLOG("%s", _result.c_str());
+            _resultLabel->setString(_result);
+        });
+    });
+}
+
+void TestGetContentsAsync::readAllAsync(const std::function<void(float)>& done)
+{
+    auto fs = FileUtils::getInstance();
+    auto start = std::make_shared<std::chrono::steady_clock::time_point>(std::chrono::steady_clock::now());
+
+    _pending = (int)_files.size();
+    _failures = 0;
+    _contents.clear();
+    // the callbacks may come after the test was left
+    retain();
+    for (size_t i = 0; i < _files.size(); ++i)
+    {
+        auto data = std::make_shared<Data>();
+        _contents.push_back(data);
+        // the last file is requested with a higher priority, so it is read before most of the others
+        int priority = (i + 1 == _files.size()) ? 1 : 0;
+        fs->getContentsAsync(_files[i], data.get(), [this, i, data, start, done](FileUtils::Status status) {
+            ssize_t expectedSize = 512 + (i * 37) % 3584;
+            if (status != FileUtils::Status::OK || data->getSize() != expectedSize || data->getBytes()[0] != 'a' + i % 26)
+                ++_failures;
+
+            if (--_pending == 0)
+            {
+                auto end = std::chrono::steady_clock::now();
+                done(std::chrono::duration_cast<std::chrono::microseconds>(end - *start).count() / 1000.0f);
+                release();
+            }
+        }, priority);
+    }
+
+    // a request which didn't start yet can be canceled, the buffer is kept alive by the callback otherwise
+    auto canceled = std::make_shared<Data>();
+    unsigned int requestId = fs->getContentsAsync(_files[0], canceled.get(), [canceled](FileUtils::Status) {}, -1);
+    fs->cancelContentsAsync(requestId);
+}
+
+void TestGetContentsAsync::evictFiles()
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+    // drop the files from the page cache, so the first read comes from the disk
+    for (const auto& file : _files)
+    {
+        int fd = open(file.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
+#endif
+}
+
+void TestGetContentsAsync::onExit()
+{
+    auto fs = FileUtils::getInstance();
+    fs->removeDirectory(fs->getWritablePath() + "contents-async/");
+    FileUtilsDemo::onExit();
+}
+
+std::string TestGetContentsAsync::title() const
+{
+    return "FileUtils: getContentsAsync()";
+}
+
+std::string TestGetContentsAsync::subtitle() const
+{
+    return "Reads 5000 small files cold and warm, blocking and asynchronous";
+}
@@ -280,4 +280,52 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class TestMountPack : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestMountPack);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class TestMountPerformance : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestMountPerformance);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    std::vector<std::string> _defaultSearchPathArray;
+    std::vector<std::string> _defaultResolutionsOrderArray;
+    std::string _manifestPath;
+};
+
+class TestGetContentsAsync : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestGetContentsAsync);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    // reads all files with getContentsAsync and calls done with the milliseconds it took
+    void readAllAsync(const std::function<void(float)>& done);
+    void evictFiles();
+
+    std::vector<std::string> _files;
+    std::vector<std::shared_ptr<cocos2d::Data>> _contents;
+    int _pending;
+    int _failures;
+    std::string _result;
+    cocos2d::Label* _resultLabel;
+};
+
 #endif /* __FILEUTILSTEST_H__ */
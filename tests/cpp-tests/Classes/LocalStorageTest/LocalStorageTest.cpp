@@ -0,0 +1,111 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "LocalStorageTest.h"
+#include "storage/local-storage/LocalStorage.h"
+#include <chrono>
+
+USING_NS_CC;
+
+LocalStorageTests::LocalStorageTests()
+{
+    ADD_TEST_CASE(LocalStorageBenchmark);
+}
+
+LocalStorageBenchmark::LocalStorageBenchmark()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    auto item1k = MenuItemFont::create("1k items", [this](Ref*) { runBenchmark(1000); });
+    auto item100k = MenuItemFont::create("100k items", [this](Ref*) { runBenchmark(100000); });
+    auto menu = Menu::create(item1k, item100k, nullptr);
+    menu->alignItemsHorizontallyWithPadding(40);
+    menu->setPosition(Vec2(s.width / 2, s.height - 80));
+    addChild(menu, 1);
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 18);
+    _label->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(_label);
+}
+
+std::string LocalStorageBenchmark::title() const
+{
+    return "LocalStorage Benchmark";
+}
+
+std::string LocalStorageBenchmark::subtitle() const
+{
+    return "one transaction per item vs batched vs write-behind";
+}
+
+void LocalStorageBenchmark::runBenchmark(int itemCount)
+{
+    std::string path = FileUtils::getInstance()->getWritablePath() + "LocalStorageBenchmark.db";
+    localStorageInit(path);
+    localStorageClear();
+
+    std::vector<std::pair<std::string, std::string>> items;
+    items.reserve(itemCount);
+    for (int i = 0; i < itemCount; ++i)
+    {
+        items.emplace_back(StringUtils::format("key_%d", i), StringUtils::format("value_%d", i));
+    }
+
+    // one autocommit statement per item, as localStorageSetItem always did
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& item : items)
+    {
+        localStorageSetItem(item.first, item.second);
+    }
+    auto singleTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+    localStorageClear();
+
+    begin = std::chrono::steady_clock::now();
+    localStorageSetItems(items);
+    auto batchTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+    localStorageClear();
+
+    localStorageSetWriteBehind(true);
+    begin = std::chrono::steady_clock::now();
+    for (const auto& item : items)
+    {
+        localStorageSetItem(item.first, item.second);
+    }
+    auto queueTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+    localStorageFlush();
+    auto writeBehindTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+    localStorageSetWriteBehind(false);
+
+    std::string value;
+    bool verified = localStorageGetItem(items.back().first, &value) && value == items.back().second;
+
+    localStorageClear();
+    localStorageFree();
+    FileUtils::getInstance()->removeFile(path);
+
+    auto result = StringUtils::format("%d items\nsetItem: %.2f ms\nsetItems: %.2f ms\nwrite-behind: %.2f ms queued, %.2f ms flushed\n%s",
+                                      itemCount, singleTime, batchTime, queueTime, writeBehindTime, verified ? "verified" : "verification failed");
+    _label->setString(result);
+    CCLOG("%s", result.c_str());
+}
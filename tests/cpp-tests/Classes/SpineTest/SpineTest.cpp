@@ -47,6 +47,8 @@ SpineTests::SpineTests()
     ADD_TEST_CASE(RaptorExample);
     ADD_TEST_CASE(SpineboyExample);
     ADD_TEST_CASE(TankExample);
+    ADD_TEST_CASE(SkeletonUpdaterExample);
+    ADD_TEST_CASE(SkeletonBatchingExample);
 }
 
 SpineTestLayer::SpineTestLayer()
@@ -234,3 +236,229 @@ bool TankExample::init () {
     
     return true;
 }
+
+// SkeletonUpdaterExample
+
+SkeletonUpdaterExample::SkeletonUpdaterExample ()
+: _atlas(nullptr)
+, _attachmentLoader(nullptr)
+, _skeletonData(nullptr)
+, _skeletons(nullptr)
+, _label(nullptr)
+, _countItem(nullptr)
+, _parallelItem(nullptr)
+, _count(50)
+, _parallel(true)
+{}
+
+bool SkeletonUpdaterExample::init () {
+    if (!SpineTestLayer::init()) return false;
+    
+    _title = "SkeletonUpdaterExample";
+    
+    // All skeletons share the atlas and skeleton data, only the pose is per instance.
+    _atlas = spAtlas_createFromFile("spine/spineboy.atlas", 0);
+    CCASSERT(_atlas, "Error reading atlas file.");
+    _attachmentLoader = (spAttachmentLoader*)Cocos2dAttachmentLoader_create(_atlas);
+    
+    spSkeletonJson* json = spSkeletonJson_createWithLoader(_attachmentLoader);
+    json->scale = 0.3f;
+    _skeletonData = spSkeletonJson_readSkeletonDataFile(json, "spine/spineboy-ess.json");
+    CCASSERT(_skeletonData, json->error ? json->error : "Error reading skeleton data file.");
+    spSkeletonJson_dispose(json);
+    
+    _skeletons = Node::create();
+    addChild(_skeletons);
+    
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _label->setPosition(Vec2(_contentSize.width / 2, _contentSize.height - 90));
+    addChild(_label, 1);
+    
+    MenuItemFont::setFontSize(16);
+    _countItem = MenuItemFont::create("", CC_CALLBACK_1(SkeletonUpdaterExample::switchCountCallback, this));
+    _parallelItem = MenuItemFont::create("", CC_CALLBACK_1(SkeletonUpdaterExample::switchParallelCallback, this));
+    auto menu = Menu::create(_countItem, _parallelItem, nullptr);
+    menu->alignItemsHorizontallyWithPadding(20);
+    menu->setPosition(Vec2(_contentSize.width / 2, _contentSize.height - 115));
+    addChild(menu, 1);
+    
+    setSkeletonCount(_count);
+    _parallelItem->setString(_parallel ? "Parallel update: on" : "Parallel update: off");
+    
+    return true;
+}
+
+SkeletonUpdaterExample::~SkeletonUpdaterExample () {
+    spSkeletonData_dispose(_skeletonData);
+    spAttachmentLoader_dispose(_attachmentLoader);
+    spAtlas_dispose(_atlas);
+}
+
+void SkeletonUpdaterExample::onEnter () {
+    SpineTestLayer::onEnter();
+    
+    SkeletonUpdater::getInstance()->setEnabled(_parallel);
+    
+    // SkeletonUpdater listens to EVENT_AFTER_UPDATE too, so the update time is taken when drawing starts
+    _frameTimer.start({ Director::EVENT_BEFORE_UPDATE, Director::EVENT_BEFORE_DRAW, Director::EVENT_AFTER_VISIT }, [this]() {
+        char text[128];
+        snprintf(text, sizeof(text), "%d skeletons: update %.2f ms, visit %.2f ms per frame", _count, _frameTimer.getAverageTime(0), _frameTimer.getAverageTime(1));
+        _label->setString(text);
+        CCLOG("SkeletonUpdaterExample: %s, parallel %s", text, _parallel ? "on" : "off");
+    });
+}
+
+void SkeletonUpdaterExample::onExit () {
+    _frameTimer.stop();
+    SkeletonUpdater::getInstance()->setEnabled(false);
+    
+    SpineTestLayer::onExit();
+}
+
+std::string SkeletonUpdaterExample::subtitle () const {
+    return "Animation and vertices of all skeletons computed on worker threads";
+}
+
+void SkeletonUpdaterExample::setSkeletonCount (int count) {
+    _count = count;
+    _skeletons->removeAllChildren();
+    
+    int xMin = _contentSize.width * 0.05f, xMax = _contentSize.width * 0.95f;
+    int yMin = 0, yMax = _contentSize.height * 0.65f;
+    const char* animations[] = { "walk", "run", "jump" };
+    for (int i = 0; i < count; i++) {
+        SkeletonAnimation* skeletonNode = SkeletonAnimation::createWithData(_skeletonData, false);
+        skeletonNode->setAnimation(0, animations[i % 3], true);
+        // desynchronize the skeletons so they don't all show the same pose
+        skeletonNode->update(RandomHelper::random_real(0.0f, 1.0f));
+        skeletonNode->setPosition(Vec2(RandomHelper::random_int(xMin, xMax), RandomHelper::random_int(yMin, yMax)));
+        _skeletons->addChild(skeletonNode);
+    }
+    
+    char text[32];
+    snprintf(text, sizeof(text), "Skeletons: %d", count);
+    _countItem->setString(text);
+    _frameTimer.reset();
+}
+
+void SkeletonUpdaterExample::switchCountCallback (Ref* sender) {
+    setSkeletonCount(_count == 50 ? 200 : _count == 200 ? 500 : 50);
+}
+
+void SkeletonUpdaterExample::switchParallelCallback (Ref* sender) {
+    _parallel = !_parallel;
+    SkeletonUpdater::getInstance()->setEnabled(_parallel);
+    _parallelItem->setString(_parallel ? "Parallel update: on" : "Parallel update: off");
+    _frameTimer.reset();
+}
+
+// SkeletonBatchingExample
+
+SkeletonBatchingExample::SkeletonBatchingExample ()
+: _atlas(nullptr)
+, _attachmentLoader(nullptr)
+, _skeletonData(nullptr)
+, _label(nullptr)
+, _batchingItem(nullptr)
+, _twoColorTintItem(nullptr)
+, _twoColorTint(false)
+, _numCommands(0)
+{}
+
+bool SkeletonBatchingExample::init () {
+    if (!SpineTestLayer::init()) return false;
+    
+    _title = "SkeletonBatchingExample";
+    
+    _atlas = spAtlas_createFromFile("spine/spineboy.atlas", 0);
+    CCASSERT(_atlas, "Error reading atlas file.");
+    _attachmentLoader = (spAttachmentLoader*)Cocos2dAttachmentLoader_create(_atlas);
+    
+    spSkeletonJson* json = spSkeletonJson_createWithLoader(_attachmentLoader);
+    json->scale = 0.3f;
+    _skeletonData = spSkeletonJson_readSkeletonDataFile(json, "spine/spineboy-ess.json");
+    CCASSERT(_skeletonData, json->error ? json->error : "Error reading skeleton data file.");
+    spSkeletonJson_dispose(json);
+    
+    // 100 identical characters next to the other children of the layer, as in a typical battle scene
+    int columns = 20;
+    for (int i = 0; i < 100; i++) {
+        SkeletonAnimation* skeletonNode = SkeletonAnimation::createWithData(_skeletonData, false);
+        skeletonNode->setAnimation(0, "walk", true);
+        skeletonNode->setPosition(Vec2(_contentSize.width * (i % columns + 0.5f) / columns, 30 + (i / columns) * _contentSize.height * 0.12f));
+        addChild(skeletonNode);
+        _skeletonNodes.push_back(skeletonNode);
+    }
+    
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _label->setPosition(Vec2(_contentSize.width / 2, _contentSize.height - 90));
+    addChild(_label, 1);
+    
+    MenuItemFont::setFontSize(16);
+    _batchingItem = MenuItemFont::create("", CC_CALLBACK_1(SkeletonBatchingExample::switchBatchingCallback, this));
+    _twoColorTintItem = MenuItemFont::create("", CC_CALLBACK_1(SkeletonBatchingExample::switchTwoColorTintCallback, this));
+    auto menu = Menu::create(_batchingItem, _twoColorTintItem, nullptr);
+    menu->alignItemsHorizontallyWithPadding(20);
+    menu->setPosition(Vec2(_contentSize.width / 2, _contentSize.height - 115));
+    addChild(menu, 1);
+    
+    return true;
+}
+
+SkeletonBatchingExample::~SkeletonBatchingExample () {
+    spSkeletonData_dispose(_skeletonData);
+    spAttachmentLoader_dispose(_attachmentLoader);
+    spAtlas_dispose(_atlas);
+}
+
+void SkeletonBatchingExample::onEnter () {
+    SpineTestLayer::onEnter();
+    
+    SkeletonRenderer::setBatchingAcrossSkeletons(true);
+    updateMenu();
+    
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    // the batches are reset after drawing, so the commands are counted before rendering
+    _listeners.push_back(dispatcher->addCustomEventListener(Director::EVENT_AFTER_VISIT, [this](EventCustom*) {
+        _numCommands = SkeletonBatch::getInstance()->getNumCommands() + SkeletonTwoColorBatch::getInstance()->getNumCommands();
+    }));
+    _listeners.push_back(dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom*) {
+        auto renderer = Director::getInstance()->getRenderer();
+        char text[128];
+        snprintf(text, sizeof(text), "100 skeletons: %u spine commands, %d draw calls (including the stats)", _numCommands, (int)renderer->getDrawnBatches());
+        _label->setString(text);
+    }));
+}
+
+void SkeletonBatchingExample::onExit () {
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    for (auto listener : _listeners) {
+        dispatcher->removeEventListener(listener);
+    }
+    _listeners.clear();
+    SkeletonRenderer::setBatchingAcrossSkeletons(false);
+    
+    SpineTestLayer::onExit();
+}
+
+std::string SkeletonBatchingExample::subtitle () const {
+    return "Consecutive skeletons with the same material drawn with one command";
+}
+
+void SkeletonBatchingExample::updateMenu () {
+    _batchingItem->setString(SkeletonRenderer::isBatchingAcrossSkeletons() ? "Batching across skeletons: on" : "Batching across skeletons: off");
+    _twoColorTintItem->setString(_twoColorTint ? "Two color tint: on" : "Two color tint: off");
+}
+
+void SkeletonBatchingExample::switchBatchingCallback (Ref* sender) {
+    SkeletonRenderer::setBatchingAcrossSkeletons(!SkeletonRenderer::isBatchingAcrossSkeletons());
+    updateMenu();
+}
+
+void SkeletonBatchingExample::switchTwoColorTintCallback (Ref* sender) {
+    _twoColorTint = !_twoColorTint;
+    for (auto skeletonNode : _skeletonNodes) {
+        skeletonNode->setTwoColorTint(_twoColorTint);
+    }
+    updateMenu();
+}
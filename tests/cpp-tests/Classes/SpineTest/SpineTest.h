@@ -109,4 +109,65 @@ private:
     spine::SkeletonAnimation* skeletonNode;
 };
 
+class SkeletonUpdaterExample : public SpineTestLayer {
+public:
+    CREATE_FUNC(SkeletonUpdaterExample);
+    SkeletonUpdaterExample ();
+    ~SkeletonUpdaterExample ();
+    
+    virtual bool init ();
+    virtual void onEnter () override;
+    virtual void onExit () override;
+    virtual std::string subtitle () const override;
+    
+protected:
+    void setSkeletonCount (int count);
+    void switchCountCallback (cocos2d::Ref* sender);
+    void switchParallelCallback (cocos2d::Ref* sender);
+    
+    spAtlas* _atlas;
+    spAttachmentLoader* _attachmentLoader;
+    spSkeletonData* _skeletonData;
+    
+    cocos2d::Node* _skeletons;
+    cocos2d::Label* _label;
+    cocos2d::MenuItemFont* _countItem;
+    cocos2d::MenuItemFont* _parallelItem;
+    int _count;
+    bool _parallel;
+    
+    // Update time covers the scheduler and SkeletonUpdater, visit time the draw calls of the scene.
+    FrameTimer _frameTimer;
+};
+
+class SkeletonBatchingExample : public SpineTestLayer {
+public:
+    CREATE_FUNC(SkeletonBatchingExample);
+    SkeletonBatchingExample ();
+    ~SkeletonBatchingExample ();
+    
+    virtual bool init ();
+    virtual void onEnter () override;
+    virtual void onExit () override;
+    virtual std::string subtitle () const override;
+    
+protected:
+    void switchBatchingCallback (cocos2d::Ref* sender);
+    void switchTwoColorTintCallback (cocos2d::Ref* sender);
+    void updateMenu ();
+    
+    spAtlas* _atlas;
+    spAttachmentLoader* _attachmentLoader;
+    spSkeletonData* _skeletonData;
+    
+    std::vector<spine::SkeletonAnimation*> _skeletonNodes;
+    cocos2d::Label* _label;
+    cocos2d::MenuItemFont* _batchingItem;
+    cocos2d::MenuItemFont* _twoColorTintItem;
+    bool _twoColorTint;
+    
+    std::vector<cocos2d::EventListenerCustom*> _listeners;
+    uint32_t _numCommands;
+};
+
 #endif // _EXAMPLELAYER_H_
@@ -29,10 +29,15 @@
 #include "2d/CCCameraBackgroundBrush.h"
 #include "3d/CCSprite3DMaterial.h"
 #include "3d/CCMotionStreak3D.h"
+#include "3d/CCBundle3D.h"
+#include "3d/CCSceneBVH.h"
 
 #include "extensions/Particle3D/PU/CCPUParticleSystem3D.h"
 #include <cmath>
 #include <algorithm>
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <sys/resource.h>
+#endif
 #include "../testResource.h"
 
 USING_NS_CC;
@@ -71,6 +76,10 @@ Sprite3DTests::Sprite3DTests()
     ADD_TEST_CASE(Sprite3DPropertyTest);
     ADD_TEST_CASE(Sprite3DNormalMappingTest);
     ADD_TEST_CASE(Issue16155Test);
+    ADD_TEST_CASE(Sprite3DInstancingTest);
+    ADD_TEST_CASE(Sprite3DCrowdTest);
+    ADD_TEST_CASE(Sprite3DBVHTest);
+    ADD_TEST_CASE(Bundle3DLoadTest);
 }
 
 //------------------------------------------------------------------
@@ -2733,3 +2742,431 @@ std::string Issue16155Test::subtitle() const
 {
     return "Should not leak texture. See console";
 }
+
+//
+// Sprite3DInstancingTest
+//
+Sprite3DInstancingTest::Sprite3DInstancingTest()
+: _root(nullptr)
+, _statsLabel(nullptr)
+, _instancingItem(nullptr)
+, _beforeDrawListener(nullptr)
+, _afterVisitListener(nullptr)
+, _submitTime(0.0f)
+, _drawCalls(0)
+, _frames(0)
+, _instancing(true)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    auto camera = Camera::createPerspective(60, s.width / s.height, 1.0f, 1000.0f);
+    camera->setCameraFlag(CameraFlag::USER1);
+    camera->setPosition3D(Vec3(0.0f, 120.0f, 200.0f));
+    camera->lookAt(Vec3::ZERO, Vec3::UNIT_Y);
+    addChild(camera);
+
+    _root = Node::create();
+    addChild(_root);
+
+    TTFConfig ttfConfig("fonts/arial.ttf", 20);
+    auto label1 = Label::createWithTTF(ttfConfig, "Instancing: On");
+    _instancingItem = MenuItemLabel::create(label1, CC_CALLBACK_1(Sprite3DInstancingTest::switchInstancing, this));
+    auto label2 = Label::createWithTTF(ttfConfig, " - ");
+    auto decrease = MenuItemLabel::create(label2, CC_CALLBACK_1(Sprite3DInstancingTest::delSpritesCallback, this));
+    auto label3 = Label::createWithTTF(ttfConfig, " + ");
+    auto increase = MenuItemLabel::create(label3, CC_CALLBACK_1(Sprite3DInstancingTest::addSpritesCallback, this));
+    auto menu = Menu::create(_instancingItem, decrease, increase, nullptr);
+    menu->alignItemsHorizontallyWithPadding(20);
+    menu->setPosition(Vec2(s.width / 2, s.height - 70));
+    addChild(menu, 1);
+
+    _statsLabel = Label::createWithTTF(ttfConfig, "");
+    _statsLabel->setPosition(Vec2(s.width / 2, s.height - 95));
+    addChild(_statsLabel, 1);
+
+    // visit and render of the running scene happen between these two events
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _beforeDrawListener = dispatcher->addCustomEventListener(Director::EVENT_BEFORE_DRAW, [this](EventCustom*) {
+        _submitBegin = std::chrono::steady_clock::now();
+    });
+    _afterVisitListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_VISIT, [this](EventCustom*) {
+        auto elapsed = std::chrono::steady_clock::now() - _submitBegin;
+        _submitTime += std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / 1000.0f;
+        _drawCalls = Director::getInstance()->getRenderer()->getDrawnBatches();
+        ++_frames;
+    });
+
+    addSpritesWithCount(1000);
+    scheduleUpdate();
+}
+
+Sprite3DInstancingTest::~Sprite3DInstancingTest()
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_beforeDrawListener);
+    dispatcher->removeEventListener(_afterVisitListener);
+}
+
+std::string Sprite3DInstancingTest::title() const
+{
+    return "Sprite3D Instancing Test";
+}
+
+std::string Sprite3DInstancingTest::subtitle() const
+{
+    return "Compare draw calls and submission time";
+}
+
+void Sprite3DInstancingTest::update(float delta)
+{
+    _root->setRotation3D(_root->getRotation3D() + Vec3(0.0f, 10.0f * delta, 0.0f));
+
+    if (_frames >= 30)
+    {
+        char buf[128];
+        sprintf(buf, "%d sprites, %d draw calls, %.2f ms/frame",
+                (int)_sprites.size(), (int)_drawCalls, _submitTime / _frames);
+        _statsLabel->setString(buf);
+        _submitTime = 0.0f;
+        _frames = 0;
+    }
+}
+
+void Sprite3DInstancingTest::switchInstancing(Ref* sender)
+{
+    _instancing = !_instancing;
+    for (auto sprite : _sprites)
+        sprite->setInstancingEnabled(_instancing);
+    _instancingItem->setString(_instancing ? "Instancing: On" : "Instancing: Off");
+}
+
+void Sprite3DInstancingTest::addSpritesCallback(Ref* sender)
+{
+    addSpritesWithCount(500);
+}
+
+void Sprite3DInstancingTest::delSpritesCallback(Ref* sender)
+{
+    delSpritesWithCount(500);
+}
+
+void Sprite3DInstancingTest::addSpritesWithCount(int count)
+{
+    const int columns = 50;
+    for (int i = 0; i < count; ++i)
+    {
+        int index = (int)_sprites.size();
+        auto sprite = Sprite3D::create("Sprite3DTest/boss1.obj");
+        sprite->setTexture("Sprite3DTest/boss.png");
+        sprite->setScale(0.5f);
+        sprite->setRotation3D(Vec3(90.0f, 0.0f, 0.0f));
+        sprite->setPosition3D(Vec3((index % columns - columns / 2) * 8.0f, 0.0f, (index / columns - columns / 2) * 8.0f));
+        sprite->setColor(Color3B(55 + CCRANDOM_0_1() * 200, 55 + CCRANDOM_0_1() * 200, 55 + CCRANDOM_0_1() * 200));
+        sprite->setInstancingEnabled(_instancing);
+        sprite->setCameraMask((unsigned short)CameraFlag::USER1);
+        _root->addChild(sprite);
+        _sprites.push_back(sprite);
+    }
+}
+
+void Sprite3DInstancingTest::delSpritesWithCount(int count)
+{
+    while (count-- > 0 && !_sprites.empty())
+    {
+        _sprites.back()->removeFromParent();
+        _sprites.pop_back();
+    }
+}
+
+//
+// Sprite3DCrowdTest
+//
+Sprite3DCrowdTest::Sprite3DCrowdTest()
+: _statsLabel(nullptr)
+, _crowdItem(nullptr)
+, _elapsed(0.0f)
+, _crowdMode(true)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    const std::string fileName = "Sprite3DTest/orc.c3b";
+    auto animation = Animation3D::create(fileName);
+    const int columns = 20, rows = 20, phases = 8;
+    for (int i = 0; i < columns * rows; ++i)
+    {
+        auto sprite = Sprite3D::create(fileName);
+        sprite->setScale(0.6f);
+        sprite->setRotation3D(Vec3(0.0f, 180.0f, 0.0f));
+        sprite->setPosition(Vec2((i % columns + 0.5f) * s.width / columns, (i / columns + 0.5f) * (s.height - 120.0f) / rows));
+        addChild(sprite);
+        _sprites.push_back(sprite);
+
+        if (animation)
+        {
+            // every character starts at one of a few phases, crowd mode evaluates one pose per phase
+            float phase = animation->getDuration() * (i % phases) / phases;
+            sprite->runAction(Sequence::create(DelayTime::create(phase), CallFunc::create([this, sprite, animation]() {
+                auto animate = Animate3D::create(animation);
+                animate->setCrowdMode(_crowdMode);
+                auto repeat = RepeatForever::create(animate);
+                repeat->setTag(110);
+                sprite->runAction(repeat);
+            }), nullptr));
+        }
+    }
+
+    TTFConfig ttfConfig("fonts/arial.ttf", 20);
+    auto label = Label::createWithTTF(ttfConfig, "Crowd Mode: On");
+    _crowdItem = MenuItemLabel::create(label, CC_CALLBACK_1(Sprite3DCrowdTest::switchCrowdMode, this));
+    auto menu = Menu::create(_crowdItem, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height - 70));
+    addChild(menu, 1);
+
+    _statsLabel = Label::createWithTTF(ttfConfig, "");
+    _statsLabel->setPosition(Vec2(s.width / 2, s.height - 95));
+    addChild(_statsLabel, 1);
+
+    Animation3DPoseCache::getInstance()->resetStats();
+    scheduleUpdate();
+}
+
+std::string Sprite3DCrowdTest::title() const
+{
+    return "Sprite3D Crowd Test";
+}
+
+std::string Sprite3DCrowdTest::subtitle() const
+{
+    return "400 orcs at 8 phases share poses";
+}
+
+void Sprite3DCrowdTest::update(float delta)
+{
+    _elapsed += delta;
+    if (_elapsed < 0.5f)
+        return;
+    _elapsed = 0.0f;
+
+    auto cache = Animation3DPoseCache::getInstance();
+    auto stats = cache->getStats();
+    unsigned int lookups = stats.hits + stats.misses;
+    char buf[128];
+    sprintf(buf, "hit rate %.1f%%, %d poses, %.1f KB",
+            lookups ? 100.0f * stats.hits / lookups : 0.0f, (int)stats.poseCount, stats.memoryBytes / 1024.0f);
+    _statsLabel->setString(buf);
+    cache->resetStats();
+}
+
+void Sprite3DCrowdTest::onExit()
+{
+    Sprite3DTestDemo::onExit();
+    Animation3DPoseCache::getInstance()->removeAllPoses();
+}
+
+void Sprite3DCrowdTest::switchCrowdMode(Ref* sender)
+{
+    _crowdMode = !_crowdMode;
+    for (auto sprite : _sprites)
+    {
+        auto repeat = dynamic_cast<RepeatForever*>(sprite->getActionByTag(110));
+        auto animate = repeat ? dynamic_cast<Animate3D*>(repeat->getInnerAction()) : nullptr;
+        if (animate)
+            animate->setCrowdMode(_crowdMode);
+    }
+    _crowdItem->setString(_crowdMode ? "Crowd Mode: On" : "Crowd Mode: Off");
+}
+
+//
+// Bundle3DLoadTest
+//
+Sprite3DBVHTest::Sprite3DBVHTest()
+: _camera(nullptr)
+, _statsLabel(nullptr)
+, _bvhItem(nullptr)
+, _picked(nullptr)
+, _angle(0.0f)
+, _elapsed(0.0f)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    _camera = Camera::createPerspective(60, s.width / s.height, 1.0f, 500.0f);
+    _camera->setCameraFlag(CameraFlag::USER1);
+    addChild(_camera);
+
+    // a field of static models around the camera, most of them are behind it or out of the sides
+    const int columns = 40, rows = 40;
+    const float spacing = 8.0f;
+    for (int i = 0; i < columns * rows; ++i)
+    {
+        auto sprite = Sprite3D::create("Sprite3DTest/boss1.obj");
+        sprite->setScale(2.0f);
+        sprite->setTexture("Sprite3DTest/boss.png");
+        sprite->setPosition3D(Vec3((i % columns - columns / 2) * spacing, 0.0f, (i / columns - rows / 2) * spacing));
+        sprite->setCameraMask((unsigned short)CameraFlag::USER1);
+        addChild(sprite);
+    }
+    setBVHEnabled(true);
+
+    TTFConfig ttfConfig("fonts/arial.ttf", 20);
+    auto label = Label::createWithTTF(ttfConfig, "BVH: On");
+    _bvhItem = MenuItemLabel::create(label, CC_CALLBACK_1(Sprite3DBVHTest::switchBVH, this));
+    auto menu = Menu::create(_bvhItem, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height - 70));
+    addChild(menu, 1);
+
+    _statsLabel = Label::createWithTTF(ttfConfig, "");
+    _statsLabel->setPosition(Vec2(s.width / 2, s.height - 95));
+    addChild(_statsLabel, 1);
+
+    auto listener = EventListenerTouchAllAtOnce::create();
+    listener->onTouchesEnded = CC_CALLBACK_2(Sprite3DBVHTest::onTouchesEnded, this);
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+
+    scheduleUpdate();
+}
+
+std::string Sprite3DBVHTest::title() const
+{
+    return "Sprite3D BVH Test";
+}
+
+std::string Sprite3DBVHTest::subtitle() const
+{
+    return "1600 models culled through the scene BVH, tap to pick";
+}
+
+void Sprite3DBVHTest::update(float delta)
+{
+    _angle += delta * 0.3f;
+    _camera->setPosition3D(Vec3(cosf(_angle) * 20.0f, 30.0f, sinf(_angle) * 20.0f));
+    _camera->lookAt(Vec3(cosf(_angle) * 120.0f, 0.0f, sinf(_angle) * 120.0f));
+
+    _elapsed += delta;
+    if (_elapsed < 0.5f)
+        return;
+    _elapsed = 0.0f;
+
+    auto bvh = getBVH();
+    if (bvh)
+    {
+        const auto& stats = bvh->getStats();
+        char buf[128];
+        sprintf(buf, "tested %u nodes, visible %u, culled %u, height %d",
+                stats.nodesTested, stats.proxiesVisible, stats.proxiesCulled, bvh->getHeight());
+        _statsLabel->setString(buf);
+        bvh->resetStats();
+    }
+    else
+    {
+        _statsLabel->setString("each model tested against the frustum");
+    }
+}
+
+void Sprite3DBVHTest::switchBVH(Ref* sender)
+{
+    if (_picked)
+    {
+        _picked->setColor(Color3B::WHITE);
+        _picked = nullptr;
+    }
+    setBVHEnabled(!isBVHEnabled());
+    _bvhItem->setString(isBVHEnabled() ? "BVH: On" : "BVH: Off");
+}
+
+void Sprite3DBVHTest::onTouchesEnded(const std::vector<Touch*>& touches, Event* event)
+{
+    auto bvh = getBVH();
+    if (!bvh || touches.empty())
+        return;
+
+    auto location = touches[0]->getLocationInView();
+    location = Director::getInstance()->convertToGL(location);
+    Vec3 nearPoint = _camera->unprojectGL(Vec3(location.x, location.y, 0.0f));
+    Vec3 farPoint = _camera->unprojectGL(Vec3(location.x, location.y, 1.0f));
+
+    if (_picked)
+        _picked->setColor(Color3B::WHITE);
+    _picked = bvh->rayCast(Ray(nearPoint, farPoint - nearPoint));
+    if (_picked)
+        _picked->setColor(Color3B::RED);
+}
+
+Bundle3DLoadTest::Bundle3DLoadTest()
+: _resultLabel(nullptr)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    TTFConfig ttfConfig("fonts/arial.ttf", 20);
+    auto label = Label::createWithTTF(ttfConfig, "Run Again");
+    auto item = MenuItemLabel::create(label, CC_CALLBACK_1(Bundle3DLoadTest::runBenchmark, this));
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height - 70));
+    addChild(menu, 1);
+
+    _resultLabel = Label::createWithTTF(ttfConfig, "");
+    _resultLabel->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(_resultLabel);
+
+    runBenchmark(nullptr);
+}
+
+std::string Bundle3DLoadTest::title() const
+{
+    return "Bundle3D Load Test";
+}
+
+std::string Bundle3DLoadTest::subtitle() const
+{
+    return "Load time and peak RSS of the .c3b test assets";
+}
+
+void Bundle3DLoadTest::runBenchmark(Ref* sender)
+{
+    static const char* files[] = {
+        "Sprite3DTest/LightMapScene.c3b",
+        "Sprite3DTest/ReskinGirl.c3b",
+        "Sprite3DTest/axe.c3b",
+        "Sprite3DTest/boss.c3b",
+        "Sprite3DTest/girl.c3b",
+        "Sprite3DTest/orc.c3b",
+        "Sprite3DTest/sphere.c3b",
+        "Sprite3DTest/teapot.c3b",
+        "Sprite3DTest/tortoise.c3b",
+    };
+
+    // goes through Bundle3D directly, Sprite3D::create would only hit Sprite3DCache after the first run
+    auto begin = std::chrono::steady_clock::now();
+    int meshCount = 0;
+    for (auto file : files)
+    {
+        auto bundle = Bundle3D::createBundle();
+        MeshDatas meshDatas;
+        if (bundle->load(FileUtils::getInstance()->fullPathForFilename(file)) && bundle->loadMeshDatas(meshDatas))
+        {
+            Vector<MeshVertexData*> vertexDatas;
+            for (auto meshData : meshDatas.meshDatas)
+            {
+                vertexDatas.pushBack(MeshVertexData::create(*meshData));
+                ++meshCount;
+            }
+        }
+        Bundle3D::destroyBundle(bundle);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+
+    char buf[256];
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+    long peakKB = usage.ru_maxrss / 1024; // bytes on apple platforms
+#else
+    long peakKB = usage.ru_maxrss;
+#endif
+    sprintf(buf, "%d files, %d meshes in %.2f ms\npeak RSS %ld KB", (int)(sizeof(files) / sizeof(files[0])), meshCount, elapsed, peakKB);
+#else
+    sprintf(buf, "%d files, %d meshes in %.2f ms", (int)(sizeof(files) / sizeof(files[0])), meshCount, elapsed);
+#endif
+    _resultLabel->setString(buf);
+    CCLOG("Bundle3DLoadTest: %s", buf);
+}
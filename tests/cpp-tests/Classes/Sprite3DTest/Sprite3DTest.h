@@ -28,6 +28,7 @@
 
 #include "BaseTest.h"
 #include <string>
+#include <chrono>
 
 namespace cocos2d {
     class Animate3D;
@@ -627,4 +628,85 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class Sprite3DInstancingTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DInstancingTest);
+    Sprite3DInstancingTest();
+    virtual ~Sprite3DInstancingTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float delta) override;
+
+    void switchInstancing(cocos2d::Ref* sender);
+    void addSpritesCallback(cocos2d::Ref* sender);
+    void delSpritesCallback(cocos2d::Ref* sender);
+    void addSpritesWithCount(int count);
+    void delSpritesWithCount(int count);
+protected:
+    cocos2d::Node* _root;
+    cocos2d::Label* _statsLabel;
+    cocos2d::MenuItemLabel* _instancingItem;
+    cocos2d::EventListenerCustom* _beforeDrawListener;
+    cocos2d::EventListenerCustom* _afterVisitListener;
+    std::vector<cocos2d::Sprite3D*> _sprites;
+    std::chrono::steady_clock::time_point _submitBegin;
+    float _submitTime;
+    ssize_t _drawCalls;
+    int _frames;
+    bool _instancing;
+};
+
+class Sprite3DCrowdTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DCrowdTest);
+    Sprite3DCrowdTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float delta) override;
+    virtual void onExit() override;
+
+    void switchCrowdMode(cocos2d::Ref* sender);
+protected:
+    std::vector<cocos2d::Sprite3D*> _sprites;
+    cocos2d::Label* _statsLabel;
+    cocos2d::MenuItemLabel* _crowdItem;
+    float _elapsed;
+    bool _crowdMode;
+};
+
+class Sprite3DBVHTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DBVHTest);
+    Sprite3DBVHTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float delta) override;
+
+    void switchBVH(cocos2d::Ref* sender);
+    void onTouchesEnded(const std::vector<cocos2d::Touch*>& touches, cocos2d::Event* event);
+protected:
+    cocos2d::Camera* _camera;
+    cocos2d::Label* _statsLabel;
+    cocos2d::MenuItemLabel* _bvhItem;
+    cocos2d::Sprite3D* _picked;
+    float _angle;
+    float _elapsed;
+};
+
+class Bundle3DLoadTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Bundle3DLoadTest);
+    Bundle3DLoadTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void runBenchmark(cocos2d::Ref* sender);
+protected:
+    cocos2d::Label* _resultLabel;
+};
+
 #endif
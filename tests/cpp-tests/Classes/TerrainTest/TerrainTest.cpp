@@ -24,6 +24,7 @@
 
 #include "TerrainTest.h"
 #include <cmath>
+#include <chrono>
 
 USING_NS_CC;
 
@@ -32,6 +33,7 @@ TerrainTests::TerrainTests()
     ADD_TEST_CASE(TerrainSimple);
     ADD_TEST_CASE(TerrainWalkThru);
     ADD_TEST_CASE(TerrainWithLightMap);
+    ADD_TEST_CASE(TerrainQueryBenchmark);
 }
 
 Vec3 camera_offset(0, 45, 60);
@@ -398,3 +400,95 @@ void TerrainWithLightMap::onTouchesMoved(const std::vector<cocos2d::Touch*>& tou
     cameraPos+=cameraRightDir*newPos.x*0.5*delta;
     _camera->setPosition3D(cameraPos);
 }
+
+TerrainQueryBenchmark::TerrainQueryBenchmark()
+: _terrain(nullptr)
+, _resultLabel(nullptr)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    Terrain::DetailMap r("TerrainTest/dirt.jpg"),g("TerrainTest/Grass2.jpg",10),b("TerrainTest/road.jpg"),a("TerrainTest/GreenSkin.jpg",20);
+    Terrain::TerrainData data("TerrainTest/heightmap16.jpg","TerrainTest/alphamap.png",r,g,b,a,Size(32,32),40.0f,2);
+    _terrain = Terrain::create(data,Terrain::CrackFixedType::SKIRT);
+    _terrain->setVisible(false);
+    addChild(_terrain);
+
+    TTFConfig ttfConfig("fonts/arial.ttf", 20);
+    auto label = Label::createWithTTF(ttfConfig, "Run Again");
+    auto item = MenuItemLabel::create(label, CC_CALLBACK_1(TerrainQueryBenchmark::runBenchmark, this));
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height - 70));
+    addChild(menu, 1);
+
+    _resultLabel = Label::createWithTTF(ttfConfig, "");
+    _resultLabel->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(_resultLabel);
+
+    runBenchmark(nullptr);
+}
+
+std::string TerrainQueryBenchmark::title() const
+{
+    return "Terrain query benchmark";
+}
+
+std::string TerrainQueryBenchmark::subtitle() const
+{
+    return "100k height queries and 10k ray casts";
+}
+
+void TerrainQueryBenchmark::runBenchmark(Ref* sender)
+{
+    static const int HEIGHT_QUERIES = 100000;
+    static const int RAY_QUERIES = 10000;
+
+    AABB aabb = _terrain->getAABB();
+    std::vector<Vec2> points(HEIGHT_QUERIES);
+    for (auto& point : points)
+    {
+        point.set(RandomHelper::random_real(aabb._min.x, aabb._max.x), RandomHelper::random_real(aabb._min.z, aabb._max.z));
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    float checksum = 0;
+    for (const auto& point : points)
+    {
+        checksum += _terrain->getHeight(point);
+    }
+    auto singleTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+
+    std::vector<float> heights(HEIGHT_QUERIES);
+    begin = std::chrono::steady_clock::now();
+    _terrain->getHeights(points.data(), heights.data(), heights.size());
+    auto batchTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+    for (auto height : heights)
+    {
+        checksum -= height;
+    }
+
+    // rays from above the terrain looking down at random angles
+    std::vector<Ray> rays;
+    rays.reserve(RAY_QUERIES);
+    for (int i = 0; i < RAY_QUERIES; ++i)
+    {
+        Vec3 origin(RandomHelper::random_real(aabb._min.x, aabb._max.x), aabb._max.y + 50, RandomHelper::random_real(aabb._min.z, aabb._max.z));
+        Vec3 direction(RandomHelper::random_real(-1.0f, 1.0f), -1.0f, RandomHelper::random_real(-1.0f, 1.0f));
+        rays.push_back(Ray(origin, direction));
+    }
+
+    begin = std::chrono::steady_clock::now();
+    int hits = 0;
+    Vec3 point;
+    for (const auto& ray : rays)
+    {
+        if (_terrain->getIntersectionPoint(ray, point))
+            ++hits;
+    }
+    auto rayTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+
+    char buf[256];
+    snprintf(buf, sizeof(buf), "getHeight: %.2f ms\ngetHeights: %.2f ms (diff %.3f)\ngetIntersectionPoint: %.2f ms, %d/%d hits",
+             singleTime, batchTime, checksum, rayTime, hits, RAY_QUERIES);
+    _resultLabel->setString(buf);
+    CCLOG("%s", buf);
+}
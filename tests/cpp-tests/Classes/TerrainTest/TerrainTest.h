@@ -110,4 +110,18 @@ protected:
     cocos2d::Camera* _camera;
 };
 
+class TerrainQueryBenchmark : public TerrainTestDemo
+{
+public:
+    CREATE_FUNC(TerrainQueryBenchmark);
+    TerrainQueryBenchmark();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    void runBenchmark(cocos2d::Ref* sender);
+
+protected:
+    cocos2d::Terrain* _terrain;
+    cocos2d::Label* _resultLabel;
+};
+
 #endif // !TERRAIN_TESH_H
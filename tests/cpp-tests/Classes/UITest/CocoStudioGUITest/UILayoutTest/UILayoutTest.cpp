@@ -43,6 +43,8 @@ UILayoutTests::UILayoutTests()
     ADD_TEST_CASE(UILayoutComponent_Berth_Test);
     ADD_TEST_CASE(UILayoutComponent_Berth_Stretch_Test);
     ADD_TEST_CASE(UILayoutTest_Issue19890);
+    ADD_TEST_CASE(UILayoutTest_NodeContentSizeChange);
+    ADD_TEST_CASE(UILayoutTest_IncrementalLayout);
 }
 
 // UILayoutTest
@@ -1015,4 +1017,224 @@ bool UILayoutTest_Issue19890::init()
     panel2->addChild(panel3);
 
     return true;
-}
\ No newline at end of file
+}
+
+// UILayoutTest_NodeContentSizeChange
+
+bool UILayoutTest_NodeContentSizeChange::init()
+{
+    if (!UIScene::init())
+    {
+        return false;
+    }
+
+    const Size widgetSize = _widget->getContentSize();
+
+    auto label = Text::create("Node Content Size Change", "fonts/Marker Felt.ttf", 32);
+    label->setAnchorPoint(Vec2(0.5f, -1.0f));
+    label->setPosition(Vec2(widgetSize.width / 2.0f,
+        widgetSize.height / 2.0f + label->getContentSize().height * 1.5f));
+    _uiLayer->addChild(label);
+
+    Text* alert = Text::create("The label should stay in the top right corner, the sprite in the centre", "fonts/Marker Felt.ttf", 20);
+    alert->setColor(Color3B(159, 168, 176));
+    alert->setPosition(Vec2(widgetSize.width / 2.0f,
+        widgetSize.height / 2.0f - alert->getContentSize().height * 3.075f));
+    _uiLayer->addChild(alert);
+
+    auto panel = Layout::create();
+    panel->setBackGroundColorType(Layout::BackGroundColorType::SOLID);
+    panel->setBackGroundColor(Color3B(60, 60, 120));
+    panel->setContentSize(Size(240, 120));
+    panel->setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+    panel->setPosition(widgetSize / 2.0f);
+    _uiLayer->addChild(panel);
+
+    auto corner = Label::createWithTTF("0", "fonts/Marker Felt.ttf", 20);
+    panel->addChild(corner);
+
+    auto cornerComponent = LayoutComponent::bindLayoutComponent(corner);
+    cornerComponent->setHorizontalEdge(LayoutComponent::HorizontalEdge::Right);
+    cornerComponent->setVerticalEdge(LayoutComponent::VerticalEdge::Top);
+    cornerComponent->setRightMargin(5);
+    cornerComponent->setTopMargin(5);
+
+    auto sprite = Sprite::create("cocosui/ccicon.png");
+    panel->addChild(sprite);
+
+    auto spriteComponent = LayoutComponent::bindLayoutComponent(sprite);
+    spriteComponent->setHorizontalEdge(LayoutComponent::HorizontalEdge::Center);
+    spriteComponent->setVerticalEdge(LayoutComponent::VerticalEdge::Center);
+    Helper::doLayout(panel);
+
+    // The panel keeps its size, only the label and the sprite change theirs.
+    const Size spriteSize = sprite->getContentSize();
+    auto count = std::make_shared<int>(0);
+    schedule([=](float) {
+        ++*count;
+        corner->setString(std::string(*count % 8 + 1, '0' + *count % 10));
+        const float scale = (*count % 4 + 1) / 4.0f;
+        sprite->setTextureRect(Rect(0, 0, spriteSize.width * scale, spriteSize.height * scale));
+        sprite->setAnchorPoint(*count % 2 ? Vec2::ANCHOR_BOTTOM_LEFT : Vec2::ANCHOR_MIDDLE);
+        Helper::doLayout(panel);
+    }, 0.5f, "resize");
+
+    return true;
+}
+
+// UILayoutTest_IncrementalLayout
+
+static const int HUD_PANEL_ROWS = 5;
+static const int HUD_PANEL_COLUMNS = 8;
+static const int HUD_PANEL_CELLS = 5;
+
+UILayoutTest_IncrementalLayout::UILayoutTest_IncrementalLayout()
+: _hud(nullptr)
+, _animatedPanel(nullptr)
+, _counterText(nullptr)
+, _statsLabel(nullptr)
+, _totalStats({ 0, 0, 0, 0, 0.0 })
+, _time(0)
+{
+}
+
+bool UILayoutTest_IncrementalLayout::init()
+{
+    if (!UIScene::init())
+    {
+        return false;
+    }
+
+    const Size widgetSize = _widget->getContentSize();
+
+    auto label = Text::create("Incremental Layout", "fonts/Marker Felt.ttf", 32);
+    label->setAnchorPoint(Vec2(0.5f, -1.0f));
+    label->setPosition(Vec2(widgetSize.width / 2.0f,
+        widgetSize.height / 2.0f + label->getContentSize().height * 1.5f));
+    _uiLayer->addChild(label);
+
+    _statsLabel = Text::create(" ", "fonts/Marker Felt.ttf", 14);
+    _statsLabel->setColor(Color3B(159, 168, 176));
+    _statsLabel->setPosition(Vec2(widgetSize.width / 2.0f, widgetSize.height / 2.0f - 110));
+    _uiLayer->addChild(_statsLabel);
+
+    _hud = Layout::create();
+    _hud->setContentSize(Size(360, 180));
+    _hud->setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+    _hud->setPosition(widgetSize / 2.0f);
+    _uiLayer->addChild(_hud);
+
+    // 40 panels of 25 cells, all sized and placed relative to their parent by LayoutComponent.
+    for (int row = 0; row < HUD_PANEL_ROWS; ++row)
+    {
+        for (int column = 0; column < HUD_PANEL_COLUMNS; ++column)
+        {
+            auto panel = Layout::create();
+            panel->setBackGroundColorType(Layout::BackGroundColorType::SOLID);
+            panel->setBackGroundColor(Color3B(60, 60 + row * 30, 60 + column * 20));
+            panel->setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+            _hud->addChild(panel);
+
+            auto panelComponent = LayoutComponent::bindLayoutComponent(panel);
+            panelComponent->setPercentWidthEnabled(true);
+            panelComponent->setPercentHeightEnabled(true);
+            panelComponent->setPercentWidth(0.9f / HUD_PANEL_COLUMNS);
+            panelComponent->setPercentHeight(0.9f / HUD_PANEL_ROWS);
+            panelComponent->setPositionPercentXEnabled(true);
+            panelComponent->setPositionPercentYEnabled(true);
+            panelComponent->setPositionPercentX((column + 0.5f) / HUD_PANEL_COLUMNS);
+            panelComponent->setPositionPercentY((row + 0.5f) / HUD_PANEL_ROWS);
+            if (_animatedPanel == nullptr)
+            {
+                _animatedPanel = panelComponent;
+            }
+
+            for (int cell = 0; cell < HUD_PANEL_CELLS * HUD_PANEL_CELLS; ++cell)
+            {
+                auto icon = Layout::create();
+                icon->setBackGroundColorType(Layout::BackGroundColorType::SOLID);
+                icon->setBackGroundColor(Color3B(200, 200, 120));
+                icon->setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+                panel->addChild(icon);
+
+                auto iconComponent = LayoutComponent::bindLayoutComponent(icon);
+                iconComponent->setPercentWidthEnabled(true);
+                iconComponent->setPercentHeightEnabled(true);
+                iconComponent->setPercentWidth(0.6f / HUD_PANEL_CELLS);
+                iconComponent->setPercentHeight(0.6f / HUD_PANEL_CELLS);
+                iconComponent->setPositionPercentXEnabled(true);
+                iconComponent->setPositionPercentYEnabled(true);
+                iconComponent->setPositionPercentX((cell % HUD_PANEL_CELLS + 0.5f) / HUD_PANEL_CELLS);
+                iconComponent->setPositionPercentY((cell / HUD_PANEL_CELLS + 0.5f) / HUD_PANEL_CELLS);
+            }
+        }
+    }
+    Helper::doLayout(_hud);
+
+    // A linear layout is laid out again when the size of a child changes.
+    auto column = Layout::create();
+    column->setLayoutType(Layout::Type::VERTICAL);
+    column->setContentSize(Size(80, 100));
+    column->setPosition(Vec2(widgetSize.width / 2.0f + 190, widgetSize.height / 2.0f - 50));
+    _uiLayer->addChild(column);
+    for (int i = 0; i < 4; ++i)
+    {
+        auto text = Text::create(StringUtils::format("Row %d", i), "fonts/Marker Felt.ttf", 14);
+        column->addChild(text);
+        if (_counterText == nullptr)
+        {
+            _counterText = text;
+        }
+    }
+
+    scheduleUpdate();
+
+    return true;
+}
+
+void UILayoutTest_IncrementalLayout::onEnter()
+{
+    UIScene::onEnter();
+
+    Helper::setLayoutStatsEnabled(true);
+
+    _frameTimer.setFrameCallbacks([]() {
+        Helper::resetLayoutStats();
+    }, [this]() {
+        const Helper::LayoutStats& stats = Helper::getLayoutStats();
+        _totalStats.layoutPasses += stats.layoutPasses;
+        _totalStats.arrangedChildren += stats.arrangedChildren;
+        _totalStats.componentRefreshes += stats.componentRefreshes;
+        _totalStats.skippedSubtrees += stats.skippedSubtrees;
+        _totalStats.layoutTime += stats.layoutTime;
+    });
+    _frameTimer.start({ Director::EVENT_BEFORE_UPDATE, Director::EVENT_AFTER_VISIT }, [this]() {
+        const unsigned int frames = _frameTimer.getFrames();
+        std::string text = StringUtils::format("Per frame: %.3f ms, %u component refreshes, %u subtrees skipped, %u layout passes of %u children",
+            _totalStats.layoutTime / frames, _totalStats.componentRefreshes / frames, _totalStats.skippedSubtrees / frames,
+            _totalStats.layoutPasses / frames, _totalStats.arrangedChildren / frames);
+        _statsLabel->setString(text);
+        CCLOG("UILayoutTest_IncrementalLayout: %s", text.c_str());
+        _totalStats = { 0, 0, 0, 0, 0.0 };
+    });
+}
+
+void UILayoutTest_IncrementalLayout::onExit()
+{
+    _frameTimer.stop();
+
+    Helper::setLayoutStatsEnabled(false);
+
+    UIScene::onExit();
+}
+
+void UILayoutTest_IncrementalLayout::update(float dt)
+{
+    _time += dt;
+
+    // Only the cells of the resized panel have to be laid out again.
+    _animatedPanel->setPercentWidth((0.9f + 0.3f * sinf(_time * 3.0f)) / HUD_PANEL_COLUMNS);
+    Helper::doLayout(_hud);
+
+    _counterText->setString(StringUtils::format("%d", static_cast<int>(_time * 10.0f)));
+}
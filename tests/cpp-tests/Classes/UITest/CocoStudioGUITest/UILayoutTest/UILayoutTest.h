@@ -170,4 +170,36 @@ public:
     CREATE_FUNC(UILayoutTest_Issue19890);
 };
 
+// Nodes that are not widgets keep their alignment when their size changes
+class UILayoutTest_NodeContentSizeChange : public UIScene
+{
+public:
+    virtual bool init() override;
+
+    CREATE_FUNC(UILayoutTest_NodeContentSizeChange);
+};
+
+// Layout cost per frame of a HUD where one panel is resized every frame
+class UILayoutTest_IncrementalLayout : public UIScene
+{
+public:
+    CREATE_FUNC(UILayoutTest_IncrementalLayout);
+
+    UILayoutTest_IncrementalLayout();
+
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+
+protected:
+    cocos2d::ui::Layout* _hud;
+    cocos2d::ui::LayoutComponent* _animatedPanel;
+    cocos2d::ui::Text* _counterText;
+    cocos2d::ui::Text* _statsLabel;
+    FrameTimer _frameTimer;
+    cocos2d::ui::Helper::LayoutStats _totalStats;
+    float _time;
+};
+
 #endif /* defined(__TestCpp__UILayoutTest__) */
@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include "UIListViewTest.h"
+#include <chrono>
 
 USING_NS_CC;
 using namespace cocos2d::ui;
@@ -41,6 +42,7 @@ UIListViewTests::UIListViewTests()
     ADD_TEST_CASE(UIListViewTest_PaddingHorizontal);
     ADD_TEST_CASE(Issue12692);
     ADD_TEST_CASE(Issue8316);
+    ADD_TEST_CASE(UIListViewTest_Virtualized);
 }
 
 // UIListViewTest_Vertical
@@ -1081,3 +1083,125 @@ void UIListViewTest_Padding::sliderEvent(Ref *pSender, Slider::EventType type)
         }
     }
 }
+
+
+// UIListViewTest_Virtualized
+
+static const ssize_t VIRTUALIZED_ITEM_COUNT = 100000;
+
+UIListViewTest_Virtualized::UIListViewTest_Virtualized()
+: _listView(nullptr)
+, _statusLabel(nullptr)
+, _boundItems(0)
+, _scrollDown(true)
+{
+}
+
+bool UIListViewTest_Virtualized::init()
+{
+    if (UIScene::init())
+    {
+        Size widgetSize = _widget->getContentSize();
+
+        auto label = Text::create("Virtualized ListView with 100000 items", "fonts/Marker Felt.ttf", 20);
+        label->setAnchorPoint(Vec2(0.5f, -1.0f));
+        label->setPosition(Vec2(widgetSize.width / 2.0f,
+                                widgetSize.height / 2.0f + label->getContentSize().height * 1.5f + 30));
+        _uiLayer->addChild(label);
+
+        _statusLabel = Text::create(" ", "fonts/Marker Felt.ttf", 14);
+        _statusLabel->setColor(Color3B(159, 168, 176));
+        _statusLabel->setPosition(Vec2(widgetSize.width / 2.0f, widgetSize.height / 2.0f - 90));
+        _uiLayer->addChild(_statusLabel);
+
+        _listView = ListView::create();
+        _listView->setDirection(ui::ScrollView::Direction::VERTICAL);
+        _listView->setBounceEnabled(true);
+        _listView->setBackGroundImage("cocosui/green_edit.png");
+        _listView->setBackGroundImageScale9Enabled(true);
+        _listView->setContentSize(Size(240, 130));
+        _listView->setPosition(Vec2((widgetSize - _listView->getContentSize()) / 2.0f));
+        _listView->setScrollBarPositionFromCorner(Vec2(7, 7));
+        _listView->setItemsMargin(2);
+        _listView->setGravity(ListView::Gravity::CENTER_HORIZONTAL);
+        _uiLayer->addChild(_listView);
+
+        Layout* model = Layout::create();
+        model->setBackGroundColorType(Layout::BackGroundColorType::SOLID);
+        model->setBackGroundColor(Color3B(80, 120, 160));
+        model->setTouchEnabled(true);
+        auto title = Text::create(" ", "fonts/Marker Felt.ttf", 14);
+        title->setName("Title");
+        model->addChild(title);
+        _listView->setItemModel(model);
+
+        // Rows of three heights, so the offsets of the items can't be calculated from the index.
+        auto itemSize = [](ListView*, ssize_t index) {
+            return Size(220, 20 + (index % 3) * 10);
+        };
+        auto start = std::chrono::steady_clock::now();
+        _listView->setItemDataSource([](ListView*) {
+            return VIRTUALIZED_ITEM_COUNT;
+        }, itemSize, [this, itemSize](ListView* listView, ssize_t index, Widget* item) {
+            Size size = itemSize(listView, index);
+            item->setContentSize(size);
+            auto title = static_cast<Text*>(item->getChildByName("Title"));
+            title->setString(StringUtils::format("Row %zd", index));
+            title->setPosition(Vec2(size / 2.0f));
+            ++_boundItems;
+            return item;
+        });
+        _listView->forceDoLayout();
+        double buildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        CCLOG("UIListViewTest_Virtualized: %zd items built in %.3f ms, %zd widgets alive",
+              _listView->getItemCount(), buildTime, _listView->getChildrenCount());
+
+        _listView->addEventListener((ui::ListView::ccListViewCallback)[this](Ref*, ListView::EventType type) {
+            if (type == ListView::EventType::ON_SELECTED_ITEM_END)
+            {
+                CCLOG("select row %zd", _listView->getCurSelectedIndex());
+            }
+        });
+
+        // Scroll the whole list back and forth to measure the cost of recycling items.
+        auto button = Button::create("cocosui/animationbuttonnormal.png", "cocosui/animationbuttonpressed.png");
+        button->setTitleText("Scroll");
+        button->setPosition(Vec2(widgetSize.width / 2.0f + 170, widgetSize.height / 2.0f));
+        button->addClickEventListener([this](Ref*) {
+            if (_scrollDown)
+            {
+                _listView->scrollToBottom(20.0f, false);
+            }
+            else
+            {
+                _listView->scrollToTop(20.0f, false);
+            }
+            _scrollDown = !_scrollDown;
+        });
+        _uiLayer->addChild(button);
+
+        return true;
+    }
+    return false;
+}
+
+void UIListViewTest_Virtualized::onEnter()
+{
+    UIScene::onEnter();
+
+    // Binding happens while ListView is visited, so measure update and visit together.
+    _frameTimer.start({ Director::EVENT_BEFORE_UPDATE, Director::EVENT_AFTER_VISIT }, [this]() {
+        std::string status = StringUtils::format("%zd widgets alive, %d binds, update + visit %.3f ms per frame, max %.3f ms",
+                                                 _listView->getChildrenCount(), _boundItems, _frameTimer.getAverageTime(), _frameTimer.getMaxTime());
+        _statusLabel->setString(status);
+        CCLOG("UIListViewTest_Virtualized: %s", status.c_str());
+        _boundItems = 0;
+    });
+}
+
+void UIListViewTest_Virtualized::onExit()
+{
+    _frameTimer.stop();
+
+    UIScene::onExit();
+}
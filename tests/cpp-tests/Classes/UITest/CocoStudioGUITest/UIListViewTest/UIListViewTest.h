@@ -217,4 +217,24 @@ public:
     }
 };
 
+// Benchmark of a virtualized ListView with 100000 items of different heights
+class UIListViewTest_Virtualized : public UIScene
+{
+public:
+    CREATE_FUNC(UIListViewTest_Virtualized);
+
+    UIListViewTest_Virtualized();
+
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+protected:
+    cocos2d::ui::ListView* _listView;
+    cocos2d::ui::Text* _statusLabel;
+    FrameTimer _frameTimer;
+    int _boundItems;
+    bool _scrollDown;
+};
+
 #endif /* defined(__TestCpp__UIListViewTest__) */
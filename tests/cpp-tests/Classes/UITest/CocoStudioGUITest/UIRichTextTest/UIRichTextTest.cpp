@@ -26,6 +26,8 @@ THE SOFTWARE.
 #include "editor-support/cocostudio/CCArmatureDataManager.h"
 #include "editor-support/cocostudio/CCArmature.h"
 
+#include <chrono>
+
 USING_NS_CC;
 using namespace cocos2d::ui;
 
@@ -49,6 +51,7 @@ UIRichTextTests::UIRichTextTests()
     ADD_TEST_CASE(UIRichTextXMLGlow);
     ADD_TEST_CASE(UIRichTextXMLExtend);
     ADD_TEST_CASE(UIRichTextXMLSpace);
+    ADD_TEST_CASE(UIRichTextChatBenchmark);
 }
 
 
@@ -1879,3 +1882,84 @@ void UIRichTextXMLSpace::switchAlignment(Ref *sender, Widget::TouchEventType typ
         _richText->setHorizontalAlignment(alignment);
     }
 }
+
+//
+// UIRichTextChatBenchmark
+//
+static const int CHAT_MESSAGE_COUNT = 500;
+
+bool UIRichTextChatBenchmark::init()
+{
+    if (UIScene::init())
+    {
+        Size widgetSize = _widget->getContentSize();
+
+        auto subtitle = Text::create(StringUtils::format("%d rich messages in a list", CHAT_MESSAGE_COUNT), "fonts/Marker Felt.ttf", 20);
+        subtitle->setPosition(Vec2(widgetSize.width / 2.0f, widgetSize.height / 2.0f + 80));
+        _widget->addChild(subtitle);
+
+        _status = Text::create(" ", "fonts/Marker Felt.ttf", 14);
+        _status->setPosition(Vec2(widgetSize.width / 2.0f, widgetSize.height / 2.0f + 60));
+        _widget->addChild(_status);
+
+        _listView = ListView::create();
+        _listView->setDirection(ui::ScrollView::Direction::VERTICAL);
+        _listView->setBounceEnabled(true);
+        _listView->setContentSize(Size(280, 160));
+        _listView->setPosition(Vec2((widgetSize.width - 280) / 2.0f, widgetSize.height / 2.0f - 110));
+        _widget->addChild(_listView);
+
+        // Mostly plain text in a few TTF faces, with some bold names and links mixed in,
+        // which is what a chat window is made of.
+        static const char* faces[] = { "fonts/Marker Felt.ttf", "fonts/arial.ttf" };
+        static const char* colors[] = { "#ffff00", "#00ffff", "#ff80ff" };
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < CHAT_MESSAGE_COUNT; ++i)
+        {
+            std::string xml = StringUtils::format("<font face='%s' color='%s'>%s%d</font>: ",
+                                                  faces[i % 2], colors[i % 3], (i % 5 == 0) ? "<b>Guild</b> " : "Player", i);
+            xml += StringUtils::format("<font face='%s' size='14'>message number %d, with enough words to wrap around the end of the line once or twice</font>", faces[(i / 2) % 2], i);
+            if (i % 7 == 0)
+                xml += " <a href='http://www.cocos2d-x.org'>link</a>";
+
+            auto richText = RichText::createWithXML(xml);
+            richText->ignoreContentAdaptWithSize(false);
+            richText->setContentSize(Size(270, 0));
+            richText->formatText();
+            _listView->pushBackCustomItem(richText);
+        }
+        _listView->forceDoLayout();
+        _buildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        _status->setString(StringUtils::format("build: %.2f ms", _buildTime));
+        CCLOG("UIRichTextChatBenchmark: %d messages built in %.3f ms", CHAT_MESSAGE_COUNT, _buildTime);
+
+        // Lays out every message again, the text runs measured during the build are reused.
+        Button* button = Button::create("cocosui/animationbuttonnormal.png", "cocosui/animationbuttonpressed.png");
+        button->setTitleText("relayout");
+        button->setPosition(Vec2(widgetSize.width / 2.0f + 180, widgetSize.height / 2.0f));
+        button->addTouchEventListener(CC_CALLBACK_2(UIRichTextChatBenchmark::relayout, this));
+        _widget->addChild(button);
+
+        return true;
+    }
+    return false;
+}
+
+void UIRichTextChatBenchmark::relayout(Ref* /*sender*/, Widget::TouchEventType type)
+{
+    if (type == Widget::TouchEventType::ENDED)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (auto& item : _listView->getItems())
+        {
+            auto richText = static_cast<RichText*>(item);
+            auto wrapMode = richText->getWrapMode();
+            richText->setWrapMode(wrapMode == RichText::WRAP_PER_WORD ? RichText::WRAP_PER_CHAR : RichText::WRAP_PER_WORD);
+            richText->formatText();
+        }
+        _listView->forceDoLayout();
+        double relayoutTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        _status->setString(StringUtils::format("build: %.2f ms, relayout: %.2f ms", _buildTime, relayoutTime));
+        CCLOG("UIRichTextChatBenchmark: %d messages laid out again in %.3f ms", CHAT_MESSAGE_COUNT, relayoutTime);
+    }
+}
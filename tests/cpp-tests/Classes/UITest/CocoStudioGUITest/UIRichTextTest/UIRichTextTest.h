@@ -280,4 +280,18 @@ protected:
     cocos2d::ui::RichText* _richText;
 };
 
+class UIRichTextChatBenchmark : public UIScene
+{
+public:
+    CREATE_FUNC(UIRichTextChatBenchmark);
+
+    bool init() override;
+    void relayout(cocos2d::Ref* sender, cocos2d::ui::Widget::TouchEventType type);
+
+protected:
+    cocos2d::ui::ListView* _listView;
+    cocos2d::ui::Text* _status;
+    double _buildTime;
+};
+
 #endif /* defined(__TestCpp__UIRichTextTest__) */
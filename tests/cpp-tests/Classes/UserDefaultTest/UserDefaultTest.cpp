@@ -28,6 +28,7 @@
 #include <vector>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
 
 using namespace std;
 
@@ -40,6 +41,7 @@ USING_NS_CC;
 UserDefaultTests::UserDefaultTests()
 {
     ADD_TEST_CASE(UserDefaultTest);
+    ADD_TEST_CASE(UserDefaultBenchmark);
 }
 
 UserDefaultTest::UserDefaultTest()
@@ -201,3 +203,73 @@ UserDefaultTest::~UserDefaultTest()
 }
 
 
+
+UserDefaultBenchmark::UserDefaultBenchmark()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    auto item = MenuItemFont::create("Run Again", CC_CALLBACK_1(UserDefaultBenchmark::runBenchmark, this));
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(Vec2(s.width / 2, s.height - 80));
+    addChild(menu, 1);
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 18);
+    _label->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(_label);
+
+    runBenchmark(nullptr);
+}
+
+std::string UserDefaultBenchmark::title() const
+{
+    return "UserDefault Benchmark";
+}
+
+std::string UserDefaultBenchmark::subtitle() const
+{
+    return "10k get/set operations over 2000 keys";
+}
+
+void UserDefaultBenchmark::runBenchmark(Ref* sender)
+{
+    static const int KEY_COUNT = 2000;
+    static const int OPERATION_COUNT = 10000;
+
+    auto userDefault = UserDefault::getInstance();
+    std::vector<std::string> keys;
+    keys.reserve(KEY_COUNT);
+    for (int i = 0; i < KEY_COUNT; ++i)
+    {
+        keys.push_back(StringUtils::format("benchmark_key_%d", i));
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < OPERATION_COUNT / 2; ++i)
+    {
+        userDefault->setIntegerForKey(keys[i % KEY_COUNT].c_str(), i);
+    }
+    auto setTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+
+    begin = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for (int i = 0; i < OPERATION_COUNT / 2; ++i)
+    {
+        sum += userDefault->getIntegerForKey(keys[i % KEY_COUNT].c_str());
+    }
+    auto getTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+
+    begin = std::chrono::steady_clock::now();
+    userDefault->flush();
+    auto flushTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() / 1000.0f;
+
+    for (const auto& key : keys)
+    {
+        userDefault->deleteValueForKey(key.c_str());
+    }
+    userDefault->flush();
+
+    auto result = StringUtils::format("%d sets: %.2f ms\n%d gets: %.2f ms (sum %lld)\nflush: %.2f ms",
+                                      OPERATION_COUNT / 2, setTime, OPERATION_COUNT / 2, getTime, sum, flushTime);
+    _label->setString(result);
+    CCLOG("%s", result.c_str());
+}
@@ -44,4 +44,18 @@ private:
     cocos2d::Label* _label;
 };
 
+class UserDefaultBenchmark : public TestCase
+{
+public:
+    CREATE_FUNC(UserDefaultBenchmark);
+    UserDefaultBenchmark();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    void runBenchmark(cocos2d::Ref* sender);
+    cocos2d::Label* _label;
+};
+
 #endif // _USERDEFAULT_TEST_H_
@@ -79,6 +79,7 @@
 #include "LabelTest/LabelTestNew.h"
 #include "LayerTest/LayerTest.h"
 #include "LightTest/LightTest.h"
+#include "LocalStorageTest/LocalStorageTest.h"
 #include "MaterialSystemTest/MaterialSystemTest.h"
 #include "MenuTest/MenuTest.h"
 #include "MotionStreakTest/MotionStreakTest.h"
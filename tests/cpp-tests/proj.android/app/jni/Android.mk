@@ -58,8 +58,11 @@ LOCAL_SRC_FILES := main.cpp \
 ../../../Classes/ExtensionsTest/NetworkTest/SocketIOTest.cpp \
 ../../../Classes/ExtensionsTest/NetworkTest/WebSocketTest.cpp \
 ../../../Classes/ExtensionsTest/NetworkTest/WebSocketDelayTest.cpp \
+../../../Classes/ExtensionsTest/NetworkTest/WebSocketThroughputTest.cpp \
 ../../../Classes/ExtensionsTest/TableViewTest/CustomTableViewCell.cpp \
 ../../../Classes/ExtensionsTest/TableViewTest/TableViewTestScene.cpp \
+../../../Classes/ExtensionsTest/CocoStudioArmatureTest/ArmatureScene.cpp \
+../../../Classes/ExtensionsTest/CocoStudioActionTimelineTest/ActionTimelineTestScene.cpp \
 ../../../Classes/FileUtilsTest/FileUtilsTest.cpp \
 ../../../Classes/FontTest/FontTest.cpp \
 ../../../Classes/InputTest/MouseTest.cpp \
@@ -137,6 +140,7 @@ LOCAL_SRC_FILES := main.cpp \
 ../../../Classes/UnitTest/RefPtrTest.cpp \
 ../../../Classes/UnitTest/UnitTest.cpp \
 ../../../Classes/UserDefaultTest/UserDefaultTest.cpp \
+../../../Classes/LocalStorageTest/LocalStorageTest.cpp \
 ../../../Classes/VisibleRect.cpp \
 ../../../Classes/VibrateTest/VibrateTest.cpp \
 ../../../Classes/VRTest/VRTest.cpp \